@@ -1113,6 +1113,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_bvh_layouts,
         default='EMBREE',
     )
+    debug_use_cpu_wavefront: BoolProperty(
+        name="Wavefront",
+        description="Render batches of pixels together one kernel at a time, tracing rays in packets and shading paths sorted by shader",
+        default=False,
+    )
 
     adaptive_compile_description = "Compile the Cycles GPU kernel with only the feature set required for the current scene"
 
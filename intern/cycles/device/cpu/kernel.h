@@ -32,6 +32,15 @@ class CPUKernels {
   IntegratorInitFunction integrator_init_from_bake;
   IntegratorShadeFunction integrator_megakernel;
 
+  /* Advances a batch of paths together, see kernel/integrator/wavefront.h. */
+  using IntegratorWavefrontFunction =
+      CPUKernelFunction<void (*)(const ThreadKernelGlobalsCPU *kg,
+                                 IntegratorStateCPU *states,
+                                 const int states_num,
+                                 ccl_global float *render_buffer)>;
+
+  IntegratorWavefrontFunction integrator_wavefront;
+
   /* Shader evaluation. */
 
   using ShaderEvalFunction = CPUKernelFunction<void (*)(
@@ -19,6 +19,7 @@
 #include "scene/scene.h"
 #include "session/buffers.h"
 
+#include "util/debug.h"
 #include "util/tbb.h"
 #include "util/time.h"
 
@@ -33,6 +34,9 @@ static inline tbb::task_arena local_tbb_arena_create(const Device *device)
   return tbb::task_arena(device->info.cpu_threads);
 }
 
+/* Width and height of the blocks of pixels which are rendered together in wavefront mode. */
+static constexpr int wavefront_block_size = 8;
+
 /* Get ThreadKernelGlobalsCPU for the current thread. */
 static inline ThreadKernelGlobalsCPU *kernel_thread_globals_get(
     vector<ThreadKernelGlobalsCPU> &kernel_thread_globals)
@@ -64,6 +68,7 @@ void PathTraceWorkCPU::deinit_execution()
 {
   device_->release_cpu_kernel_thread_globals();
   kernel_thread_globals_ = nullptr;
+  wavefront_states_.clear();
 }
 
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
@@ -83,6 +88,11 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
 
   tbb::task_arena local_arena = local_tbb_arena_create(device_);
   local_arena.execute([&]() {
+    if (DebugFlags().cpu.wavefront) {
+      render_samples_wavefront(start_sample, samples_num, sample_offset);
+      return;
+    }
+
     parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
       if (is_cancel_requested()) {
         return;
@@ -195,6 +205,129 @@ void PathTraceWorkCPU::render_samples_full_pipeline(ThreadKernelGlobalsCPU *kern
   }
 }
 
+void PathTraceWorkCPU::render_samples_wavefront(const int start_sample,
+                                                const int samples_num,
+                                                const int sample_offset)
+{
+  const int64_t image_width = effective_buffer_params_.width;
+  const int64_t image_height = effective_buffer_params_.height;
+  const int64_t blocks_x = divide_up(image_width, wavefront_block_size);
+  const int64_t blocks_num = blocks_x * divide_up(image_height, wavefront_block_size);
+
+  wavefront_states_.resize(kernel_thread_globals_->size());
+
+  parallel_for(int64_t(0), blocks_num, [&](int64_t block_index) {
+    if (is_cancel_requested()) {
+      return;
+    }
+
+    const int x = (block_index % blocks_x) * wavefront_block_size;
+    const int y = (block_index / blocks_x) * wavefront_block_size;
+
+    KernelWorkTile work_tile;
+    work_tile.x = effective_buffer_params_.full_x + x;
+    work_tile.y = effective_buffer_params_.full_y + y;
+    work_tile.w = min(wavefront_block_size, int(image_width - x));
+    work_tile.h = min(wavefront_block_size, int(image_height - y));
+    work_tile.start_sample = start_sample;
+    work_tile.sample_offset = sample_offset;
+    work_tile.num_samples = 1;
+    work_tile.offset = effective_buffer_params_.offset;
+    work_tile.stride = effective_buffer_params_.stride;
+
+    ThreadKernelGlobalsCPU *kernel_globals = kernel_thread_globals_get(*kernel_thread_globals_);
+
+    /* States are not initialized, the kernels initialize them for every sample. */
+    const int thread_index = tbb::this_task_arena::current_thread_index();
+    unique_ptr<IntegratorStateCPU[]> &states = wavefront_states_[thread_index];
+    if (!states) {
+      states.reset(new IntegratorStateCPU[INTEGRATOR_WAVEFRONT_MAX_STATES]);
+    }
+
+    render_samples_wavefront_block(kernel_globals, states.get(), work_tile, samples_num);
+  });
+}
+
+void PathTraceWorkCPU::render_samples_wavefront_block(ThreadKernelGlobalsCPU *kernel_globals,
+                                                      IntegratorStateCPU *states,
+                                                      const KernelWorkTile &work_tile,
+                                                      const int samples_num)
+{
+#if defined(WITH_PATH_GUIDING)
+  /* Training data is gathered per path, so render pixel by pixel with the megakernel. */
+  if (kernel_globals->data.integrator.train_guiding) {
+    for (int y = 0; y < work_tile.h; y++) {
+      for (int x = 0; x < work_tile.w; x++) {
+        KernelWorkTile pixel_work_tile = work_tile;
+        pixel_work_tile.x = work_tile.x + x;
+        pixel_work_tile.y = work_tile.y + y;
+        pixel_work_tile.w = 1;
+        pixel_work_tile.h = 1;
+        render_samples_full_pipeline(kernel_globals, pixel_work_tile, samples_num);
+      }
+    }
+    return;
+  }
+#endif
+
+  const bool has_bake = device_scene_->data.bake.use;
+
+  /* Every path state is followed by its shadow catcher state, same as for the megakernel. */
+  const int state_stride = device_scene_->data.integrator.has_shadow_catcher ? 2 : 1;
+  const int pixels_num = work_tile.w * work_tile.h;
+  const int states_num = pixels_num * state_stride;
+  DCHECK_LE(states_num, INTEGRATOR_WAVEFRONT_MAX_STATES);
+
+  float *render_buffer = buffers_->buffer.data();
+
+  fast_timer render_timer;
+
+  for (int sample = 0; sample < samples_num; ++sample) {
+    if (is_cancel_requested()) {
+      break;
+    }
+
+    for (int i = 0; i < pixels_num; i++) {
+      KernelWorkTile pixel_work_tile = work_tile;
+      pixel_work_tile.x = work_tile.x + i % work_tile.w;
+      pixel_work_tile.y = work_tile.y + i / work_tile.w;
+      pixel_work_tile.w = 1;
+      pixel_work_tile.h = 1;
+      pixel_work_tile.start_sample = work_tile.start_sample + sample;
+
+      IntegratorStateCPU *state = &states[i * state_stride];
+      if (state_stride == 2) {
+        path_state_init_queues(state + 1);
+      }
+
+      /* Pixels which do not need more samples have no kernel queued, so are skipped by the
+       * wavefront kernel. */
+      if (has_bake) {
+        kernels_.integrator_init_from_bake(kernel_globals, state, &pixel_work_tile, render_buffer);
+      }
+      else {
+        kernels_.integrator_init_from_camera(
+            kernel_globals, state, &pixel_work_tile, render_buffer);
+      }
+    }
+
+    kernels_.integrator_wavefront(kernel_globals, states, states_num, render_buffer);
+
+    if (kernel_globals->data.film.pass_render_time != PASS_UNUSED) {
+      uint64_t time;
+      if (render_timer.lap(time)) {
+        /* Paths of the block are rendered together, so distribute the time evenly. */
+        for (int i = 0; i < pixels_num; i++) {
+          ccl_global float *buffer = render_buffer +
+                                     (uint64_t)states[i * state_stride].path.render_pixel_index *
+                                         kernel_globals->data.film.pass_stride;
+          *(buffer + kernel_globals->data.film.pass_render_time) += float(time) / pixels_num;
+        }
+      }
+    }
+  }
+}
+
 void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
                                        PassMode pass_mode,
                                        const int num_samples)
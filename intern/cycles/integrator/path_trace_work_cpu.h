@@ -11,6 +11,7 @@
 
 #include "integrator/path_trace_work.h"
 
+#include "util/unique_ptr.h"
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -76,12 +77,25 @@ class PathTraceWorkCPU : public PathTraceWork {
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Render samples of blocks of pixels, advancing the paths of a block together one kernel at a
+   * time using the wavefront kernel. Must be called from within the local TBB arena. */
+  void render_samples_wavefront(const int start_sample,
+                                const int samples_num,
+                                const int sample_offset);
+  void render_samples_wavefront_block(ThreadKernelGlobalsCPU *kernel_globals,
+                                      IntegratorStateCPU *states,
+                                      const KernelWorkTile &work_tile,
+                                      const int samples_num);
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
   /* Pointer to device-owned kernel globals which is suitable for concurrent access from multiple
    * threads. This allows dynamic updates to image_info when textures are loaded on demand. */
   vector<ThreadKernelGlobalsCPU> *kernel_thread_globals_ = nullptr;
+
+  /* Per-thread integrator states of the wavefront kernel, allocated on first use. */
+  vector<unique_ptr<IntegratorStateCPU[]>> wavefront_states_;
 };
 
 CCL_NAMESPACE_END
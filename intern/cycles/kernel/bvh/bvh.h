@@ -274,6 +274,37 @@ ccl_device_intersect bool scene_intersect_shadow(KernelGlobals kg,
   return scene_intersect(kg, ray, visibility, &isect);
 }
 
+#  ifndef __KERNEL_GPU__
+/* Closest hit intersection of multiple rays at once, for the CPU wavefront integrator. With
+ * Embree the rays are traced as a packet of up to #EMBREE_PACKET_SIZE rays. */
+ccl_device_intersect void scene_intersect_packet(KernelGlobals kg,
+                                                 const Ray *const *rays,
+                                                 const uint *visibility,
+                                                 const int rays_num,
+                                                 Intersection *isect,
+                                                 bool *hit)
+{
+#    ifdef __EMBREE__
+  if (kernel_data.device_bvh) {
+    for (int i = 0; i < rays_num; i += EMBREE_PACKET_SIZE) {
+      kernel_embree_intersect_packet(kg,
+                                     rays + i,
+                                     visibility + i,
+                                     min(rays_num - i, EMBREE_PACKET_SIZE),
+                                     isect + i,
+                                     hit + i);
+    }
+    return;
+  }
+#    endif
+
+  for (int i = 0; i < rays_num; i++) {
+    isect[i].t = rays[i]->tmax;
+    hit[i] = scene_intersect(kg, rays[i], visibility[i], &isect[i]);
+  }
+}
+#  endif
+
 /* Single object BVH traversal, for SSS/AO/bevel. */
 
 #  ifdef __BVH_LOCAL__
@@ -41,6 +41,8 @@ using numhit_t = uint32_t;
 #  define RTCTraversable RTCScene
 #  define rtcGetGeometryUserDataFromTraversable rtcGetGeometryUserDataFromScene
 #  define rtcTraversableIntersect1 rtcIntersect1
+#  define rtcTraversableIntersect4 rtcIntersect4
+#  define rtcTraversableIntersect8 rtcIntersect8
 #  define rtcTraversableOccluded1 rtcOccluded1
 #endif
 
@@ -58,6 +60,20 @@ using numhit_t = uint32_t;
 
 #define EMBREE_IS_HAIR(x) (x & 1)
 
+/* Ray packets, used by the CPU wavefront integrator. The packet size matches the SIMD width of
+ * the kernel architecture. */
+#ifndef __KERNEL_ONEAPI__
+#  ifdef __KERNEL_AVX2__
+#    define EMBREE_PACKET_SIZE 8
+using RTCRayHitPacket = RTCRayHit8;
+#    define rtcTraversableIntersectPacket rtcTraversableIntersect8
+#  else
+#    define EMBREE_PACKET_SIZE 4
+using RTCRayHitPacket = RTCRayHit4;
+#    define rtcTraversableIntersectPacket rtcTraversableIntersect4
+#  endif
+#endif
+
 /* Intersection context. */
 
 struct CCLFirstHitContext : public RTCRayQueryContext {
@@ -66,6 +82,14 @@ struct CCLFirstHitContext : public RTCRayQueryContext {
   const Ray *ray;
 };
 
+#ifndef __KERNEL_ONEAPI__
+struct CCLFirstHitPacketContext : public RTCRayQueryContext {
+  KernelGlobals kg;
+  /* Rays of the packet, indexed by the ray ID. */
+  const Ray *rays[EMBREE_PACKET_SIZE];
+};
+#endif
+
 struct CCLShadowContext : public RTCRayQueryContext {
 #if defined(__KERNEL_ONEAPI__)
   ONEAPIKernelContext *oneapi_kernel_context;
@@ -245,6 +269,42 @@ ccl_device_forceinline void kernel_embree_filter_intersection_func_impl(
 #endif
 }
 
+#ifndef __KERNEL_ONEAPI__
+/* Same as #kernel_embree_filter_intersection_func_impl, for packet queries. Embree may invoke it
+ * with any number of rays, so the ray of each hit is looked up by its ID. */
+ccl_device void kernel_embree_filter_intersection_packet_func(
+    const RTCFilterFunctionNArguments *args)
+{
+  const CCLFirstHitPacketContext *ctx = (const CCLFirstHitPacketContext *)(args->context);
+  const ThreadKernelGlobalsCPU *kg = ctx->kg;
+  const intptr_t prim_offset = reinterpret_cast<intptr_t>(args->geometryUserPtr);
+
+  for (uint i = 0; i < args->N; i++) {
+    if (args->valid[i] == 0) {
+      continue;
+    }
+
+    RTCHit hit;
+    hit.geomID = RTCHitN_geomID(args->hit, args->N, i);
+    hit.primID = RTCHitN_primID(args->hit, args->N, i);
+    hit.instID[0] = RTCHitN_instID(args->hit, args->N, i, 0);
+    const Ray *cray = ctx->rays[RTCRayN_id(args->ray, args->N, i)];
+
+    if (kernel_embree_is_self_intersection(kg, &hit, cray, prim_offset)) {
+      args->valid[i] = 0;
+      continue;
+    }
+
+#  ifdef __SHADOW_LINKING__
+    if (intersection_skip_shadow_link(kg, cray->self, kernel_embree_get_hit_object(&hit))) {
+      args->valid[i] = 0;
+      continue;
+    }
+#  endif
+  }
+}
+#endif
+
 /* This gets called by Embree at every valid ray/object intersection.
  * Things like recording subsurface or shadow hits for later evaluation
  * as well as filtering for volume objects happen here.
@@ -516,6 +576,81 @@ ccl_device_intersect bool kernel_embree_intersect(KernelGlobals kg,
   return true;
 }
 
+#ifndef __KERNEL_ONEAPI__
+/* Intersect up to #EMBREE_PACKET_SIZE rays with a single packet query. Rays which are not valid
+ * are masked out of the packet and do not hit anything. */
+ccl_device_intersect void kernel_embree_intersect_packet(KernelGlobals kg,
+                                                         const Ray *const *rays,
+                                                         const uint *visibility,
+                                                         const int rays_num,
+                                                         Intersection *isect,
+                                                         bool *hit)
+{
+  kernel_assert(rays_num <= EMBREE_PACKET_SIZE);
+
+  CCLFirstHitPacketContext ctx;
+  rtcInitRayQueryContext(&ctx);
+  ctx.kg = kg;
+
+  /* Embree loads the valid mask with an aligned vector load. */
+  alignas(sizeof(int) * EMBREE_PACKET_SIZE) int valid[EMBREE_PACKET_SIZE];
+  RTCRayHitPacket ray_hit;
+  for (int i = 0; i < EMBREE_PACKET_SIZE; i++) {
+    const Ray *ray = (i < rays_num) ? rays[i] : nullptr;
+    valid[i] = (ray && intersection_ray_valid(ray)) ? -1 : 0;
+    ctx.rays[i] = ray;
+    if (ray) {
+      /* Same as #kernel_embree_intersect, rays which miss or are masked out keep the full
+       * distance, which light and volume intersection rely on. */
+      isect[i].t = ray->tmax;
+    }
+    if (!valid[i]) {
+      continue;
+    }
+    ray_hit.ray.org_x[i] = ray->P.x;
+    ray_hit.ray.org_y[i] = ray->P.y;
+    ray_hit.ray.org_z[i] = ray->P.z;
+    ray_hit.ray.dir_x[i] = ray->D.x;
+    ray_hit.ray.dir_y[i] = ray->D.y;
+    ray_hit.ray.dir_z[i] = ray->D.z;
+    ray_hit.ray.tnear[i] = ray->tmin;
+    ray_hit.ray.tfar[i] = ray->tmax;
+    ray_hit.ray.time[i] = ray->time;
+    ray_hit.ray.mask[i] = visibility[i];
+    ray_hit.ray.id[i] = i;
+    ray_hit.ray.flags[i] = 0;
+    ray_hit.hit.geomID[i] = RTC_INVALID_GEOMETRY_ID;
+    ray_hit.hit.instID[0][i] = RTC_INVALID_GEOMETRY_ID;
+  }
+
+  RTCIntersectArguments args;
+  rtcInitIntersectArguments(&args);
+  args.filter = reinterpret_cast<RTCFilterFunctionN>(
+      kernel_embree_filter_intersection_packet_func);
+  args.feature_mask = CYCLES_EMBREE_USED_FEATURES;
+  args.context = &ctx;
+  rtcTraversableIntersectPacket(valid, kernel_data.device_bvh, &ray_hit, &args);
+
+  for (int i = 0; i < rays_num; i++) {
+    hit[i] = valid[i] && ray_hit.hit.geomID[i] != RTC_INVALID_GEOMETRY_ID &&
+             ray_hit.hit.primID[i] != RTC_INVALID_GEOMETRY_ID;
+    if (!hit[i]) {
+      continue;
+    }
+
+    RTCRay lane_ray;
+    lane_ray.tfar = ray_hit.ray.tfar[i];
+    RTCHit lane_hit;
+    lane_hit.geomID = ray_hit.hit.geomID[i];
+    lane_hit.primID = ray_hit.hit.primID[i];
+    lane_hit.instID[0] = ray_hit.hit.instID[0][i];
+    lane_hit.u = ray_hit.hit.u[i];
+    lane_hit.v = ray_hit.hit.v[i];
+    kernel_embree_convert_hit(kg, &lane_ray, &lane_hit, &isect[i]);
+  }
+}
+#endif
+
 #ifdef __BVH_LOCAL__
 ccl_device_intersect bool kernel_embree_intersect_local(KernelGlobals kg,
                                                         const ccl_private Ray *ray,
@@ -28,6 +28,10 @@
 KERNEL_INTEGRATOR_INIT_FUNCTION(init_from_camera);
 KERNEL_INTEGRATOR_INIT_FUNCTION(init_from_bake);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel);
+void KERNEL_FUNCTION_FULL_NAME(integrator_wavefront)(const ThreadKernelGlobalsCPU *ccl_restrict kg,
+                                                     IntegratorStateCPU *states,
+                                                     const int states_num,
+                                                     ccl_global float *render_buffer);
 
 #undef KERNEL_INTEGRATOR_FUNCTION
 #undef KERNEL_INTEGRATOR_INIT_FUNCTION
@@ -25,6 +25,7 @@
 #    include "kernel/integrator/init_from_camera.h"
 #    include "kernel/integrator/init_from_bake.h"
 #    include "kernel/integrator/megakernel.h"
+#    include "kernel/integrator/wavefront.h"
 
 #    include "kernel/film/adaptive_sampling.h"
 #    include "kernel/film/cryptomatte_passes.h"
@@ -82,6 +83,22 @@ DEFINE_INTEGRATOR_INIT_KERNEL(init_from_camera)
 DEFINE_INTEGRATOR_INIT_KERNEL(init_from_bake)
 DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel)
 
+void KERNEL_FUNCTION_FULL_NAME(integrator_wavefront)(const ThreadKernelGlobalsCPU *kg,
+                                                     IntegratorStateCPU *states,
+                                                     const int states_num,
+                                                     ccl_global float *render_buffer)
+{
+#ifdef KERNEL_STUB
+  STUB_ASSERT(KERNEL_ARCH, integrator_wavefront);
+  (void)kg;
+  (void)states;
+  (void)states_num;
+  (void)render_buffer;
+#else
+  integrator_wavefront(kg, states, states_num, render_buffer);
+#endif
+}
+
 /* --------------------------------------------------------------------
  * Shader evaluation.
  */
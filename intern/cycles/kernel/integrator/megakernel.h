@@ -19,6 +19,78 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Execute a kernel for a shadow path. */
+ccl_device_forceinline void integrator_execute_shadow_kernel(
+    KernelGlobals kg,
+    IntegratorShadowState state,
+    const uint32_t queued_kernel,
+    ccl_global float *ccl_restrict render_buffer)
+{
+  switch (queued_kernel) {
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW:
+      integrator_intersect_shadow(kg, state);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW:
+      integrator_shade_shadow(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT_NEE:
+      integrator_shade_light_nee(kg, state, render_buffer);
+      break;
+    default:
+      kernel_assert(0);
+      break;
+  }
+}
+
+/* Execute a kernel for a regular path. */
+ccl_device_forceinline void integrator_execute_kernel(KernelGlobals kg,
+                                                      IntegratorState state,
+                                                      const uint32_t queued_kernel,
+                                                      ccl_global float *ccl_restrict render_buffer)
+{
+  switch (queued_kernel) {
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
+      integrator_intersect_closest(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
+      integrator_shade_background(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
+      integrator_shade_surface(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
+      integrator_shade_volume(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME_RAY_MARCHING:
+      integrator_shade_volume_ray_marching(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
+      integrator_shade_surface_raytrace(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT_FORWARD:
+      integrator_shade_light_forward(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_DEDICATED_LIGHT:
+      integrator_shade_dedicated_light(kg, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE:
+      integrator_intersect_subsurface(kg, state);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK:
+      integrator_intersect_volume_stack(kg, state);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_DEDICATED_LIGHT:
+      integrator_intersect_dedicated_light(kg, state);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_MNEE:
+      integrator_intersect_mnee(kg, state);
+      break;
+    default:
+      kernel_assert(0);
+      break;
+  }
+}
+
 ccl_device void integrator_megakernel(KernelGlobals kg,
                                       IntegratorState state,
                                       ccl_global float *ccl_restrict render_buffer)
@@ -29,88 +101,26 @@ ccl_device void integrator_megakernel(KernelGlobals kg,
     /* Handle any shadow paths before we potentially create more shadow paths. */
     const uint32_t shadow_queued_kernel = INTEGRATOR_STATE(
         &state->shadow, shadow_path, queued_kernel);
-    if (shadow_queued_kernel) {
-      switch (shadow_queued_kernel) {
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW:
-          integrator_intersect_shadow(kg, &state->shadow);
-          continue;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW:
-          integrator_shade_shadow(kg, &state->shadow, render_buffer);
-          continue;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT_NEE:
-          integrator_shade_light_nee(kg, &state->shadow, render_buffer);
-          continue;
-        case DEVICE_KERNEL_INTEGRATOR_SHADOW_PATH_MNEE_PENDING:
-          /* Not a real kernel, only a state to keep it alive until
-           * shade_surface uses this shadow path. */
-          break;
-        default:
-          kernel_assert(0);
-          break;
-      }
+    /* The MNEE pending kernel is not a real kernel, only a state to keep it alive until
+     * shade_surface uses this shadow path. */
+    if (shadow_queued_kernel &&
+        shadow_queued_kernel != DEVICE_KERNEL_INTEGRATOR_SHADOW_PATH_MNEE_PENDING)
+    {
+      integrator_execute_shadow_kernel(kg, &state->shadow, shadow_queued_kernel, render_buffer);
+      continue;
     }
 
     /* Handle any AO paths before we potentially create more AO paths. */
     const uint32_t ao_queued_kernel = INTEGRATOR_STATE(&state->ao, shadow_path, queued_kernel);
     if (ao_queued_kernel) {
-      switch (ao_queued_kernel) {
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW:
-          integrator_intersect_shadow(kg, &state->ao);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW:
-          integrator_shade_shadow(kg, &state->ao, render_buffer);
-          break;
-        default:
-          kernel_assert(0);
-          break;
-      }
+      integrator_execute_shadow_kernel(kg, &state->ao, ao_queued_kernel, render_buffer);
       continue;
     }
 
     /* Then handle regular path kernels. */
     const uint32_t queued_kernel = INTEGRATOR_STATE(state, path, queued_kernel);
     if (queued_kernel) {
-      switch (queued_kernel) {
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
-          integrator_intersect_closest(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
-          integrator_shade_background(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
-          integrator_shade_surface(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
-          integrator_shade_volume(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME_RAY_MARCHING:
-          integrator_shade_volume_ray_marching(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
-          integrator_shade_surface_raytrace(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT_FORWARD:
-          integrator_shade_light_forward(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_SHADE_DEDICATED_LIGHT:
-          integrator_shade_dedicated_light(kg, state, render_buffer);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE:
-          integrator_intersect_subsurface(kg, state);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK:
-          integrator_intersect_volume_stack(kg, state);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_DEDICATED_LIGHT:
-          integrator_intersect_dedicated_light(kg, state);
-          break;
-        case DEVICE_KERNEL_INTEGRATOR_INTERSECT_MNEE:
-          integrator_intersect_mnee(kg, state);
-          break;
-        default:
-          kernel_assert(0);
-          break;
-      }
+      integrator_execute_kernel(kg, state, queued_kernel, render_buffer);
       continue;
     }
 
@@ -215,7 +215,8 @@ ccl_device_forceinline void integrator_path_init_sorted(KernelGlobals /*kg*/,
                                                         const uint32_t key)
 {
   INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel;
-  (void)key;
+  /* Used by the wavefront integrator to sort paths by shader. */
+  INTEGRATOR_STATE_WRITE(state, path, shader_sort_key) = key;
 }
 
 ccl_device_forceinline void integrator_path_next(IntegratorState state,
@@ -256,7 +257,7 @@ ccl_device_forceinline void integrator_path_next_sorted(KernelGlobals /*kg*/,
                                                         const uint32_t key)
 {
   INTEGRATOR_STATE_WRITE(state, path, queued_kernel) = next_kernel;
-  (void)key;
+  INTEGRATOR_STATE_WRITE(state, path, shader_sort_key) = key;
   (void)current_kernel;
 }
 
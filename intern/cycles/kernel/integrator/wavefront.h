@@ -0,0 +1,150 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#pragma once
+
+#include "kernel/integrator/megakernel.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* CPU Wavefront Integrator
+ *
+ * Instead of running the megakernel to completion for one path at a time, the paths of a batch
+ * of pixels are advanced together, one kernel at a time for all paths queued for it. Rays of the
+ * closest hit intersection kernel are traced together as ray packets, and the surface shading
+ * kernels run over the paths sorted by shader, so that consecutive evaluations use the same
+ * shader program and textures.
+ *
+ * States are laid out in pairs like for the megakernel: every path state is followed by the
+ * state which is used when the path is split for the shadow catcher. */
+
+/* Execute the queued kernels of all shadow and AO paths until they are done. */
+ccl_device void integrator_wavefront_shadow(KernelGlobals kg,
+                                            IntegratorStateCPU *states,
+                                            const int states_num,
+                                            ccl_global float *ccl_restrict render_buffer)
+{
+  const uint32_t shadow_kernels[] = {DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW,
+                                     DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW,
+                                     DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT_NEE};
+
+  bool executed = true;
+  while (executed) {
+    executed = false;
+    for (const uint32_t kernel : shadow_kernels) {
+      for (int i = 0; i < states_num; i++) {
+        IntegratorShadowState shadow_states[2] = {&states[i].shadow, &states[i].ao};
+        for (IntegratorShadowState shadow_state : shadow_states) {
+          if (INTEGRATOR_STATE(shadow_state, shadow_path, queued_kernel) == kernel) {
+            integrator_execute_shadow_kernel(kg, shadow_state, kernel, render_buffer);
+            executed = true;
+          }
+        }
+      }
+    }
+  }
+}
+
+/* Intersect the rays of all queued paths, as packets when the BVH supports it. */
+ccl_device void integrator_wavefront_intersect(KernelGlobals kg,
+                                               IntegratorStateCPU *states,
+                                               const int *queue,
+                                               const int queue_num,
+                                               ccl_global float *ccl_restrict render_buffer)
+{
+  PROFILING_INIT(kg, PROFILING_INTERSECT_CLOSEST);
+
+  Ray rays[INTEGRATOR_WAVEFRONT_MAX_STATES];
+  const Ray *ray_ptrs[INTEGRATOR_WAVEFRONT_MAX_STATES];
+  uint visibility[INTEGRATOR_WAVEFRONT_MAX_STATES];
+  Intersection isect[INTEGRATOR_WAVEFRONT_MAX_STATES];
+  bool hit[INTEGRATOR_WAVEFRONT_MAX_STATES];
+
+  for (int i = 0; i < queue_num; i++) {
+    visibility[i] = integrator_intersect_closest_ray(kg, &states[queue[i]], &rays[i], &isect[i]);
+    ray_ptrs[i] = &rays[i];
+  }
+
+  scene_intersect_packet(kg, ray_ptrs, visibility, queue_num, isect, hit);
+
+  for (int i = 0; i < queue_num; i++) {
+    integrator_intersect_closest_result(
+        kg, &states[queue[i]], &rays[i], &isect[i], hit[i], render_buffer);
+  }
+}
+
+/* Sort the queued paths by their shader sort key. Insertion sort is stable and fast enough for
+ * the small number of paths in a batch, and keeps paths of the same shader in pixel order. */
+ccl_device void integrator_wavefront_sort(const IntegratorStateCPU *states,
+                                          int *queue,
+                                          const int queue_num)
+{
+  for (int i = 1; i < queue_num; i++) {
+    const int index = queue[i];
+    const uint32_t key = INTEGRATOR_STATE(&states[index], path, shader_sort_key);
+    int j = i - 1;
+    while (j >= 0 && INTEGRATOR_STATE(&states[queue[j]], path, shader_sort_key) > key) {
+      queue[j + 1] = queue[j];
+      j--;
+    }
+    queue[j + 1] = index;
+  }
+}
+
+ccl_device void integrator_wavefront(KernelGlobals kg,
+                                     IntegratorStateCPU *states,
+                                     const int states_num,
+                                     ccl_global float *ccl_restrict render_buffer)
+{
+  kernel_assert(states_num <= INTEGRATOR_WAVEFRONT_MAX_STATES);
+
+  int queue[INTEGRATOR_WAVEFRONT_MAX_STATES];
+
+  while (true) {
+    /* Handle all shadow paths before we potentially create more shadow paths. */
+    integrator_wavefront_shadow(kg, states, states_num, render_buffer);
+
+    /* Execute the kernel with the most queued paths next, same as the GPU scheduler. */
+    int num_queued[DEVICE_KERNEL_INTEGRATOR_MEGAKERNEL] = {0};
+    for (int i = 0; i < states_num; i++) {
+      num_queued[INTEGRATOR_STATE(&states[i], path, queued_kernel)]++;
+    }
+
+    uint32_t kernel = 0;
+    int max_queued = 0;
+    for (uint32_t k = 1; k < DEVICE_KERNEL_INTEGRATOR_MEGAKERNEL; k++) {
+      if (num_queued[k] > max_queued) {
+        kernel = k;
+        max_queued = num_queued[k];
+      }
+    }
+    if (kernel == 0) {
+      break;
+    }
+
+    int queue_num = 0;
+    for (int i = 0; i < states_num; i++) {
+      if (INTEGRATOR_STATE(&states[i], path, queued_kernel) == kernel) {
+        queue[queue_num++] = i;
+      }
+    }
+
+    if (kernel == DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST) {
+      integrator_wavefront_intersect(kg, states, queue, queue_num, render_buffer);
+      continue;
+    }
+
+    if (kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE ||
+        kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE)
+    {
+      integrator_wavefront_sort(states, queue, queue_num);
+    }
+
+    for (int i = 0; i < queue_num; i++) {
+      integrator_execute_kernel(kg, &states[queue[i]], kernel, render_buffer);
+    }
+  }
+}
+
+CCL_NAMESPACE_END
@@ -45,6 +45,10 @@ class DebugFlags {
      * CPUs and GPUs can be selected here instead.
      */
     BVHLayout bvh_layout = BVH_LAYOUT_AUTO;
+
+    /* Advance the paths of batches of pixels together one kernel at a time, instead of running
+     * the megakernel for every path. */
+    bool wavefront = false;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
@@ -851,6 +851,7 @@ class USERPREF_PT_system_memory(SystemPanel, CenterAlignMixIn, Panel):
         col = layout.column()
         col.prop(edit, "undo_steps", text="Undo Steps")
         col.prop(edit, "undo_memory_limit", text="Undo Memory Limit")
+        col.prop(edit, "use_undo_compression")
         col.prop(edit, "use_global_undo")
 
         layout.separator()
@@ -892,6 +893,7 @@ class USERPREF_PT_system_video_sequencer(SystemPanel, CenterAlignMixIn, Panel):
         system = prefs.system
 
         layout.prop(system, "memory_cache_limit")
+        layout.prop(system, "memory_cache_disk_limit")
 
         layout.separator()
 
@@ -3037,6 +3039,8 @@ class USERPREF_PT_experimental_prototypes(ExperimentalPanel, Panel):
             (
                 ({"property": "use_new_curves_tools"}, ("blender/blender/issues/68981", "#68981")),
                 ({"property": "use_sculpt_texture_paint"}, ("blender/blender/issues/96225", "#96225")),
+                ({"property": "use_display_transform_lut"}, None),
+                ({"property": "use_depsgraph_priority_scheduling"}, None),
             ),
         )
 
@@ -8,8 +8,11 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <mutex>
 #include <variant>
 
+#include "BLI_map.hh"
 #include "BLI_mutex.hh"
 #include "BLI_set.hh"
 #include "BLI_sub_frame.hh"
@@ -26,6 +29,7 @@ struct NodesModifierData;
 struct Main;
 struct Object;
 struct Scene;
+struct TaskPool;
 
 namespace bke::bake {
 
@@ -54,6 +58,68 @@ struct FrameCache {
   std::optional<std::variant<std::string, Span<std::byte>>> meta_data_source;
 };
 
+struct NodeBakeCache;
+
+/**
+ * Loads baked frames in a background thread before they are used, so that reading from disk and
+ * deserializing is not on the critical path of the depsgraph evaluation during playback. Which
+ * frames to load is predicted from the direction and speed of the playback. The number of frames
+ * that are loaded ahead of time is bounded.
+ */
+class FramePrefetcher : NonCopyable, NonMovable {
+ private:
+  /** Number of evaluated frames ahead of the current frame that are prefetched. */
+  static constexpr int frames_ahead_num = 8;
+  /** Larger steps between evaluated frames are considered to be jumps, not playback. */
+  static constexpr float max_playback_step = 4.0f;
+
+  struct Request {
+    SubFrame frame;
+    std::variant<std::string, Span<std::byte>> meta_data_source;
+  };
+
+  const NodeBakeCache &bake_cache_;
+  TaskPool *task_pool_ = nullptr;
+
+  std::mutex mutex_;
+  /** Notified when a frame has been loaded in the background and when loading is done. */
+  std::condition_variable loaded_cv_;
+  /** Frames that should be loaded next. The last request is handled first. */
+  Vector<Request> queue_;
+  /** True while a task is loading the requested frames. */
+  bool is_loading_ = false;
+  /** The frame that is currently loaded in the background. */
+  std::optional<SubFrame> loading_frame_;
+  /** Frames that have been loaded in the background and have not been used yet. */
+  Map<SubFrame, BakeValues> loaded_values_;
+  /** The frame that was evaluated before, used to predict the next frames. */
+  std::optional<SubFrame> last_frame_;
+
+ public:
+  explicit FramePrefetcher(const NodeBakeCache &bake_cache);
+  ~FramePrefetcher();
+
+  /**
+   * Predict the frames that will be evaluated after the current frame and start loading them in
+   * the background. Frames that are already loaded in the bake cache are skipped. Has to be called
+   * while the frames of the bake cache can't be modified.
+   */
+  void update(SubFrame current_frame);
+
+  /**
+   * Get the values for the frame if they have been prefetched. If the frame is loaded in the
+   * background right now, this waits until it is done.
+   */
+  std::optional<BakeValues> try_take(SubFrame frame);
+
+  /** Wait until all frames that have been requested so far are loaded. */
+  void wait_until_loaded();
+
+ private:
+  static void load_requested_fn(TaskPool *pool, void *taskdata);
+  void load_requested();
+};
+
 /**
  * Stores the state after the previous simulation step. This is only used, when the frame-cache is
  * not used.
@@ -80,9 +146,24 @@ struct NodeBakeCache {
   /** Used to avoid checking if a bake exists many times. */
   bool failed_finding_bake = false;
 
+  /**
+   * Loads frames in the background when the baked data is loaded lazily. This is declared last,
+   * so that it is destructed first, because it uses the other members from another thread.
+   */
+  std::unique_ptr<FramePrefetcher> prefetcher;
+
   /** Range spanning from the first to the last baked frame. */
   IndexRange frame_range() const;
 
+  /** Load the baked data of the frame if it is loaded lazily and not loaded yet. */
+  void ensure_frame_loaded(FrameCache &frame_cache);
+
+  /**
+   * Start loading the frames that are likely evaluated after the current frame in the background.
+   * Does nothing when the baked data is not loaded lazily.
+   */
+  void prefetch(SubFrame current_frame);
+
   void reset();
 };
 
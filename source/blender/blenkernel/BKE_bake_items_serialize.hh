@@ -15,9 +15,23 @@
 #include "BLI_serialize.hh"
 
 #include "BKE_bake_values.hh"
+#include "BKE_geometry_set.hh"
 
 namespace blender::bke::bake {
 
+/**
+ * How the data of a blob is encoded.
+ */
+enum class BlobCompression {
+  /** The data is stored as is, which allows reading it without a copy. */
+  None,
+  /**
+   * The bytes of the items are transposed and delta encoded (see #filter_transpose_delta) and
+   * then compressed with zstd. This is lossless and works well for smoothly varying data.
+   */
+  ZstdFiltered,
+};
+
 /**
  * Reference to a slice of memory typically stored on disk.
  * A blob is a "binary large object".
@@ -25,6 +39,17 @@ namespace blender::bke::bake {
 struct BlobSlice {
   std::string name;
   IndexRange range;
+  BlobCompression compression = BlobCompression::None;
+  /** Size of the data after decoding. Only used when the data is compressed. */
+  int64_t decoded_size = 0;
+  /** Size of the items that the data consists of. Only used when the data is compressed. */
+  int64_t item_size = 1;
+
+  /** Size of the data that the slice references after decoding. */
+  int64_t data_size() const
+  {
+    return this->compression == BlobCompression::None ? this->range.size() : this->decoded_size;
+  }
 
   std::shared_ptr<io::serialize::DictionaryValue> serialize() const;
   static std::optional<BlobSlice> deserialize(const io::serialize::DictionaryValue &io_slice);
@@ -43,6 +68,14 @@ class BlobReader {
    */
   [[nodiscard]] virtual bool read(const BlobSlice &slice, void *r_data) const = 0;
 
+  /**
+   * Get shared ownership of the data of the slice without copying it. This is only supported by
+   * some readers, and only for uncompressed data that has the given alignment. Otherwise, #read
+   * has to be used.
+   */
+  [[nodiscard]] virtual std::optional<ImplicitSharingInfoAndData> read_mapped(
+      const BlobSlice &slice, int64_t alignment) const;
+
   /**
    * Provides an #istream that can be used to read the data from the given slice.
    * \return True on success, otherwise false.
@@ -57,6 +90,7 @@ class BlobReader {
 class BlobWriter {
  protected:
   int64_t total_written_size_ = 0;
+  BlobCompression compression_ = BlobCompression::None;
 
  public:
   virtual ~BlobWriter() = default;
@@ -67,6 +101,19 @@ class BlobWriter {
    */
   virtual BlobSlice write(const void *data, int64_t size) = 0;
 
+  /**
+   * Write the provided data which consists of items of the given size, compressing it if
+   * compression is enabled for the writer and it's worth it.
+   * \return Slice where the data has been written to.
+   */
+  BlobSlice write_encoded(const void *data, int64_t size, int64_t item_size);
+
+  /** Set how data written with #write_encoded is compressed. */
+  void set_compression(const BlobCompression compression)
+  {
+    compression_ = compression;
+  }
+
   /**
    * Provides an #ostream that can be used to write the blob.
    * \param file_extension: May be used if the data is written to an independent file. Based on the
@@ -132,7 +179,7 @@ class BlobWriteSharing : NonCopyable, NonMovable {
    * Its hash is remembered so that the same data won't be written again.
    */
   [[nodiscard]] std::shared_ptr<io::serialize::DictionaryValue> write_deduplicated(
-      BlobWriter &writer, const void *data, int64_t size_in_bytes);
+      BlobWriter &writer, const void *data, int64_t size_in_bytes, int64_t item_size = 1);
 };
 
 /**
@@ -141,14 +188,27 @@ class BlobWriteSharing : NonCopyable, NonMovable {
 class BlobReadSharing : NonCopyable, NonMovable {
  private:
   /**
-   * Use a mutex so that #read_shared can be implemented in a thread-safe way.
+   * Data that is read once and shared afterwards. The entry is added before the data is read, so
+   * that other threads wait for the same data instead of reading it again.
+   */
+  struct SharedData {
+    /** Locked while the data is read, which is not done while #mutex_ is locked. */
+    Mutex mutex;
+    /** Has a strong reference to #ImplicitSharingInfo once the data has been read. */
+    std::optional<ImplicitSharingInfoAndData> data;
+  };
+
+  /**
+   * Use a mutex so that #read_shared can be implemented in a thread-safe way. It only protects
+   * the map, not the reading of the data.
    */
   mutable Mutex mutex_;
   /**
-   * Map used to detect when some data has been previously loaded. This keeps strong
-   * references to #ImplicitSharingInfo.
+   * Map used to detect when some data has been previously loaded or is being loaded. The stored
+   * data is released in the destructor. Memory mapped arrays keep their blob file mapped, so this
+   * has to be freed together with the baked data (see #NodeBakeCache::reset).
    */
-  mutable Map<std::string, ImplicitSharingInfoAndData> runtime_by_stored_;
+  mutable Map<std::string, std::shared_ptr<SharedData>> runtime_by_stored_;
 
  public:
   ~BlobReadSharing();
@@ -162,22 +222,31 @@ class BlobReadSharing : NonCopyable, NonMovable {
       FunctionRef<std::optional<ImplicitSharingInfoAndData>()> read_fn) const;
 };
 
+class MappedBlobFile;
+
 /**
- * A specific #BlobReader that reads from disk.
+ * A specific #BlobReader that reads from disk. Uncompressed data is read from memory mapped files
+ * when possible, so that it does not have to be copied.
  */
 class DiskBlobReader : public BlobReader {
  private:
   const std::string blobs_dir_;
   mutable Mutex mutex_;
   mutable Map<std::string, std::unique_ptr<fstream>> open_input_streams_;
+  /** Memory mapped blob files, which are kept alive by the data that references them. */
+  mutable Map<std::string, std::shared_ptr<MappedBlobFile>> mapped_files_;
 
  public:
   DiskBlobReader(std::string blobs_dir);
   [[nodiscard]] bool read(const BlobSlice &slice, void *r_data) const override;
+  [[nodiscard]] std::optional<ImplicitSharingInfoAndData> read_mapped(
+      const BlobSlice &slice, int64_t alignment) const override;
 };
 
 /**
- * A specific #BlobWriter that writes to a file on disk.
+ * A specific #BlobWriter that writes to a file on disk. The data of every blob starts at an
+ * offset that is a multiple of #alignment, so that it can be used directly when the file is memory
+ * mapped.
  */
 class DiskBlobWriter : public BlobWriter {
  private:
@@ -194,6 +263,8 @@ class DiskBlobWriter : public BlobWriter {
   int independent_file_count_ = 0;
 
  public:
+  static constexpr int64_t alignment = 16;
+
   DiskBlobWriter(std::string blob_dir, std::string base_name);
 
   BlobSlice write(const void *data, int64_t size) override;
@@ -245,6 +316,9 @@ class MemoryBlobReader : public BlobReader {
   [[nodiscard]] bool read(const BlobSlice &slice, void *r_data) const override;
 };
 
+/** Version of the format written by #serialize_bake, other versions can't be read. */
+constexpr int bake_file_version = 3;
+
 void serialize_bake(const BakeValues &bake_values,
                     BlobWriter &blob_writer,
                     BlobWriteSharing &blob_sharing,
@@ -254,4 +328,17 @@ std::optional<BakeValues> deserialize_bake(std::istream &stream,
                                            const BlobReader &blob_reader,
                                            const BlobReadSharing &blob_sharing);
 
+/**
+ * Write the geometry including all of its binary data to a single stream, using the same format
+ * as bakes. This is used to store geometries outside of bakes, e.g. in the disk tier of
+ * #memory_cache. Data-block references are not written.
+ */
+[[nodiscard]] bool serialize_geometry(const GeometrySet &geometry, std::ostream &stream);
+
+/**
+ * Read a geometry written by #serialize_geometry. The returned geometry does not reference the
+ * buffer.
+ */
+std::optional<GeometrySet> deserialize_geometry(Span<std::byte> buffer);
+
 }  // namespace blender::bke::bake
@@ -107,6 +107,13 @@ class Tree {
   /** Intersect a single ray against the tree. */
   std::optional<RayHit> ray_intersect(const Ray &ray) const;
 
+  /**
+   * Intersect many rays against the tree, with the same result as #ray_intersect for every ray.
+   * Consecutive rays that start close to each other and have a similar direction are cheaper to
+   * intersect together than one by one.
+   */
+  void ray_intersect_batch(Span<Ray> rays, MutableSpan<std::optional<RayHit>> r_hits) const;
+
   /** Call a callback for every ray intersection. */
   void ray_intersect_all(const Ray &ray, FunctionRef<void(const RayHit &)> fn) const;
 
@@ -35,6 +35,10 @@ struct Scene;
  * represented by a float, given its precision. */
 #define ALMOST_ZERO FLT_EPSILON
 
+/* How much the cost of queries of the cloth and collision BVH trees may grow while they deform,
+ * before they are balanced again instead of only refit. */
+#define CLOTH_BVH_MAX_COST_FACTOR 1.5f
+
 /* Bits to or into the #ClothVertex.flags. */
 enum eClothVertexFlag {
   CLOTH_VERT_FLAG_PINNED = (1 << 0),
@@ -2,7 +2,9 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <algorithm>
 #include <sstream>
+#include <utility>
 
 #include "BKE_bake_geometry_nodes_modifier.hh"
 #include "BKE_collection.hh"
@@ -12,9 +14,12 @@
 #include "DNA_modifier_types.h"
 #include "DNA_node_types.h"
 
+#include "BLI_binary_search.hh"
+#include "BLI_fileops.hh"
 #include "BLI_listbase.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_string.hh"
+#include "BLI_task_c.hh"
 
 #include "MOD_nodes.hh"
 
@@ -38,6 +43,149 @@ void NodeBakeCache::reset()
   new (this) NodeBakeCache();
 }
 
+static std::optional<BakeValues> load_frame_values(
+    const NodeBakeCache &bake_cache,
+    const std::variant<std::string, Span<std::byte>> &meta_data_source)
+{
+  if (bake_cache.memory_blob_reader) {
+    if (const auto *meta_buffer = std::get_if<Span<std::byte>>(&meta_data_source)) {
+      const std::string meta_str{reinterpret_cast<const char *>(meta_buffer->data()),
+                                 size_t(meta_buffer->size())};
+      std::istringstream meta_stream{meta_str};
+      return deserialize_bake(
+          meta_stream, *bake_cache.memory_blob_reader, *bake_cache.blob_sharing);
+    }
+  }
+  if (!bake_cache.blobs_dir) {
+    return std::nullopt;
+  }
+  const auto *meta_path = std::get_if<std::string>(&meta_data_source);
+  if (!meta_path) {
+    return std::nullopt;
+  }
+  DiskBlobReader blob_reader{*bake_cache.blobs_dir};
+  fstream meta_file{*meta_path};
+  return deserialize_bake(meta_file, blob_reader, *bake_cache.blob_sharing);
+}
+
+FramePrefetcher::FramePrefetcher(const NodeBakeCache &bake_cache) : bake_cache_(bake_cache) {}
+
+FramePrefetcher::~FramePrefetcher()
+{
+  if (!task_pool_) {
+    return;
+  }
+  {
+    std::lock_guard lock{mutex_};
+    queue_.clear();
+  }
+  /* Only the frame that is loaded right now has to be finished. */
+  BLI_task_pool_work_and_wait(task_pool_);
+  BLI_task_pool_free(task_pool_);
+}
+
+void FramePrefetcher::update(const SubFrame current_frame)
+{
+  std::lock_guard lock{mutex_};
+  if (last_frame_ == current_frame) {
+    /* The same frame is evaluated again, which does not tell anything about the playback. */
+    return;
+  }
+  const std::optional<SubFrame> last_frame = std::exchange(last_frame_, current_frame);
+
+  /* Find the frames that are needed to evaluate the predicted frames. Those are the frame itself
+   * or the two frames that are interpolated. */
+  Vector<int> frame_indices;
+  if (last_frame) {
+    const float step = float(current_frame) - float(*last_frame);
+    if (std::abs(step) <= max_playback_step) {
+      const Span<std::unique_ptr<FrameCache>> frames = bake_cache_.frames;
+      for (const int i : IndexRange(1, frames_ahead_num)) {
+        const float predicted_frame = float(current_frame) + step * float(i);
+        const int next_index = binary_search::first_if(
+            frames, [&](const std::unique_ptr<FrameCache> &frame_cache) {
+              return float(frame_cache->frame) >= predicted_frame;
+            });
+        for (const int index : {next_index, next_index - 1}) {
+          if (frames.index_range().contains(index) && !frame_indices.contains(index)) {
+            frame_indices.append(index);
+          }
+        }
+      }
+    }
+  }
+
+  Vector<Request> new_queue;
+  Set<SubFrame> wanted_frames;
+  for (const int index : frame_indices) {
+    const FrameCache &frame_cache = *bake_cache_.frames[index];
+    if (!frame_cache.values.is_empty() || !frame_cache.meta_data_source) {
+      continue;
+    }
+    wanted_frames.add(frame_cache.frame);
+    if (loaded_values_.contains(frame_cache.frame) || loading_frame_ == frame_cache.frame) {
+      continue;
+    }
+    new_queue.append({frame_cache.frame, *frame_cache.meta_data_source});
+  }
+  /* Free frames that are not expected to be used anymore, e.g. after jumping to another frame. */
+  loaded_values_.remove_if([&](const auto item) { return !wanted_frames.contains(item.key); });
+
+  /* The closest frames are loaded first. */
+  std::reverse(new_queue.begin(), new_queue.end());
+  queue_ = std::move(new_queue);
+  if (queue_.is_empty() || is_loading_) {
+    return;
+  }
+  if (!task_pool_) {
+    /* The frames are loaded one after another, because loading them is mostly bound by IO. */
+    task_pool_ = BLI_task_pool_create_background_serial(this, TASK_PRIORITY_LOW);
+  }
+  is_loading_ = true;
+  BLI_task_pool_push(task_pool_, load_requested_fn, nullptr, false, nullptr);
+}
+
+std::optional<BakeValues> FramePrefetcher::try_take(const SubFrame frame)
+{
+  std::unique_lock lock{mutex_};
+  loaded_cv_.wait(lock, [&]() { return loading_frame_ != frame; });
+  /* The frame is loaded by the caller if it was not loaded yet. */
+  queue_.remove_if([&](const Request &request) { return request.frame == frame; });
+  return loaded_values_.pop_try(frame);
+}
+
+void FramePrefetcher::load_requested_fn(TaskPool *pool, void * /*taskdata*/)
+{
+  static_cast<FramePrefetcher *>(BLI_task_pool_user_data(pool))->load_requested();
+}
+
+void FramePrefetcher::load_requested()
+{
+  std::unique_lock lock{mutex_};
+  while (!queue_.is_empty()) {
+    const Request request = queue_.pop_last();
+    loading_frame_ = request.frame;
+    lock.unlock();
+
+    std::optional<BakeValues> values = load_frame_values(bake_cache_, request.meta_data_source);
+
+    lock.lock();
+    loading_frame_.reset();
+    if (values) {
+      loaded_values_.add_overwrite(request.frame, std::move(*values));
+    }
+    loaded_cv_.notify_all();
+  }
+  is_loading_ = false;
+  loaded_cv_.notify_all();
+}
+
+void FramePrefetcher::wait_until_loaded()
+{
+  std::unique_lock lock{mutex_};
+  loaded_cv_.wait(lock, [&]() { return !is_loading_; });
+}
+
 IndexRange NodeBakeCache::frame_range() const
 {
   if (this->frames.is_empty()) {
@@ -48,6 +196,37 @@ IndexRange NodeBakeCache::frame_range() const
   return IndexRange::from_begin_end_inclusive(start_frame, end_frame);
 }
 
+void NodeBakeCache::ensure_frame_loaded(FrameCache &frame_cache)
+{
+  if (!frame_cache.values.is_empty()) {
+    return;
+  }
+  if (!frame_cache.meta_data_source.has_value()) {
+    return;
+  }
+  if (this->prefetcher) {
+    if (std::optional<BakeValues> values = this->prefetcher->try_take(frame_cache.frame)) {
+      frame_cache.values = std::move(*values);
+      return;
+    }
+  }
+  if (std::optional<BakeValues> values = load_frame_values(*this, *frame_cache.meta_data_source))
+  {
+    frame_cache.values = std::move(*values);
+  }
+}
+
+void NodeBakeCache::prefetch(const SubFrame current_frame)
+{
+  if (!this->memory_blob_reader && !this->blobs_dir) {
+    return;
+  }
+  if (!this->prefetcher) {
+    this->prefetcher = std::make_unique<FramePrefetcher>(*this);
+  }
+  this->prefetcher->update(current_frame);
+}
+
 SimulationNodeCache *ModifierCache::get_simulation_node_cache(const int id)
 {
   std::unique_ptr<SimulationNodeCache> *ptr = this->simulation_cache_by_id.lookup_ptr(id);
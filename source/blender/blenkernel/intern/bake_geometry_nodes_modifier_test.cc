@@ -0,0 +1,129 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BKE_bake_geometry_nodes_modifier.hh"
+#include "BKE_gtest_base.hh"
+
+#include <sstream>
+#include <string>
+
+namespace blender::bke::bake::tests {
+
+static constexpr int frames_num = 20;
+
+class FramePrefetcherTest : public BlenderGTestBase {
+ protected:
+  /** Serialized meta data of every frame, which is referenced by the frames of #bake_cache. */
+  Vector<std::string> meta_data_;
+  NodeBakeCache bake_cache;
+
+  void SetUp() override
+  {
+    BlenderGTestBase::SetUp();
+    bake_cache.memory_blob_reader = std::make_unique<MemoryBlobReader>();
+    bake_cache.blob_sharing = std::make_unique<BlobReadSharing>();
+
+    /* Every frame stores a single integer, which is ten times the frame number. */
+    meta_data_.reserve(frames_num);
+    for (const int frame : IndexRange(1, frames_num)) {
+      Map<int, BakeValues::Item> items;
+      items.add_new(0, BakeValues::Item{SocketValueVariant::From(frame * 10)});
+      MemoryBlobWriter blob_writer{"test"};
+      BlobWriteSharing blob_sharing;
+      std::ostringstream stream;
+      serialize_bake(BakeValues(std::move(items)), blob_writer, blob_sharing, stream);
+      meta_data_.append(stream.str());
+
+      auto frame_cache = std::make_unique<FrameCache>();
+      frame_cache->frame = SubFrame(frame);
+      frame_cache->meta_data_source = Span<std::byte>(
+          reinterpret_cast<const std::byte *>(meta_data_.last().data()), meta_data_.last().size());
+      bake_cache.frames.append(std::move(frame_cache));
+    }
+  }
+
+  void TearDown() override
+  {
+    bake_cache.reset();
+    BlenderGTestBase::TearDown();
+  }
+};
+
+static int get_value(const BakeValues &values)
+{
+  return values.values_by_id().lookup(0).value.get<int>();
+}
+
+TEST_F(FramePrefetcherTest, PrefetchPlayback)
+{
+  bake_cache.prefetch(SubFrame(1));
+  ASSERT_NE(bake_cache.prefetcher, nullptr);
+  /* A single frame does not tell the direction of the playback. */
+  bake_cache.prefetcher->wait_until_loaded();
+  EXPECT_FALSE(bake_cache.prefetcher->try_take(SubFrame(2)).has_value());
+
+  /* The current frame is loaded as well, since it is also needed to interpolate the next one. */
+  bake_cache.prefetch(SubFrame(2));
+  bake_cache.prefetcher->wait_until_loaded();
+  for (const int frame : IndexRange::from_begin_end_inclusive(2, 10)) {
+    const std::optional<BakeValues> values = bake_cache.prefetcher->try_take(SubFrame(frame));
+    ASSERT_TRUE(values.has_value());
+    EXPECT_EQ(get_value(*values), frame * 10);
+  }
+  EXPECT_FALSE(bake_cache.prefetcher->try_take(SubFrame(11)).has_value());
+}
+
+TEST_F(FramePrefetcherTest, PrefetchBackwards)
+{
+  bake_cache.prefetch(SubFrame(20));
+  bake_cache.prefetch(SubFrame(18));
+  bake_cache.prefetcher->wait_until_loaded();
+  for (const int frame : {16, 14, 12, 10, 4}) {
+    const std::optional<BakeValues> values = bake_cache.prefetcher->try_take(SubFrame(frame));
+    ASSERT_TRUE(values.has_value());
+    EXPECT_EQ(get_value(*values), frame * 10);
+  }
+  EXPECT_FALSE(bake_cache.prefetcher->try_take(SubFrame(19)).has_value());
+}
+
+TEST_F(FramePrefetcherTest, JumpFreesPrefetchedFrames)
+{
+  bake_cache.prefetch(SubFrame(1));
+  bake_cache.prefetch(SubFrame(2));
+  bake_cache.prefetcher->wait_until_loaded();
+
+  /* Jumps stop the prediction, and frames that are not expected anymore are freed. */
+  bake_cache.prefetch(SubFrame(15));
+  bake_cache.prefetcher->wait_until_loaded();
+  EXPECT_FALSE(bake_cache.prefetcher->try_take(SubFrame(3)).has_value());
+  EXPECT_FALSE(bake_cache.prefetcher->try_take(SubFrame(16)).has_value());
+
+  bake_cache.prefetch(SubFrame(16));
+  bake_cache.prefetcher->wait_until_loaded();
+  const std::optional<BakeValues> values = bake_cache.prefetcher->try_take(SubFrame(20));
+  ASSERT_TRUE(values.has_value());
+  EXPECT_EQ(get_value(*values), 200);
+}
+
+TEST_F(FramePrefetcherTest, EnsureFrameLoaded)
+{
+  /* Frames are loaded with the same values, whether they have been prefetched or not. The
+   * prefetcher runs concurrently with the evaluation here, like during playback. */
+  for (const int step : {1, 3}) {
+    for (int frame = 1; frame <= frames_num; frame += step) {
+      bake_cache.prefetch(SubFrame(frame));
+      FrameCache &frame_cache = *bake_cache.frames[frame - 1];
+      bake_cache.ensure_frame_loaded(frame_cache);
+      ASSERT_FALSE(frame_cache.values.is_empty());
+      EXPECT_EQ(get_value(frame_cache.values), frame * 10);
+    }
+    for (std::unique_ptr<FrameCache> &frame_cache : bake_cache.frames) {
+      frame_cache->values.clear();
+    }
+  }
+}
+
+}  // namespace blender::bke::bake::tests
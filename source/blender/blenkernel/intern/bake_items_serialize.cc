@@ -16,11 +16,14 @@
 #include "BKE_pointcloud.hh"
 #include "BKE_volume.hh"
 
+#include "BLI_compression.hh"
 #include "BLI_listbase.hh"
 #include "BLI_math_matrix_types.hh"
+#include "BLI_mmap.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_string.hh"
 #include "BLI_string_utf8.hh"
+#include "BLI_task.hh"
 
 #include "DNA_object_types.h"
 #include "DNA_volume_types.h"
@@ -34,8 +37,16 @@
 #include "NOD_geometry_nodes_list.hh"
 
 #include <fmt/format.h>
+#include <array>
+#include <fcntl.h>
 #include <sstream>
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
 #include <xxhash.h>
+#include <zstd.h>
 
 #ifdef WITH_OPENVDB
 #  include <openvdb/io/Stream.h>
@@ -73,6 +84,11 @@ std::shared_ptr<DictionaryValue> BlobSlice::serialize() const
   io_slice->append_str("name", this->name);
   io_slice->append_int("start", range.start());
   io_slice->append_int("size", range.size());
+  if (this->compression == BlobCompression::ZstdFiltered) {
+    io_slice->append_str("compression", "zstd_filtered");
+    io_slice->append_int("decoded_size", this->decoded_size);
+    io_slice->append_int("item_size", this->item_size);
+  }
   return io_slice;
 }
 
@@ -84,8 +100,22 @@ std::optional<BlobSlice> BlobSlice::deserialize(const DictionaryValue &io_slice)
   if (!name || !start || !size) {
     return std::nullopt;
   }
+  BlobSlice slice{*name, {*start, *size}};
 
-  return BlobSlice{*name, {*start, *size}};
+  if (const std::optional<StringRefNull> compression = io_slice.lookup_str("compression")) {
+    if (*compression != "zstd_filtered") {
+      return std::nullopt;
+    }
+    const std::optional<int64_t> decoded_size = io_slice.lookup_int("decoded_size");
+    const std::optional<int64_t> item_size = io_slice.lookup_int("item_size");
+    if (!decoded_size || !item_size || *item_size <= 0 || *decoded_size % *item_size != 0) {
+      return std::nullopt;
+    }
+    slice.compression = BlobCompression::ZstdFiltered;
+    slice.decoded_size = *decoded_size;
+    slice.item_size = *item_size;
+  }
+  return slice;
 }
 
 BlobSlice BlobWriter::write_as_stream(const StringRef /*file_extension*/,
@@ -97,6 +127,46 @@ BlobSlice BlobWriter::write_as_stream(const StringRef /*file_extension*/,
   return this->write(data.data(), data.size());
 }
 
+BlobSlice BlobWriter::write_encoded(const void *data, const int64_t size, const int64_t item_size)
+{
+  /* Compressing small amounts of data does not save enough to be worth the decoding overhead. */
+  constexpr int64_t min_compressed_size = 1024;
+  if (compression_ == BlobCompression::None || size < min_compressed_size || item_size <= 0 ||
+      size % item_size != 0)
+  {
+    return this->write(data, size);
+  }
+
+  Array<std::byte> filtered(size, NoInitialization());
+  filter_transpose_delta(static_cast<const uint8_t *>(data),
+                         reinterpret_cast<uint8_t *>(filtered.data()),
+                         size / item_size,
+                         item_size);
+
+  /* Level 3 gives a good balance of compression performance and ratio, and is also used elsewhere
+   * across Blender for calls to #ZSTD_compress. */
+  constexpr int zstd_level = 3;
+  Array<std::byte> compressed(ZSTD_compressBound(size), NoInitialization());
+  const size_t compressed_size = ZSTD_compress(
+      compressed.data(), compressed.size(), filtered.data(), filtered.size(), zstd_level);
+  if (ZSTD_isError(compressed_size) || int64_t(compressed_size) >= size) {
+    /* Uncompressed data can be memory mapped, so only use the compressed data if it is smaller. */
+    return this->write(data, size);
+  }
+
+  BlobSlice slice = this->write(compressed.data(), int64_t(compressed_size));
+  slice.compression = BlobCompression::ZstdFiltered;
+  slice.decoded_size = size;
+  slice.item_size = item_size;
+  return slice;
+}
+
+std::optional<ImplicitSharingInfoAndData> BlobReader::read_mapped(const BlobSlice & /*slice*/,
+                                                                  int64_t /*alignment*/) const
+{
+  return std::nullopt;
+}
+
 bool BlobReader::read_as_stream(const BlobSlice &slice, FunctionRef<bool(std::istream &)> fn) const
 {
   const int64_t size = slice.range.size();
@@ -112,8 +182,108 @@ bool BlobReader::read_as_stream(const BlobSlice &slice, FunctionRef<bool(std::is
   return true;
 }
 
+/**
+ * A blob file that is memory mapped. The mapping is copy-on-write, so that the data can be
+ * modified in place by its users without affecting the file.
+ */
+class MappedBlobFile : NonCopyable, NonMovable {
+ private:
+  BLI_mmap_file *mmap_file_;
+
+ public:
+  MappedBlobFile(BLI_mmap_file *mmap_file) : mmap_file_(mmap_file) {}
+
+  ~MappedBlobFile()
+  {
+    BLI_mmap_free(mmap_file_);
+  }
+
+  Span<std::byte> data() const
+  {
+    return {static_cast<const std::byte *>(BLI_mmap_get_pointer(mmap_file_)),
+            int64_t(BLI_mmap_get_length(mmap_file_))};
+  }
+};
+
+/**
+ * Owns a single array within a memory mapped blob file. Every array needs its own sharing info,
+ * because sharing infos are also used to identify data (see #BlobWriteSharing). The file stays
+ * mapped as long as any of its arrays is used.
+ */
+class MappedBlobSharingInfo : public ImplicitSharingInfo {
+ private:
+  std::shared_ptr<MappedBlobFile> file_;
+
+ public:
+  MappedBlobSharingInfo(std::shared_ptr<MappedBlobFile> file) : file_(std::move(file)) {}
+
+ private:
+  void delete_self_with_data() override
+  {
+    MEM_delete(this);
+  }
+};
+
+#ifndef WIN32
+static std::shared_ptr<MappedBlobFile> map_blob_file(const char *path)
+{
+  const int file = BLI_open(path, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    return nullptr;
+  }
+  BLI_mmap_file *mmap_file = BLI_mmap_open_copy_on_write(file);
+  /* The mapping stays valid after the file is closed. */
+  close(file);
+  if (mmap_file == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<MappedBlobFile>(mmap_file);
+}
+#endif
+
 DiskBlobReader::DiskBlobReader(std::string blobs_dir) : blobs_dir_(std::move(blobs_dir)) {}
 
+std::optional<ImplicitSharingInfoAndData> DiskBlobReader::read_mapped(
+    const BlobSlice &slice, const int64_t alignment) const
+{
+#ifdef WIN32
+  /* Files can't be deleted while they are mapped on Windows, which would prevent re-baking while
+   * the baked data is still used. */
+  UNUSED_VARS(slice, alignment);
+  return std::nullopt;
+#else
+  if (slice.compression != BlobCompression::None || slice.range.is_empty()) {
+    return std::nullopt;
+  }
+
+  char blob_path[FILE_MAX];
+  BLI_path_join(blob_path, sizeof(blob_path), blobs_dir_.c_str(), slice.name.c_str());
+
+  std::shared_ptr<MappedBlobFile> file;
+  {
+    std::lock_guard lock{mutex_};
+    /* A file that failed to be mapped is remembered as null, so it is not tried again. */
+    file = mapped_files_.lookup_or_add_cb_as(blob_path,
+                                             [&]() { return map_blob_file(blob_path); });
+  }
+  if (!file) {
+    return std::nullopt;
+  }
+  const Span<std::byte> file_data = file->data();
+  if (!file_data.index_range().contains(slice.range)) {
+    return std::nullopt;
+  }
+  const std::byte *data = file_data.slice(slice.range).data();
+  if (uintptr_t(data) % uintptr_t(alignment) != 0) {
+    /* Bakes written before the blob offsets were aligned have to be copied. */
+    return std::nullopt;
+  }
+  const ImplicitSharingInfo *sharing_info = MEM_new<MappedBlobSharingInfo>(__func__,
+                                                                           std::move(file));
+  return ImplicitSharingInfoAndData{sharing_info, data};
+#endif
+}
+
 [[nodiscard]] bool DiskBlobReader::read(const BlobSlice &slice, void *r_data) const
 {
   if (slice.range.is_empty()) {
@@ -150,6 +320,15 @@ BlobSlice DiskBlobWriter::write(const void *data, const int64_t size)
     blob_stream_.open(blob_path, std::ios::out | std::ios::binary);
   }
 
+  /* Pad the previous data so that the new data is aligned when the file is memory mapped. */
+  const int64_t padding = (alignment - current_offset_ % alignment) % alignment;
+  if (padding > 0) {
+    const std::array<char, alignment> zeros{};
+    blob_stream_.write(zeros.data(), padding);
+    current_offset_ += padding;
+    total_written_size_ += padding;
+  }
+
   const int64_t old_offset = current_offset_;
   blob_stream_.write(static_cast<const char *>(data), size);
   current_offset_ += size;
@@ -241,9 +420,9 @@ BlobWriteSharing::~BlobWriteSharing()
 
 BlobReadSharing::~BlobReadSharing()
 {
-  for (const ImplicitSharingInfoAndData &value : runtime_by_stored_.values()) {
-    if (value.sharing_info) {
-      value.sharing_info->remove_user_and_delete_if_last();
+  for (const std::shared_ptr<SharedData> &shared_data : runtime_by_stored_.values()) {
+    if (shared_data->data) {
+      shared_data->data->sharing_info->remove_user_and_delete_if_last();
     }
   }
 }
@@ -277,11 +456,11 @@ DictionaryValuePtr BlobWriteSharing::write_implicitly_shared(
 }
 
 std::shared_ptr<io::serialize::DictionaryValue> BlobWriteSharing::write_deduplicated(
-    BlobWriter &writer, const void *data, const int64_t size_in_bytes)
+    BlobWriter &writer, const void *data, const int64_t size_in_bytes, const int64_t item_size)
 {
   const uint64_t content_hash = XXH3_64bits(data, size_in_bytes);
   const BlobSlice slice = slice_by_content_hash_.lookup_or_add_cb(
-      content_hash, [&]() { return writer.write(data, size_in_bytes); });
+      content_hash, [&]() { return writer.write_encoded(data, size_in_bytes, item_size); });
   return slice.serialize();
 }
 
@@ -289,26 +468,35 @@ std::optional<ImplicitSharingInfoAndData> BlobReadSharing::read_shared(
     const DictionaryValue &io_data,
     FunctionRef<std::optional<ImplicitSharingInfoAndData>()> read_fn) const
 {
-  std::lock_guard lock{mutex_};
-
   io::serialize::JsonFormatter formatter;
   std::stringstream ss;
   formatter.serialize(ss, io_data);
   const std::string key = ss.str();
 
-  if (const ImplicitSharingInfoAndData *shared_data = runtime_by_stored_.lookup_ptr(key)) {
-    shared_data->sharing_info->add_user();
-    return *shared_data;
-  }
-  std::optional<ImplicitSharingInfoAndData> data = read_fn();
-  if (!data) {
-    return std::nullopt;
+  std::shared_ptr<SharedData> shared_data;
+  {
+    std::lock_guard lock{mutex_};
+    shared_data = runtime_by_stored_.lookup_or_add_cb(
+        key, []() { return std::make_shared<SharedData>(); });
   }
-  if (data->sharing_info != nullptr) {
+
+  /* Other threads that need the same data wait here until it has been read. The data may be read
+   * with multi-threading, which must not pick up tasks that wait for this lock. */
+  std::lock_guard lock{shared_data->mutex};
+  if (!shared_data->data) {
+    std::optional<ImplicitSharingInfoAndData> data = threading::isolate_task(read_fn);
+    if (!data) {
+      return std::nullopt;
+    }
+    if (data->sharing_info == nullptr) {
+      /* The data can't be shared, so it is not stored. */
+      return data;
+    }
     data->sharing_info->add_user();
-    runtime_by_stored_.add_new(key, *data);
+    shared_data->data = std::move(data);
   }
-  return data;
+  shared_data->data->sharing_info->add_user();
+  return shared_data->data;
 }
 
 static StringRefNull get_domain_io_name(const AttrDomain domain)
@@ -364,9 +552,10 @@ static std::optional<AttrStorageType> get_storage_type_from_io_name(const String
 static std::shared_ptr<DictionaryValue> write_blob_raw_bytes(BlobWriter &blob_writer,
                                                              BlobWriteSharing &blob_sharing,
                                                              const void *data,
-                                                             const int64_t size_in_bytes)
+                                                             const int64_t size_in_bytes,
+                                                             const int64_t item_size = 1)
 {
-  return blob_sharing.write_deduplicated(blob_writer, data, size_in_bytes);
+  return blob_sharing.write_deduplicated(blob_writer, data, size_in_bytes, item_size);
 }
 
 [[nodiscard]] static bool read_blob_raw_bytes(const BlobReader &blob_reader,
@@ -378,17 +567,36 @@ static std::shared_ptr<DictionaryValue> write_blob_raw_bytes(BlobWriter &blob_wr
   if (!slice) {
     return false;
   }
-  if (slice->range.size() != bytes_num) {
+  if (slice->data_size() != bytes_num) {
+    return false;
+  }
+  if (slice->compression == BlobCompression::None) {
+    return blob_reader.read(*slice, r_data);
+  }
+
+  Array<std::byte> compressed(slice->range.size(), NoInitialization());
+  if (!blob_reader.read(*slice, compressed.data())) {
+    return false;
+  }
+  Array<std::byte> filtered(bytes_num, NoInitialization());
+  const size_t decompressed_size = ZSTD_decompress(
+      filtered.data(), filtered.size(), compressed.data(), compressed.size());
+  if (ZSTD_isError(decompressed_size) || int64_t(decompressed_size) != bytes_num) {
     return false;
   }
-  return blob_reader.read(*slice, r_data);
+  unfilter_transpose_delta(reinterpret_cast<const uint8_t *>(filtered.data()),
+                           static_cast<uint8_t *>(r_data),
+                           bytes_num / slice->item_size,
+                           slice->item_size);
+  return true;
 }
 
 static std::shared_ptr<DictionaryValue> write_blob_simple_gspan(BlobWriter &blob_writer,
                                                                 BlobWriteSharing &blob_sharing,
                                                                 const GSpan data)
 {
-  return write_blob_raw_bytes(blob_writer, blob_sharing, data.data(), data.size_in_bytes());
+  return write_blob_raw_bytes(
+      blob_writer, blob_sharing, data.data(), data.size_in_bytes(), data.type().size);
 }
 
 [[nodiscard]] static bool read_blob_simple_gspan(const BlobReader &blob_reader,
@@ -419,6 +627,15 @@ static std::shared_ptr<DictionaryValue> write_blob_shared_simple_gspan(
   const char *func = __func__;
   const std::optional<ImplicitSharingInfoAndData> sharing_info_and_data = blob_sharing.read_shared(
       io_data, [&]() -> std::optional<ImplicitSharingInfoAndData> {
+        if (const std::optional<BlobSlice> slice = BlobSlice::deserialize(io_data)) {
+          if (slice->data_size() == size * cpp_type.size) {
+            if (std::optional<ImplicitSharingInfoAndData> mapped = blob_reader.read_mapped(
+                    *slice, cpp_type.alignment))
+            {
+              return mapped;
+            }
+          }
+        }
         void *data_mem = MEM_new_uninitialized_aligned(
             size * cpp_type.size, cpp_type.alignment, func);
         if (!read_blob_simple_gspan(blob_reader, io_data, {cpp_type, data_mem, size})) {
@@ -2025,8 +2242,6 @@ static std::optional<SocketValueVariant> deserialize_bake_item(const DictionaryV
   return {};
 }
 
-static constexpr int bake_file_version = 3;
-
 void serialize_bake(const BakeValues &bake_values,
                     BlobWriter &blob_writer,
                     BlobWriteSharing &blob_sharing,
@@ -2099,4 +2314,96 @@ std::optional<BakeValues> deserialize_bake(std::istream &stream,
   return BakeValues(std::move(bake_values));
 }
 
+static void write_sized_data(std::ostream &stream, const StringRef data)
+{
+  const uint64_t size = data.size();
+  stream.write(reinterpret_cast<const char *>(&size), sizeof(uint64_t));
+  stream.write(data.data(), data.size());
+}
+
+static std::optional<Span<std::byte>> read_sized_data(Span<std::byte> &buffer)
+{
+  uint64_t size;
+  if (buffer.size() < int64_t(sizeof(uint64_t))) {
+    return std::nullopt;
+  }
+  memcpy(&size, buffer.data(), sizeof(uint64_t));
+  buffer = buffer.drop_front(sizeof(uint64_t));
+  if (uint64_t(buffer.size()) < size) {
+    return std::nullopt;
+  }
+  const Span<std::byte> data = buffer.take_front(int64_t(size));
+  buffer = buffer.drop_front(int64_t(size));
+  return data;
+}
+
+static StringRef as_string(const Span<std::byte> data)
+{
+  return StringRef(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+/* The geometry is the only item of the bake. */
+static constexpr int geometry_item_id = 0;
+
+bool serialize_geometry(const GeometrySet &geometry, std::ostream &stream)
+{
+  Map<int, BakeValues::Item> items;
+  items.add_new(geometry_item_id, {SocketValueVariant::From(GeometrySet(geometry)), "Geometry"});
+  const BakeValues bake_values(std::move(items));
+
+  MemoryBlobWriter blob_writer{"geometry"};
+  BlobWriteSharing blob_sharing;
+  std::ostringstream meta_stream{std::ios::binary};
+  serialize_bake(bake_values, blob_writer, blob_sharing, meta_stream);
+
+  /* The meta data is followed by the number of blobs, and the name and data of every blob. */
+  write_sized_data(stream, meta_stream.str());
+  const Map<std::string, MemoryBlobWriter::OutputStream> &blob_stream_by_name =
+      blob_writer.get_stream_by_name();
+  const uint64_t blobs_num = blob_stream_by_name.size();
+  stream.write(reinterpret_cast<const char *>(&blobs_num), sizeof(uint64_t));
+  for (const auto &item : blob_stream_by_name.items()) {
+    write_sized_data(stream, item.key);
+    write_sized_data(stream, item.value.stream->str());
+  }
+  return stream.good();
+}
+
+std::optional<GeometrySet> deserialize_geometry(Span<std::byte> buffer)
+{
+  const std::optional<Span<std::byte>> meta_data = read_sized_data(buffer);
+  if (!meta_data || buffer.size() < int64_t(sizeof(uint64_t))) {
+    return std::nullopt;
+  }
+  uint64_t blobs_num;
+  memcpy(&blobs_num, buffer.data(), sizeof(uint64_t));
+  buffer = buffer.drop_front(sizeof(uint64_t));
+
+  /* The blobs are read directly from the buffer, without copying them first. */
+  MemoryBlobReader blob_reader;
+  for ([[maybe_unused]] const uint64_t i : IndexRange(blobs_num)) {
+    const std::optional<Span<std::byte>> name = read_sized_data(buffer);
+    if (!name) {
+      return std::nullopt;
+    }
+    const std::optional<Span<std::byte>> data = read_sized_data(buffer);
+    if (!data) {
+      return std::nullopt;
+    }
+    blob_reader.add(as_string(*name), *data);
+  }
+
+  std::istringstream meta_stream{std::string(as_string(*meta_data)), std::ios::binary};
+  BlobReadSharing blob_sharing;
+  std::optional<BakeValues> bake_values = deserialize_bake(meta_stream, blob_reader, blob_sharing);
+  if (!bake_values) {
+    return std::nullopt;
+  }
+  const BakeValues::Item *item = bake_values->values_by_id().lookup_ptr(geometry_item_id);
+  if (!item || item->value.socket_type() != SOCK_GEOMETRY || !item->value.is_single()) {
+    return std::nullopt;
+  }
+  return item->value.get<GeometrySet>();
+}
+
 }  // namespace blender::bke::bake
@@ -8,13 +8,27 @@
 #include "BKE_geometry_set.hh"
 #include "BKE_gtest_base.hh"
 #include "BKE_node.hh"
+#include "BKE_pointcloud.hh"
+
+#include "BLI_fileops.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_system.hh"
+#include "BLI_task.hh"
+#include "BLI_tempfile.hh"
+
+#include "DNA_pointcloud_types.h"
+
+#include "MEM_guardedalloc.h"
 
 #include "NOD_geometry_nodes_bundle.hh"
 #include "NOD_geometry_nodes_list.hh"
 
+#include <atomic>
 #include <sstream>
 #include <string>
 
+#include BLI_SYSTEM_PID_H
+
 namespace blender::bke::bake::tests {
 
 class BakeItemsSerializeTest : public BlenderGTestBase {};
@@ -106,4 +120,225 @@ TEST_F(BakeItemsSerializeTest, nested_bundle_with_geometry_and_bundle_lists)
   EXPECT_EQ((*restored_bundles)->size(), 2);
 }
 
+TEST(bake_items_serialize, read_shared_once)
+{
+  BlobReadSharing blob_sharing;
+  io::serialize::DictionaryValue io_data;
+  io_data.append_str("name", "blob");
+
+  /* Threads that need the same data wait for the thread that reads it. */
+  std::atomic<int> read_count = 0;
+  std::atomic<int> users_count = 0;
+  threading::parallel_for(IndexRange(64), 1, [&](const IndexRange range) {
+    for ([[maybe_unused]] const int i : range) {
+      const std::optional<ImplicitSharingInfoAndData> data = blob_sharing.read_shared(
+          io_data, [&]() -> std::optional<ImplicitSharingInfoAndData> {
+            read_count++;
+            int *value = MEM_new_uninitialized<int>(__func__);
+            *value = 5;
+            return ImplicitSharingInfoAndData{implicit_sharing::info_for_mem_free(value), value};
+          });
+      ASSERT_TRUE(data.has_value());
+      EXPECT_EQ(*static_cast<const int *>(data->data), 5);
+      users_count++;
+      data->sharing_info->remove_user_and_delete_if_last();
+    }
+  });
+  EXPECT_EQ(read_count, 1);
+  EXPECT_EQ(users_count, 64);
+
+  /* Failed reads are not stored. */
+  io::serialize::DictionaryValue failing_io_data;
+  failing_io_data.append_str("name", "missing");
+  for ([[maybe_unused]] const int i : IndexRange(2)) {
+    EXPECT_FALSE(blob_sharing.read_shared(
+        failing_io_data, [&]() -> std::optional<ImplicitSharingInfoAndData> {
+          read_count++;
+          return std::nullopt;
+        }));
+  }
+  EXPECT_EQ(read_count, 3);
+}
+
+class BakeBlobTest : public BlenderGTestBase {
+ protected:
+  std::string blobs_dir_;
+
+  void SetUp() override
+  {
+    BlenderGTestBase::SetUp();
+    char temp_dir[FILE_MAX];
+    BLI_temp_directory_path_get(temp_dir, sizeof(temp_dir));
+    blobs_dir_ = std::string(temp_dir) + SEP_STR + "blender_bake_blob_test_" +
+                 std::to_string(getpid());
+    BLI_dir_create_recursive(blobs_dir_.c_str());
+  }
+
+  void TearDown() override
+  {
+    BLI_delete(blobs_dir_.c_str(), true, true);
+    BlenderGTestBase::TearDown();
+  }
+};
+
+/** Smoothly varying positions, which are compressed well by #BlobCompression::ZstdFiltered. */
+static GeometrySet create_point_cloud(const int points_num)
+{
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(points_num);
+  MutableSpan<float3> positions = pointcloud->positions_for_write();
+  for (const int i : positions.index_range()) {
+    positions[i] = float3(i * 0.1f, std::sin(i * 0.01f), 2.0f);
+  }
+  return GeometrySet::from_pointcloud(pointcloud);
+}
+
+static Span<float3> get_positions(const BakeValues &bake_values)
+{
+  /* The point cloud stays alive after the copied geometry is freed, because the bake values still
+   * own it. */
+  const GeometrySet geometry = bake_values.values_by_id().lookup(0).value.get<GeometrySet>();
+  return geometry.get_pointcloud()->positions();
+}
+
+static BakeValues create_bake_values(const int points_num)
+{
+  Map<int, BakeValues::Item> items;
+  items.add_new(0, BakeValues::Item{SocketValueVariant::From(create_point_cloud(points_num))});
+  return BakeValues(std::move(items));
+}
+
+TEST_F(BakeBlobTest, roundtrip_memory)
+{
+  const BakeValues bake_values = create_bake_values(1000);
+  for (const BlobCompression compression : {BlobCompression::None, BlobCompression::ZstdFiltered})
+  {
+    MemoryBlobWriter blob_writer{"test"};
+    blob_writer.set_compression(compression);
+    BlobWriteSharing blob_write_sharing;
+    std::ostringstream stream;
+    serialize_bake(bake_values, blob_writer, blob_write_sharing, stream);
+    const std::string meta_data = stream.str();
+    EXPECT_EQ(meta_data.find("zstd_filtered") != std::string::npos,
+              compression == BlobCompression::ZstdFiltered);
+
+    Map<std::string, std::string> blobs;
+    for (const auto &item : blob_writer.get_stream_by_name().items()) {
+      blobs.add_new(item.key, item.value.stream->str());
+    }
+    MemoryBlobReader blob_reader;
+    for (auto item : blobs.items()) {
+      std::string &blob = item.value;
+      blob_reader.add(item.key,
+                      Span<std::byte>(reinterpret_cast<std::byte *>(blob.data()), blob.size()));
+    }
+    BlobReadSharing blob_read_sharing;
+    std::istringstream read_stream{meta_data};
+    const std::optional<BakeValues> read_values = deserialize_bake(
+        read_stream, blob_reader, blob_read_sharing);
+    ASSERT_TRUE(read_values.has_value());
+    EXPECT_EQ(get_positions(*read_values), get_positions(bake_values));
+  }
+}
+
+TEST_F(BakeBlobTest, roundtrip_disk)
+{
+  const BakeValues bake_values = create_bake_values(1000);
+  for (const BlobCompression compression : {BlobCompression::None, BlobCompression::ZstdFiltered})
+  {
+    const std::string base_name = compression == BlobCompression::None ? "none" : "zstd";
+    std::ostringstream stream;
+    {
+      DiskBlobWriter blob_writer{blobs_dir_, base_name};
+      blob_writer.set_compression(compression);
+      BlobWriteSharing blob_write_sharing;
+      serialize_bake(bake_values, blob_writer, blob_write_sharing, stream);
+    }
+    EXPECT_EQ(stream.str().find("zstd_filtered") != std::string::npos,
+              compression == BlobCompression::ZstdFiltered);
+
+    DiskBlobReader blob_reader{blobs_dir_};
+    BlobReadSharing blob_read_sharing;
+    std::istringstream read_stream{stream.str()};
+    const std::optional<BakeValues> read_values = deserialize_bake(
+        read_stream, blob_reader, blob_read_sharing);
+    ASSERT_TRUE(read_values.has_value());
+    EXPECT_EQ(get_positions(*read_values), get_positions(bake_values));
+  }
+}
+
+TEST_F(BakeBlobTest, disk_alignment_and_mapping)
+{
+  /* Sizes that are not a multiple of the alignment, so that the following data has to be padded.
+   * The compressed slice is written in between to check that its offset is padded as well. */
+  Array<int8_t> data(3000);
+  for (const int i : data.index_range()) {
+    data[i] = int8_t(i % 7);
+  }
+  Vector<BlobSlice> slices;
+  {
+    DiskBlobWriter blob_writer{blobs_dir_, "aligned"};
+    slices.append(blob_writer.write(data.data(), 5));
+    blob_writer.set_compression(BlobCompression::ZstdFiltered);
+    slices.append(blob_writer.write_encoded(data.data(), data.size(), 1));
+    blob_writer.set_compression(BlobCompression::None);
+    slices.append(blob_writer.write(data.data(), 23));
+    slices.append(blob_writer.write_encoded(data.data(), data.size(), 1));
+  }
+  EXPECT_EQ(slices[1].compression, BlobCompression::ZstdFiltered);
+  EXPECT_EQ(slices[1].data_size(), data.size());
+  EXPECT_EQ(slices[3].compression, BlobCompression::None);
+  for (const BlobSlice &slice : slices) {
+    EXPECT_EQ(slice.range.start() % DiskBlobWriter::alignment, 0);
+  }
+
+  DiskBlobReader blob_reader{blobs_dir_};
+  for (const BlobSlice &slice : {slices[0], slices[2], slices[3]}) {
+    Array<int8_t> read_data(slice.range.size());
+    ASSERT_TRUE(blob_reader.read(slice, read_data.data()));
+    EXPECT_EQ(read_data.as_span(), data.as_span().take_front(slice.range.size()));
+  }
+  /* Compressed data can't be used without decoding it. */
+  EXPECT_FALSE(blob_reader.read_mapped(slices[1], 1).has_value());
+
+#ifndef WIN32
+  const std::optional<ImplicitSharingInfoAndData> mapped = blob_reader.read_mapped(
+      slices[3], DiskBlobWriter::alignment);
+  ASSERT_TRUE(mapped.has_value());
+  EXPECT_EQ(uintptr_t(mapped->data) % DiskBlobWriter::alignment, 0);
+  EXPECT_EQ(Span(static_cast<const int8_t *>(mapped->data), data.size()), data.as_span());
+  mapped->sharing_info->remove_user_and_delete_if_last();
+#endif
+}
+
+#ifndef WIN32
+TEST_F(BakeBlobTest, mapped_data_released_with_read_sharing)
+{
+  Array<int64_t> data(1000);
+  for (const int i : data.index_range()) {
+    data[i] = i;
+  }
+  BlobSlice slice;
+  {
+    DiskBlobWriter blob_writer{blobs_dir_, "mapped"};
+    slice = blob_writer.write(data.data(), data.as_span().size_in_bytes());
+  }
+  const DiskBlobReader blob_reader{blobs_dir_};
+
+  std::optional<ImplicitSharingInfoAndData> mapped;
+  {
+    /* The read sharing is owned by the bake cache, e.g. #NodeBakeCache::blob_sharing. */
+    BlobReadSharing blob_read_sharing;
+    mapped = blob_read_sharing.read_shared(*slice.serialize(), [&]() {
+      return blob_reader.read_mapped(slice, alignof(int64_t));
+    });
+    ASSERT_TRUE(mapped.has_value());
+    EXPECT_FALSE(mapped->sharing_info->is_mutable());
+  }
+  /* Freeing the bake releases its reference to the mapped data, so the data is only used here. */
+  EXPECT_TRUE(mapped->sharing_info->is_mutable());
+  EXPECT_EQ(Span(static_cast<const int64_t *>(mapped->data), data.size()), data.as_span());
+  mapped->sharing_info->remove_user_and_delete_if_last();
+}
+#endif
+
 }  // namespace blender::bke::bake::tests
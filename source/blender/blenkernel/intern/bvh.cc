@@ -370,6 +370,61 @@ std::optional<RayHit> Tree::ray_intersect(const Ray &ray) const
 #endif
 }
 
+void Tree::ray_intersect_batch(const Span<Ray> rays,
+                               MutableSpan<std::optional<RayHit>> r_hits) const
+{
+  BLI_assert(rays.size() == r_hits.size());
+#ifdef WITH_EMBREE
+  /* Embree traverses single rays efficiently already. */
+  for (const int i : rays.index_range()) {
+    r_hits[i] = this->ray_intersect(rays[i]);
+  }
+#else /* WITH_EMBREE */
+  BVHTreeFromMesh *data = fallback_mesh_data(*this->fallback_tree_);
+  if (!data->tree) {
+    r_hits.fill(std::nullopt);
+    return;
+  }
+
+  Array<float3> origins(rays.size());
+  Array<float3> directions(rays.size());
+  Array<BVHTreeRayHit> bvh_hits(rays.size());
+  for (const int i : rays.index_range()) {
+    origins[i] = rays[i].origin;
+    directions[i] = rays[i].direction;
+    bvh_hits[i].index = -1;
+    bvh_hits[i].dist = rays[i].dist_max;
+  }
+  BLI_bvhtree_ray_cast_batch(data->tree,
+                             rays.size(),
+                             reinterpret_cast<const float (*)[3]>(origins.data()),
+                             reinterpret_cast<const float (*)[3]>(directions.data()),
+                             0.0f,
+                             bvh_hits.data(),
+                             data->raycast_callback,
+                             data,
+                             BVH_RAYCAST_DEFAULT);
+
+  for (const int i : rays.index_range()) {
+    const BVHTreeRayHit &bvh_hit = bvh_hits[i];
+    if (bvh_hit.index == -1) {
+      r_hits[i] = std::nullopt;
+      continue;
+    }
+    RayHit hit;
+    hit.normal = float3(bvh_hit.no);
+    hit.index = bvh_hit.index;
+    hit.distance = bvh_hit.dist;
+    hit.bary_coord = bke::mesh_surface_sample::compute_bary_coord_in_triangle(
+        data->vert_positions,
+        data->corner_verts,
+        data->corner_tris[bvh_hit.index],
+        hit.position(rays[i]));
+    r_hits[i] = hit;
+  }
+#endif
+}
+
 void Tree::ray_intersect_all(const Ray &ray, FunctionRef<void(const RayHit &)> fn) const
 {
 #ifdef WITH_EMBREE
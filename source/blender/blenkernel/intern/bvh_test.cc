@@ -0,0 +1,85 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_math_base.hh"
+#include "BLI_offset_indices.hh"
+#include "BLI_rand.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "BKE_bvh.hh"
+#include "BKE_gtest_base.hh"
+#include "BKE_lib_id.hh"
+#include "BKE_mesh.hh"
+
+namespace blender::bke::bvh::tests {
+
+class BVHTreeTest : public BlenderGTestBase {};
+
+/** Create a wavy grid of quads in the XY plane, which makes many rays hit at different depths. */
+static Mesh *create_wavy_grid_mesh(const int size)
+{
+  const int faces_num = (size - 1) * (size - 1);
+  Mesh *mesh = BKE_mesh_new_nomain(size * size, 0, faces_num, faces_num * 4);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      positions[y * size + x] = float3(x, y, math::sin(x * 0.7f) * math::cos(y * 0.4f) * 2.0f);
+    }
+  }
+  offset_indices::fill_constant_group_size(4, 0, mesh->face_offsets_for_write());
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  for (const int y : IndexRange(size - 1)) {
+    for (const int x : IndexRange(size - 1)) {
+      const int face = y * (size - 1) + x;
+      corner_verts[face * 4 + 0] = y * size + x;
+      corner_verts[face * 4 + 1] = y * size + x + 1;
+      corner_verts[face * 4 + 2] = (y + 1) * size + x + 1;
+      corner_verts[face * 4 + 3] = (y + 1) * size + x;
+    }
+  }
+  mesh_calc_edges(*mesh, false, false);
+  return mesh;
+}
+
+TEST_F(BVHTreeTest, RayIntersectBatch)
+{
+  Mesh *mesh = create_wavy_grid_mesh(40);
+  const Tree &tree = mesh->bvh_tris();
+
+  /* Coherent rays pointing down, with some rays outside of the grid and some too short to reach
+   * it. */
+  RandomNumberGenerator rng(0);
+  Array<Ray> rays(2001);
+  for (const int i : rays.index_range()) {
+    const float3 origin(i % 45 - 2.0f + rng.get_float(), i / 45 - 2.0f + rng.get_float(), 5.0f);
+    const float3 direction(rng.get_float() * 0.2f - 0.1f, rng.get_float() * 0.2f - 0.1f, -1.0f);
+    rays[i] = Ray(origin, direction, i % 7 == 0 ? 3.5f : 10.0f);
+  }
+
+  Array<std::optional<RayHit>> hits(rays.size());
+  tree.ray_intersect_batch(rays, hits);
+
+  int hits_num = 0;
+  for (const int i : rays.index_range()) {
+    const std::optional<RayHit> expected = tree.ray_intersect(rays[i]);
+    ASSERT_EQ(hits[i].has_value(), expected.has_value()) << "ray " << i;
+    if (!expected) {
+      continue;
+    }
+    hits_num++;
+    EXPECT_EQ(hits[i]->index, expected->index);
+    EXPECT_FLOAT_EQ(hits[i]->distance, expected->distance);
+    EXPECT_V3_NEAR(hits[i]->normal, expected->normal, 1e-6f);
+    EXPECT_V3_NEAR(hits[i]->bary_coord, expected->bary_coord, 1e-6f);
+  }
+  EXPECT_GT(hits_num, 0);
+  EXPECT_LT(hits_num, rays.size());
+
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::bvh::tests
@@ -505,7 +505,8 @@ static std::unique_ptr<BVHTree, BVHTreeDeleter> create_tree_from_legacy_faces(
 
 static std::unique_ptr<BVHTree, BVHTreeDeleter> create_tree_from_tris(const Span<float3> positions,
                                                                       const Span<int> corner_verts,
-                                                                      const Span<int3> corner_tris)
+                                                                      const Span<int3> corner_tris,
+                                                                      const bool use_sah = false)
 {
   std::unique_ptr<BVHTree, BVHTreeDeleter> tree = bvhtree_new_common(corner_tris.size());
   if (!tree) {
@@ -518,7 +519,12 @@ static std::unique_ptr<BVHTree, BVHTreeDeleter> create_tree_from_tris(const Span
     copy_v3_v3(co[2], positions[corner_verts[corner_tris[tri][2]]]);
     BLI_bvhtree_insert(tree.get(), tri, co[0], 3);
   }
-  BLI_bvhtree_balance(tree.get());
+  if (use_sah) {
+    BLI_bvhtree_balance_sah(tree.get());
+  }
+  else {
+    BLI_bvhtree_balance(tree.get());
+  }
   return tree;
 }
 
@@ -528,11 +534,12 @@ static std::unique_ptr<BVHTree, BVHTreeDeleter> create_tree_from_tris(
     const Span<int> corner_verts,
     const Span<int3> corner_tris,
     const IndexMask &faces_mask,
-    const bool map_global_indices)
+    const bool map_global_indices,
+    const bool use_sah = false)
 {
   if (faces_mask.size() == faces.size()) {
     /* Avoid accessing face offsets if the selection is full. */
-    return create_tree_from_tris(positions, corner_verts, corner_tris);
+    return create_tree_from_tris(positions, corner_verts, corner_tris, use_sah);
   }
 
   int tris_num = 0;
@@ -555,7 +562,12 @@ static std::unique_ptr<BVHTree, BVHTreeDeleter> create_tree_from_tris(
       i++;
     }
   });
-  BLI_bvhtree_balance(tree.get());
+  if (use_sah) {
+    BLI_bvhtree_balance_sah(tree.get());
+  }
+  else {
+    BLI_bvhtree_balance(tree.get());
+  }
   return tree;
 }
 
@@ -564,11 +576,17 @@ BVHTreeFromMesh bvhtree_from_mesh_corner_tris_ex(const Span<float3> vert_positio
                                                  const Span<int> corner_verts,
                                                  const Span<int3> corner_tris,
                                                  const IndexMask &faces_mask,
-                                                 const bool map_global_indices)
+                                                 const bool map_global_indices,
+                                                 const bool use_sah)
 {
   return create_tris_tree_data(
-      create_tree_from_tris(
-          vert_positions, faces, corner_verts, corner_tris, faces_mask, map_global_indices),
+      create_tree_from_tris(vert_positions,
+                            faces,
+                            corner_verts,
+                            corner_tris,
+                            faces_mask,
+                            map_global_indices,
+                            use_sah),
       vert_positions,
       corner_verts,
       corner_tris);
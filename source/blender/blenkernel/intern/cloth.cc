@@ -23,6 +23,7 @@
 #include "BLI_math_vector.hh"
 #include "BLI_math_vector_c.hh"
 #include "BLI_rand_c.hh"
+#include "BLI_task.hh"
 
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_query.hh"
@@ -122,7 +123,6 @@ static BVHTree *bvhtree_build_from_cloth(ClothModifierData *clmd, float epsilon)
 
 void bvhtree_update_from_cloth(ClothModifierData *clmd, bool moving, bool self)
 {
-  uint i = 0;
   Cloth *cloth = clmd->clothObject;
   BVHTree *bvhtree;
   ClothVertex *verts = cloth->verts;
@@ -145,56 +145,54 @@ void bvhtree_update_from_cloth(ClothModifierData *clmd, bool moving, bool self)
   /* update vertex position in bvh tree */
   if (clmd->hairdata == nullptr) {
     if (verts && vert_tris) {
-      for (i = 0; i < cloth->primitive_num; i++) {
-        float co[3][3], co_moving[3][3];
-        bool ret;
-
-        /* copy new locations into array */
-        if (moving) {
-          copy_v3_v3(co[0], verts[vert_tris[i][0]].txold);
-          copy_v3_v3(co[1], verts[vert_tris[i][1]].txold);
-          copy_v3_v3(co[2], verts[vert_tris[i][2]].txold);
-
-          /* update moving positions */
-          copy_v3_v3(co_moving[0], verts[vert_tris[i][0]].tx);
-          copy_v3_v3(co_moving[1], verts[vert_tris[i][1]].tx);
-          copy_v3_v3(co_moving[2], verts[vert_tris[i][2]].tx);
-
-          ret = BLI_bvhtree_update_node(bvhtree, i, co[0], co_moving[0], 3);
-        }
-        else {
-          copy_v3_v3(co[0], verts[vert_tris[i][0]].tx);
-          copy_v3_v3(co[1], verts[vert_tris[i][1]].tx);
-          copy_v3_v3(co[2], verts[vert_tris[i][2]].tx);
-
-          ret = BLI_bvhtree_update_node(bvhtree, i, co[0], nullptr, 3);
-        }
+      /* The leafs are independent, so they are updated in parallel. The tree is never full,
+       * because it was built with a leaf for every primitive. */
+      threading::parallel_for(IndexRange(cloth->primitive_num), 1024, [&](const IndexRange range) {
+        for (const int i : range) {
+          float co[3][3], co_moving[3][3];
+
+          /* copy new locations into array */
+          if (moving) {
+            copy_v3_v3(co[0], verts[vert_tris[i][0]].txold);
+            copy_v3_v3(co[1], verts[vert_tris[i][1]].txold);
+            copy_v3_v3(co[2], verts[vert_tris[i][2]].txold);
+
+            /* update moving positions */
+            copy_v3_v3(co_moving[0], verts[vert_tris[i][0]].tx);
+            copy_v3_v3(co_moving[1], verts[vert_tris[i][1]].tx);
+            copy_v3_v3(co_moving[2], verts[vert_tris[i][2]].tx);
+
+            BLI_bvhtree_update_node(bvhtree, i, co[0], co_moving[0], 3);
+          }
+          else {
+            copy_v3_v3(co[0], verts[vert_tris[i][0]].tx);
+            copy_v3_v3(co[1], verts[vert_tris[i][1]].tx);
+            copy_v3_v3(co[2], verts[vert_tris[i][2]].tx);
 
-        /* check if tree is already full */
-        if (ret == false) {
-          break;
+            BLI_bvhtree_update_node(bvhtree, i, co[0], nullptr, 3);
+          }
         }
-      }
+      });
 
-      BLI_bvhtree_update_tree(bvhtree);
+      BLI_bvhtree_update_tree_or_balance(bvhtree, CLOTH_BVH_MAX_COST_FACTOR);
     }
   }
   else {
     if (verts) {
       const int2 *edges = reinterpret_cast<const int2 *>(cloth->edges);
 
-      for (i = 0; i < cloth->primitive_num; i++) {
-        float co[2][3];
+      threading::parallel_for(IndexRange(cloth->primitive_num), 1024, [&](const IndexRange range) {
+        for (const int i : range) {
+          float co[2][3];
 
-        copy_v3_v3(co[0], verts[edges[i][0]].tx);
-        copy_v3_v3(co[1], verts[edges[i][1]].tx);
+          copy_v3_v3(co[0], verts[edges[i][0]].tx);
+          copy_v3_v3(co[1], verts[edges[i][1]].tx);
 
-        if (!BLI_bvhtree_update_node(bvhtree, i, co[0], nullptr, 2)) {
-          break;
+          BLI_bvhtree_update_node(bvhtree, i, co[0], nullptr, 2);
         }
-      }
+      });
 
-      BLI_bvhtree_update_tree(bvhtree);
+      BLI_bvhtree_update_tree_or_balance(bvhtree, CLOTH_BVH_MAX_COST_FACTOR);
     }
   }
 }
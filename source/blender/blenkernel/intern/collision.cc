@@ -19,6 +19,7 @@
 #include "BLI_listbase.hh"
 #include "BLI_math_geom_c.hh"
 #include "BLI_math_vector_c.hh"
+#include "BLI_task.hh"
 #include "BLI_task_c.hh"
 
 #include "BKE_cloth.hh"
@@ -129,35 +130,33 @@ void bvhtree_update_from_mvert(BVHTree *bvhtree,
     moving = false;
   }
 
-  for (int i = 0; i < tri_num; i++) {
-    float co[3][3];
-    bool ret;
+  /* The leafs are independent, so they are updated in parallel. The tree is never full, because it
+   * was built with a leaf for every triangle. */
+  threading::parallel_for(IndexRange(tri_num), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      float co[3][3];
 
-    copy_v3_v3(co[0], positions[vert_tris[i][0]]);
-    copy_v3_v3(co[1], positions[vert_tris[i][1]]);
-    copy_v3_v3(co[2], positions[vert_tris[i][2]]);
+      copy_v3_v3(co[0], positions[vert_tris[i][0]]);
+      copy_v3_v3(co[1], positions[vert_tris[i][1]]);
+      copy_v3_v3(co[2], positions[vert_tris[i][2]]);
 
-    /* copy new locations into array */
-    if (moving) {
-      float co_moving[3][3];
-      /* update moving positions */
-      copy_v3_v3(co_moving[0], positions_moving[vert_tris[i][0]]);
-      copy_v3_v3(co_moving[1], positions_moving[vert_tris[i][1]]);
-      copy_v3_v3(co_moving[2], positions_moving[vert_tris[i][2]]);
+      /* copy new locations into array */
+      if (moving) {
+        float co_moving[3][3];
+        /* update moving positions */
+        copy_v3_v3(co_moving[0], positions_moving[vert_tris[i][0]]);
+        copy_v3_v3(co_moving[1], positions_moving[vert_tris[i][1]]);
+        copy_v3_v3(co_moving[2], positions_moving[vert_tris[i][2]]);
 
-      ret = BLI_bvhtree_update_node(bvhtree, i, &co[0][0], &co_moving[0][0], 3);
-    }
-    else {
-      ret = BLI_bvhtree_update_node(bvhtree, i, &co[0][0], nullptr, 3);
-    }
-
-    /* check if tree is already full */
-    if (ret == false) {
-      break;
+        BLI_bvhtree_update_node(bvhtree, i, &co[0][0], &co_moving[0][0], 3);
+      }
+      else {
+        BLI_bvhtree_update_node(bvhtree, i, &co[0][0], nullptr, 3);
+      }
     }
-  }
+  });
 
-  BLI_bvhtree_update_tree(bvhtree);
+  BLI_bvhtree_update_tree_or_balance(bvhtree, CLOTH_BVH_MAX_COST_FACTOR);
 }
 
 /** \} */
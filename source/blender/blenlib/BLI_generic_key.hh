@@ -10,6 +10,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
 
 #include "BLI_assert.hh"
 
@@ -43,6 +45,16 @@ class GenericKey {
    */
   virtual std::unique_ptr<GenericKey> to_storable() const = 0;
 
+  /**
+   * An identifier that is equal for equal keys and stays the same across Blender sessions. Keys
+   * that reference data of the current session only (which is the default) return nothing. This
+   * is used to find values that have been stored on disk, e.g. by #memory_cache.
+   */
+  virtual std::optional<std::string> persistent_identifier() const
+  {
+    return std::nullopt;
+  }
+
   friend bool operator==(const GenericKey &a, const GenericKey &b)
   {
     const bool are_equal = a.equal_to(b);
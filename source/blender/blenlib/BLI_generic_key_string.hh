@@ -45,6 +45,11 @@ class GenericStringKey : public GenericKey, NonMovable {
     storable_key->value_ref_ = storable_key->value_;
     return storable_key;
   }
+
+  std::optional<std::string> persistent_identifier() const override
+  {
+    return value_ref_;
+  }
 };
 
 }  // namespace blender
@@ -98,6 +98,8 @@ enum {
 };
 #define BVH_RAYCAST_DEFAULT (BVH_RAYCAST_WATERTIGHT)
 #define BVH_RAYCAST_DIST_MAX (FLT_MAX / 2.0f)
+/** Number of rays that are traversed together by #BLI_bvhtree_ray_cast_batch. */
+#define BVH_RAYCAST_PACKET_SIZE 4
 
 /**
  * Callback must update nearest in case it finds a nearest result.
@@ -155,6 +157,15 @@ BVHTree *BLI_bvhtree_new(int maxsize, float epsilon, char tree_type, char axis);
  */
 void BLI_bvhtree_insert(BVHTree *tree, int index, const float co[3], int numpoints);
 void BLI_bvhtree_balance(BVHTree *tree);
+/**
+ * Alternative to #BLI_bvhtree_balance that splits nodes where the surface area heuristic
+ * estimates the lowest cost for ray-casts, instead of splitting them into equal halves. This takes
+ * longer to build, but ray-casts are usually faster, especially for unevenly distributed elements.
+ *
+ * \note Only binary trees that contain the x, y and z axis (6, 8, 14 and 26 axis k-DOPs) are built
+ * this way, others fall back to #BLI_bvhtree_balance.
+ */
+void BLI_bvhtree_balance_sah(BVHTree *tree);
 
 /**
  * Update: first update points/nodes, then call update_tree to refit the bounding volumes.
@@ -169,6 +180,18 @@ bool BLI_bvhtree_update_node(
  * too much, operations on the tree may become suboptimal.
  */
 void BLI_bvhtree_update_tree(BVHTree *tree);
+/**
+ * Same as #BLI_bvhtree_update_tree, but balances the tree again when refitting made it much worse
+ * for queries. This is measured with the surface area heuristic: the summed area of all branches
+ * relative to the root, compared to the value right after the tree was balanced.
+ *
+ * \param max_cost_factor: How much the cost may grow before the tree is balanced again.
+ * \return True if the tree was balanced again.
+ *
+ * \note Trees are always balanced again with #BLI_bvhtree_balance. Trees which don't use the x, y
+ * and z axis (18 axis k-DOPs) are only refit.
+ */
+bool BLI_bvhtree_update_tree_or_balance(BVHTree *tree, float max_cost_factor);
 
 /**
  * Use to check the total number of threads #BLI_bvhtree_overlap will use.
@@ -264,6 +287,28 @@ int BLI_bvhtree_ray_cast(const BVHTree *tree,
                          BVHTree_RayCastCallback callback,
                          void *userdata);
 
+/**
+ * Cast many rays, with the same result as #BLI_bvhtree_ray_cast_ex for every ray. Only when there
+ * are multiple hits at exactly the same distance, which one is found may differ.
+ *
+ * The rays are traversed in packets of #BVH_RAYCAST_PACKET_SIZE rays that share the traversal of
+ * the tree, and the bounding volumes are tested for all rays of a packet at once using SIMD. This
+ * is faster when consecutive rays are coherent, i.e. they start close to each other and have a
+ * similar direction.
+ *
+ * \param hits: The hit of every ray, which has to be initialized like the hit passed to
+ * #BLI_bvhtree_ray_cast_ex.
+ */
+void BLI_bvhtree_ray_cast_batch(const BVHTree *tree,
+                                int rays_num,
+                                const float (*origins)[3],
+                                const float (*directions)[3],
+                                float radius,
+                                BVHTreeRayHit *hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag);
+
 /**
  * Calls the callback for every ray intersection
  *
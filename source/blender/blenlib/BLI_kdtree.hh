@@ -15,12 +15,17 @@
 #include "BLI_kdtree_types.hh"
 #include "BLI_math_base_c.hh"
 #include "BLI_math_vector.hh"
+#include "BLI_sort.hh"
+#include "BLI_span.hh"
 #include "BLI_stack.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "PRF_profile.hh"
 
 #include <algorithm>
+#include <array>
+#include <limits>
 
 namespace blender {
 
@@ -32,6 +37,13 @@ constexpr int kd_found_alloc_inc = 50; /* alloc increment for collecting nearest
 
 constexpr uint kd_node_unset = (uint(-1));
 
+/** Sub-trees with more nodes than this are balanced in parallel. */
+constexpr uint kd_balance_parallel_threshold = 8192;
+/** Number of queries of a batched search that traverse the tree together. */
+constexpr int kd_batch_packet_size = 16;
+/** Number of query packets of a batched search that are handled by one task. */
+constexpr int kd_batch_grain_size = 16;
+
 /**
  * When set we know all values are unbalanced,
  * otherwise clear them when re-balancing: see #62210.
@@ -118,7 +130,11 @@ inline void kdtree_insert(KDTree<CoordT> *tree, int index, const CoordT &co)
 namespace detail {
 
 template<typename CoordT>
-static uint kdtree_balance(KDTreeNode<CoordT> *nodes, uint nodes_len, uint axis, const uint ofs)
+static uint kdtree_balance(KDTreeNode<CoordT> *nodes,
+                           uint nodes_len,
+                           uint axis,
+                           const uint ofs,
+                           const bool use_threading)
 {
   KDTreeNode<CoordT> *node;
   typename KDTree<CoordT>::ValueType co;
@@ -171,16 +187,29 @@ static uint kdtree_balance(KDTreeNode<CoordT> *nodes, uint nodes_len, uint axis,
   node = &nodes[median];
   node->d = axis;
   axis = (axis + 1) % KDTree<CoordT>::DimsNum;
-  node->left = kdtree_balance(nodes, median, axis, ofs);
-  node->right = kdtree_balance(
-      nodes + median + 1, (nodes_len - (median + 1)), axis, (median + 1) + ofs);
+  /* The sub-trees use disjoint parts of the nodes array,
+   * so large ones can be balanced in parallel with the same result. */
+  threading::parallel_invoke(
+      use_threading && nodes_len > kd_balance_parallel_threshold,
+      [&]() { node->left = kdtree_balance(nodes, median, axis, ofs, use_threading); },
+      [&]() {
+        node->right = kdtree_balance(nodes + median + 1,
+                                     (nodes_len - (median + 1)),
+                                     axis,
+                                     (median + 1) + ofs,
+                                     use_threading);
+      });
 
   return median + ofs;
 }
 
 }  // namespace detail
 
-template<typename CoordT> inline void kdtree_balance(KDTree<CoordT> *tree)
+/**
+ * \param use_threading: Balance large sub-trees in parallel, which results in the same tree.
+ */
+template<typename CoordT>
+inline void kdtree_balance(KDTree<CoordT> *tree, const bool use_threading = true)
 {
   PRF_scope(ProfileCategory::Default);
   if (tree->root != detail::kd_node_root_is_init) {
@@ -190,7 +219,7 @@ template<typename CoordT> inline void kdtree_balance(KDTree<CoordT> *tree)
     }
   }
 
-  tree->root = detail::kdtree_balance<CoordT>(tree->nodes, tree->nodes_len, 0, 0);
+  tree->root = detail::kdtree_balance<CoordT>(tree->nodes, tree->nodes_len, 0, 0, use_threading);
 
 #ifndef NDEBUG
   tree->is_balanced = true;
@@ -456,6 +485,203 @@ inline int kdtree_find_nearest_n(const KDTree<CoordT> *tree,
 
 namespace detail {
 
+/**
+ * Find the node that a search for \a co descends to first, used to order queries spatially.
+ * Nodes are stored in the order of a depth-first traversal, so close points get close indices.
+ */
+template<typename CoordT>
+static uint kdtree_find_leaf(const KDTree<CoordT> *tree, const CoordT &co)
+{
+  const KDTreeNode<CoordT> *nodes = tree->nodes;
+  uint node_index = tree->root;
+  while (true) {
+    const KDTreeNode<CoordT> *node = &nodes[node_index];
+    const uint next = (axis_get(co, node->d) < axis_get(node->co, node->d)) ? node->left :
+                                                                               node->right;
+    if (next == kd_node_unset) {
+      return node_index;
+    }
+    node_index = next;
+  }
+}
+
+/**
+ * Search the nearest points of a packet of up to #kd_batch_packet_size queries with a single
+ * traversal of the tree. Every node is loaded once for all queries in the packet, and a sub-tree
+ * is skipped when it can't contain closer points for any of the queries. Nodes are only tested
+ * for a query under the same conditions as in #kdtree_find_nearest_n_with_len_squared_cb, so the
+ * results are the same, apart from the order of points at the same distance.
+ */
+template<typename CoordT>
+static void kdtree_find_nearest_n_packet(const KDTree<CoordT> *tree,
+                                         const Span<CoordT> query_cos,
+                                         const Span<uint64_t> packet,
+                                         const uint nearest_len_capacity,
+                                         MutableSpan<KDTreeNearest<CoordT>> r_nearest,
+                                         MutableSpan<int> r_nearest_len)
+{
+  using ValueType = typename KDTree<CoordT>::ValueType;
+  BLI_assert(packet.size() <= kd_batch_packet_size);
+  const KDTreeNode<CoordT> *nodes = tree->nodes;
+  const int packet_size = int(packet.size());
+
+  std::array<CoordT, kd_batch_packet_size> cos;
+  std::array<KDTreeNearest<CoordT> *, kd_batch_packet_size> nearest;
+  std::array<uint, kd_batch_packet_size> nearest_len;
+  for (const int q : IndexRange(packet_size)) {
+    const int64_t query = int64_t(packet[q] & 0xFFFFFFFFu);
+    cos[q] = query_cos[query];
+    nearest[q] = &r_nearest[query * nearest_len_capacity];
+    nearest_len[q] = 0;
+  }
+  /* Whether a point at the given squared distance may be one of the nearest points of query `q`.
+   */
+  auto is_candidate = [&](const int q, const ValueType dist_sq) {
+    return nearest_len[q] < nearest_len_capacity ||
+           dist_sq < nearest[q][nearest_len[q] - 1].dist;
+  };
+
+  const KDTreeNode<CoordT> *root = &nodes[tree->root];
+  for (const int q : IndexRange(packet_size)) {
+    nearest_ordered_insert<CoordT>(nearest[q],
+                                   &nearest_len[q],
+                                   nearest_len_capacity,
+                                   root->index,
+                                   distance_squared(cos[q], root->co),
+                                   root->co);
+  }
+
+  /* Sub-trees are pushed in the order that is best for the first query, the queries in a packet
+   * are usually close to each other. */
+  Stack<uint, kd_stack_init> stack;
+  if (axis_get(cos[0], root->d) < axis_get(root->co, root->d)) {
+    if (root->right != kd_node_unset) {
+      stack.push(root->right);
+    }
+    if (root->left != kd_node_unset) {
+      stack.push(root->left);
+    }
+  }
+  else {
+    if (root->left != kd_node_unset) {
+      stack.push(root->left);
+    }
+    if (root->right != kd_node_unset) {
+      stack.push(root->right);
+    }
+  }
+
+  while (!stack.is_empty()) {
+    const KDTreeNode<CoordT> *node = &nodes[stack.pop()];
+    const ValueType split = axis_get(node->co, node->d);
+
+    /* The sub-tree on the side of the query is always searched, the node itself and the sub-tree
+     * on the other side only when the splitting plane is closer than the found points. */
+    bool use_left = false;
+    bool use_right = false;
+    for (const int q : IndexRange(packet_size)) {
+      const ValueType offset = split - axis_get(cos[q], node->d);
+      const bool is_right = offset < 0.0f;
+      if (is_candidate(q, offset * offset)) {
+        const ValueType dist_sq = distance_squared(cos[q], node->co);
+        if (is_candidate(q, dist_sq)) {
+          nearest_ordered_insert<CoordT>(
+              nearest[q], &nearest_len[q], nearest_len_capacity, node->index, dist_sq, node->co);
+        }
+        use_left = true;
+        use_right = true;
+      }
+      else if (is_right) {
+        use_right = true;
+      }
+      else {
+        use_left = true;
+      }
+    }
+
+    const uint left = use_left ? node->left : kd_node_unset;
+    const uint right = use_right ? node->right : kd_node_unset;
+    const uint near = split - axis_get(cos[0], node->d) < 0.0f ? right : left;
+    const uint far = near == left ? right : left;
+    if (far != kd_node_unset) {
+      stack.push(far);
+    }
+    if (near != kd_node_unset) {
+      stack.push(near);
+    }
+  }
+
+  for (const int q : IndexRange(packet_size)) {
+    for (const int64_t i : IndexRange(nearest_len[q])) {
+      nearest[q][i].dist = sqrtf(nearest[q][i].dist);
+    }
+    r_nearest_len[int64_t(packet[q] & 0xFFFFFFFFu)] = int(nearest_len[q]);
+  }
+}
+
+}  // namespace detail
+
+/**
+ * Batched version of #kdtree_find_nearest_n, searching for many points in parallel.
+ *
+ * Queries are sorted spatially and grouped into small packets, which traverse the tree together.
+ * This loads every visited node once for all queries of a packet instead of once per query, which
+ * is more cache friendly, especially when the query points are not sorted.
+ *
+ * \param r_nearest: Results of query `i` are stored at `i * nearest_len_capacity`,
+ * sized at least `query_cos.size() * nearest_len_capacity`.
+ * \param r_nearest_len: The number of points found for every query.
+ */
+template<typename CoordT>
+inline void kdtree_find_nearest_n_batch(const KDTree<CoordT> *tree,
+                                        const Span<CoordT> query_cos,
+                                        const uint nearest_len_capacity,
+                                        MutableSpan<KDTreeNearest<CoordT>> r_nearest,
+                                        MutableSpan<int> r_nearest_len)
+{
+  PRF_scope(ProfileCategory::Default);
+  BLI_assert(r_nearest.size() >= query_cos.size() * int64_t(nearest_len_capacity));
+  BLI_assert(r_nearest_len.size() >= query_cos.size());
+  BLI_assert(query_cos.size() <= std::numeric_limits<uint32_t>::max());
+
+#ifndef NDEBUG
+  BLI_assert(tree->is_balanced == true);
+#endif
+
+  if ((tree->root == detail::kd_node_unset) || nearest_len_capacity == 0) [[unlikely]] {
+    r_nearest_len.take_front(query_cos.size()).fill(0);
+    return;
+  }
+
+  /* Sort the queries by the node they descend to, with the query index in the lower bits. */
+  Array<uint64_t> order(query_cos.size());
+  threading::parallel_for(query_cos.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      const uint leaf = detail::kdtree_find_leaf<CoordT>(tree, query_cos[i]);
+      order[i] = (uint64_t(leaf) << 32) | uint64_t(i);
+    }
+  });
+  parallel_sort(order.begin(), order.end());
+
+  const int64_t packets_num = (order.size() + detail::kd_batch_packet_size - 1) /
+                              detail::kd_batch_packet_size;
+  threading::parallel_for(
+      IndexRange(packets_num), detail::kd_batch_grain_size, [&](const IndexRange range) {
+        for (const int64_t packet : range) {
+          const IndexRange packet_range = order.index_range().intersect(
+              IndexRange(packet * detail::kd_batch_packet_size, detail::kd_batch_packet_size));
+          detail::kdtree_find_nearest_n_packet<CoordT>(tree,
+                                                       query_cos,
+                                                       order.as_span().slice(packet_range),
+                                                       nearest_len_capacity,
+                                                       r_nearest,
+                                                       r_nearest_len);
+        }
+      });
+}
+
+namespace detail {
+
 template<typename CoordT> static int nearest_cmp_dist(const void *a, const void *b)
 {
   const KDTreeNearest<CoordT> *kda = static_cast<const KDTreeNearest<CoordT> *>(a);
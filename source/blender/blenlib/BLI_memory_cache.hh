@@ -8,9 +8,13 @@
 
 #pragma once
 
+#include <iosfwd>
+
 #include "BLI_function_ref.hh"
 #include "BLI_generic_key.hh"
 #include "BLI_memory_counter_fwd.hh"
+#include "BLI_span.hh"
+#include "BLI_string_ref.hh"
 
 namespace blender::memory_cache {
 
@@ -27,6 +31,16 @@ class CachedValue {
    * full.
    */
   virtual void count_memory(MemoryCounter &memory) const = 0;
+
+  /**
+   * Write the value to the stream so that it can be kept in the disk tier of the cache after it
+   * has been freed from memory, see #set_disk_cache. The data is read back by the `read_fn` passed
+   * to #get. Returns false if the value can't be stored on disk, which is the default.
+   */
+  virtual bool write_to_disk(std::ostream & /*stream*/) const
+  {
+    return false;
+  }
 };
 
 /**
@@ -39,10 +53,22 @@ template<typename T>
 std::shared_ptr<const T> get(const GenericKey &key, FunctionRef<std::unique_ptr<T>()> compute_fn);
 
 /**
- * A non-templated version of the main entry point above.
+ * Same as above, but the value may also be found in the disk tier of the cache, in which case
+ * #read_fn is called with the data that #CachedValue::write_to_disk wrote. The data is only valid
+ * during the call. If #read_fn returns null, the value is computed instead.
+ */
+template<typename T>
+std::shared_ptr<const T> get(const GenericKey &key,
+                             FunctionRef<std::unique_ptr<T>()> compute_fn,
+                             FunctionRef<std::unique_ptr<T>(Span<std::byte> data)> read_fn);
+
+/**
+ * A non-templated version of the main entry points above.
  */
-std::shared_ptr<CachedValue> get_base(const GenericKey &key,
-                                      FunctionRef<std::unique_ptr<CachedValue>()> compute_fn);
+std::shared_ptr<CachedValue> get_base(
+    const GenericKey &key,
+    FunctionRef<std::unique_ptr<CachedValue>()> compute_fn,
+    FunctionRef<std::unique_ptr<CachedValue>(Span<std::byte> data)> read_fn = {});
 
 /**
  * Set how much memory the cache is allowed to use. This is only an approximation because counting
@@ -50,6 +76,22 @@ std::shared_ptr<CachedValue> get_base(const GenericKey &key,
  */
 void set_approximate_size_limit(int64_t limit_in_bytes);
 
+/**
+ * Enable the disk tier of the cache which stores values that are freed from memory in the given
+ * directory, so that they don't have to be computed again when they are used later on, even in a
+ * different Blender session. Only values which have a persistent key (see
+ * #GenericKey::persistent_identifier) and support #CachedValue::write_to_disk are stored. When
+ * the files in the directory use more than the given size, the least recently used ones are
+ * removed. An empty directory or a zero size disables the disk tier.
+ */
+void set_disk_cache(StringRef directory, int64_t size_limit_in_bytes);
+
+/**
+ * Write all values that are currently in memory to the disk tier of the cache if it's enabled and
+ * they are not stored there yet. This is typically done before Blender exits.
+ */
+void flush_to_disk();
+
 /**
  * Remove all elements from the cache. Note that this does not guarantee that no elements are in
  * the cache after the function returned. This is because another thread may have added a new
@@ -75,6 +117,14 @@ inline std::shared_ptr<const T> get(const GenericKey &key,
   return std::dynamic_pointer_cast<const T>(get_base(key, compute_fn));
 }
 
+template<typename T>
+inline std::shared_ptr<const T> get(const GenericKey &key,
+                                    FunctionRef<std::unique_ptr<T>()> compute_fn,
+                                    FunctionRef<std::unique_ptr<T>(Span<std::byte> data)> read_fn)
+{
+  return std::dynamic_pointer_cast<const T>(get_base(key, compute_fn, read_fn));
+}
+
 /** \} */
 
 }  // namespace blender::memory_cache
@@ -19,9 +19,22 @@ std::shared_ptr<const T> get_loaded(const GenericKey &loader_key,
                                     Span<StringRefNull> file_paths,
                                     FunctionRef<std::unique_ptr<T>()> load_fn);
 
-std::shared_ptr<CachedValue> get_loaded_base(const GenericKey &loader_key,
-                                             Span<StringRefNull> file_paths,
-                                             FunctionRef<std::unique_ptr<CachedValue>()> load_fn);
+/**
+ * Same as above, but the loaded value may also be read from the disk tier of the cache, see
+ * #memory_cache::get. Values in the disk tier are only used if the files have not been modified
+ * since the value was loaded.
+ */
+template<typename T>
+std::shared_ptr<const T> get_loaded(const GenericKey &loader_key,
+                                    Span<StringRefNull> file_paths,
+                                    FunctionRef<std::unique_ptr<T>()> load_fn,
+                                    FunctionRef<std::unique_ptr<T>(Span<std::byte> data)> read_fn);
+
+std::shared_ptr<CachedValue> get_loaded_base(
+    const GenericKey &loader_key,
+    Span<StringRefNull> file_paths,
+    FunctionRef<std::unique_ptr<CachedValue>()> load_fn,
+    FunctionRef<std::unique_ptr<CachedValue>(Span<std::byte> data)> read_fn = {});
 
 template<typename T>
 inline std::shared_ptr<const T> get_loaded(const GenericKey &loader_key,
@@ -31,4 +44,15 @@ inline std::shared_ptr<const T> get_loaded(const GenericKey &loader_key,
   return std::dynamic_pointer_cast<const T>(get_loaded_base(loader_key, file_paths, load_fn));
 }
 
+template<typename T>
+inline std::shared_ptr<const T> get_loaded(
+    const GenericKey &loader_key,
+    Span<StringRefNull> file_paths,
+    FunctionRef<std::unique_ptr<T>()> load_fn,
+    FunctionRef<std::unique_ptr<T>(Span<std::byte> data)> read_fn)
+{
+  return std::dynamic_pointer_cast<const T>(
+      get_loaded_base(loader_key, file_paths, load_fn, read_fn));
+}
+
 }  // namespace blender::memory_cache
@@ -21,6 +21,8 @@
  *   #BLI_bvhtree_overlap, #BVHOverlapData_Shared, #BVHOverlapData_Thread
  * - Range Query:
  *   #BLI_bvhtree_range_query
+ * - Ray-cast of ray packets:
+ *   #BLI_bvhtree_ray_cast_batch, #BVHRayPacket
  */
 
 #include <algorithm>
@@ -32,9 +34,12 @@
 #include "BLI_kdopbvh.hh"
 #include "BLI_math_geom_c.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_simd.hh"
 #include "BLI_stack_c.hh"
+#include "BLI_task.hh"
 #include "BLI_task_c.hh"
 #include "BLI_utildefines.hh"
+#include "BLI_vector.hh"
 
 #include "BLI_strict_flags.hh" /* IWYU pragma: keep. Keep last. */
 
@@ -83,6 +88,7 @@ struct BVHTree {
   BVHNode **nodechild; /* Pre-allocate children for nodes. */
   float *nodebv;       /* Pre-allocate bounding-volumes for nodes. */
   float epsilon;       /* Epsilon is used for inflation of the K-DOP. */
+  float balanced_cost; /* SAH cost after the last balance, zero if unknown. */
   int leaf_num;        /* Leafs. */
   int branch_num;
   int nodes_num_alloc;          /* Allocated length of #nodes & #nodearray. */
@@ -93,7 +99,7 @@ struct BVHTree {
 
 /* optimization, ensure we stay small */
 BLI_STATIC_ASSERT((sizeof(void *) == 8 && sizeof(BVHTree) <= 56) ||
-                      (sizeof(void *) == 4 && sizeof(BVHTree) <= 36),
+                      (sizeof(void *) == 4 && sizeof(BVHTree) <= 40),
                   "over sized")
 
 /* avoid duplicating vars in BVHOverlapData_Thread */
@@ -422,31 +428,65 @@ static char get_largest_axis(const float *bv)
  * bottom-up update of bvh node BV
  * join the children on the parent BV.
  */
-static void node_join(BVHTree *tree, BVHNode *node)
+static void node_join(const BVHTree *tree, BVHNode *node)
 {
-  int i;
-  axis_t axis_iter;
-
-  node_minmax_init(tree, node);
+  BVHNode **children = node->children;
+  int children_num = 0;
+  while (children_num < tree->tree_type && children[children_num]) {
+    children_num++;
+  }
+  if (children_num == 0) {
+    node_minmax_init(tree, node);
+    return;
+  }
 
-  for (i = 0; i < tree->tree_type; i++) {
-    if (node->children[i]) {
-      for (axis_iter = tree->start_axis; axis_iter < tree->stop_axis; axis_iter++) {
-        /* update minimum */
-        node->bv[(2 * axis_iter)] = std::min(node->children[i]->bv[(2 * axis_iter)],
-                                             node->bv[(2 * axis_iter)]);
-
-        /* update maximum */
-        node->bv[(2 * axis_iter) + 1] = std::max(node->children[i]->bv[(2 * axis_iter) + 1],
-                                                 node->bv[(2 * axis_iter) + 1]);
-      }
+  int i = 2 * tree->start_axis;
+  const int end = 2 * tree->stop_axis;
+#if BLI_HAVE_SSE2
+  /* The minimum and maximum of every axis are interleaved, so two axes are joined at once by
+   * taking the minimum of the even and the maximum of the odd lanes. Every part of the bounding
+   * volume is joined from all children before it is stored. */
+  const __m128 max_mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, -1, 0));
+  for (; i + 4 <= end; i += 4) {
+    __m128 result = _mm_loadu_ps(children[0]->bv + i);
+    for (int child = 1; child < children_num; child++) {
+      const __m128 child_bv = _mm_loadu_ps(children[child]->bv + i);
+      result = _mm_or_ps(_mm_and_ps(max_mask, _mm_max_ps(result, child_bv)),
+                         _mm_andnot_ps(max_mask, _mm_min_ps(result, child_bv)));
     }
-    else {
-      break;
+    _mm_storeu_ps(node->bv + i, result);
+  }
+#endif
+  for (; i < end; i += 2) {
+    float min = children[0]->bv[i];
+    float max = children[0]->bv[i + 1];
+    for (int child = 1; child < children_num; child++) {
+      min = std::min(children[child]->bv[i], min);
+      max = std::max(children[child]->bv[i + 1], max);
     }
+    node->bv[i] = min;
+    node->bv[i + 1] = max;
   }
 }
 
+static bool node_is_branch(const BVHTree *tree, const BVHNode *node)
+{
+  return node - tree->nodearray >= tree->leaf_num;
+}
+
+/**
+ * Join the bounding volumes of all branches in the sub-tree of \a node, bottom-up.
+ */
+static void node_join_recursive(const BVHTree *tree, BVHNode *node)
+{
+  for (int i = 0; i < node->node_num; i++) {
+    if (node_is_branch(tree, node->children[i])) {
+      node_join_recursive(tree, node->children[i]);
+    }
+  }
+  node_join(tree, node);
+}
+
 /** \} */
 
 #ifdef USE_PRINT_TREE
@@ -857,6 +897,191 @@ static void non_recursive_bvh_div_nodes(const BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Binned SAH Tree Construction
+ *
+ * Builds a binary tree top-down, splitting the leafs of every branch where the surface area
+ * heuristic (SAH) estimates the lowest cost for ray-casts. Candidate splits are found by binning
+ * the centers of the leafs along the x, y and z axis.
+ *
+ * The branches are stored in depth first order after the leafs, so like in the implicit tree all
+ * children have a greater index than their parent. A binary tree always has one branch less than
+ * leafs, so this needs no more branches than the implicit tree.
+ * \{ */
+
+#define BVH_SAH_BINS_NUM 16
+
+/** Half of the surface area of the box spanned by the x, y and z axis of the bounding volume. */
+static float bv_half_area(const float *bv)
+{
+  const float dx = bv[1] - bv[0];
+  const float dy = bv[3] - bv[2];
+  const float dz = bv[5] - bv[4];
+  return dx * dy + dy * dz + dz * dx;
+}
+
+static float bv_center(const float *bv, const int axis)
+{
+  return (bv[2 * axis] + bv[2 * axis + 1]) * 0.5f;
+}
+
+static void bv_box_init(float box[6])
+{
+  for (int axis = 0; axis < 3; axis++) {
+    box[2 * axis] = FLT_MAX;
+    box[2 * axis + 1] = -FLT_MAX;
+  }
+}
+
+static void bv_box_expand(float box[6], const float *bv)
+{
+  for (int axis = 0; axis < 3; axis++) {
+    box[2 * axis] = std::min(box[2 * axis], bv[2 * axis]);
+    box[2 * axis + 1] = std::max(box[2 * axis + 1], bv[2 * axis + 1]);
+  }
+}
+
+struct BVHSAHBin {
+  float box[6];
+  int leafs_num;
+};
+
+static int sah_bin_index(const float center, const float center_min, const float bin_scale)
+{
+  return std::min(int((center - center_min) * bin_scale), BVH_SAH_BINS_NUM - 1);
+}
+
+/**
+ * Reorder the leafs in the range, so that the leafs of the first child come first.
+ * \return The index of the first leaf of the second child.
+ */
+static int sah_split_leafs(const BVHTree *tree, const int begin, const int end, char *r_axis)
+{
+  BVHNode **leafs = tree->nodes;
+
+  float center_min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+  float center_max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+  for (int i = begin; i < end; i++) {
+    for (int axis = 0; axis < 3; axis++) {
+      const float center = bv_center(leafs[i]->bv, axis);
+      center_min[axis] = std::min(center_min[axis], center);
+      center_max[axis] = std::max(center_max[axis], center);
+    }
+  }
+
+  float best_cost = FLT_MAX;
+  int best_axis = -1;
+  int best_bin = 0;
+  for (int axis = 0; axis < 3; axis++) {
+    const float extent = center_max[axis] - center_min[axis];
+    if (!(extent > 0.0f)) {
+      continue;
+    }
+    const float bin_scale = float(BVH_SAH_BINS_NUM) / extent;
+
+    BVHSAHBin bins[BVH_SAH_BINS_NUM];
+    for (BVHSAHBin &bin : bins) {
+      bv_box_init(bin.box);
+      bin.leafs_num = 0;
+    }
+    for (int i = begin; i < end; i++) {
+      const float center = bv_center(leafs[i]->bv, axis);
+      BVHSAHBin &bin = bins[sah_bin_index(center, center_min[axis], bin_scale)];
+      bv_box_expand(bin.box, leafs[i]->bv);
+      bin.leafs_num++;
+    }
+
+    /* Accumulate the bins right of every split position. */
+    float right_area[BVH_SAH_BINS_NUM];
+    int right_num[BVH_SAH_BINS_NUM];
+    float box[6];
+    bv_box_init(box);
+    int leafs_num = 0;
+    for (int bin = BVH_SAH_BINS_NUM - 1; bin > 0; bin--) {
+      bv_box_expand(box, bins[bin].box);
+      leafs_num += bins[bin].leafs_num;
+      right_area[bin] = leafs_num ? bv_half_area(box) : 0.0f;
+      right_num[bin] = leafs_num;
+    }
+
+    /* Find the split with the lowest cost, splitting before the bin. */
+    bv_box_init(box);
+    leafs_num = 0;
+    for (int bin = 1; bin < BVH_SAH_BINS_NUM; bin++) {
+      bv_box_expand(box, bins[bin - 1].box);
+      leafs_num += bins[bin - 1].leafs_num;
+      if (leafs_num == 0 || right_num[bin] == 0) {
+        continue;
+      }
+      const float cost = bv_half_area(box) * float(leafs_num) +
+                         right_area[bin] * float(right_num[bin]);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_axis = axis;
+        best_bin = bin;
+      }
+    }
+  }
+
+  if (best_axis == -1) {
+    /* All leafs have the same center, split them in the middle. */
+    const int mid = begin + (end - begin) / 2;
+    *r_axis = 0;
+    partition_nth_element(leafs, begin, end, mid, 1);
+    return mid;
+  }
+
+  const float bin_scale = float(BVH_SAH_BINS_NUM) /
+                          (center_max[best_axis] - center_min[best_axis]);
+  BVHNode **mid = std::partition(leafs + begin, leafs + end, [&](const BVHNode *leaf) {
+    return sah_bin_index(bv_center(leaf->bv, best_axis), center_min[best_axis], bin_scale) <
+           best_bin;
+  });
+  *r_axis = char(best_axis);
+  return int(mid - leafs);
+}
+
+static void bvh_sah_build_branch(const BVHTree *tree,
+                                 BVHNode *branches_array,
+                                 const int branch_index,
+                                 const int begin,
+                                 const int end)
+{
+  BVHNode *node = &branches_array[branch_index];
+  refit_kdop_hull(tree, node, begin, end);
+
+  const int mid = sah_split_leafs(tree, begin, end, &node->main_axis);
+  const int left_leafs_num = mid - begin;
+  const int right_leafs_num = end - mid;
+
+  /* The branches of the first child take up the indices directly after this branch. */
+  const int left_branch_index = branch_index + 1;
+  const int right_branch_index = branch_index + left_leafs_num;
+
+  node->children[0] = (left_leafs_num == 1) ? tree->nodes[begin] :
+                                              &branches_array[left_branch_index];
+  node->children[1] = (right_leafs_num == 1) ? tree->nodes[mid] :
+                                               &branches_array[right_branch_index];
+  node->children[0]->parent = node;
+  node->children[1]->parent = node;
+  node->node_num = 2;
+
+  threading::parallel_invoke(
+      (end - begin) > KDOPBVH_THREAD_LEAF_THRESHOLD,
+      [&]() {
+        if (left_leafs_num > 1) {
+          bvh_sah_build_branch(tree, branches_array, left_branch_index, begin, mid);
+        }
+      },
+      [&]() {
+        if (right_leafs_num > 1) {
+          bvh_sah_build_branch(tree, branches_array, right_branch_index, mid, end);
+        }
+      });
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree API
  * \{ */
@@ -943,21 +1168,33 @@ void BLI_bvhtree_free(BVHTree *tree)
   }
 }
 
-void BLI_bvhtree_balance(BVHTree *tree)
+/**
+ * Estimated cost of queries of the tree according to the surface area heuristic: the summed surface
+ * area of all branches relative to the root. The tree gets worse for queries as it grows, when the
+ * leafs moved too far from where the tree was balanced for. Zero if it can't be computed, because
+ * the tree doesn't use the x, y and z axis or the root has no area.
+ */
+static float bvhtree_sah_cost(const BVHTree *tree)
 {
-  BVHNode **leafs_array = tree->nodes;
-
-  /* This function should only be called once
-   * (some big bug goes here if its being called more than once per tree) */
-  BLI_assert(tree->branch_num == 0);
-
-  /* Build the implicit tree */
-  non_recursive_bvh_div_nodes(
-      tree, tree->nodearray + (tree->leaf_num - 1), leafs_array, tree->leaf_num);
+  if (tree->start_axis != 0 || tree->branch_num == 0) {
+    return 0.0f;
+  }
+  const float root_area = bv_half_area(tree->nodes[tree->leaf_num]->bv);
+  if (!(root_area > 0.0f)) {
+    return 0.0f;
+  }
+  double area_sum = 0.0;
+  for (int i = 0; i < tree->branch_num; i++) {
+    area_sum += bv_half_area(tree->nodes[tree->leaf_num + i]->bv);
+  }
+  return float(area_sum / root_area);
+}
 
+static void bvhtree_balance_finish(BVHTree *tree, const int branch_num)
+{
   /* current code expects the branches to be linked to the nodes array
    * we perform that linkage here */
-  tree->branch_num = implicit_needed_branches(tree->tree_type, tree->leaf_num);
+  tree->branch_num = branch_num;
   for (int i = 0; i < tree->branch_num; i++) {
     tree->nodes[tree->leaf_num + i] = &tree->nodearray[tree->leaf_num + i];
   }
@@ -966,6 +1203,8 @@ void BLI_bvhtree_balance(BVHTree *tree)
   build_skip_links(tree, tree->nodes[tree->leaf_num], nullptr, nullptr);
 #endif
 
+  tree->balanced_cost = bvhtree_sah_cost(tree);
+
 #ifdef USE_VERIFY_TREE
   bvhtree_verify(tree);
 #endif
@@ -975,6 +1214,39 @@ void BLI_bvhtree_balance(BVHTree *tree)
 #endif
 }
 
+void BLI_bvhtree_balance(BVHTree *tree)
+{
+  BVHNode **leafs_array = tree->nodes;
+
+  /* This function should only be called once
+   * (some big bug goes here if its being called more than once per tree) */
+  BLI_assert(tree->branch_num == 0);
+
+  /* Build the implicit tree */
+  non_recursive_bvh_div_nodes(
+      tree, tree->nodearray + (tree->leaf_num - 1), leafs_array, tree->leaf_num);
+
+  bvhtree_balance_finish(tree, implicit_needed_branches(tree->tree_type, tree->leaf_num));
+}
+
+void BLI_bvhtree_balance_sah(BVHTree *tree)
+{
+  /* The surface area is computed from the x, y and z axis, which are not used by all k-DOP
+   * types. The build also only creates binary trees. */
+  if (tree->tree_type != 2 || tree->start_axis != 0 || tree->leaf_num < 2) {
+    BLI_bvhtree_balance(tree);
+    return;
+  }
+
+  BLI_assert(tree->branch_num == 0);
+
+  BVHNode *root = &tree->nodearray[tree->leaf_num];
+  root->parent = nullptr;
+  bvh_sah_build_branch(tree, root, 0, 0, tree->leaf_num);
+
+  bvhtree_balance_finish(tree, tree->leaf_num - 1);
+}
+
 static void bvhtree_node_inflate(const BVHTree *tree, BVHNode *node, const float dist)
 {
   axis_t axis_iter;
@@ -1027,8 +1299,52 @@ bool BLI_bvhtree_update_node(
   return true;
 }
 
+/**
+ * Refit the tree by splitting it into sub-trees which are refit in parallel, after which the
+ * branches above them are joined.
+ */
+static void bvhtree_update_tree_parallel(BVHTree *tree)
+{
+  /* Enough sub-trees for threads to balance the load when they have a different size. */
+  constexpr int64_t sub_trees_num = 64;
+
+  /* Expand branches breadth first, so that all branches are after their parent. The branches
+   * which were not expanded are the roots of the sub-trees. */
+  Vector<BVHNode *, sub_trees_num> branches = {tree->nodes[tree->leaf_num]};
+  int64_t top_branches_num = 0;
+  while (top_branches_num < branches.size() && branches.size() - top_branches_num < sub_trees_num)
+  {
+    const BVHNode *node = branches[top_branches_num++];
+    for (int i = 0; i < node->node_num; i++) {
+      if (node_is_branch(tree, node->children[i])) {
+        branches.append(node->children[i]);
+      }
+    }
+  }
+
+  const Span<BVHNode *> sub_tree_roots = branches.as_span().drop_front(top_branches_num);
+  threading::parallel_for(sub_tree_roots.index_range(), 1, [&](const IndexRange range) {
+    for (BVHNode *node : sub_tree_roots.slice(range)) {
+      node_join_recursive(tree, node);
+    }
+  });
+
+  for (int64_t i = top_branches_num - 1; i >= 0; i--) {
+    node_join(tree, branches[i]);
+  }
+}
+
 void BLI_bvhtree_update_tree(BVHTree *tree)
 {
+  if (tree->branch_num == 0) {
+    return;
+  }
+
+  if (tree->leaf_num > KDOPBVH_THREAD_LEAF_THRESHOLD) {
+    bvhtree_update_tree_parallel(tree);
+    return;
+  }
+
   /* Update bottom=>top
    * TRICKY: the way we build the tree all the children have an index greater than the parent
    * This allows us todo a bottom up update by starting on the bigger numbered branch. */
@@ -1040,6 +1356,27 @@ void BLI_bvhtree_update_tree(BVHTree *tree)
     node_join(tree, *index);
   }
 }
+
+bool BLI_bvhtree_update_tree_or_balance(BVHTree *tree, const float max_cost_factor)
+{
+  BLI_bvhtree_update_tree(tree);
+
+  if (tree->balanced_cost == 0.0f ||
+      bvhtree_sah_cost(tree) <= tree->balanced_cost * max_cost_factor)
+  {
+    return false;
+  }
+
+  /* Build the branches again from the leafs, which are up to date already. */
+  for (int i = 0; i < tree->branch_num; i++) {
+    BVHNode *node = tree->nodes[tree->leaf_num + i];
+    std::fill_n(node->children, tree->tree_type, nullptr);
+    node->node_num = 0;
+  }
+  tree->branch_num = 0;
+  BLI_bvhtree_balance(tree);
+  return true;
+}
 int BLI_bvhtree_get_len(const BVHTree *tree)
 {
   return tree->leaf_num;
@@ -2107,6 +2444,171 @@ void BLI_bvhtree_ray_cast_all(const BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BLI_bvhtree_ray_cast_batch
+ *
+ * Casts packets of rays that share the traversal of the tree. Every ray keeps its own
+ * #BVHRayCastData, so leafs are handled exactly like in #dfs_raycast. Only the bounding volumes
+ * of branches are tested for all rays of the packet at once.
+ *
+ * \{ */
+
+struct BVHRayPacket {
+  BVHRayCastData rays[BVH_RAYCAST_PACKET_SIZE];
+  /** Bit mask of the rays that are used, the last packet may not be full. */
+  int rays_mask;
+
+  /* Copies of the ray data in a SIMD friendly layout. */
+  float origin[3][BVH_RAYCAST_PACKET_SIZE];
+  float idot_axis[3][BVH_RAYCAST_PACKET_SIZE];
+  float hit_dist[BVH_RAYCAST_PACKET_SIZE];
+};
+
+/**
+ * Same test as #fast_ray_nearest_hit for all rays in the packet.
+ * \return Bit mask of the rays that hit the bounding volume before their current hit.
+ */
+static int ray_packet_hit_mask(const BVHRayPacket *packet, const BVHNode *node)
+{
+  const float *bv = node->bv;
+#if BLI_HAVE_SSE2 && BVH_RAYCAST_PACKET_SIZE == 4
+  __m128 t_near = _mm_setzero_ps();
+  __m128 t_far = _mm_setzero_ps();
+  for (int axis = 0; axis < 3; axis++) {
+    const __m128 origin = _mm_loadu_ps(packet->origin[axis]);
+    const __m128 idot = _mm_loadu_ps(packet->idot_axis[axis]);
+    const __m128 t_min = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bv[2 * axis]), origin), idot);
+    const __m128 t_max = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bv[2 * axis + 1]), origin), idot);
+    const __m128 t_axis_near = _mm_min_ps(t_min, t_max);
+    const __m128 t_axis_far = _mm_max_ps(t_min, t_max);
+    t_near = (axis == 0) ? t_axis_near : _mm_max_ps(t_near, t_axis_near);
+    t_far = (axis == 0) ? t_axis_far : _mm_min_ps(t_far, t_axis_far);
+  }
+  const __m128 hit = _mm_and_ps(
+      _mm_and_ps(_mm_cmple_ps(t_near, t_far), _mm_cmpge_ps(t_far, _mm_setzero_ps())),
+      _mm_cmplt_ps(t_near, _mm_loadu_ps(packet->hit_dist)));
+  return _mm_movemask_ps(hit) & packet->rays_mask;
+#else
+  int mask = 0;
+  for (int i = 0; i < BVH_RAYCAST_PACKET_SIZE; i++) {
+    if ((packet->rays_mask & (1 << i)) &&
+        fast_ray_nearest_hit(&packet->rays[i], node) < packet->hit_dist[i])
+    {
+      mask |= 1 << i;
+    }
+  }
+  return mask;
+#endif
+}
+
+/**
+ * Same test as #ray_nearest_hit for all rays in the packet, which supports a ray radius.
+ */
+static int ray_packet_hit_mask_radius(const BVHRayPacket *packet, const BVHNode *node)
+{
+  int mask = 0;
+  for (int i = 0; i < BVH_RAYCAST_PACKET_SIZE; i++) {
+    if ((packet->rays_mask & (1 << i)) &&
+        ray_nearest_hit(&packet->rays[i], node->bv) < packet->hit_dist[i])
+    {
+      mask |= 1 << i;
+    }
+  }
+  return mask;
+}
+
+static void dfs_raycast_packet(BVHRayPacket *packet,
+                               const BVHNode *node,
+                               const int parent_mask,
+                               const bool use_radius)
+{
+  const int mask = parent_mask & (use_radius ? ray_packet_hit_mask_radius(packet, node) :
+                                               ray_packet_hit_mask(packet, node));
+  if (mask == 0) {
+    return;
+  }
+
+  if (node->node_num == 0) {
+    for (int i = 0; i < BVH_RAYCAST_PACKET_SIZE; i++) {
+      if (mask & (1 << i)) {
+        /* Tests the leaf again, so the hit is exactly the same as when casting a single ray. */
+        dfs_raycast(&packet->rays[i], const_cast<BVHNode *>(node));
+        packet->hit_dist[i] = packet->rays[i].hit.dist;
+      }
+    }
+    return;
+  }
+
+  /* Pick the loop direction based on the direction of the first ray that hits the node. */
+  int first_ray = 0;
+  while (!(mask & (1 << first_ray))) {
+    first_ray++;
+  }
+  if (packet->rays[first_ray].ray_dot_axis[node->main_axis] > 0.0f) {
+    for (int i = 0; i != node->node_num; i++) {
+      dfs_raycast_packet(packet, node->children[i], mask, use_radius);
+    }
+  }
+  else {
+    for (int i = node->node_num - 1; i >= 0; i--) {
+      dfs_raycast_packet(packet, node->children[i], mask, use_radius);
+    }
+  }
+}
+
+void BLI_bvhtree_ray_cast_batch(const BVHTree *tree,
+                                const int rays_num,
+                                const float (*origins)[3],
+                                const float (*directions)[3],
+                                const float radius,
+                                BVHTreeRayHit *hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                const int flag)
+{
+  const BVHNode *root = tree->nodes[tree->leaf_num];
+  if (root == nullptr) {
+    return;
+  }
+
+  for (int start = 0; start < rays_num; start += BVH_RAYCAST_PACKET_SIZE) {
+    const int packet_size = std::min(BVH_RAYCAST_PACKET_SIZE, rays_num - start);
+
+    BVHRayPacket packet;
+    packet.rays_mask = (1 << packet_size) - 1;
+    for (int i = 0; i < BVH_RAYCAST_PACKET_SIZE; i++) {
+      /* Unused rays repeat the last ray, so they contain valid numbers. */
+      const int ray_index = start + std::min(i, packet_size - 1);
+      BVHRayCastData &data = packet.rays[i];
+
+      BLI_ASSERT_UNIT_V3(directions[ray_index]);
+
+      data.tree = tree;
+      data.callback = callback;
+      data.userdata = userdata;
+      copy_v3_v3(data.ray.origin, origins[ray_index]);
+      copy_v3_v3(data.ray.direction, directions[ray_index]);
+      data.ray.radius = radius;
+      bvhtree_ray_cast_data_precalc(&data, flag);
+      data.hit = hits[ray_index];
+
+      for (int axis = 0; axis < 3; axis++) {
+        packet.origin[axis][i] = data.ray.origin[axis];
+        packet.idot_axis[axis][i] = data.idot_axis[axis];
+      }
+      packet.hit_dist[i] = data.hit.dist;
+    }
+
+    dfs_raycast_packet(&packet, root, packet.rays_mask, radius != 0.0f);
+
+    for (int i = 0; i < packet_size; i++) {
+      hits[start + i] = packet.rays[i].hit;
+    }
+  }
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree_range_query
  *
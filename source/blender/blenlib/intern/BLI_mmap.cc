@@ -43,6 +43,9 @@ struct BLI_mmap_file {
    * within the signal handler, which is not part of the normal execution flow. */
   volatile bool io_error;
 
+  /* The mapped memory can be written to, see #BLI_mmap_open_copy_on_write. */
+  bool copy_on_write;
+
   /* Used to break out of infinite loops when an error keeps occurring.
    * See the comments in #try_handle_error_for_address for details. */
   size_t id;
@@ -81,7 +84,7 @@ static bool try_map_zeros(BLI_mmap_file *file);
 
 /* Find the file mapping containing the address and call #try_map_zeroes for it.
  * Returns true when execution can continue. */
-static bool try_handle_error_for_address(const void *address)
+static bool try_handle_error_for_address(const void *address, const bool is_write)
 {
   static thread_local size_t last_handled_file_id = -1;
 
@@ -100,6 +103,10 @@ static bool try_handle_error_for_address(const void *address)
     /* Not our error. */
     return false;
   }
+  if (is_write && !file->copy_on_write) {
+    /* Writing to a read-only mapping is not an IO error. */
+    return false;
+  }
 
   /* Check if we already handled this error. */
   if (file->io_error) {
@@ -190,9 +197,10 @@ static bool try_map_zeros(BLI_mmap_file *file)
 
   ULARGE_INTEGER length_ularge_int;
   length_ularge_int.QuadPart = file->length;
+  const ULONG protection = file->copy_on_write ? PAGE_READWRITE : PAGE_READONLY;
   file->handle = CreateFileMapping(INVALID_HANDLE_VALUE,
                                    nullptr,
-                                   PAGE_READONLY,
+                                   protection,
                                    length_ularge_int.HighPart,
                                    length_ularge_int.LowPart,
                                    nullptr);
@@ -206,7 +214,7 @@ static bool try_map_zeros(BLI_mmap_file *file)
                                      0,
                                      file->length,
                                      MEM_REPLACE_PLACEHOLDER,
-                                     PAGE_READONLY,
+                                     protection,
                                      nullptr,
                                      0);
   if (memory == nullptr) {
@@ -228,14 +236,12 @@ static LONG page_exception_handler(EXCEPTION_POINTERS *ExceptionInfo) noexcept
       ExceptionInfo->ExceptionRecord->ExceptionCode == EXCEPTION_ACCESS_VIOLATION)
   {
     if (ExceptionInfo->ExceptionRecord->NumberParameters >= 2) {
-      /* Currently, MMAP'd files are read only, so don't replace the mapping when a write is
-       * attempted. */
-      if (ExceptionInfo->ExceptionRecord->ExceptionInformation[0] == 1) {
-        return EXCEPTION_CONTINUE_SEARCH;
-      }
+      /* Only copy-on-write mappings can be written to, so the mapping is not replaced when a
+       * write to a read-only mapping is attempted. */
+      const bool is_write = ExceptionInfo->ExceptionRecord->ExceptionInformation[0] == 1;
       const void *address = reinterpret_cast<const void *>(
           ExceptionInfo->ExceptionRecord->ExceptionInformation[1]);
-      if (try_handle_error_for_address(address)) {
+      if (try_handle_error_for_address(address, is_write)) {
         return EXCEPTION_CONTINUE_EXECUTION;
       }
     }
@@ -285,8 +291,9 @@ static void print_error(const char *message)
 static bool try_map_zeros(BLI_mmap_file *file)
 {
   /* Replace the mapped memory with zeroes. */
+  const int protection = file->copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
   const void *mapped_memory = mmap(
-      file->memory, file->length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+      file->memory, file->length, protection, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
   if (mapped_memory == MAP_FAILED) {
     return false;
   }
@@ -301,7 +308,8 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr) noexcept
   /* We only handle SIGBUS here for now. */
   BLI_assert(sig == SIGBUS);
 
-  if (try_handle_error_for_address(siginfo->si_addr)) {
+  /* A bus error is never caused by writing to a read-only mapping. */
+  if (try_handle_error_for_address(siginfo->si_addr, false)) {
     return;
   }
 
@@ -366,7 +374,7 @@ static void error_handler_remove(BLI_mmap_file *file)
   open_mmaps_vector().remove_first_occurrence_and_reorder(file);
 }
 
-BLI_mmap_file *BLI_mmap_open(int fd)
+static BLI_mmap_file *mmap_open(const int fd, const bool copy_on_write)
 {
   static std::atomic_size_t id_counter = 0;
 
@@ -388,7 +396,8 @@ BLI_mmap_file *BLI_mmap_open(int fd)
 
 #ifndef WIN32
   /* Map the given file to memory. */
-  memory = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  const int protection = copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+  memory = mmap(nullptr, length, protection, MAP_PRIVATE, fd, 0);
   if (memory == MAP_FAILED) {
     return nullptr;
   }
@@ -399,8 +408,8 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   /* Memory mapping on Windows is a multi-step process - first we create a placeholder
    * allocation. Then we create a mapping, and after that we create a view into that mapping
    * on top of the placeholder. In our case, one view that spans the entire file is enough.
-   * NOTE: Changes to protection flags should also be reflected in #try_map_zeros. If write
-   * support is added, the write check in #page_exception_handler should be updated. */
+   * NOTE: Changes to protection flags should also be reflected in #try_map_zeros. */
+  const ULONG protection = copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY;
   if (mmap_MapViewOfFile3 && mmap_VirtualAlloc2) {
     memory = mmap_VirtualAlloc2(nullptr,
                                 nullptr,
@@ -413,7 +422,7 @@ BLI_mmap_file *BLI_mmap_open(int fd)
       return nullptr;
     }
 
-    handle = CreateFileMapping(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    handle = CreateFileMapping(file_handle, nullptr, protection, 0, 0, nullptr);
     if (handle == nullptr) {
       VirtualFree(memory, 0, MEM_RELEASE);
       return nullptr;
@@ -425,7 +434,7 @@ BLI_mmap_file *BLI_mmap_open(int fd)
                             0,
                             length,
                             MEM_REPLACE_PLACEHOLDER,
-                            PAGE_READONLY,
+                            protection,
                             nullptr,
                             0) == nullptr)
     {
@@ -437,12 +446,12 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   else {
     /* Fallback without error handling in case `MapViewOfFile3` or `VirtualAlloc2` is not
      * available. */
-    handle = CreateFileMapping(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    handle = CreateFileMapping(file_handle, nullptr, protection, 0, 0, nullptr);
     if (handle == nullptr) {
       return nullptr;
     }
 
-    memory = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+    memory = MapViewOfFile(handle, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
     if (memory == nullptr) {
       CloseHandle(handle);
       return nullptr;
@@ -456,6 +465,7 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   file->handle = handle;
   file->length = length;
   file->id = id_counter++;
+  file->copy_on_write = copy_on_write;
 
   /* Register the file with the error handler. */
   error_handler_add(file);
@@ -463,6 +473,16 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   return file;
 }
 
+BLI_mmap_file *BLI_mmap_open(int fd)
+{
+  return mmap_open(fd, false);
+}
+
+BLI_mmap_file *BLI_mmap_open_copy_on_write(int fd)
+{
+  return mmap_open(fd, true);
+}
+
 bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length)
 {
   /* If a previous read has already failed or we try to read past the end,
@@ -7,16 +7,84 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
 #include <zstd.h>
 
+#include "BLI_array.hh"
 #include "BLI_fileops.hh"
 #include "BLI_filereader.hh"
+#include "BLI_task_c.hh"
 
 #include "MEM_guardedalloc.h"
 
 namespace blender {
 
+/**
+ * Upper bound for the amount of decoded frames kept around by the prefetching reader.
+ * Frames written by Blender are about 1 MB each (see `ZSTD_CHUNK_SIZE` in `writefile.cc`).
+ */
+#define ZSTD_PREFETCH_FRAMES_MAX 32
+
+/**
+ * Amount of consecutive frames that have to be read in order before prefetching starts, so that
+ * reads alternating between seeks and a few blocks do not keep starting and stopping it.
+ */
+#define ZSTD_PREFETCH_SEQUENTIAL_FRAMES 2
+
+enum eZstdFrameState {
+  /** The slot does not hold a frame, or its task was abandoned. */
+  ZSTD_FRAME_EMPTY = 0,
+  /** Compressed data is loaded, decompression has not started yet. */
+  ZSTD_FRAME_QUEUED,
+  /** Decompression is in progress, either on a worker or the reading thread. */
+  ZSTD_FRAME_RUNNING,
+  ZSTD_FRAME_DONE,
+  ZSTD_FRAME_FAILED,
+};
+
+/** One entry in the ring of frames that are decompressed ahead of the reader. */
+struct ZstdFrameSlot {
+  /** Every slot has its own context so that slots can be decompressed in parallel. */
+  ZSTD_DCtx *ctx = nullptr;
+  int frame = -1;
+  std::atomic<int> state = ZSTD_FRAME_EMPTY;
+
+  char *compressed_data = nullptr;
+  size_t compressed_size = 0;
+  char *uncompressed_data = nullptr;
+  size_t uncompressed_size = 0;
+
+  /** Allocated size of the buffers, they are reused for following frames that fit. */
+  size_t compressed_capacity = 0;
+  size_t uncompressed_capacity = 0;
+};
+
+/**
+ * Decompresses frames following the current read position on the task pool.
+ *
+ * Frame `i` always lives in `slots[i % slots_num]`, so the ring covers the frame that is
+ * currently being read plus the frames directly following it. The compressed data is read on the
+ * calling thread (the base reader is not thread-safe), only the decompression runs on workers.
+ *
+ * Whoever changes the state of a slot from #ZSTD_FRAME_QUEUED to #ZSTD_FRAME_RUNNING does the
+ * work. This lets the reading thread take over frames that no worker picked up yet instead of
+ * waiting for them, and makes tasks of recycled slots harmless.
+ */
+struct ZstdPrefetch {
+  TaskPool *task_pool = nullptr;
+  Array<ZstdFrameSlot> slots;
+  int slots_num = 0;
+  /** The frame that was requested last, used to detect seeks away from the prefetched range. */
+  int last_frame = -1;
+
+  /** Protects waiting for #ZSTD_FRAME_RUNNING slots to finish. */
+  std::mutex mutex;
+  std::condition_variable cond;
+};
+
 struct ZstdReader {
   FileReader reader;
 
@@ -33,6 +101,11 @@ struct ZstdReader {
 
     char *cached_content;
     int cached_frame;
+    /** Number of times in a row the cached frame was replaced by the frame following it. */
+    int sequential_frames;
+
+    /** Created once the file is read sequentially, see #zstd_prefetch_should_start. */
+    ZstdPrefetch *prefetch;
   } seek;
 };
 
@@ -155,6 +228,17 @@ static int zstd_frame_from_pos(ZstdReader *zstd, size_t pos)
   return low;
 }
 
+static bool zstd_frame_decompress(ZSTD_DCtx *ctx,
+                                  char *uncompressed_data,
+                                  const size_t uncompressed_size,
+                                  const char *compressed_data,
+                                  const size_t compressed_size)
+{
+  const size_t res = ZSTD_decompressDCtx(
+      ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
+  return !ZSTD_isError(res) && res >= uncompressed_size;
+}
+
 /* Ensure that the currently loaded frame is the correct one. */
 static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
 {
@@ -180,10 +264,10 @@ static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
     return nullptr;
   }
 
-  size_t res = ZSTD_decompressDCtx(
+  const bool ok = zstd_frame_decompress(
       zstd->ctx, uncompressed_data, uncompressed_size, compressed_data, compressed_size);
   MEM_delete(compressed_data);
-  if (ZSTD_isError(res) || res < uncompressed_size) {
+  if (!ok) {
     MEM_delete(uncompressed_data);
     return nullptr;
   }
@@ -193,6 +277,233 @@ static const char *zstd_ensure_cache(ZstdReader *zstd, int frame)
   return uncompressed_data;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Frame Prefetching
+ * \{ */
+
+/** Decompress a slot that was claimed by the calling thread and wake up anyone waiting on it. */
+static void zstd_prefetch_slot_run(ZstdPrefetch *prefetch, ZstdFrameSlot *slot)
+{
+  const bool ok = zstd_frame_decompress(slot->ctx,
+                                        slot->uncompressed_data,
+                                        slot->uncompressed_size,
+                                        slot->compressed_data,
+                                        slot->compressed_size);
+  {
+    std::lock_guard lock(prefetch->mutex);
+    slot->state.store(ok ? ZSTD_FRAME_DONE : ZSTD_FRAME_FAILED, std::memory_order_release);
+  }
+  prefetch->cond.notify_all();
+}
+
+static bool zstd_prefetch_slot_claim(ZstdFrameSlot *slot)
+{
+  int expected = ZSTD_FRAME_QUEUED;
+  return slot->state.compare_exchange_strong(
+      expected, ZSTD_FRAME_RUNNING, std::memory_order_acq_rel);
+}
+
+static void zstd_prefetch_task(TaskPool *__restrict pool, void *taskdata)
+{
+  ZstdPrefetch *prefetch = static_cast<ZstdPrefetch *>(BLI_task_pool_user_data(pool));
+  ZstdFrameSlot *slot = static_cast<ZstdFrameSlot *>(taskdata);
+  if (zstd_prefetch_slot_claim(slot)) {
+    zstd_prefetch_slot_run(prefetch, slot);
+  }
+}
+
+/** Make sure no worker is using the slot anymore, so that it can be refilled or freed. */
+static void zstd_prefetch_slot_release(ZstdPrefetch *prefetch, ZstdFrameSlot *slot)
+{
+  int expected = ZSTD_FRAME_QUEUED;
+  if (!slot->state.compare_exchange_strong(expected, ZSTD_FRAME_EMPTY, std::memory_order_acq_rel))
+  {
+    std::unique_lock lock(prefetch->mutex);
+    prefetch->cond.wait(lock, [&]() {
+      return slot->state.load(std::memory_order_acquire) != ZSTD_FRAME_RUNNING;
+    });
+  }
+  slot->frame = -1;
+}
+
+/** Load the compressed data of `frame` into its slot and queue its decompression. */
+static bool zstd_prefetch_slot_fill(ZstdReader *zstd, const int frame)
+{
+  ZstdPrefetch *prefetch = zstd->seek.prefetch;
+  ZstdFrameSlot *slot = &prefetch->slots[frame % prefetch->slots_num];
+  if (slot->frame == frame) {
+    return true;
+  }
+  zstd_prefetch_slot_release(prefetch, slot);
+
+  const size_t compressed_size = zstd->seek.compressed_ofs[frame + 1] -
+                                 zstd->seek.compressed_ofs[frame];
+  const size_t uncompressed_size = zstd->seek.uncompressed_ofs[frame + 1] -
+                                   zstd->seek.uncompressed_ofs[frame];
+
+  /* Buffers are reused as long as they are large enough, all frames but the last one
+   * written by Blender have the same size. */
+  if (slot->compressed_capacity < compressed_size) {
+    MEM_SAFE_DELETE(slot->compressed_data);
+    slot->compressed_data = MEM_new_array_uninitialized<char>(compressed_size, __func__);
+    slot->compressed_capacity = compressed_size;
+  }
+  if (slot->uncompressed_capacity < uncompressed_size) {
+    MEM_SAFE_DELETE(slot->uncompressed_data);
+    slot->uncompressed_data = MEM_new_array_uninitialized<char>(uncompressed_size, __func__);
+    slot->uncompressed_capacity = uncompressed_size;
+  }
+  slot->compressed_size = compressed_size;
+  slot->uncompressed_size = uncompressed_size;
+
+  if (zstd->base->seek(zstd->base, zstd->seek.compressed_ofs[frame], SEEK_SET) < 0 ||
+      zstd->base->read(zstd->base, slot->compressed_data, compressed_size) < compressed_size)
+  {
+    return false;
+  }
+
+  slot->frame = frame;
+  slot->state.store(ZSTD_FRAME_QUEUED, std::memory_order_release);
+  BLI_task_pool_push(prefetch->task_pool, zstd_prefetch_task, slot, false, nullptr);
+  return true;
+}
+
+/**
+ * Only start prefetching once the file is read front to back, reading just the header or a few
+ * blocks (e.g. for thumbnails or linking) should not decompress the whole file.
+ */
+static bool zstd_prefetch_should_start(const ZstdReader *zstd, const int frame)
+{
+  if (zstd->seek.cached_frame < 0 || frame != zstd->seek.cached_frame + 1) {
+    return false;
+  }
+  if (zstd->seek.sequential_frames + 1 < ZSTD_PREFETCH_SEQUENTIAL_FRAMES) {
+    return false;
+  }
+  if (zstd->seek.frames_num - frame < 2) {
+    return false;
+  }
+  return BLI_task_scheduler_num_threads() > 1;
+}
+
+static void zstd_prefetch_start(ZstdReader *zstd)
+{
+  ZstdPrefetch *prefetch = MEM_new<ZstdPrefetch>(__func__);
+  prefetch->slots_num = std::clamp(
+      BLI_task_scheduler_num_threads() * 2, 2, ZSTD_PREFETCH_FRAMES_MAX);
+  prefetch->slots_num = std::min(prefetch->slots_num, zstd->seek.frames_num);
+  prefetch->slots.reinitialize(prefetch->slots_num);
+  for (int i = 0; i < prefetch->slots_num; i++) {
+    prefetch->slots[i].ctx = ZSTD_createDCtx();
+  }
+  prefetch->task_pool = BLI_task_pool_create(prefetch, TASK_PRIORITY_HIGH);
+
+  /* The single cached frame is not used anymore from now on. */
+  prefetch->last_frame = zstd->seek.cached_frame;
+  MEM_SAFE_DELETE(zstd->seek.cached_content);
+  zstd->seek.cached_frame = -1;
+  zstd->seek.sequential_frames = 0;
+  zstd->seek.prefetch = prefetch;
+}
+
+static void zstd_prefetch_free(ZstdPrefetch *prefetch)
+{
+  /* Abandon all frames that have not started yet, so waiting on the pool is quick. */
+  for (int i = 0; i < prefetch->slots_num; i++) {
+    int expected = ZSTD_FRAME_QUEUED;
+    prefetch->slots[i].state.compare_exchange_strong(expected, ZSTD_FRAME_EMPTY);
+  }
+  BLI_task_pool_work_and_wait(prefetch->task_pool);
+  BLI_task_pool_free(prefetch->task_pool);
+
+  for (int i = 0; i < prefetch->slots_num; i++) {
+    ZstdFrameSlot &slot = prefetch->slots[i];
+    ZSTD_freeDCtx(slot.ctx);
+    MEM_SAFE_DELETE(slot.compressed_data);
+    MEM_SAFE_DELETE(slot.uncompressed_data);
+  }
+  MEM_delete(prefetch);
+}
+
+/**
+ * Whether `frame` continues the sequential read the ring was filled for. Skipping ahead within
+ * the ring is fine (e.g. skipped blocks), anything else would discard most prefetched frames.
+ */
+static bool zstd_prefetch_is_sequential(const ZstdPrefetch *prefetch, const int frame)
+{
+  return frame >= prefetch->last_frame && frame < prefetch->last_frame + prefetch->slots_num;
+}
+
+/** Get the decompressed content of `frame` and queue the frames following it. */
+static const char *zstd_prefetch_ensure(ZstdReader *zstd, const int frame)
+{
+  ZstdPrefetch *prefetch = zstd->seek.prefetch;
+  ZstdFrameSlot *slot = &prefetch->slots[frame % prefetch->slots_num];
+
+  prefetch->last_frame = frame;
+  if (!zstd_prefetch_slot_fill(zstd, frame)) {
+    slot->frame = -1;
+    return nullptr;
+  }
+
+  /* Do the work directly if no worker got to it yet, otherwise wait for the worker. */
+  if (zstd_prefetch_slot_claim(slot)) {
+    zstd_prefetch_slot_run(prefetch, slot);
+  }
+  else if (slot->state.load(std::memory_order_acquire) == ZSTD_FRAME_RUNNING) {
+    std::unique_lock lock(prefetch->mutex);
+    prefetch->cond.wait(lock, [&]() {
+      return slot->state.load(std::memory_order_acquire) != ZSTD_FRAME_RUNNING;
+    });
+  }
+
+  if (slot->state.load(std::memory_order_acquire) != ZSTD_FRAME_DONE) {
+    slot->frame = -1;
+    return nullptr;
+  }
+
+  /* Refill the rest of the ring. This never touches the slot of `frame` itself. */
+  const int last_frame = std::min(frame + prefetch->slots_num, zstd->seek.frames_num) - 1;
+  for (int next = frame + 1; next <= last_frame; next++) {
+    if (!zstd_prefetch_slot_fill(zstd, next)) {
+      /* Errors are reported once the frame is actually requested. */
+      prefetch->slots[next % prefetch->slots_num].frame = -1;
+      break;
+    }
+  }
+
+  return slot->uncompressed_data;
+}
+
+/** \} */
+
+static const char *zstd_frame_content(ZstdReader *zstd, int frame)
+{
+  if (zstd->seek.prefetch && !zstd_prefetch_is_sequential(zstd->seek.prefetch, frame)) {
+    /* Random access after a sequential read, stop decompressing ahead until the reads become
+     * sequential again. */
+    zstd_prefetch_free(zstd->seek.prefetch);
+    zstd->seek.prefetch = nullptr;
+  }
+  if (zstd->seek.prefetch == nullptr && zstd->seek.cached_frame != frame) {
+    if (zstd->seek.cached_frame >= 0 && frame == zstd->seek.cached_frame + 1) {
+      if (zstd_prefetch_should_start(zstd, frame)) {
+        zstd_prefetch_start(zstd);
+      }
+      else {
+        zstd->seek.sequential_frames++;
+      }
+    }
+    else {
+      zstd->seek.sequential_frames = 0;
+    }
+  }
+  if (zstd->seek.prefetch) {
+    return zstd_prefetch_ensure(zstd, frame);
+  }
+  return zstd_ensure_cache(zstd, frame);
+}
+
 static int64_t zstd_read_seekable(FileReader *reader, void *buffer, size_t size)
 {
   ZstdReader *zstd = reinterpret_cast<ZstdReader *>(reader);
@@ -205,7 +516,7 @@ static int64_t zstd_read_seekable(FileReader *reader, void *buffer, size_t size)
       break;
     }
 
-    const char *framedata = zstd_ensure_cache(zstd, frame);
+    const char *framedata = zstd_frame_content(zstd, frame);
     if (framedata == nullptr) {
       /* Error while reading the frame, so return as much as we can. */
       break;
@@ -287,6 +598,9 @@ static void zstd_close(FileReader *reader)
     if (zstd->seek.cached_content) {
       MEM_delete(zstd->seek.cached_content);
     }
+    if (zstd->seek.prefetch) {
+      zstd_prefetch_free(zstd->seek.prefetch);
+    }
   }
   else {
     MEM_delete(static_cast<const std::byte *>(zstd->in_buf.src));
@@ -7,12 +7,35 @@
  */
 
 #include <atomic>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
 #include <optional>
+#include <sys/stat.h>
+#ifndef WIN32
+#  include <unistd.h>
+#else
+#  include <io.h>
+#endif
+#include <fmt/format.h>
+
+#include "MEM_guardedalloc.h"
 
 #include "BLI_concurrent_map.hh"
+#include "BLI_fileops.hh"
+#include "BLI_fileops_types.hh"
+#include "BLI_hash.hh"
+#include "BLI_map.hh"
 #include "BLI_memory_cache.hh"
 #include "BLI_memory_counter.hh"
+#include "BLI_mmap.hh"
 #include "BLI_mutex.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_system.hh"
+#include "BLI_task.hh"
+#include "BLI_task_c.hh"
+
+#include BLI_SYSTEM_PID_H
 
 namespace blender::memory_cache {
 
@@ -61,6 +84,385 @@ static Cache &get_cache()
 
 static void try_enforce_limit();
 
+/* -------------------------------------------------------------------- */
+/** \name Disk Tier
+ *
+ * Values which are freed from memory can be written to files in a directory, from which they are
+ * read again when they are requested later on. Every file starts with a header which contains the
+ * persistent identifier of the key, followed by the data written by #CachedValue::write_to_disk.
+ * The file name is derived from the hash of the identifier, and the identifier in the header is
+ * used to detect hash collisions. The least recently used files are removed when the files use
+ * more than the size limit. The modification time of the files is used as last use time, so that
+ * the order is kept across sessions.
+ *
+ * The mutex of the disk tier only protects the file bookkeeping, files are read and written
+ * without holding it. Values freed from memory are written in a background task, so that the
+ * thread that added a value to the cache is not blocked by writing the values it evicted.
+ * \{ */
+
+static constexpr StringRef disk_file_extension = ".blcache";
+/** Written at the start of every file. Has to be changed when the header layout changes. */
+static constexpr StringRef disk_file_magic = "BLMEMCACHE1";
+
+struct DiskFile {
+  int64_t size_in_bytes = 0;
+  /** Time in seconds when the file was last used. Lower values are older. */
+  int64_t last_use_time = 0;
+};
+
+struct DiskCache {
+  /** Allows checking if the disk tier is used without locking the mutex. */
+  std::atomic<bool> enabled = false;
+
+  Mutex mutex;
+  /** Directory that contains the files. Empty when the disk tier is disabled. */
+  std::string directory;
+  int64_t size_limit = 0;
+  int64_t size_in_bytes = 0;
+  /** All files in the directory, by their file name. */
+  Map<std::string, DiskFile> files;
+
+  Mutex write_pool_mutex;
+  /** Writes the values that are freed from memory, created on demand. */
+  TaskPool *write_pool = nullptr;
+};
+
+static DiskCache &get_disk_cache()
+{
+  static DiskCache disk_cache;
+  return disk_cache;
+}
+
+static std::string disk_file_name(const StringRef identifier)
+{
+  return fmt::format("{:016x}{}", hash_string(identifier), disk_file_extension);
+}
+
+static std::string disk_file_path(const DiskCache &disk_cache, const StringRef file_name)
+{
+  char path[FILE_MAX];
+  BLI_path_join(path, sizeof(path), disk_cache.directory.c_str(), std::string(file_name).c_str());
+  return path;
+}
+
+static int64_t current_disk_time()
+{
+  return int64_t(std::time(nullptr));
+}
+
+static void remove_disk_file(DiskCache &disk_cache, const StringRef file_name)
+{
+  const std::string path = disk_file_path(disk_cache, file_name);
+  BLI_delete(path.c_str(), false, false);
+  disk_cache.size_in_bytes -= disk_cache.files.pop_as(file_name).size_in_bytes;
+}
+
+static void enforce_disk_limit(DiskCache &disk_cache)
+{
+  if (disk_cache.size_in_bytes <= disk_cache.size_limit) {
+    return;
+  }
+  Vector<std::pair<int64_t, std::string>> files_with_time;
+  for (const auto item : disk_cache.files.items()) {
+    files_with_time.append({item.value.last_use_time, item.key});
+  }
+  /* Sort the files so that the oldest ones come first. */
+  std::ranges::sort(files_with_time);
+  for (const std::pair<int64_t, std::string> &item : files_with_time) {
+    if (disk_cache.size_in_bytes <= disk_cache.size_limit) {
+      break;
+    }
+    remove_disk_file(disk_cache, item.second);
+  }
+}
+
+/** Find the files that have been written in previous sessions. */
+static bool scan_disk_cache_directory(DiskCache &disk_cache)
+{
+  if (!BLI_dir_create_recursive(disk_cache.directory.c_str())) {
+    return false;
+  }
+  direntry *entries = nullptr;
+  const uint entries_num = BLI_filelist_dir_contents(disk_cache.directory.c_str(), &entries);
+  for (const direntry &entry : Span(entries, entries_num)) {
+    if (!S_ISREG(entry.type)) {
+      continue;
+    }
+    const StringRef file_name = entry.relname;
+    if (file_name.endswith(disk_file_extension)) {
+      const int64_t size = int64_t(entry.s.st_size);
+      disk_cache.files.add_as(file_name, DiskFile{size, int64_t(entry.s.st_mtime)});
+      disk_cache.size_in_bytes += size;
+    }
+    else if (file_name.endswith(".tmp") && file_name.find(disk_file_extension) != -1) {
+      /* Left over from a session that did not finish writing the file. */
+      BLI_delete(entry.path, false, false);
+    }
+  }
+  BLI_filelist_free(entries, entries_num);
+  return true;
+}
+
+void set_disk_cache(const StringRef directory, const int64_t size_limit_in_bytes)
+{
+  DiskCache &disk_cache = get_disk_cache();
+  std::lock_guard lock{disk_cache.mutex};
+
+  const std::string new_directory = size_limit_in_bytes > 0 ? std::string(directory) : "";
+  if (new_directory != disk_cache.directory) {
+    disk_cache.directory = new_directory;
+    disk_cache.files.clear();
+    disk_cache.size_in_bytes = 0;
+    if (!disk_cache.directory.empty() && !scan_disk_cache_directory(disk_cache)) {
+      /* The directory can't be used. */
+      disk_cache.directory.clear();
+    }
+  }
+  disk_cache.size_limit = size_limit_in_bytes;
+  disk_cache.enabled = !disk_cache.directory.empty();
+  enforce_disk_limit(disk_cache);
+}
+
+/**
+ * Returns the part of the file data that was written by #CachedValue::write_to_disk, or nothing
+ * if the header does not match.
+ */
+static std::optional<Span<std::byte>> parse_disk_file_header(const Span<std::byte> data,
+                                                             const StringRef identifier)
+{
+  const int64_t identifier_offset = disk_file_magic.size() + sizeof(uint64_t);
+  const int64_t header_size = identifier_offset + identifier.size();
+  if (data.size() < header_size) {
+    return std::nullopt;
+  }
+  const char *header = reinterpret_cast<const char *>(data.data());
+  if (StringRef(header, disk_file_magic.size()) != disk_file_magic) {
+    return std::nullopt;
+  }
+  uint64_t identifier_size;
+  memcpy(&identifier_size, header + disk_file_magic.size(), sizeof(uint64_t));
+  if (identifier_size != uint64_t(identifier.size()) ||
+      StringRef(header + identifier_offset, identifier.size()) != identifier)
+  {
+    /* The file belongs to a different key with the same hash. */
+    return std::nullopt;
+  }
+  return data.drop_front(header_size);
+}
+
+using ReadFn = FunctionRef<std::unique_ptr<CachedValue>(Span<std::byte> data)>;
+
+static std::unique_ptr<CachedValue> read_disk_file_data(const StringRefNull path,
+                                                        const StringRef identifier,
+                                                        const ReadFn read_fn)
+{
+  const int file = BLI_open(path.c_str(), O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    return nullptr;
+  }
+  BLI_SCOPED_DEFER([&]() { close(file); });
+
+  /* Memory map the file, so that only the data which is actually used by #read_fn is read, and
+   * it is not copied another time. */
+  BLI_mmap_file *mmap_file = BLI_mmap_open(file);
+  if (!mmap_file) {
+    return nullptr;
+  }
+  BLI_SCOPED_DEFER([&]() { BLI_mmap_free(mmap_file); });
+  const Span<std::byte> data(static_cast<const std::byte *>(BLI_mmap_get_pointer(mmap_file)),
+                             int64_t(BLI_mmap_get_length(mmap_file)));
+  const std::optional<Span<std::byte>> value_data = parse_disk_file_header(data, identifier);
+  if (!value_data) {
+    return nullptr;
+  }
+  std::unique_ptr<CachedValue> value = read_fn(*value_data);
+  if (BLI_mmap_any_io_error(mmap_file)) {
+    return nullptr;
+  }
+  return value;
+}
+
+static std::unique_ptr<CachedValue> read_from_disk(const GenericKey &key, const ReadFn read_fn)
+{
+  DiskCache &disk_cache = get_disk_cache();
+  if (!disk_cache.enabled.load(std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  const std::optional<std::string> identifier = key.persistent_identifier();
+  if (!identifier) {
+    return nullptr;
+  }
+  const std::string file_name = disk_file_name(*identifier);
+
+  std::string path;
+  {
+    std::lock_guard lock{disk_cache.mutex};
+    if (!disk_cache.files.contains(file_name)) {
+      return nullptr;
+    }
+    path = disk_file_path(disk_cache, file_name);
+  }
+
+  /* The file may be removed while it is read, which just makes opening or mapping it fail. */
+  std::unique_ptr<CachedValue> value = read_disk_file_data(path, *identifier, read_fn);
+
+  std::lock_guard lock{disk_cache.mutex};
+  DiskFile *file = disk_cache.files.lookup_ptr(file_name);
+  if (!file || path != disk_file_path(disk_cache, file_name)) {
+    /* The file has been removed or the directory changed in the mean time. */
+    return value;
+  }
+  if (!value) {
+    /* The file is invalid or belongs to a different key, so it's not useful anymore. */
+    remove_disk_file(disk_cache, file_name);
+    return nullptr;
+  }
+  file->last_use_time = current_disk_time();
+  BLI_file_touch(path.c_str());
+  return value;
+}
+
+static void write_disk_file(DiskCache &disk_cache,
+                            const StringRef identifier,
+                            const CachedValue &value)
+{
+  const std::string file_name = disk_file_name(identifier);
+  std::string path;
+  {
+    std::lock_guard lock{disk_cache.mutex};
+    if (disk_cache.directory.empty()) {
+      return;
+    }
+    if (DiskFile *file = disk_cache.files.lookup_ptr(file_name)) {
+      /* The value has been read from the disk or written already. */
+      file->last_use_time = current_disk_time();
+      return;
+    }
+    path = disk_file_path(disk_cache, file_name);
+  }
+
+  /* Write to a temporary file first, so that readers never see partial files. The same value may
+   * be written by multiple threads or Blender instances at the same time. */
+  static std::atomic<int> temp_file_counter = 0;
+  const std::string temp_path = fmt::format(
+      "{}.{}-{}.tmp", path, int(getpid()), temp_file_counter.fetch_add(1));
+  bool success = false;
+  {
+    fstream stream{temp_path, std::ios::out | std::ios::binary};
+    if (!stream) {
+      return;
+    }
+    const uint64_t identifier_size = identifier.size();
+    stream.write(disk_file_magic.data(), disk_file_magic.size());
+    stream.write(reinterpret_cast<const char *>(&identifier_size), sizeof(uint64_t));
+    stream.write(identifier.data(), identifier.size());
+    success = value.write_to_disk(stream) && stream.good();
+  }
+  if (!success || BLI_rename_overwrite(temp_path.c_str(), path.c_str()) != 0) {
+    BLI_delete(temp_path.c_str(), false, false);
+    return;
+  }
+  const int64_t size = int64_t(BLI_file_size(path.c_str()));
+
+  std::lock_guard lock{disk_cache.mutex};
+  if (path != disk_file_path(disk_cache, file_name) || disk_cache.files.contains(file_name)) {
+    /* The directory changed in the mean time, the file is found when it is used again. */
+    return;
+  }
+  if (size > disk_cache.size_limit) {
+    /* Don't remove all other files for a value that does not fit anyway. */
+    BLI_delete(path.c_str(), false, false);
+    return;
+  }
+  disk_cache.files.add_new(file_name, {size, current_disk_time()});
+  disk_cache.size_in_bytes += size;
+  enforce_disk_limit(disk_cache);
+}
+
+using ValueToWrite = std::pair<std::string, std::shared_ptr<CachedValue>>;
+
+static void write_to_disk(const Span<ValueToWrite> values)
+{
+  DiskCache &disk_cache = get_disk_cache();
+  for (const ValueToWrite &value : values) {
+    write_disk_file(disk_cache, value.first, *value.second);
+  }
+}
+
+static void write_to_disk_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  write_to_disk(*static_cast<const Vector<ValueToWrite> *>(taskdata));
+}
+
+static void write_to_disk_task_free(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  MEM_delete(static_cast<Vector<ValueToWrite> *>(taskdata));
+}
+
+/** Write the values in a background task, the values are kept alive until they are written. */
+static void write_to_disk_in_background(Vector<ValueToWrite> values)
+{
+  if (values.is_empty()) {
+    return;
+  }
+  DiskCache &disk_cache = get_disk_cache();
+  std::lock_guard lock{disk_cache.write_pool_mutex};
+  if (disk_cache.write_pool == nullptr) {
+    disk_cache.write_pool = BLI_task_pool_create_background_serial(nullptr, TASK_PRIORITY_LOW);
+  }
+  BLI_task_pool_push(disk_cache.write_pool,
+                     write_to_disk_task,
+                     MEM_new<Vector<ValueToWrite>>(__func__, std::move(values)),
+                     false,
+                     write_to_disk_task_free);
+}
+
+/** Wait until the values freed from memory are written. */
+static void wait_for_background_writes()
+{
+  DiskCache &disk_cache = get_disk_cache();
+  std::lock_guard lock{disk_cache.write_pool_mutex};
+  if (disk_cache.write_pool) {
+    BLI_task_pool_work_and_wait(disk_cache.write_pool);
+    BLI_task_pool_free(disk_cache.write_pool);
+    disk_cache.write_pool = nullptr;
+  }
+}
+
+/**
+ * Gather the persistent identifier of the key if the value should be written to the disk tier
+ * when it's freed. Must be called while the global mutex of the cache is locked.
+ */
+static void gather_value_to_write(const StoredValue &stored_value, Vector<ValueToWrite> &r_values)
+{
+  if (!get_disk_cache().enabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+  if (std::optional<std::string> identifier = stored_value.key->persistent_identifier()) {
+    r_values.append({std::move(*identifier), stored_value.value});
+  }
+}
+
+void flush_to_disk()
+{
+  Cache &cache = get_cache();
+  Vector<ValueToWrite> values;
+  {
+    std::lock_guard lock{cache.global_mutex};
+    for (const GenericKey *key : cache.keys) {
+      CacheMap::ConstAccessor accessor;
+      if (cache.map.lookup(accessor, *key)) {
+        gather_value_to_write(accessor->second, values);
+      }
+    }
+  }
+  /* Files written by the background task don't have to be written again. */
+  wait_for_background_writes();
+  write_to_disk(values);
+}
+
+/** \} */
+
 static void set_new_logical_time(const StoredValue &stored_value, const int64_t new_time)
 {
   /* Don't want to use `std::atomic` directly in the struct, because that makes it
@@ -72,7 +474,8 @@ static void set_new_logical_time(const StoredValue &stored_value, const int64_t
 }
 
 std::shared_ptr<CachedValue> get_base(const GenericKey &key,
-                                      const FunctionRef<std::unique_ptr<CachedValue>()> compute_fn)
+                                      const FunctionRef<std::unique_ptr<CachedValue>()> compute_fn,
+                                      const ReadFn read_fn)
 {
   Cache &cache = get_cache();
   /* "Touch" the cached value so that we know that it is still used. This makes it less likely that
@@ -89,8 +492,15 @@ std::shared_ptr<CachedValue> get_base(const GenericKey &key,
 
   /* Compute value while no locks are held to avoid potential for dead-locks. Not using a lock also
    * means that the value may be computed more than once, but that's still better than locking all
-   * the time. It may be possible to implement something smarter in the future. */
-  std::shared_ptr<CachedValue> result = compute_fn();
+   * the time. It may be possible to implement something smarter in the future. Reading the value
+   * from the disk tier is done under the same assumption. */
+  std::shared_ptr<CachedValue> result;
+  if (read_fn) {
+    result = read_from_disk(key, read_fn);
+  }
+  if (!result) {
+    result = compute_fn();
+  }
   /* Result should be valid. Use exception to propagate error if necessary. */
   BLI_assert(result);
 
@@ -191,7 +601,7 @@ static void try_enforce_limit()
     return;
   }
 
-  std::lock_guard lock{cache.global_mutex};
+  std::unique_lock lock{cache.global_mutex};
 
   /* Gather all the keys with their latest usage times. */
   Vector<std::pair<int64_t, const GenericKey *>> keys_with_time;
@@ -247,9 +657,17 @@ static void try_enforce_limit()
     need_memory_recount = true;
   }
 
-  /* Remove elements that don't fit anymore. */
+  /* Remove elements that don't fit anymore. They are written to the disk tier of the cache in the
+   * background, because that can take a while. */
+  Vector<ValueToWrite> values_to_write;
   for (const int i : keys_with_time.index_range().drop_front(*first_bad_index)) {
     const GenericKey &key = *keys_with_time[i].second;
+    {
+      CacheMap::ConstAccessor accessor;
+      if (cache.map.lookup(accessor, key)) {
+        gather_value_to_write(accessor->second, values_to_write);
+      }
+    }
     cache.map.remove(key);
   }
 
@@ -274,6 +692,9 @@ static void try_enforce_limit()
     }
   }
   cache.size_in_bytes = cache.memory.total_bytes;
+  lock.unlock();
+
+  write_to_disk_in_background(std::move(values_to_write));
 }
 
 }  // namespace blender::memory_cache
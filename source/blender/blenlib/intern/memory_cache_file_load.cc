@@ -27,10 +27,20 @@ class LoadFileKey : public GenericKey {
    * which can result in different data that needs to be cached separately.
    */
   std::shared_ptr<const GenericKey> loader_key_;
+  /**
+   * Modification times of the files when the key was created. They are not part of the key
+   * equality, because outdated values are removed from the cache when a file changes, but they
+   * make sure that outdated values are not found in the disk tier of the cache.
+   */
+  Vector<std::optional<int64_t>> modification_times_;
 
  public:
-  LoadFileKey(Vector<std::string> file_paths, std::shared_ptr<const GenericKey> loader_key)
-      : file_paths_(std::move(file_paths)), loader_key_(std::move(loader_key))
+  LoadFileKey(Vector<std::string> file_paths,
+              std::shared_ptr<const GenericKey> loader_key,
+              Vector<std::optional<int64_t>> modification_times)
+      : file_paths_(std::move(file_paths)),
+        loader_key_(std::move(loader_key)),
+        modification_times_(std::move(modification_times))
   {
   }
 
@@ -64,6 +74,22 @@ class LoadFileKey : public GenericKey {
      * but that causes some boilerplate now that is not worth it. */
     return std::make_unique<LoadFileKey>(*this);
   }
+
+  std::optional<std::string> persistent_identifier() const override
+  {
+    std::optional<std::string> identifier = loader_key_->persistent_identifier();
+    if (!identifier) {
+      return std::nullopt;
+    }
+    for (const int i : file_paths_.index_range()) {
+      if (!modification_times_[i]) {
+        /* The file does not exist, which is not worth storing. */
+        return std::nullopt;
+      }
+      *identifier += "\n" + file_paths_[i] + "\n" + std::to_string(*modification_times_[i]);
+    }
+    return identifier;
+  }
 };
 
 static std::optional<int64_t> get_file_modification_time(const StringRefNull path)
@@ -86,14 +112,18 @@ static FileStatMap &get_file_stat_map()
   return file_stat_map;
 }
 
-static void invalidate_outdated_caches_if_necessary(const Span<StringRefNull> file_paths)
+/**
+ * Returns the current modification times of the files.
+ */
+static Vector<std::optional<int64_t>> invalidate_outdated_caches_if_necessary(
+    const Span<StringRefNull> file_paths)
 {
   FileStatMap &file_stat_map = get_file_stat_map();
 
   /* Retrieve the file modification times before the lock because there is no need for the lock
    * yet. While not guaranteed, retrieving the modification time is often optimized by the OS so
    * that no actual access to the hard drive is necessary. */
-  Array<std::optional<int64_t>> new_times(file_paths.size());
+  Vector<std::optional<int64_t>> new_times(file_paths.size());
   for (const int i : file_paths.index_range()) {
     new_times[i] = get_file_modification_time(file_paths[i]);
   }
@@ -129,15 +159,19 @@ static void invalidate_outdated_caches_if_necessary(const Span<StringRefNull> fi
       });
     });
   }
+  return new_times;
 }
 
-std::shared_ptr<CachedValue> get_loaded_base(const GenericKey &loader_key,
-                                             Span<StringRefNull> file_paths,
-                                             FunctionRef<std::unique_ptr<CachedValue>()> load_fn)
+std::shared_ptr<CachedValue> get_loaded_base(
+    const GenericKey &loader_key,
+    Span<StringRefNull> file_paths,
+    FunctionRef<std::unique_ptr<CachedValue>()> load_fn,
+    FunctionRef<std::unique_ptr<CachedValue>(Span<std::byte> data)> read_fn)
 {
-  invalidate_outdated_caches_if_necessary(file_paths);
-  const LoadFileKey key{file_paths, loader_key.to_storable()};
-  return memory_cache::get_base(key, load_fn);
+  Vector<std::optional<int64_t>> modification_times = invalidate_outdated_caches_if_necessary(
+      file_paths);
+  const LoadFileKey key{file_paths, loader_key.to_storable(), std::move(modification_times)};
+  return memory_cache::get_base(key, load_fn, read_fn);
 }
 
 }  // namespace blender::memory_cache
@@ -0,0 +1,164 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include <zstd.h>
+
+#include "BLI_filereader.hh"
+#include "BLI_rand.hh"
+#include "BLI_task_c.hh"
+#include "BLI_threads.hh"
+#include "BLI_vector.hh"
+
+namespace blender::tests {
+
+static void append_u32(Vector<char> &file, const uint32_t value)
+{
+  /* Little endian, matching `writefile.cc`. */
+  for (int i = 0; i < 4; i++) {
+    file.append(char((value >> (i * 8)) & 0xff));
+  }
+}
+
+/**
+ * Compress `data` into a seekable zstd stream the way `writefile.cc` does, with frames of
+ * varying size so that the reader has to deal with frames not fitting the buffers of the previous
+ * ones.
+ */
+static Vector<char> zstd_seekable_compress(const Span<char> data, const Span<uint32_t> frame_sizes)
+{
+  Vector<char> file;
+  Vector<uint32_t> compressed_sizes;
+  int64_t offset = 0;
+  for (const uint32_t size : frame_sizes) {
+    const size_t bound = ZSTD_compressBound(size);
+    const int64_t start = file.size();
+    file.resize(start + bound);
+    const size_t compressed_size = ZSTD_compress(
+        file.data() + start, bound, data.data() + offset, size, 1);
+    EXPECT_FALSE(ZSTD_isError(compressed_size));
+    file.resize(start + compressed_size);
+    compressed_sizes.append(uint32_t(compressed_size));
+    offset += size;
+  }
+
+  append_u32(file, 0x184D2A5E);
+  append_u32(file, uint32_t(frame_sizes.size() * 8 + 9));
+  for (const int i : frame_sizes.index_range()) {
+    append_u32(file, compressed_sizes[i]);
+    append_u32(file, frame_sizes[i]);
+  }
+  append_u32(file, uint32_t(frame_sizes.size()));
+  file.append(0);
+  append_u32(file, 0x8F92EAB1);
+  return file;
+}
+
+class ZstdFileReaderTest : public testing::Test {
+ public:
+  Vector<char> data;
+  Vector<uint32_t> frame_starts;
+  Vector<char> file;
+
+  void SetUp() override
+  {
+    /* Prefetching is only used with multiple threads, make sure it is tested on any machine. */
+    BLI_system_num_threads_override_set(4);
+    BLI_task_scheduler_init();
+
+    RandomNumberGenerator rng(7);
+    Vector<uint32_t> frame_sizes;
+    for (const int i : IndexRange(48)) {
+      frame_sizes.append(i % 5 == 3 ? 9000 : (i % 7 == 0 ? 1500 : 4096));
+    }
+    for (const uint32_t size : frame_sizes) {
+      frame_starts.append(uint32_t(data.size()));
+      for ([[maybe_unused]] const int i : IndexRange(size)) {
+        /* Somewhat compressible, but different for every position. */
+        data.append(char(rng.get_int32(16) + (data.size() / 64) % 64));
+      }
+    }
+    file = zstd_seekable_compress(data, frame_sizes);
+  }
+
+  void TearDown() override
+  {
+    BLI_task_scheduler_exit();
+    BLI_system_num_threads_override_set(0);
+  }
+
+  FileReader *open() const
+  {
+    FileReader *base = BLI_filereader_new_memory(file.data(), file.size());
+    return BLI_filereader_new_zstd(base);
+  }
+
+  /** Read `size` bytes at the current position and compare them with the source data. */
+  void expect_read(FileReader *reader, const int64_t size) const
+  {
+    const int64_t offset = reader->offset;
+    const int64_t expected_size = std::min<int64_t>(size, data.size() - offset);
+    Vector<char> buffer(size);
+    ASSERT_EQ(reader->read(reader, buffer.data(), size), expected_size);
+    EXPECT_EQ(buffer.as_span().take_front(expected_size),
+              data.as_span().slice(offset, expected_size));
+    EXPECT_EQ(reader->offset, offset + expected_size);
+  }
+};
+
+TEST_F(ZstdFileReaderTest, ReadSequential)
+{
+  FileReader *reader = this->open();
+  ASSERT_NE(reader, nullptr);
+  ASSERT_NE(reader->seek, nullptr);
+  while (reader->offset < data.size()) {
+    this->expect_read(reader, 1000);
+  }
+  reader->close(reader);
+}
+
+TEST_F(ZstdFileReaderTest, ReadSequentialAndSeek)
+{
+  FileReader *reader = this->open();
+  ASSERT_NE(reader, nullptr);
+  ASSERT_NE(reader->seek, nullptr);
+
+  /* Start the prefetching with a sequential read. */
+  for ([[maybe_unused]] const int i : IndexRange(12)) {
+    this->expect_read(reader, 2000);
+  }
+
+  /* Seek back into a frame that has been recycled by the prefetching, then read on. */
+  ASSERT_EQ(reader->seek(reader, frame_starts[1] + 10, SEEK_SET), frame_starts[1] + 10);
+  for ([[maybe_unused]] const int i : IndexRange(10)) {
+    this->expect_read(reader, 3000);
+  }
+
+  /* Skip ahead within the prefetched frames and far ahead of them. */
+  ASSERT_GE(reader->seek(reader, 5000, SEEK_CUR), 0);
+  this->expect_read(reader, 2000);
+  ASSERT_EQ(reader->seek(reader, frame_starts[40], SEEK_SET), frame_starts[40]);
+  this->expect_read(reader, 500);
+
+  /* Alternate between random seeks and sequential runs of different length. */
+  RandomNumberGenerator rng(42);
+  for ([[maybe_unused]] const int i : IndexRange(64)) {
+    const int64_t offset = rng.get_int32(int(data.size()));
+    ASSERT_EQ(reader->seek(reader, offset, SEEK_SET), offset);
+    const int reads_num = rng.get_int32(6);
+    for ([[maybe_unused]] const int j : IndexRange(reads_num)) {
+      this->expect_read(reader, 1 + rng.get_int32(12000));
+    }
+  }
+
+  /* Reading up to the end still works after all of that. */
+  ASSERT_EQ(reader->seek(reader, 0, SEEK_SET), 0);
+  while (reader->offset < data.size()) {
+    this->expect_read(reader, 7000);
+  }
+  reader->close(reader);
+}
+
+}  // namespace blender::tests
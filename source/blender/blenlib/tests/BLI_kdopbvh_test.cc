@@ -4,14 +4,18 @@
 
 #include "testing/testing.h"
 
-/* TODO: ray intersection, overlap ... etc. */
+/* TODO: overlap ... etc. */
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_array.hh"
 #include "BLI_compiler_attrs.hh"
 #include "BLI_kdopbvh.hh"
+#include "BLI_math_vector.hh"
 #include "BLI_math_vector_c.hh"
+#include "BLI_math_vector_types.hh"
 #include "BLI_rand_c.hh"
+#include "BLI_timeit.hh"
 
 namespace blender {
 
@@ -70,11 +74,17 @@ static void optimal_check_callback(void *userdata,
  * Note that a small epsilon is added to the BVH nodes bounds, even if we pass in zero.
  * Use rounding to ensure very close nodes don't cause the wrong node to be found as nearest.
  */
-static void find_nearest_points_test(
-    int points_len, float scale, int round, int random_seed, bool optimal = false)
+static void find_nearest_points_test(int points_len,
+                                     float scale,
+                                     int round,
+                                     int random_seed,
+                                     bool optimal = false,
+                                     bool use_sah = false)
 {
   RNG *rng = BLI_rng_new(random_seed);
-  BVHTree *tree = BLI_bvhtree_new(points_len, 0.0, 8, 8);
+  /* The SAH build is only used for binary trees. */
+  BVHTree *tree = use_sah ? BLI_bvhtree_new(points_len, 0.0, 2, 6) :
+                            BLI_bvhtree_new(points_len, 0.0, 8, 8);
 
   void *mem = MEM_new_array_uninitialized<float[3]>(size_t(points_len), __func__);
   float (*points)[3] = static_cast<float (*)[3]>(mem);
@@ -83,7 +93,12 @@ static void find_nearest_points_test(
     rng_v3_round(points[i], 3, rng, round, scale);
     BLI_bvhtree_insert(tree, i, points[i], 1);
   }
-  BLI_bvhtree_balance(tree);
+  if (use_sah) {
+    BLI_bvhtree_balance_sah(tree);
+  }
+  else {
+    BLI_bvhtree_balance(tree);
+  }
 
   /* first find each point */
   BVHTree_NearestPointCallback callback = optimal ? optimal_check_callback : nullptr;
@@ -137,4 +152,247 @@ TEST(kdopbvh, OptimalFindNearest_500)
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
 
+TEST(kdopbvh, FindNearestSAH_500)
+{
+  find_nearest_points_test(500, 1.0, 1000, 12, false, true);
+}
+
+/**
+ * Create a tree of small random triangles, which are clustered along the x axis to get uneven
+ * node sizes.
+ */
+static BVHTree *create_random_triangles_tree(int tris_num, int random_seed, bool use_sah)
+{
+  RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree = BLI_bvhtree_new(tris_num, 0.0f, 2, 6);
+  for (int i = 0; i < tris_num; i++) {
+    float center[3];
+    rng_v3_round(center, 3, rng, 1000, 10.0f);
+    center[0] = center[0] * center[0] * center[0] / 100.0f;
+    float co[3][3];
+    for (int j = 0; j < 3; j++) {
+      rng_v3_round(co[j], 3, rng, 1000, 0.1f);
+      add_v3_v3(co[j], center);
+    }
+    BLI_bvhtree_insert(tree, i, co[0], 3);
+  }
+  if (use_sah) {
+    BLI_bvhtree_balance_sah(tree);
+  }
+  else {
+    BLI_bvhtree_balance(tree);
+  }
+  BLI_rng_free(rng);
+  return tree;
+}
+
+/** Create parallel rays in a grid, which are coherent like rays used for projections. */
+static void create_ray_grid(
+    int rays_num, float (*r_origins)[3], float (*r_directions)[3], float radius)
+{
+  const int grid_size = int(sqrtf(float(rays_num))) + 1;
+  for (int i = 0; i < rays_num; i++) {
+    const float x = float(i % grid_size) / float(grid_size);
+    const float y = float(i / grid_size) / float(grid_size);
+    copy_v3_fl3(r_origins[i], -12.0f + radius, x * 20.0f - 10.0f, y * 20.0f - 10.0f);
+    copy_v3_fl3(r_directions[i], 1.0f, 0.1f, 0.05f);
+    normalize_v3(r_directions[i]);
+  }
+}
+
+static void init_ray_hits(BVHTreeRayHit *hits, int hits_num)
+{
+  for (int i = 0; i < hits_num; i++) {
+    hits[i].index = -1;
+    hits[i].dist = BVH_RAYCAST_DIST_MAX;
+  }
+}
+
+static void ray_cast_batch_test(int tris_num, int rays_num, float radius, bool use_sah)
+{
+  BVHTree *tree = create_random_triangles_tree(tris_num, 1234, use_sah);
+
+  Array<float3> origins(rays_num);
+  Array<float3> directions(rays_num);
+  create_ray_grid(rays_num,
+                  reinterpret_cast<float (*)[3]>(origins.data()),
+                  reinterpret_cast<float (*)[3]>(directions.data()),
+                  radius);
+
+  Array<BVHTreeRayHit> hits(rays_num);
+  init_ray_hits(hits.data(), rays_num);
+  BLI_bvhtree_ray_cast_batch(tree,
+                             rays_num,
+                             reinterpret_cast<const float (*)[3]>(origins.data()),
+                             reinterpret_cast<const float (*)[3]>(directions.data()),
+                             radius,
+                             hits.data(),
+                             nullptr,
+                             nullptr,
+                             BVH_RAYCAST_DEFAULT);
+
+  int hits_num = 0;
+  for (int i = 0; i < rays_num; i++) {
+    BVHTreeRayHit hit;
+    init_ray_hits(&hit, 1);
+    BLI_bvhtree_ray_cast_ex(
+        tree, origins[i], directions[i], radius, &hit, nullptr, nullptr, BVH_RAYCAST_DEFAULT);
+    EXPECT_EQ(hits[i].index, hit.index);
+    EXPECT_EQ(hits[i].dist, hit.dist);
+    hits_num += hit.index != -1;
+  }
+  /* Make sure that the test is meaningful. */
+  EXPECT_GT(hits_num, 0);
+  EXPECT_LT(hits_num, rays_num);
+
+  BLI_bvhtree_free(tree);
+}
+
+TEST(kdopbvh, RayCastBatch)
+{
+  ray_cast_batch_test(1000, 1001, 0.0f, false);
+}
+TEST(kdopbvh, RayCastBatchRadius)
+{
+  ray_cast_batch_test(1000, 1001, 0.05f, false);
+}
+TEST(kdopbvh, RayCastBatchSAH)
+{
+  ray_cast_batch_test(1000, 1001, 0.0f, true);
+}
+
+static void update_triangles_tree(BVHTree *tree, Span<float3> positions)
+{
+  for (const int i : IndexRange(positions.size() / 3)) {
+    BLI_bvhtree_update_node(tree, i, positions[i * 3], nullptr, 3);
+  }
+}
+
+/**
+ * Refit a tree of small triangles after moving them, and check that every triangle is still found
+ * and the root contains all of them.
+ */
+static void update_tree_test(int tris_num, bool scramble)
+{
+  RNG *rng = BLI_rng_new(tris_num);
+  Array<float3> positions(tris_num * 3);
+  for (const int i : IndexRange(tris_num)) {
+    float center[3];
+    rng_v3_round(center, 3, rng, 1000, 10.0f);
+    for (const int j : IndexRange(3)) {
+      rng_v3_round(positions[i * 3 + j], 3, rng, 1000, 0.01f);
+      positions[i * 3 + j] += float3(center);
+    }
+  }
+
+  BVHTree *tree = BLI_bvhtree_new(tris_num, 0.0f, 4, 26);
+  for (const int i : IndexRange(tris_num)) {
+    BLI_bvhtree_insert(tree, i, positions[i * 3], 3);
+  }
+  BLI_bvhtree_balance(tree);
+
+  if (scramble) {
+    /* Swap triangles, so the tree gets much worse if it is only refit. */
+    for (const int i : IndexRange(tris_num)) {
+      const int j = int(BLI_rng_get_uint(rng) % uint(tris_num));
+      for (const int k : IndexRange(3)) {
+        std::swap(positions[i * 3 + k], positions[j * 3 + k]);
+      }
+    }
+  }
+  else {
+    for (float3 &position : positions) {
+      position.x += 0.5f;
+    }
+  }
+  update_triangles_tree(tree, positions);
+  EXPECT_EQ(BLI_bvhtree_update_tree_or_balance(tree, 1.5f), scramble);
+
+  float3 bounds_min(FLT_MAX);
+  float3 bounds_max(-FLT_MAX);
+  for (const float3 &position : positions) {
+    bounds_min = math::min(bounds_min, position);
+    bounds_max = math::max(bounds_max, position);
+  }
+  float3 tree_min, tree_max;
+  BLI_bvhtree_get_bounding_box(tree, tree_min, tree_max);
+  EXPECT_V3_NEAR(tree_min, bounds_min, 1e-4f);
+  EXPECT_V3_NEAR(tree_max, bounds_max, 1e-4f);
+
+  for (const int i : IndexRange(tris_num)) {
+    const float3 center = (positions[i * 3] + positions[i * 3 + 1] + positions[i * 3 + 2]) / 3.0f;
+    BVHTreeNearest nearest;
+    nearest.index = -1;
+    nearest.dist_sq = FLT_MAX;
+    BLI_bvhtree_find_nearest(tree, center, &nearest, nullptr, nullptr);
+    EXPECT_NE(nearest.index, -1);
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+}
+
+TEST(kdopbvh, UpdateTree)
+{
+  update_tree_test(5000, false);
+}
+TEST(kdopbvh, UpdateTreeOrBalance)
+{
+  update_tree_test(5000, true);
+}
+
+/**
+ * Set this to 1 to activate the benchmark. It is disabled by default, because it prints a lot.
+ */
+#if 0
+static void benchmark_ray_cast(int tris_num, int rays_num, bool use_sah)
+{
+  const std::string name = use_sah ? "SAH" : "Median";
+  BVHTree *tree;
+  {
+    SCOPED_TIMER(name + " Build");
+    tree = create_random_triangles_tree(tris_num, 1234, use_sah);
+  }
+
+  Array<float3> origins(rays_num);
+  Array<float3> directions(rays_num);
+  create_ray_grid(rays_num,
+                  reinterpret_cast<float (*)[3]>(origins.data()),
+                  reinterpret_cast<float (*)[3]>(directions.data()),
+                  0.0f);
+  Array<BVHTreeRayHit> hits(rays_num);
+
+  init_ray_hits(hits.data(), rays_num);
+  {
+    SCOPED_TIMER(name + " Single Rays");
+    for (int i = 0; i < rays_num; i++) {
+      BLI_bvhtree_ray_cast_ex(
+          tree, origins[i], directions[i], 0.0f, &hits[i], nullptr, nullptr, BVH_RAYCAST_DEFAULT);
+    }
+  }
+
+  init_ray_hits(hits.data(), rays_num);
+  {
+    SCOPED_TIMER(name + " Ray Packets");
+    BLI_bvhtree_ray_cast_batch(tree,
+                               rays_num,
+                               reinterpret_cast<const float (*)[3]>(origins.data()),
+                               reinterpret_cast<const float (*)[3]>(directions.data()),
+                               0.0f,
+                               hits.data(),
+                               nullptr,
+                               nullptr,
+                               BVH_RAYCAST_DEFAULT);
+  }
+
+  BLI_bvhtree_free(tree);
+}
+
+TEST(kdopbvh, BenchmarkRayCast)
+{
+  benchmark_ray_cast(200000, 1000000, false);
+  benchmark_ray_cast(200000, 1000000, true);
+}
+#endif /* Benchmark */
+
 }  // namespace blender
@@ -0,0 +1,120 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: Apache-2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_kdtree.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_rand.hh"
+
+namespace blender::tests {
+
+static KDTree<float3> *kdtree_from_random_points(const int points_num,
+                                                 const uint32_t seed,
+                                                 const bool use_threading = true)
+{
+  RandomNumberGenerator rng(seed);
+  KDTree<float3> *tree = kdtree_new<float3>(points_num);
+  for (const int i : IndexRange(points_num)) {
+    kdtree_insert(tree, i, float3(rng.get_float(), rng.get_float(), rng.get_float()));
+  }
+  kdtree_balance(tree, use_threading);
+  return tree;
+}
+
+TEST(kdtree, BalanceParallel)
+{
+  /* Large enough to balance sub-trees in parallel. */
+  constexpr int points_num = 50000;
+  KDTree<float3> *tree = kdtree_from_random_points(points_num, 0);
+  KDTree<float3> *serial_tree = kdtree_from_random_points(points_num, 0, false);
+
+  /* The parallel build results in the same tree as the serial build. */
+  ASSERT_EQ(tree->root, serial_tree->root);
+  for (const int i : IndexRange(points_num)) {
+    const KDTreeNode<float3> &node = tree->nodes[i];
+    const KDTreeNode<float3> &serial_node = serial_tree->nodes[i];
+    ASSERT_EQ(node.index, serial_node.index);
+    ASSERT_EQ(node.left, serial_node.left);
+    ASSERT_EQ(node.right, serial_node.right);
+    ASSERT_EQ(node.d, serial_node.d);
+  }
+
+  constexpr int nearest_len = 8;
+  RandomNumberGenerator rng(1);
+  for ([[maybe_unused]] const int i : IndexRange(100)) {
+    const float3 co(rng.get_float(), rng.get_float(), rng.get_float());
+    KDTreeNearest<float3> nearest[nearest_len];
+    KDTreeNearest<float3> serial_nearest[nearest_len];
+    const int found = kdtree_find_nearest_n(tree, co, nearest, nearest_len);
+    const int serial_found = kdtree_find_nearest_n(serial_tree, co, serial_nearest, nearest_len);
+    ASSERT_EQ(found, nearest_len);
+    ASSERT_EQ(found, serial_found);
+    for (const int j : IndexRange(found)) {
+      EXPECT_EQ(nearest[j].index, serial_nearest[j].index);
+      EXPECT_EQ(nearest[j].dist, serial_nearest[j].dist);
+    }
+
+    /* Compare against a brute-force search. */
+    float min_dist_sq = FLT_MAX;
+    for (const uint node_i : IndexRange(tree->nodes_len)) {
+      min_dist_sq = std::min(min_dist_sq, math::distance_squared(tree->nodes[node_i].co, co));
+    }
+    EXPECT_FLOAT_EQ(nearest[0].dist, std::sqrt(min_dist_sq));
+  }
+  kdtree_free(tree);
+  kdtree_free(serial_tree);
+}
+
+static void test_find_nearest_n_batch(const int points_num, const int nearest_len)
+{
+  KDTree<float3> *tree = kdtree_from_random_points(points_num, 2);
+
+  /* The number of queries is not a multiple of the packet size. */
+  RandomNumberGenerator rng(3);
+  Array<float3> query_cos(3001);
+  for (float3 &co : query_cos) {
+    co = float3(rng.get_float(), rng.get_float(), rng.get_float());
+  }
+
+  Array<KDTreeNearest<float3>> batch_nearest(query_cos.size() * nearest_len);
+  Array<int> batch_nearest_len(query_cos.size());
+  kdtree_find_nearest_n_batch<float3>(
+      tree, query_cos, nearest_len, batch_nearest, batch_nearest_len);
+
+  Array<KDTreeNearest<float3>> nearest(nearest_len);
+  for (const int i : query_cos.index_range()) {
+    const int found = kdtree_find_nearest_n(tree, query_cos[i], nearest.data(), nearest_len);
+    ASSERT_EQ(found, std::min(points_num, nearest_len));
+    ASSERT_EQ(found, batch_nearest_len[i]);
+    for (const int j : IndexRange(found)) {
+      EXPECT_EQ(nearest[j].index, batch_nearest[i * nearest_len + j].index);
+      EXPECT_EQ(nearest[j].dist, batch_nearest[i * nearest_len + j].dist);
+    }
+  }
+  kdtree_free(tree);
+}
+
+TEST(kdtree, FindNearestNBatch)
+{
+  test_find_nearest_n_batch(20000, 4);
+  test_find_nearest_n_batch(1000, 20);
+  /* Fewer points than requested. */
+  test_find_nearest_n_batch(3, 4);
+}
+
+TEST(kdtree, FindNearestNBatchEmpty)
+{
+  KDTree<float3> *tree = kdtree_new<float3>(0);
+  kdtree_balance(tree);
+  Array<float3> query_cos(2, float3(0.0f));
+  Array<KDTreeNearest<float3>> nearest(2);
+  Array<int> nearest_len(2, -1);
+  kdtree_find_nearest_n_batch<float3>(tree, query_cos, 1, nearest, nearest_len);
+  EXPECT_EQ(nearest_len[0], 0);
+  EXPECT_EQ(nearest_len[1], 0);
+  kdtree_free(tree);
+}
+
+}  // namespace blender::tests
@@ -2,12 +2,22 @@
  *
  * SPDX-License-Identifier: Apache-2.0 */
 
+#include <cstring>
+#include <ostream>
+
+#include "BLI_fileops.hh"
+#include "BLI_generic_key_string.hh"
 #include "BLI_hash.hh"
 #include "BLI_memory_cache.hh"
 #include "BLI_memory_counter.hh"
+#include "BLI_path_utils.hh"
+#include "BLI_system.hh"
+#include "BLI_tempfile.hh"
 
 #include "testing/testing.h"
 
+#include BLI_SYSTEM_PID_H
+
 #include "BLI_strict_flags.hh" /* IWYU pragma: keep. Keep last. */
 
 namespace blender::memory_cache::tests {
@@ -54,6 +64,22 @@ class CachedInt : public memory_cache::CachedValue {
   {
     memory.add(sizeof(int));
   }
+
+  bool write_to_disk(std::ostream &stream) const override
+  {
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(int));
+    return true;
+  }
+
+  static std::unique_ptr<CachedInt> read_from_disk(const Span<std::byte> data)
+  {
+    if (data.size() != sizeof(int)) {
+      return nullptr;
+    }
+    int value;
+    memcpy(&value, data.data(), sizeof(int));
+    return std::make_unique<CachedInt>(value);
+  }
 };
 
 TEST(memory_cache, Simple)
@@ -105,4 +131,75 @@ TEST(memory_cache, RemoveIf)
                })->value);
 }
 
+static std::string disk_cache_test_directory()
+{
+  char temp_dir[FILE_MAX];
+  BLI_temp_directory_path_get(temp_dir, sizeof(temp_dir));
+  return std::string(temp_dir) + SEP_STR + "blender_memory_cache_test_" + std::to_string(getpid());
+}
+
+/** Get a value with a key that has a persistent identifier, so that it can be stored on disk. */
+static int get_persistent(const StringRef key,
+                          const FunctionRef<std::unique_ptr<CachedInt>()> compute_fn)
+{
+  return memory_cache::get<CachedInt>(GenericStringKey(key), compute_fn, CachedInt::read_from_disk)
+      ->value;
+}
+
+TEST(memory_cache, DiskTier)
+{
+  const std::string temp_dir = disk_cache_test_directory();
+  memory_cache::clear();
+  memory_cache::set_disk_cache(temp_dir, 1024 * 1024);
+
+  const auto compute_4 = []() { return std::make_unique<CachedInt>(4); };
+  const auto compute_5 = []() { return std::make_unique<CachedInt>(5); };
+  EXPECT_EQ(4, get_persistent("a", compute_4));
+  /* Keys without a persistent identifier are not stored on disk. */
+  memory_cache::get<CachedInt>(GenericIntKey(0), compute_5);
+  memory_cache::flush_to_disk();
+  memory_cache::clear();
+
+  bool newly_computed = false;
+  const auto compute_10 = [&]() {
+    newly_computed = true;
+    return std::make_unique<CachedInt>(10);
+  };
+  EXPECT_EQ(4, get_persistent("a", compute_10));
+  EXPECT_FALSE(newly_computed);
+  EXPECT_EQ(10, memory_cache::get<CachedInt>(GenericIntKey(0), compute_10)->value);
+  EXPECT_TRUE(newly_computed);
+
+  memory_cache::clear();
+  memory_cache::set_disk_cache("", 0);
+  BLI_delete(temp_dir.c_str(), true, true);
+}
+
+TEST(memory_cache, DiskTierEviction)
+{
+  const std::string temp_dir = disk_cache_test_directory();
+  memory_cache::clear();
+  memory_cache::set_disk_cache(temp_dir, 1024 * 1024);
+
+  /* Evicted values are written to disk in the background, flushing waits for the write. */
+  memory_cache::set_approximate_size_limit(1);
+  const auto compute_7 = []() { return std::make_unique<CachedInt>(7); };
+  EXPECT_EQ(7, get_persistent("b", compute_7));
+  memory_cache::flush_to_disk();
+  memory_cache::set_approximate_size_limit(1024 * 1024 * 1024);
+  memory_cache::clear();
+
+  bool newly_computed = false;
+  const auto compute_10 = [&]() {
+    newly_computed = true;
+    return std::make_unique<CachedInt>(10);
+  };
+  EXPECT_EQ(7, get_persistent("b", compute_10));
+  EXPECT_FALSE(newly_computed);
+
+  memory_cache::clear();
+  memory_cache::set_disk_cache("", 0);
+  BLI_delete(temp_dir.c_str(), true, true);
+}
+
 }  // namespace blender::memory_cache::tests
@@ -31,12 +31,20 @@ struct MemFileSharedStorage {
   ~MemFileSharedStorage();
 };
 
+/**
+ * Reference counted content of #MemFileChunk. Chunks with identical content share the same data,
+ * regardless of their position and undo step, see #BLO_memfile_chunk_add.
+ */
+struct MemFileChunkData;
+
 struct MemFileChunk {
   void *next, *prev;
-  const char *buf;
+  /** Owns one user of the data. It may be compressed, see #BLO_memfile_compress. */
+  MemFileChunkData *data;
   /** Size in bytes. */
   size_t size;
-  /** When true, this chunk doesn't own the memory, it's shared with a previous #MemFileChunk */
+  /** When true, this chunk is identical to the chunk at the same position in the previous step
+   * (used by undo code to detect unchanged IDs). */
   bool is_identical;
   /** When true, this chunk is also identical to the one in the next step (used by undo code to
    * detect unchanged IDs).
@@ -111,6 +119,16 @@ void BLO_memfile_merge(MemFile *first, MemFile *second);
  * Clear is_identical_future before adding next memfile.
  */
 void BLO_memfile_clear_future(MemFile *memfile);
+/**
+ * Compress the chunk data that is only used by this memfile in a background task.
+ * Meant for steps which are unlikely to be loaded soon, compressed data is decompressed again
+ * when the memfile is read. #MemFile.size is updated for both, it only counts data the memfile
+ * added itself (or took over from a merged memfile), so data shared with other memfiles is not
+ * compressed.
+ *
+ * All other memfile functions wait for pending compression to be done before accessing any data.
+ */
+void BLO_memfile_compress(MemFile *memfile);
 
 /* Utilities. */
 
@@ -48,6 +48,12 @@ struct BlendFileWriteParams {
   uint use_userdef : 1 = false;
   /** This is writing a copy/paste buffer, not a regular blendfile. */
   uint is_copypaste_buffer : 1 = false;
+  /**
+   * When compressing, pick the compression level from the measured throughput of the
+   * compression threads and of the target disk, instead of using a fixed level.
+   * Meant for saves that block the user (e.g. auto-save), where time matters more than size.
+   */
+  uint use_adaptive_compression : 1 = false;
   const BlendThumbnail *thumb = nullptr;
 };
 
@@ -62,7 +62,8 @@ BlendHandle *BLO_blendhandle_from_file(const char *filepath, BlendFileReadReport
 {
   BlendHandle *bh;
 
-  bh = reinterpret_cast<BlendHandle *>(blo_filedata_from_file(filepath, reports));
+  /* Handles are used to list or link some of the IDs. */
+  bh = reinterpret_cast<BlendHandle *>(blo_filedata_from_file(filepath, reports, true));
 
   return bh;
 }
@@ -362,7 +363,7 @@ BlendFileData *BLO_read_from_file(const char *filepath,
   BlendFileData *bfd = nullptr;
   FileData *fd;
 
-  fd = blo_filedata_from_file(filepath, reports);
+  fd = blo_filedata_from_file(filepath, reports, false);
   if (fd) {
     fd->skip_flags = skip_flags;
     bfd = blo_read_file_internal(fd, filepath);
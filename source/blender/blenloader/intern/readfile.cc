@@ -8,6 +8,7 @@
 
 #include "fmt/core.h"
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdarg> /* for va_start/end. */
 #include <cstddef> /* for offsetof. */
@@ -51,6 +52,7 @@
 #include "MEM_guardedalloc.h"
 #include "MEM_safe_multiply.h"
 
+#include "BLI_array.hh"
 #include "BLI_endian_defines.hh"
 #include "BLI_fileops.hh"
 #include "BLI_ghash.hh"
@@ -65,6 +67,7 @@
 #include "BLI_threads.hh"
 #include "BLI_time.hh"
 #include "BLI_utildefines.hh"
+#include "BLI_vector.hh"
 
 #include "BLT_translation.hh"
 
@@ -209,6 +212,8 @@ struct BHeadN {
   /** When set, the remainder of this allocation is the data, otherwise it needs to be read. */
   bool has_data;
 #endif
+  /** File offset of the #BHead. */
+  off64_t bhead_offset;
   bool is_memchunk_identical;
   BHead bhead;
 };
@@ -519,9 +524,11 @@ static void read_file_version_and_colorspace(FileData *fd, Main *main)
         main->colorspace.scene_linear_to_xyz = float3x3(fg->colorspace_scene_linear_to_xyz);
         MEM_delete(fg);
       }
-      else if (bhead->code == BLO_CODE_ENDB) {
-        break;
-      }
+      /* There is only one global block, the rest of the file does not need to be read. */
+      break;
+    }
+    if (bhead->code == BLO_CODE_ENDB) {
+      break;
     }
   }
   if (main->curlib) {
@@ -557,6 +564,10 @@ static void read_file_bhead_idname_map_create(FileData *fd)
   int code_prev = BLO_CODE_ENDB;
 
   fd->bhead_idname_map.emplace();
+  if (fd->bhead_index) {
+    /* Filled on demand from the index, see #find_bhead_from_idname_map. */
+    return;
+  }
   for (BHead *bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
     if (code_prev != bhead->code) {
       code_prev = bhead->code;
@@ -598,11 +609,29 @@ void blo_readfile_invalidate(FileData *fd, Main *bmain, const char *message)
 /** \name File Parsing
  * \{ */
 
-static BHeadN *get_bhead(FileData *fd)
+/** File offset of the #BHead following the given one. */
+static off64_t bhead_next_offset(const FileData *fd, const BHeadN *bheadn)
+{
+  return bheadn->bhead_offset + BLO_bhead_size(fd->blender_header.bhead_type()) +
+         bheadn->bhead.len;
+}
+
+/**
+ * Read the #BHead at the given file offset and insert it after `prev_bhead` in the list.
+ * Unless the list has gaps, blocks are read sequentially from the current position in the file.
+ */
+static BHeadN *get_bhead(FileData *fd, const off64_t offset, BHeadN *prev_bhead)
 {
   BHeadN *new_bhead = nullptr;
+  off64_t bhead_offset = -1;
 
   if (fd) {
+    if (fd->bhead_list_has_gaps && !fd->is_eof && fd->file->offset != offset) {
+      if (fd->file->seek == nullptr || fd->file->seek(fd->file, offset, SEEK_SET) == -1) {
+        fd->is_eof = true;
+      }
+    }
+    bhead_offset = fd->file->offset;
     if (!fd->is_eof) {
       std::optional<BHead> bhead_opt = BLO_readfile_read_bhead(fd->file,
                                                                fd->blender_header.bhead_type());
@@ -630,6 +659,7 @@ static BHeadN *get_bhead(FileData *fd)
         new_bhead = MEM_new_uninitialized<BHeadN>("new_bhead");
         if (new_bhead) {
           new_bhead->next = new_bhead->prev = nullptr;
+          new_bhead->bhead_offset = bhead_offset;
           new_bhead->file_offset = fd->file->offset;
           new_bhead->has_data = false;
           new_bhead->is_memchunk_identical = false;
@@ -654,6 +684,7 @@ static BHeadN *get_bhead(FileData *fd)
             MEM_new_uninitialized(sizeof(BHeadN) + size_t(bhead->len), "new_bhead"));
         if (new_bhead) {
           new_bhead->next = new_bhead->prev = nullptr;
+          new_bhead->bhead_offset = bhead_offset;
 #ifdef USE_BHEAD_READ_ON_DEMAND
           new_bhead->file_offset = 0; /* don't seek. */
           new_bhead->has_data = true;
@@ -686,7 +717,10 @@ static BHeadN *get_bhead(FileData *fd)
    * of blocks.
    */
   if (new_bhead) {
-    BLI_addtail(&fd->bhead_list, new_bhead);
+    BLI_insertlinkafter(&fd->bhead_list, prev_bhead, new_bhead);
+    if (fd->bhead_list_has_gaps) {
+      fd->bhead_by_offset.add(bhead_offset, new_bhead);
+    }
   }
 
   return new_bhead;
@@ -697,12 +731,20 @@ BHead *blo_bhead_first(FileData *fd)
   BHeadN *new_bhead;
   BHead *bhead = nullptr;
 
+  if (fd->first_bhead_offset == -1) {
+    fd->first_bhead_offset = fd->file->offset;
+  }
+
   /* Rewind the file
    * Read in a new block if necessary
    */
   new_bhead = static_cast<BHeadN *>(fd->bhead_list.first);
+  if (new_bhead && fd->bhead_list_has_gaps && new_bhead->bhead_offset != fd->first_bhead_offset)
+  {
+    new_bhead = nullptr;
+  }
   if (new_bhead == nullptr) {
-    new_bhead = get_bhead(fd);
+    new_bhead = get_bhead(fd, fd->first_bhead_offset, nullptr);
   }
 
   if (new_bhead) {
@@ -712,6 +754,10 @@ BHead *blo_bhead_first(FileData *fd)
   return bhead;
 }
 
+/**
+ * \note When blocks were read using the #BHeadIndex, this only returns the previous block if it
+ * was loaded already.
+ */
 BHead *blo_bhead_prev(FileData * /*fd*/, BHead *thisblock)
 {
   BHeadN *bheadn = BHEADN_FROM_BHEAD(thisblock);
@@ -730,10 +776,22 @@ BHead *blo_bhead_next(FileData *fd, BHead *thisblock)
      * We calculate the BHeadN pointer from the BHead pointer below */
     new_bhead = BHEADN_FROM_BHEAD(thisblock);
 
+    BHeadN *this_bhead = new_bhead;
+    const off64_t next_offset = bhead_next_offset(fd, this_bhead);
+
     /* get the next BHeadN. If it doesn't exist we read in the next one */
     new_bhead = new_bhead->next;
+    if (fd->bhead_list_has_gaps) {
+      if (thisblock->code == BLO_CODE_ENDB) {
+        /* Don't read the index footer as block, it would stop further reading. */
+        return nullptr;
+      }
+      if (new_bhead && new_bhead->bhead_offset != next_offset) {
+        new_bhead = nullptr;
+      }
+    }
     if (new_bhead == nullptr) {
-      new_bhead = get_bhead(fd);
+      new_bhead = get_bhead(fd, next_offset, this_bhead);
     }
   }
 
@@ -746,6 +804,32 @@ BHead *blo_bhead_next(FileData *fd, BHead *thisblock)
   return bhead;
 }
 
+/**
+ * Get the block at the given file offset, reading only that block if necessary.
+ * Only used with offsets from the #BHeadIndex.
+ */
+static BHead *blo_bhead_at_offset(FileData *fd, const off64_t offset)
+{
+  if (!fd->bhead_list_has_gaps) {
+    /* Start tracking blocks by offset, the list is contiguous so far. */
+    fd->bhead_list_has_gaps = true;
+    for (BHeadN &bheadn : fd->bhead_list) {
+      fd->bhead_by_offset.add(bheadn.bhead_offset, &bheadn);
+    }
+  }
+  if (BHeadN *bheadn = fd->bhead_by_offset.lookup_default(offset, nullptr)) {
+    return &bheadn->bhead;
+  }
+
+  /* Insert after the last loaded block before the offset, to keep the list sorted. */
+  BHeadN *prev_bhead = static_cast<BHeadN *>(fd->bhead_list.last);
+  while (prev_bhead && prev_bhead->bhead_offset > offset) {
+    prev_bhead = prev_bhead->prev;
+  }
+  BHeadN *new_bhead = get_bhead(fd, offset, prev_bhead);
+  return new_bhead ? &new_bhead->bhead : nullptr;
+}
+
 #ifdef USE_BHEAD_READ_ON_DEMAND
 static bool blo_bhead_read_data(FileData *fd, BHead *thisblock, void *buf)
 {
@@ -781,6 +865,7 @@ static BHead *blo_bhead_read_full(FileData *fd, BHead *thisblock)
   BHeadN *new_bhead_data = static_cast<BHeadN *>(
       MEM_new_uninitialized(sizeof(BHeadN) + new_bhead->bhead.len, "new_bhead"));
   new_bhead_data->bhead = new_bhead->bhead;
+  new_bhead_data->bhead_offset = new_bhead->bhead_offset;
   new_bhead_data->file_offset = new_bhead->file_offset;
   new_bhead_data->has_data = true;
   new_bhead_data->is_memchunk_identical = false;
@@ -884,6 +969,81 @@ static void read_blender_header(FileData *fd)
   fd->blender_header = header;
 }
 
+/**
+ * Read the #BHeadIndex if the file has one. Must be called right after reading the file header.
+ *
+ * Only done for partial reads like linking. Loading the whole file reads all blocks sequentially
+ * anyway, jumping to indexed blocks first would only add seeks.
+ */
+static void read_file_bhead_index(FileData *fd)
+{
+  fd->first_bhead_offset = fd->file->offset;
+  /* Undo steps have no index, and blocks are only read at offsets in seekable files. */
+  if ((fd->flags & FD_FLAGS_IS_MEMFILE) || fd->file->seek == nullptr) {
+    return;
+  }
+  /* The index stores 64 bit #BHead.old values. */
+  if (fd->blender_header.pointer_size != 8 || sizeof(void *) != 8) {
+    return;
+  }
+
+  const std::optional<int64_t> index_offset = BLO_bhead_index_offset_read(fd->file);
+  if (index_offset) {
+    std::optional<BHead> bhead;
+    if (fd->file->seek(fd->file, *index_offset, SEEK_SET) != -1) {
+      bhead = BLO_readfile_read_bhead(fd->file, fd->blender_header.bhead_type());
+    }
+    if (bhead && bhead->code == BLO_CODE_IDIX && bhead->len > 0) {
+      Array<char> data(bhead->len, NoInitialization());
+      if (fd->file->read(fd->file, data.data(), size_t(bhead->len)) == bhead->len) {
+        fd->bhead_index = BHeadIndex::deserialize(data);
+      }
+    }
+    if (!fd->bhead_index) {
+      CLOG_WARN(&LOG, "%s: ignoring invalid block index", fd->relabase);
+    }
+  }
+
+  /* Blocks are read sequentially from the start of the file by default. */
+  if (fd->file->seek(fd->file, fd->first_bhead_offset, SEEK_SET) == -1) {
+    fd->is_eof = true;
+  }
+}
+
+/**
+ * Get the block of an ID using the #BHeadIndex.
+ * The index is discarded if it does not match the file content.
+ */
+static BHead *bhead_from_index_entry(FileData *fd, const BHeadIndexEntry &entry)
+{
+  BHead *bhead = blo_bhead_at_offset(fd, entry.bhead_offset);
+  if (bhead == nullptr || bhead->code != entry.code ||
+      uint64_t(uintptr_t(bhead->old)) != entry.old)
+  {
+    CLOG_WARN(&LOG, "%s: block index does not match the file, ignoring it", fd->relabase);
+    fd->bhead_index.reset();
+    return nullptr;
+  }
+  return bhead;
+}
+
+/**
+ * Get the #BLO_CODE_GLOB or #BLO_CODE_DNA1 block at the given offset from the #BHeadIndex.
+ */
+static BHead *bhead_from_index_offset(FileData *fd, const int64_t offset, const int code)
+{
+  if (offset == -1) {
+    return nullptr;
+  }
+  BHead *bhead = blo_bhead_at_offset(fd, offset);
+  if (bhead == nullptr || bhead->code != code) {
+    CLOG_WARN(&LOG, "%s: block index does not match the file, ignoring it", fd->relabase);
+    fd->bhead_index.reset();
+    return nullptr;
+  }
+  return bhead;
+}
+
 /**
  * \return Success if the file is read correctly, else set \a r_error_message.
  */
@@ -892,7 +1052,28 @@ static bool read_file_dna(FileData *fd, const char **r_error_message)
   BHead *bhead;
   int subversion = 0;
 
-  for (bhead = blo_bhead_first(fd); bhead; bhead = blo_bhead_next(fd, bhead)) {
+  /* Avoid reading all blocks to find the DNA at the end of the file. */
+  Vector<BHead *, 2> indexed_bheads;
+  if (fd->bhead_index) {
+    BHead *glob = bhead_from_index_offset(fd, fd->bhead_index->glob_offset, BLO_CODE_GLOB);
+    BHead *dna = fd->bhead_index ?
+                     bhead_from_index_offset(fd, fd->bhead_index->dna_offset, BLO_CODE_DNA1) :
+                     nullptr;
+    if (glob && dna) {
+      indexed_bheads = {glob, dna};
+    }
+  }
+  auto next_bhead = [&](BHead *bhead) -> BHead * {
+    if (indexed_bheads.is_empty()) {
+      return bhead ? blo_bhead_next(fd, bhead) : blo_bhead_first(fd);
+    }
+    if (bhead == nullptr) {
+      return indexed_bheads.first();
+    }
+    return bhead == indexed_bheads.first() ? indexed_bheads.last() : nullptr;
+  };
+
+  for (bhead = next_bhead(nullptr); bhead; bhead = next_bhead(bhead)) {
     if (bhead->code == BLO_CODE_GLOB) {
       /* Before this, the subversion didn't exist in 'FileGlobal' so the subversion
        * value isn't accessible for the purpose of DNA versioning in this case. */
@@ -1229,9 +1410,14 @@ static bool is_minversion_older_than_blender(FileData *fd, ReportList *reports)
   return false;
 }
 
-static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
+static FileData *blo_decode_and_check(FileData *fd,
+                                      ReportList *reports,
+                                      const bool use_bhead_index)
 {
   read_blender_header(fd);
+  if ((fd->flags & FD_FLAGS_FILE_OK) && use_bhead_index) {
+    read_file_bhead_index(fd);
+  }
 
   if (fd->flags & FD_FLAGS_SWITCH_ENDIAN) {
     BLI_STATIC_ASSERT(ENDIAN_ORDER == L_ENDIAN, "Blender only builds on little endian systems")
@@ -1311,14 +1497,16 @@ static FileData *blo_filedata_from_file_open(const char *filepath, BlendFileRead
   return blo_filedata_from_file_descriptor(filepath, reports, file);
 }
 
-FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *reports)
+FileData *blo_filedata_from_file(const char *filepath,
+                                 BlendFileReadReport *reports,
+                                 const bool use_bhead_index)
 {
   FileData *fd = blo_filedata_from_file_open(filepath, reports);
   if (fd != nullptr) {
     /* needed for library_append and read_libraries */
     STRNCPY(fd->relabase, filepath);
 
-    return blo_decode_and_check(fd, reports->reports);
+    return blo_decode_and_check(fd, reports->reports, use_bhead_index);
   }
   return nullptr;
 }
@@ -1359,7 +1547,7 @@ FileData *blo_filedata_from_memory(const void *mem,
   FileData *fd = filedata_new(reports);
   fd->file = file;
 
-  return blo_decode_and_check(fd, reports->reports);
+  return blo_decode_and_check(fd, reports->reports, false);
 }
 
 FileData *blo_filedata_from_memfile(MemFile *memfile,
@@ -1376,7 +1564,7 @@ FileData *blo_filedata_from_memfile(MemFile *memfile,
   fd->undo_direction = params->undo_direction;
   fd->flags |= FD_FLAGS_IS_MEMFILE;
 
-  return blo_decode_and_check(fd, reports->reports);
+  return blo_decode_and_check(fd, reports->reports, false);
 }
 
 void blo_filedata_free(FileData *fd)
@@ -4340,6 +4528,7 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
       case BLO_CODE_DNA1:
       case BLO_CODE_TEST: /* used as preview since 2.5x */
       case BLO_CODE_REND:
+      case BLO_CODE_IDIX:
         bhead = blo_bhead_next(fd, bhead);
         break;
       case BLO_CODE_GLOB:
@@ -4752,6 +4941,29 @@ static BHead *find_previous_lib(FileData *fd, BHead *bhead)
     return nullptr;
   }
 
+  if (fd->bhead_index) {
+    /* Previous blocks may not be loaded, the index knows the owning library. */
+    if (const BHeadIndexEntry *entry = fd->bhead_index->lookup_old(
+            uint64_t(uintptr_t(bhead->old))))
+    {
+      if (entry->library_index == -1) {
+        return nullptr;
+      }
+      const BHeadIndexEntry &library_entry = fd->bhead_index->entries()[entry->library_index];
+      if (BHead *bheadlib = bhead_from_index_entry(fd, library_entry)) {
+        return bheadlib;
+      }
+    }
+    /* Read all blocks when the index is missing data or invalid. */
+    for (BHead *bhead_iter = blo_bhead_first(fd); bhead_iter;
+         bhead_iter = blo_bhead_next(fd, bhead_iter))
+    {
+      if (bhead_iter == bhead) {
+        break;
+      }
+    }
+  }
+
   for (; bhead; bhead = blo_bhead_prev(fd, bhead)) {
     if (bhead->code == ID_LI) {
       break;
@@ -4772,6 +4984,15 @@ static BHead *find_bhead(FileData *fd, void *old)
     return nullptr;
   }
 
+  if (fd->bheadmap == nullptr && fd->bhead_index) {
+    /* ID pointers can be resolved without reading all blocks. */
+    if (const BHeadIndexEntry *entry = fd->bhead_index->lookup_old(uint64_t(uintptr_t(old)))) {
+      if (BHead *bhead = bhead_from_index_entry(fd, *entry)) {
+        return bhead;
+      }
+    }
+  }
+
   if (fd->bheadmap == nullptr) {
     sort_bhead_old_map(fd);
   }
@@ -4795,18 +5016,96 @@ static BHead *find_bhead(FileData *fd, void *old)
   return nullptr;
 }
 
+/**
+ * Load the blocks of the IDs that linking the ID of \a entry pulls in, using the dependency hints
+ * of the #BHeadIndex. They are loaded in file order with their data blocks, so that expanding the
+ * linked ID afterwards doesn't have to seek back and forth through the file.
+ */
+static void bhead_index_read_dependencies(FileData *fd, const BHeadIndexEntry &entry)
+{
+  const BHeadIndex &index = *fd->bhead_index;
+  Set<const BHeadIndexEntry *> entries_to_read = {&entry};
+  Vector<const BHeadIndexEntry *> entries_to_visit = {&entry};
+  while (!entries_to_visit.is_empty()) {
+    const BHeadIndexEntry *entry_iter = entries_to_visit.pop_last();
+    /* Linked IDs are only read as placeholders, they are not expanded. */
+    if (entry_iter->library_index != -1) {
+      continue;
+    }
+    for (const uint64_t old : index.dependencies(*entry_iter)) {
+      const BHeadIndexEntry *dependency = index.lookup_old(old);
+      if (dependency && entries_to_read.add(dependency)) {
+        entries_to_visit.append(dependency);
+      }
+    }
+  }
+
+  Vector<const BHeadIndexEntry *> entries(entries_to_read.begin(), entries_to_read.end());
+  std::sort(entries.begin(), entries.end(), [](const auto *a, const auto *b) {
+    return a->bhead_offset < b->bhead_offset;
+  });
+  for (const BHeadIndexEntry *entry_iter : entries) {
+    BHead *bhead = bhead_from_index_entry(fd, *entry_iter);
+    if (bhead == nullptr) {
+      /* The index was invalid and has been freed. */
+      return;
+    }
+    do {
+      bhead = blo_bhead_next(fd, bhead);
+    } while (bhead && bhead->code == BLO_CODE_DATA);
+  }
+}
+
+/**
+ * Find a linkable ID block by name in #FileData.bhead_idname_map, which is filled from the
+ * #BHeadIndex as needed when the file has one.
+ */
+static BHead *find_bhead_from_idname_map(FileData *fd, const char *idname)
+{
+  if (BHead *bhead = fd->bhead_idname_map->lookup_default(idname, nullptr)) {
+    return bhead;
+  }
+  if (!fd->bhead_index) {
+    return nullptr;
+  }
+  const BHeadIndexEntry *entry = fd->bhead_index->lookup_name(idname);
+  if (entry == nullptr) {
+    return nullptr;
+  }
+  BHead *bhead = bhead_from_index_entry(fd, *entry);
+  if (bhead == nullptr) {
+    /* The index was invalid, fall back to reading all blocks. */
+    fd->bhead_idname_map.reset();
+    read_file_bhead_idname_map_create(fd);
+    return fd->bhead_idname_map->lookup_default(idname, nullptr);
+  }
+  /* Same checks as #read_file_bhead_idname_map_create. */
+  if (!blo_bhead_is_id_valid_type(bhead) ||
+      !BKE_idtype_idcode_is_linkable(short(bhead->code)))
+  {
+    return nullptr;
+  }
+  const char *bhead_idname = blo_bhead_id_name(fd, bhead);
+  if (bhead_idname == nullptr || !STREQ(bhead_idname, idname)) {
+    return nullptr;
+  }
+  fd->bhead_idname_map->add(bhead_idname, bhead);
+  bhead_index_read_dependencies(fd, *entry);
+  return bhead;
+}
+
 static BHead *find_bhead_from_code_name(FileData *fd, const short idcode, const char *name)
 {
   char idname_full[MAX_ID_NAME];
   *(reinterpret_cast<short *>(idname_full)) = idcode;
   BLI_strncpy(idname_full + 2, name, sizeof(idname_full) - 2);
 
-  return fd->bhead_idname_map->lookup_default(idname_full, nullptr);
+  return find_bhead_from_idname_map(fd, idname_full);
 }
 
 static BHead *find_bhead_from_idname(FileData *fd, const char *idname)
 {
-  BHead *bhead = fd->bhead_idname_map->lookup_default(idname, nullptr);
+  BHead *bhead = find_bhead_from_idname_map(fd, idname);
   if (bhead) [[likely]] {
     return bhead;
   }
@@ -5885,7 +6184,8 @@ static FileData *read_library_file_data(FileData *basefd, Main *bmain, Main *lib
                      lib_bmain->curlib->runtime->filepath_abs,
                      lib_bmain->curlib->filepath,
                      library_parent_filepath(lib_bmain->curlib));
-    fd = blo_filedata_from_file(lib_bmain->curlib->runtime->filepath_abs, basefd->reports);
+    fd = blo_filedata_from_file(
+        lib_bmain->curlib->runtime->filepath_abs, basefd->reports, true);
   }
 
   if (fd) {
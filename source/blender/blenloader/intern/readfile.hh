@@ -25,6 +25,7 @@
 #include "DNA_space_types.h"
 
 #include "BLO_core_bhead.hh"
+#include "BLO_core_bhead_index.hh"
 #include "BLO_core_blend_header.hh"
 #include "BLO_readfile.hh"
 
@@ -80,10 +81,25 @@ ENUM_OPERATORS(eFileDataFlag)
  * be accessed concurrently.
  */
 struct FileData {
-  /** Linked list of BHeadN's. */
+  /** Linked list of BHeadN's, sorted by file offset. */
   ListBaseT<BHeadN> bhead_list = {};
   enum eFileDataFlag flags = eFileDataFlag(0);
   bool is_eof = false;
+  /** File offset of the first #BHead, right after the file header. */
+  off64_t first_bhead_offset = -1;
+
+  /**
+   * Index of the ID blocks, read from the end of the file if it has one. Used to read only the
+   * blocks that are needed, e.g. when linking from a library.
+   */
+  std::optional<BHeadIndex> bhead_index;
+  /**
+   * Set once blocks were read at an offset from #bhead_index. #bhead_list may then have gaps,
+   * which are filled in when iterating over the blocks.
+   */
+  bool bhead_list_has_gaps = false;
+  /** Loaded blocks by their file offset, only maintained while #bhead_list has gaps. */
+  Map<off64_t, BHeadN *> bhead_by_offset;
   BlenderHeader blender_header = {};
 
   FileReader *file = nullptr;
@@ -236,7 +252,13 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath) ATTR_N
  *
  * cannot be called with relative paths anymore!
  */
-FileData *blo_filedata_from_file(const char *filepath, BlendFileReadReport *reports);
+/**
+ * \param use_bhead_index: Read only the needed blocks using the #BHeadIndex of the file, if it
+ * has one. Meant for partial reads like linking, loading the whole file doesn't benefit from it.
+ */
+FileData *blo_filedata_from_file(const char *filepath,
+                                 BlendFileReadReport *reports,
+                                 bool use_bhead_index);
 FileData *blo_filedata_from_memory(const void *mem, int memsize, BlendFileReadReport *reports);
 FileData *blo_filedata_from_memfile(MemFile *memfile,
                                     const BlendFileReadParams *params,
@@ -10,6 +10,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <fcntl.h>
+#include <mutex>
+#include <xxhash.h>
+#include <zstd.h>
 
 /* open/close */
 #ifndef _WIN32
@@ -24,6 +27,8 @@
 
 #include "BLI_implicit_sharing.hh"
 #include "BLI_listbase.hh"
+#include "BLI_map.hh"
+#include "BLI_task_c.hh"
 
 #include "BLO_readfile.hh"
 #include "BLO_undofile.hh"
@@ -38,14 +43,194 @@
 
 namespace blender {
 
+/* Chunks smaller than this are not worth compressing. */
+#define MEMFILE_COMPRESS_MIN_SIZE 256
+#define MEMFILE_COMPRESSION_LEVEL 1
+
+/* -------------------------------------------------------------------- */
+/** \name Chunk Data Storage
+ *
+ * The content of all chunks of all memfiles is stored in a single content-addressed store,
+ * keyed by a hash of the data. Chunks with identical data share a #MemFileChunkData, even when
+ * they are at different positions of the stream (e.g. after some data was inserted before them)
+ * or when the data was only present in older undo steps.
+ * \{ */
+
+struct MemFileChunkData : public ImplicitSharingInfo {
+  uint64_t hash = 0;
+  size_t size = 0;
+  /** Uncompressed content, null while the data is compressed. */
+  char *buf = nullptr;
+  char *compressed_buf = nullptr;
+  size_t compressed_size = 0;
+  /** False when the hash was already taken by different data (collision). */
+  bool is_in_store = false;
+  /**
+   * The memfile that counts this data in its #MemFile.size, null when that memfile has been
+   * freed while other memfiles still use the data. Only the owner compresses the data, and its
+   * size is updated when the data is compressed or decompressed.
+   */
+  MemFile *owner = nullptr;
+
+ private:
+  void delete_self_with_data() override;
+};
+
+struct MemFileChunkStore {
+  std::mutex mutex;
+  Map<uint64_t, MemFileChunkData *> data_by_hash;
+  /** Pending #BLO_memfile_compress tasks, only accessed from the main thread. */
+  TaskPool *compress_pool = nullptr;
+};
+
+static MemFileChunkStore &memfile_chunk_store()
+{
+  static MemFileChunkStore store;
+  return store;
+}
+
+void MemFileChunkData::delete_self_with_data()
+{
+  if (is_in_store) {
+    MemFileChunkStore &store = memfile_chunk_store();
+    std::lock_guard lock(store.mutex);
+    store.data_by_hash.remove_contained(hash);
+  }
+  MEM_SAFE_DELETE(buf);
+  MEM_SAFE_DELETE(compressed_buf);
+  MEM_delete(this);
+}
+
+/** Size of the data as it is currently stored. */
+static size_t memfile_chunk_data_stored_size(const MemFileChunkData *data)
+{
+  return data->buf ? data->size : data->compressed_size;
+}
+
+/** Compressed data is decompressed on first access and then stays uncompressed. */
+static const char *memfile_chunk_data_buf(MemFileChunkData *data)
+{
+  if (data->buf == nullptr) {
+    BLI_assert(data->compressed_buf != nullptr);
+    char *buf = MEM_new_array_uninitialized<char>(data->size, "Chunk buffer");
+    const size_t size = ZSTD_decompress(
+        buf, data->size, data->compressed_buf, data->compressed_size);
+    BLI_assert(!ZSTD_isError(size) && size == data->size);
+    UNUSED_VARS_NDEBUG(size);
+    if (data->owner) {
+      data->owner->size += data->size - data->compressed_size;
+    }
+    data->buf = buf;
+    MEM_SAFE_DELETE(data->compressed_buf);
+    data->compressed_size = 0;
+  }
+  return data->buf;
+}
+
+/**
+ * Get the existing data with the same content or add a new one.
+ * In both cases the caller becomes a user of the returned data.
+ */
+static MemFileChunkData *memfile_chunk_data_ensure(MemFile *memfile,
+                                                   const char *buf,
+                                                   const size_t size)
+{
+  const uint64_t hash = XXH3_64bits(buf, size);
+
+  MemFileChunkStore &store = memfile_chunk_store();
+  std::lock_guard lock(store.mutex);
+
+  MemFileChunkData *existing_data = store.data_by_hash.lookup_default(hash, nullptr);
+  if (existing_data && existing_data->size == size &&
+      memcmp(memfile_chunk_data_buf(existing_data), buf, size) == 0)
+  {
+    existing_data->add_user();
+    return existing_data;
+  }
+
+  MemFileChunkData *data = MEM_new<MemFileChunkData>("MemFileChunkData");
+  data->hash = hash;
+  data->size = size;
+  char *buf_new = MEM_new_array_uninitialized<char>(size, "Chunk buffer");
+  memcpy(buf_new, buf, size);
+  data->buf = buf_new;
+  data->owner = memfile;
+  memfile->size += size;
+  /* On hash collisions the new data is just not shared. */
+  if (existing_data == nullptr) {
+    store.data_by_hash.add_new(hash, data);
+    data->is_in_store = true;
+  }
+  return data;
+}
+
+/** Ensure that no background compression is accessing chunk data anymore. */
+static void memfile_chunk_store_wait()
+{
+  MemFileChunkStore &store = memfile_chunk_store();
+  if (store.compress_pool) {
+    BLI_task_pool_work_and_wait(store.compress_pool);
+    BLI_task_pool_free(store.compress_pool);
+    store.compress_pool = nullptr;
+  }
+}
+
+static void memfile_compress_task(TaskPool *__restrict /*pool*/, void *taskdata)
+{
+  MemFile *memfile = static_cast<MemFile *>(taskdata);
+  ZSTD_CCtx *ctx = ZSTD_createCCtx();
+
+  for (MemFileChunk &chunk : memfile->chunks) {
+    MemFileChunkData *data = chunk.data;
+    /* Data shared with other chunks is likely to be used by more recent steps too. Data counted
+     * by another memfile is skipped as well, its savings would not show up in this memfile. */
+    if (!data->is_mutable() || data->owner != memfile || data->buf == nullptr ||
+        data->size < MEMFILE_COMPRESS_MIN_SIZE)
+    {
+      continue;
+    }
+    const size_t bound = ZSTD_compressBound(data->size);
+    char *compressed_buf = MEM_new_array_uninitialized<char>(bound, __func__);
+    const size_t compressed_size = ZSTD_compressCCtx(
+        ctx, compressed_buf, bound, data->buf, data->size, MEMFILE_COMPRESSION_LEVEL);
+    if (ZSTD_isError(compressed_size) || compressed_size >= data->size) {
+      MEM_delete(compressed_buf);
+      continue;
+    }
+    data->compressed_buf = MEM_new_array_uninitialized<char>(compressed_size, "Chunk buffer");
+    memcpy(data->compressed_buf, compressed_buf, compressed_size);
+    data->compressed_size = compressed_size;
+    MEM_delete(compressed_buf);
+    MEM_SAFE_DELETE(data->buf);
+
+    memfile->size -= data->size - compressed_size;
+  }
+
+  ZSTD_freeCCtx(ctx);
+}
+
+void BLO_memfile_compress(MemFile *memfile)
+{
+  MemFileChunkStore &store = memfile_chunk_store();
+  if (store.compress_pool == nullptr) {
+    store.compress_pool = BLI_task_pool_create_background(nullptr, TASK_PRIORITY_LOW);
+  }
+  BLI_task_pool_push(store.compress_pool, memfile_compress_task, memfile, false, nullptr);
+}
+
+/** \} */
+
 /* **************** support for memory-write, for undo buffers *************** */
 
 void BLO_memfile_free(MemFile *memfile)
 {
+  memfile_chunk_store_wait();
   while (MemFileChunk *chunk = static_cast<MemFileChunk *>(BLI_pophead(&memfile->chunks))) {
-    if (chunk->is_identical == false) {
-      MEM_delete(chunk->buf);
+    if (chunk->data->owner == memfile) {
+      /* Still used by other memfiles, which did not count it. */
+      chunk->data->owner = nullptr;
     }
+    chunk->data->remove_user_and_delete_if_last();
     MEM_delete(chunk);
   }
   MEM_SAFE_DELETE(memfile->shared_storage);
@@ -62,32 +247,15 @@ MemFileSharedStorage::~MemFileSharedStorage()
 
 void BLO_memfile_merge(MemFile *first, MemFile *second)
 {
-  /* We use this mapping to store the memory buffers from second memfile chunks which are not owned
-   * by it (i.e. shared with some previous memory steps). */
-  Map<const char *, MemFileChunk *> buffer_to_second_memchunk;
-
-  /* First, detect all memchunks in second memfile that are not owned by it. */
-  for (MemFileChunk &sc : second->chunks) {
-    if (sc.is_identical) {
-      buffer_to_second_memchunk.add(sc.buf, &sc);
+  /* Chunk data is reference counted, data still used by the second memfile is kept alive by its
+   * own users. Only the accounting of its size is transferred. */
+  memfile_chunk_store_wait();
+  for (MemFileChunk &chunk : second->chunks) {
+    if (chunk.data->owner == first) {
+      chunk.data->owner = second;
+      second->size += memfile_chunk_data_stored_size(chunk.data);
     }
   }
-
-  /* Now, check all chunks from first memfile (the one we are removing), and if a memchunk owned by
-   * it is also used by the second memfile, transfer the ownership. */
-  for (MemFileChunk &fc : first->chunks) {
-    if (!fc.is_identical) {
-      if (MemFileChunk *sc = buffer_to_second_memchunk.lookup_default(fc.buf, nullptr)) {
-        BLI_assert(sc->is_identical);
-        sc->is_identical = false;
-        fc.is_identical = true;
-      }
-      /* Note that if the second memfile does not use that chunk, we assume that the first one
-       * fully owns it without sharing it with any other memfile, and hence it should be freed with
-       * it. */
-    }
-  }
-
   BLO_memfile_free(first);
 }
 
@@ -105,6 +273,9 @@ void BLO_memfile_write_init(WriteData *wd,
 {
   wd->use_memfile = true;
 
+  /* The reference memfile may be compressed in the background. */
+  memfile_chunk_store_wait();
+
   mem_data->written_memfile = written_memfile;
   mem_data->reference_memfile = reference_memfile;
   mem_data->reference_current_chunk = reference_memfile ? static_cast<MemFileChunk *>(
@@ -139,7 +310,7 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
 
   MemFileChunk *curchunk = MEM_new_uninitialized<MemFileChunk>("MemFileChunk");
   curchunk->size = size;
-  curchunk->buf = nullptr;
+  curchunk->data = nullptr;
   curchunk->is_identical = false;
   /* This is unsafe in the sense that an app handler or other code that does not
    * perform an undo push may make changes after the last undo push that
@@ -148,12 +319,14 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
   curchunk->id_session_uid = mem_data->current_id_session_uid;
   BLI_addtail(&memfile->chunks, curchunk);
 
-  /* we compare compchunk with buf */
+  /* We compare compchunk with buf, this is the common case of unchanged data and avoids
+   * hashing. */
   if (*compchunk_step != nullptr) {
     MemFileChunk *compchunk = *compchunk_step;
     if (compchunk->size == curchunk->size) {
-      if (memcmp(compchunk->buf, buf, size) == 0) {
-        curchunk->buf = compchunk->buf;
+      if (memcmp(memfile_chunk_data_buf(compchunk->data), buf, size) == 0) {
+        compchunk->data->add_user();
+        curchunk->data = compchunk->data;
         curchunk->is_identical = true;
         compchunk->is_identical_future = true;
       }
@@ -161,12 +334,9 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
     *compchunk_step = static_cast<MemFileChunk *>(compchunk->next);
   }
 
-  /* not equal... */
-  if (curchunk->buf == nullptr) {
-    char *buf_new = MEM_new_array_uninitialized<char>(size, "Chunk buffer");
-    memcpy(buf_new, buf, size);
-    curchunk->buf = buf_new;
-    memfile->size += size;
+  /* Not equal, but the same data may still exist elsewhere in this or any other step. */
+  if (curchunk->data == nullptr) {
+    curchunk->data = memfile_chunk_data_ensure(memfile, buf, size);
   }
 }
 
@@ -245,7 +415,9 @@ static int64_t undo_read(FileReader *reader, void *buffer, size_t size)
         readsize = chunk->size - chunkoffset;
       }
 
-      memcpy(POINTER_OFFSET(buffer, totread), chunk->buf + chunkoffset, readsize);
+      memcpy(POINTER_OFFSET(buffer, totread),
+             memfile_chunk_data_buf(chunk->data) + chunkoffset,
+             readsize);
       totread += readsize;
       undo->reader.offset += off64_t(readsize);
       seek += readsize;
@@ -271,6 +443,8 @@ static void undo_close(FileReader *reader)
 
 FileReader *BLO_memfile_new_filereader(MemFile *memfile, int undo_direction)
 {
+  memfile_chunk_store_wait();
+
   UndoReader *undo = MEM_new_zeroed<UndoReader>(__func__);
 
   undo->memfile = memfile;
@@ -168,6 +168,18 @@ namespace blender {
 
 #define ZSTD_COMPRESSION_LEVEL 3
 
+/** Range of levels used by #BlendFileWriteParams::use_adaptive_compression. */
+#define ZSTD_ADAPTIVE_LEVEL_MIN 1
+#define ZSTD_ADAPTIVE_LEVEL_MAX 9
+/** Amount of written frames between two adaptive level updates. */
+#define ZSTD_ADAPTIVE_UPDATE_FRAMES 16
+
+/**
+ * Maximum number of frames pending compression or writing, per thread.
+ * Once reached, serialization waits for the oldest frame to be written.
+ */
+#define ZSTD_FRAMES_IN_FLIGHT_PER_THREAD 4
+
 static CLG_LogRef LOG = {"blend.writefile"};
 static CLG_LogRef LOG_UNDO = {"undo"};
 
@@ -228,6 +240,9 @@ class ZstdWriteWrap : public WriteWrap {
     uint32_t compressed_size = 0;
     const void *compressed_data = nullptr;
 
+    /** Time spent compressing this frame, used for adaptive compression level. */
+    double compress_time = 0.0;
+
     /**
      * Marker that the related compression task is done.
      *
@@ -269,8 +284,35 @@ class ZstdWriteWrap : public WriteWrap {
    */
   std::atomic<bool> write_error = false;
 
+  /**
+   * Bounds the amount of frames in the pipeline (see #ZSTD_FRAMES_IN_FLIGHT_PER_THREAD), so that
+   * memory usage doesn't grow with the file size when compression is slower than serialization.
+   */
+  int max_frames_in_flight = 0;
+  /** Notified by compression tasks when a frame is done, to wake up a waiting #write. */
+  std::mutex frame_done_mutex;
+  std::condition_variable frame_done_cond;
+
+  /** Level used for newly compressed frames, only changes in adaptive mode. */
+  std::atomic<int> compression_level = ZSTD_COMPRESSION_LEVEL;
+  bool use_adaptive_level = false;
+  /**
+   * Throughput measurements since the last adaptive level update.
+   * Only accessed from the main thread.
+   */
+  struct {
+    int frames_num = 0;
+    size_t uncompressed_size = 0;
+    size_t compressed_size = 0;
+    double compress_time = 0.0;
+    double write_time = 0.0;
+  } throughput;
+
  public:
-  ZstdWriteWrap(WriteWrap &base_wrap) : base_wrap(base_wrap) {}
+  ZstdWriteWrap(WriteWrap &base_wrap, const bool use_adaptive_level)
+      : base_wrap(base_wrap), use_adaptive_level(use_adaptive_level)
+  {
+  }
 
   bool open(const char *filepath) override;
   bool close() override;
@@ -287,6 +329,17 @@ class ZstdWriteWrap : public WriteWrap {
    * compression tasks to be done, to ensure that all frames have been compressed and written.
    */
   void write_compressed_frames();
+  /** Block until the amount of pending frames is below #max_frames_in_flight. */
+  void wait_for_frames_in_flight();
+  /**
+   * Pick the compression level for the next frames from the measured throughput, see
+   * #BlendFileWriteParams::use_adaptive_compression.
+   *
+   * Compressing harder only pays off while the disk is slower than the compression threads: the
+   * level goes up while the workers could compress at least twice as fast as the disk writes,
+   * and down as soon as they can't keep up with it anymore.
+   */
+  void update_adaptive_level();
   /** Utils to write uint32_t little endian values.  */
   void write_u32_le(uint32_t val);
   /**
@@ -308,13 +361,14 @@ void ZstdWriteWrap::compress_task_run(TaskPool *pool, void *taskdata)
   auto *frame = static_cast<ZstdFrame *>(taskdata);
   auto *ww = static_cast<ZstdWriteWrap *>(BLI_task_pool_user_data(pool));
 
+  const double start_time = BLI_time_now_seconds();
   size_t out_buf_len = ZSTD_compressBound(frame->uncompressed_size);
   void *out_buf = MEM_new_uninitialized(out_buf_len, "Zstd out buffer");
   const size_t out_size = ZSTD_compress(out_buf,
                                         out_buf_len,
                                         frame->uncompressed_data,
                                         frame->uncompressed_size,
-                                        ZSTD_COMPRESSION_LEVEL);
+                                        ww->compression_level.load(std::memory_order_relaxed));
   MEM_delete_void(frame->uncompressed_data);
   frame->uncompressed_data = nullptr;
 
@@ -328,7 +382,12 @@ void ZstdWriteWrap::compress_task_run(TaskPool *pool, void *taskdata)
   else {
     frame->compressed_size = uint32_t(out_size);
   }
-  frame->compressed_done = true;
+  frame->compress_time = BLI_time_now_seconds() - start_time;
+  {
+    std::lock_guard lock(ww->frame_done_mutex);
+    frame->compressed_done = true;
+  }
+  ww->frame_done_cond.notify_one();
 }
 
 void ZstdWriteWrap::write_compressed_frames()
@@ -342,15 +401,60 @@ void ZstdWriteWrap::write_compressed_frames()
     }
     if (!write_error) [[likely]] {
       BLI_assert(frame->compressed_size > 0);
+      const double start_time = BLI_time_now_seconds();
       const bool has_error = !base_wrap.write(frame->compressed_data, frame->compressed_size);
       if (has_error) [[unlikely]] {
         write_error = true;
       }
+      throughput.write_time += BLI_time_now_seconds() - start_time;
+      throughput.compress_time += frame->compress_time;
+      throughput.uncompressed_size += frame->uncompressed_size;
+      throughput.compressed_size += frame->compressed_size;
+      throughput.frames_num++;
     }
     next_frame++;
     BLI_assert(frame->uncompressed_data == nullptr);
     MEM_SAFE_DELETE_VOID(frame->compressed_data);
   }
+
+  if (use_adaptive_level && throughput.frames_num >= ZSTD_ADAPTIVE_UPDATE_FRAMES) {
+    update_adaptive_level();
+  }
+}
+
+void ZstdWriteWrap::wait_for_frames_in_flight()
+{
+  while (frames.size() - next_frame > max_frames_in_flight) {
+    const ZstdFrame &frame = *frames[next_frame];
+    {
+      std::unique_lock lock(frame_done_mutex);
+      frame_done_cond.wait(lock, [&]() { return bool(frame.compressed_done); });
+    }
+    write_compressed_frames();
+  }
+}
+
+void ZstdWriteWrap::update_adaptive_level()
+{
+  /* Avoid divisions by zero on very fast disks or timers with coarse resolution. */
+  const double min_time = 1e-6;
+  const int threads_num = std::max(BLI_task_scheduler_num_threads(), 1);
+  const double compress_rate = double(throughput.uncompressed_size) * threads_num /
+                               std::max(throughput.compress_time, min_time);
+  /* Express the disk speed in uncompressed bytes per second, to be comparable. */
+  const double write_rate = double(throughput.uncompressed_size) /
+                            std::max(throughput.write_time, min_time);
+
+  int level = compression_level.load(std::memory_order_relaxed);
+  if (compress_rate > write_rate * 2.0) {
+    level = std::min(level + 1, ZSTD_ADAPTIVE_LEVEL_MAX);
+  }
+  else if (compress_rate < write_rate) {
+    level = std::max(level - 1, ZSTD_ADAPTIVE_LEVEL_MIN);
+  }
+  compression_level.store(level, std::memory_order_relaxed);
+
+  throughput = {};
 }
 
 bool ZstdWriteWrap::open(const char *filepath)
@@ -360,6 +464,8 @@ bool ZstdWriteWrap::open(const char *filepath)
   }
 
   pool = BLI_task_pool_create_background(this, TASK_PRIORITY_HIGH);
+  max_frames_in_flight = std::max(BLI_task_scheduler_num_threads(), 1) *
+                         ZSTD_FRAMES_IN_FLIGHT_PER_THREAD;
 
   return true;
 }
@@ -434,6 +540,7 @@ bool ZstdWriteWrap::write(const void *buf, const size_t buf_len)
   BLI_task_pool_push(pool, compress_task_run, frame_p, false, nullptr);
 
   write_compressed_frames();
+  wait_for_frames_in_flight();
   return true;
 }
 
@@ -454,6 +561,12 @@ static WriteData *writedata_new(WriteWrap *ww)
 
   wd->ww = ww;
 
+  /* Undo steps are always read completely, they don't need an index. */
+  if (ww != nullptr) {
+    wd->bhead_index.emplace();
+    wd->bhead_index_library = -1;
+  }
+
   if ((ww == nullptr) || (ww->use_buf)) {
     if (ww == nullptr) {
       wd->buffer.max_size = MEM_BUFFER_SIZE;
@@ -540,6 +653,7 @@ static void mywrite(WriteData *wd, const void *adr, size_t len)
 #ifdef USE_WRITE_DATA_LEN
   wd->write_len += len;
 #endif
+  wd->file_offset += int64_t(len);
 
   if (wd->buffer.buf == nullptr) {
     writedata_do_write(wd, adr, len);
@@ -683,6 +797,7 @@ static void mywrite_id_begin(WriteData *wd, ID *id)
   const bool is_undo = wd->use_memfile;
 
   wd->stable_address_ids.next_id_hint = get_stable_pointer_hint_for_id(*id, is_undo);
+  wd->bhead_index_pending_id = id;
 
   if (is_undo) {
     wd->mem.current_id_session_uid = id->session_uid;
@@ -741,6 +856,7 @@ static void mywrite_id_end(WriteData *wd, ID * /*id*/)
 
   wd->validation_data.per_id_addresses_set.clear();
   wd->per_id_written_shared_addresses.clear();
+  wd->bhead_index_pending_id = nullptr;
 
   BLI_assert(wd->is_writing_id == true);
   wd->is_writing_id = false;
@@ -777,8 +893,79 @@ static bool write_at_address_validate(WriteData *wd, const int filecode, const v
   return true;
 }
 
+/**
+ * Dependency hints of the #BHeadIndex: the written addresses of the IDs that reading \a id pulls
+ * in when it is linked, matching what #expand_main in `readfile.cc` follows.
+ */
+static Vector<uint64_t> bhead_index_dependencies(WriteData *wd, const ID *id)
+{
+  Vector<uint64_t> dependencies;
+  BKE_library_foreach_ID_link(
+      nullptr,
+      const_cast<ID *>(id),
+      [&](LibraryIDLinkCallbackData *cb_data) {
+        const ID *id_used = *cb_data->id_pointer;
+        if (id_used == nullptr ||
+            (cb_data->cb_flag & (IDWALK_CB_EMBEDDED | IDWALK_CB_EMBEDDED_NOT_OWNING |
+                                 IDWALK_CB_DIRECT_WEAK_LINK | IDWALK_CB_READFILE_IGNORE)))
+        {
+          return IDWALK_RET_NOP;
+        }
+        if ((cb_data->cb_flag & IDWALK_CB_LOOPBACK) &&
+            !(cb_data->cb_flag & IDWALK_CB_OVERRIDE_LIBRARY_HIERARCHY_ROOT))
+        {
+          return IDWALK_RET_NOP;
+        }
+        const uint64_t address_id = wd->stable_address_ids.pointer_map.lookup_default(id_used, 0);
+        if (address_id != 0 && !dependencies.contains(address_id)) {
+          dependencies.append(address_id);
+        }
+        return IDWALK_RET_NOP;
+      },
+      nullptr,
+      IDWALK_READONLY);
+  return dependencies;
+}
+
+/** Add blocks that readers may want to access directly to the #BHeadIndex. */
+static void bhead_index_add(WriteData *wd, const BHead &bhead)
+{
+  BHeadIndex &index = *wd->bhead_index;
+  switch (bhead.code) {
+    case BLO_CODE_DATA:
+      return;
+    case BLO_CODE_GLOB:
+      index.glob_offset = wd->file_offset;
+      return;
+    case BLO_CODE_DNA1:
+      index.dna_offset = wd->file_offset;
+      return;
+  }
+  /* The first non-data block written for an ID is the ID itself. */
+  const ID *id = wd->bhead_index_pending_id;
+  if (id == nullptr) {
+    return;
+  }
+  wd->bhead_index_pending_id = nullptr;
+
+  const bool is_library = bhead.code == ID_LI;
+  const int entry_index = index.add(wd->file_offset,
+                                    uint64_t(uintptr_t(bhead.old)),
+                                    bhead.code,
+                                    is_library ? -1 : wd->bhead_index_library,
+                                    id->name,
+                                    bhead_index_dependencies(wd, id));
+  if (is_library) {
+    wd->bhead_index_library = entry_index;
+  }
+}
+
 static void write_bhead(WriteData *wd, const BHead &bhead)
 {
+  if (wd->bhead_index) {
+    bhead_index_add(wd, bhead);
+  }
+
   if constexpr (sizeof(void *) == 4) {
     /* Always write #BHead4 in 32 bit builds. */
     BHead4 bh;
@@ -1105,6 +1292,17 @@ static void writedata(WriteData *wd, const int filecode, const size_t len, const
   writedata(wd, filecode, adr, len, adr);
 }
 
+/**
+ * Write the #BHeadIndex block, and return its file offset for the #BHeadIndexFooter.
+ */
+static int64_t write_bhead_index(WriteData *wd)
+{
+  const Vector<char> data = wd->bhead_index->serialize();
+  const int64_t index_offset = wd->file_offset;
+  writedata(wd, BLO_CODE_IDIX, size_t(data.size()), data.data());
+  return index_offset;
+}
+
 /**
  * Use this to force writing of lists in same order as reading (using link_list).
  */
@@ -1877,11 +2075,25 @@ static bool write_file_handle(Main *mainvar,
    * so writing each time uses the same address and doesn't cause unnecessary undo overhead. */
   writedata(wd, BLO_CODE_DNA1, size_t(wd->sdna->data_size), wd->sdna->data);
 
+  std::optional<int64_t> bhead_index_offset;
+  if (wd->bhead_index) {
+    bhead_index_offset = write_bhead_index(wd);
+  }
+
   /* End of file. */
   BHead bhead{};
   bhead.code = BLO_CODE_ENDB;
   write_bhead(wd, bhead);
 
+  if (bhead_index_offset) {
+    /* Readers that don't know about the index stop at #BLO_CODE_ENDB. */
+    BHeadIndexFooter footer;
+    memcpy(footer.magic, BHEAD_INDEX_MAGIC, sizeof(footer.magic));
+    footer.version = BHEAD_INDEX_VERSION;
+    footer.index_offset = *bhead_index_offset;
+    mywrite(wd, &footer, sizeof(footer));
+  }
+
   return mywrite_end(wd);
 }
 
@@ -2188,7 +2400,7 @@ bool BLO_write_file(Main *mainvar,
   RawWriteWrap raw_wrap;
 
   if (write_flags & G_FILE_COMPRESS) {
-    ZstdWriteWrap zstd_wrap(raw_wrap);
+    ZstdWriteWrap zstd_wrap(raw_wrap, params->use_adaptive_compression);
     return BLO_write_file_impl(mainvar, filepath, write_flags, params, reports, zstd_wrap);
   }
 
@@ -17,10 +17,12 @@
 #include "BLI_map.hh"
 #include "BLI_set.hh"
 
+#include "BLO_core_bhead_index.hh"
 #include "BLO_undofile.hh"
 
 namespace blender {
 
+struct ID;
 class WriteWrap;
 
 struct WriteDataStableAddressIDs {
@@ -97,9 +99,19 @@ struct WriteData {
   size_t write_len;
 #endif
 
+  /** File offset of the next written byte (in the uncompressed file). */
+  int64_t file_offset;
+
   /** Whether writefile code is currently writing an ID. */
   bool is_writing_id;
 
+  /** Index of the written ID blocks, written at the end of the file (not used for undo). */
+  std::optional<BHeadIndex> bhead_index;
+  /** ID being written whose #BHead has not been added to #bhead_index yet. */
+  const ID *bhead_index_pending_id;
+  /** Index entry of the last written library, owning the linked IDs written after it. */
+  int bhead_index_library;
+
   /** Some validation and error handling data. */
   struct {
     /**
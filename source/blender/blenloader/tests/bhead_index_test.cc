@@ -0,0 +1,172 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cstring>
+
+#include "BLI_filereader.hh"
+#include "BLI_vector.hh"
+
+#include "BLO_core_bhead_index.hh"
+
+#include "DNA_ID_enums.h"
+
+namespace blender::tests {
+
+static constexpr uint64_t library_old = 0x1000;
+static constexpr uint64_t object_old = 0x2000;
+static constexpr uint64_t mesh_old = 0x3000;
+static constexpr uint64_t material_old = 0x4000;
+
+static BHeadIndex bhead_index_example()
+{
+  BHeadIndex index;
+  index.glob_offset = 100;
+  index.dna_offset = 9000;
+  const int library = index.add(200, library_old, ID_LI, -1, "LILibrary");
+  /* The object uses a mesh that is written after it, and a material that is not written. */
+  index.add(300, object_old, ID_OB, -1, "OBCube", {mesh_old, 0x5000});
+  index.add(800, mesh_old, ID_ME, -1, "MECube", {material_old});
+  index.add(1500, material_old, ID_MA, library, "MAMaterial");
+  return index;
+}
+
+/** Size of the #BHeadIndex data after the fixed size header. */
+static int64_t bhead_index_example_data_size()
+{
+  const int64_t names_size = strlen("LILibrary") + strlen("OBCube") + strlen("MECube") +
+                             strlen("MAMaterial") + 4;
+  return 4 * sizeof(BHeadIndexEntry) + 3 * sizeof(uint64_t) + names_size;
+}
+
+TEST(bhead_index, SerializeRoundTrip)
+{
+  const Vector<char> data = bhead_index_example().serialize();
+  const std::optional<BHeadIndex> index = BHeadIndex::deserialize(data);
+  ASSERT_TRUE(index.has_value());
+  EXPECT_EQ(index->glob_offset, 100);
+  EXPECT_EQ(index->dna_offset, 9000);
+  ASSERT_EQ(index->entries().size(), 4);
+
+  const BHeadIndexEntry *object = index->lookup_name("OBCube");
+  ASSERT_NE(object, nullptr);
+  EXPECT_EQ(object, index->lookup_old(object_old));
+  EXPECT_EQ(object->bhead_offset, 300);
+  EXPECT_EQ(object->code, ID_OB);
+  EXPECT_EQ(object->library_index, -1);
+  EXPECT_EQ(index->name(*object), "OBCube");
+  EXPECT_EQ(index->dependencies(*object), Span<uint64_t>({mesh_old, 0x5000}));
+
+  const BHeadIndexEntry *mesh = index->lookup_old(mesh_old);
+  ASSERT_NE(mesh, nullptr);
+  EXPECT_EQ(index->dependencies(*mesh), Span<uint64_t>({material_old}));
+
+  const BHeadIndexEntry *material = index->lookup_name("MAMaterial");
+  ASSERT_NE(material, nullptr);
+  EXPECT_TRUE(index->dependencies(*material).is_empty());
+  ASSERT_EQ(material->library_index, 0);
+  EXPECT_EQ(index->name(index->entries()[material->library_index]), "LILibrary");
+
+  EXPECT_EQ(index->lookup_name("OBMissing"), nullptr);
+  EXPECT_EQ(index->lookup_old(0x5000), nullptr);
+}
+
+TEST(bhead_index, SerializeEmpty)
+{
+  const std::optional<BHeadIndex> index = BHeadIndex::deserialize(BHeadIndex().serialize());
+  ASSERT_TRUE(index.has_value());
+  EXPECT_TRUE(index->entries().is_empty());
+  EXPECT_EQ(index->glob_offset, -1);
+  EXPECT_EQ(index->dna_offset, -1);
+}
+
+TEST(bhead_index, DeserializeCorrupt)
+{
+  const Vector<char> data = bhead_index_example().serialize();
+  const int64_t header_size = data.size() - bhead_index_example_data_size();
+  ASSERT_GT(header_size, 0);
+
+  auto modified = [&](const int64_t offset, const auto value) {
+    Vector<char> result = data;
+    memcpy(result.data() + offset, &value, sizeof(value));
+    return result;
+  };
+  auto entry_offset = [&](const int entry, const size_t member_offset) {
+    return header_size + entry * int64_t(sizeof(BHeadIndexEntry)) + int64_t(member_offset);
+  };
+  auto is_valid = [](const Span<char> index_data) {
+    return BHeadIndex::deserialize(index_data).has_value();
+  };
+
+  EXPECT_FALSE(is_valid({}));
+  EXPECT_FALSE(is_valid(data.as_span().drop_back(1)));
+  EXPECT_FALSE(is_valid(data.as_span().take_front(header_size - 1)));
+
+  /* Unknown version. */
+  EXPECT_FALSE(is_valid(modified(0, uint32_t(BHEAD_INDEX_VERSION + 1))));
+  /* Names are not null terminated. */
+  EXPECT_FALSE(is_valid(modified(data.size() - 1, 'x')));
+
+  const size_t library_index = offsetof(BHeadIndexEntry, library_index);
+  EXPECT_FALSE(is_valid(modified(entry_offset(3, library_index), int32_t(4))));
+  EXPECT_FALSE(is_valid(modified(entry_offset(3, library_index), int32_t(-2))));
+  const size_t name_offset = offsetof(BHeadIndexEntry, name_offset);
+  EXPECT_FALSE(is_valid(modified(entry_offset(1, name_offset), int64_t(10000))));
+  const size_t bhead_offset = offsetof(BHeadIndexEntry, bhead_offset);
+  EXPECT_FALSE(is_valid(modified(entry_offset(1, bhead_offset), int64_t(-1))));
+  const size_t dependencies_num = offsetof(BHeadIndexEntry, dependencies_num);
+  EXPECT_FALSE(is_valid(modified(entry_offset(1, dependencies_num), int64_t(4))));
+  const size_t dependencies_offset = offsetof(BHeadIndexEntry, dependencies_offset);
+  EXPECT_FALSE(is_valid(modified(entry_offset(2, dependencies_offset), int64_t(3))));
+  EXPECT_FALSE(is_valid(modified(entry_offset(2, dependencies_offset), int64_t(-1))));
+
+  /* Changing values that are not validated keeps the index readable. */
+  const std::optional<BHeadIndex> index = BHeadIndex::deserialize(
+      modified(entry_offset(1, bhead_offset), int64_t(400)));
+  ASSERT_TRUE(index.has_value());
+  EXPECT_EQ(index->lookup_name("OBCube")->bhead_offset, 400);
+}
+
+static std::optional<int64_t> footer_read(const Span<char> file_data)
+{
+  FileReader *file = BLI_filereader_new_memory(file_data.data(), file_data.size());
+  const std::optional<int64_t> index_offset = BLO_bhead_index_offset_read(file);
+  file->close(file);
+  return index_offset;
+}
+
+TEST(bhead_index, FooterRead)
+{
+  BHeadIndexFooter footer;
+  memcpy(footer.magic, BHEAD_INDEX_MAGIC, sizeof(footer.magic));
+  footer.version = BHEAD_INDEX_VERSION;
+  footer.index_offset = 1234;
+
+  Vector<char> file_data(100, 'E');
+  file_data.extend(reinterpret_cast<const char *>(&footer), sizeof(footer));
+  EXPECT_EQ(footer_read(file_data), 1234);
+
+  /* Files without an index end with #BLO_CODE_ENDB. */
+  EXPECT_FALSE(footer_read(file_data.as_span().drop_back(sizeof(footer))).has_value());
+  /* Too small to contain a footer. */
+  EXPECT_FALSE(footer_read(file_data.as_span().take_back(sizeof(footer) - 1)).has_value());
+
+  Vector<char> wrong_magic = file_data;
+  wrong_magic[file_data.size() - sizeof(footer)] = 'X';
+  EXPECT_FALSE(footer_read(wrong_magic).has_value());
+
+  footer.version = BHEAD_INDEX_VERSION + 1;
+  Vector<char> wrong_version(100, 'E');
+  wrong_version.extend(reinterpret_cast<const char *>(&footer), sizeof(footer));
+  EXPECT_FALSE(footer_read(wrong_version).has_value());
+
+  footer.version = BHEAD_INDEX_VERSION;
+  footer.index_offset = -1;
+  Vector<char> negative_offset(100, 'E');
+  negative_offset.extend(reinterpret_cast<const char *>(&footer), sizeof(footer));
+  EXPECT_FALSE(footer_read(negative_offset).has_value());
+}
+
+}  // namespace blender::tests
@@ -3,8 +3,25 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 #include "blendfile_loading_base_test.h"
 
+#include <fstream>
+
+#include "BKE_appdir.hh"
+#include "BKE_global.hh"
+#include "BKE_main.hh"
+#include "BKE_report.hh"
+
+#include "BLI_filereader.hh"
+#include "BLI_listbase.hh"
 #include "BLI_path_utils.hh"
 
+#include "BLO_core_bhead.hh"
+#include "BLO_core_bhead_index.hh"
+#include "BLO_core_blend_header.hh"
+#include "BLO_readfile.hh"
+#include "BLO_writefile.hh"
+
+#include "DNA_object_types.h"
+
 namespace blender {
 
 class BlendfileLoadingTest : public BlendfileLoadingBaseTest {};
@@ -19,4 +36,155 @@ TEST_F(BlendfileLoadingTest, CanaryTest)
   EXPECT_NE(nullptr, this->depsgraph);
 }
 
+class BlendfileBHeadIndexTest : public BlendfileLoadingBaseTest {
+ public:
+  void SetUp() override
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    BKE_tempdir_init(nullptr);
+  }
+
+  void TearDown() override
+  {
+    BlendfileLoadingBaseTest::TearDown();
+    BKE_tempdir_session_purge();
+  }
+
+  std::string temp_filepath(const char *filename)
+  {
+    return std::string(BKE_tempdir_session()) + SEP_STR + filename;
+  }
+
+  std::string write_file(const char *filename, const int write_flags)
+  {
+    const std::string filepath = this->temp_filepath(filename);
+    BlendFileWriteParams params{};
+    ReportList reports;
+    BKE_reports_init(&reports, RPT_STORE);
+    EXPECT_TRUE(BLO_write_file(bfile->main, filepath.c_str(), write_flags, &params, &reports));
+    BKE_reports_free(&reports);
+    return filepath;
+  }
+
+  /** Link an object, \return the name of its data, which is linked along with it. */
+  std::string link_object_data_name(const std::string &filepath, const Object &object)
+  {
+    ReportList reports;
+    BKE_reports_init(&reports, RPT_STORE);
+    TempLibraryContext *temp_lib_ctx = BLO_library_temp_load_id(
+        bfile->main, filepath.c_str(), ID_OB, object.id.name + 2, &reports);
+    std::string data_name;
+    if (const Object *linked_object = reinterpret_cast<const Object *>(temp_lib_ctx->temp_id)) {
+      EXPECT_STREQ(linked_object->id.name, object.id.name);
+      if (linked_object->data) {
+        data_name = static_cast<const ID *>(linked_object->data)->name;
+      }
+    }
+    BLO_library_temp_free(temp_lib_ctx);
+    BKE_reports_free(&reports);
+    return data_name;
+  }
+};
+
+static std::string file_read(const std::string &filepath)
+{
+  std::ifstream file(filepath, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void file_write(const std::string &filepath, const StringRef data)
+{
+  std::ofstream file(filepath, std::ios::binary);
+  file.write(data.data(), data.size());
+}
+
+TEST_F(BlendfileBHeadIndexTest, WriteAndLink)
+{
+  if (!blendfile_load("modifier_stack" SEP_STR "array_test.blend")) {
+    return;
+  }
+  const Object *object = static_cast<const Object *>(bfile->main->objects.first);
+  ASSERT_NE(object, nullptr);
+  ASSERT_NE(object->data, nullptr);
+  const char *data_name = static_cast<const ID *>(object->data)->name;
+
+  const std::string filepath = this->write_file("bhead_index.blend", 0);
+  const std::string file_data = file_read(filepath);
+
+  /* The file ends with the index block, #BLO_CODE_ENDB and the footer pointing to the index. */
+  FileReader *file = BLI_filereader_new_memory(file_data.data(), file_data.size());
+  const BlenderHeaderVariant header = BLO_readfile_blender_header_decode(file);
+  ASSERT_TRUE(std::holds_alternative<BlenderHeader>(header));
+  const BHeadType bhead_type = std::get<BlenderHeader>(header).bhead_type();
+  const std::optional<int64_t> index_offset = BLO_bhead_index_offset_read(file);
+  ASSERT_TRUE(index_offset.has_value());
+  ASSERT_EQ(file->seek(file, *index_offset, SEEK_SET), *index_offset);
+  const std::optional<BHead> index_bhead = BLO_readfile_read_bhead(file, bhead_type);
+  const int64_t index_data_offset = file->offset;
+  file->close(file);
+  ASSERT_TRUE(index_bhead.has_value());
+  EXPECT_EQ(index_bhead->code, BLO_CODE_IDIX);
+  EXPECT_EQ(index_data_offset + index_bhead->len + BLO_bhead_size(bhead_type) +
+                int64_t(sizeof(BHeadIndexFooter)),
+            int64_t(file_data.size()));
+
+  const std::optional<BHeadIndex> index = BHeadIndex::deserialize(
+      Span<char>(file_data.data() + index_data_offset, index_bhead->len));
+  ASSERT_TRUE(index.has_value());
+  EXPECT_NE(index->glob_offset, -1);
+  EXPECT_NE(index->dna_offset, -1);
+  const BHeadIndexEntry *object_entry = index->lookup_name(object->id.name);
+  const BHeadIndexEntry *data_entry = index->lookup_name(data_name);
+  ASSERT_NE(object_entry, nullptr);
+  ASSERT_NE(data_entry, nullptr);
+  EXPECT_EQ(object_entry->code, ID_OB);
+  EXPECT_EQ(object_entry->library_index, -1);
+  EXPECT_TRUE(index->dependencies(*object_entry).contains(data_entry->old));
+
+  /* Linking uses the index. */
+  EXPECT_EQ(this->link_object_data_name(filepath, *object), data_name);
+
+  /* Files without an index are read sequentially. */
+  const std::string filepath_no_index = this->temp_filepath("bhead_index_none.blend");
+  file_write(filepath_no_index, StringRef(file_data).drop_suffix(sizeof(BHeadIndexFooter)));
+  EXPECT_EQ(this->link_object_data_name(filepath_no_index, *object), data_name);
+
+  /* Point the object entry to the block of its data. Such an index is only detected as invalid
+   * when reading the block, which falls back to reading the file sequentially. */
+  std::string file_data_corrupt = file_data;
+  const size_t object_entry_offset = file_data_corrupt.find(
+      std::string_view(reinterpret_cast<const char *>(object_entry), sizeof(BHeadIndexEntry)),
+      index_data_offset);
+  ASSERT_NE(object_entry_offset, std::string::npos);
+  memcpy(file_data_corrupt.data() + object_entry_offset + offsetof(BHeadIndexEntry, bhead_offset),
+         &data_entry->bhead_offset,
+         sizeof(int64_t));
+  const std::string filepath_corrupt = this->temp_filepath("bhead_index_corrupt.blend");
+  file_write(filepath_corrupt, file_data_corrupt);
+  EXPECT_EQ(this->link_object_data_name(filepath_corrupt, *object), data_name);
+
+  /* Loading the whole file doesn't use the index. */
+  BlendFileReadReport bf_reports = {};
+  BlendFileData *bfile_read = BLO_read_from_file(
+      filepath.c_str(), BLO_READ_SKIP_NONE, &bf_reports);
+  ASSERT_NE(bfile_read, nullptr);
+  EXPECT_EQ(bfile_read->main->objects.count(), bfile->main->objects.count());
+  BLO_blendfiledata_free(bfile_read);
+}
+
+TEST_F(BlendfileBHeadIndexTest, LinkCompressed)
+{
+  if (!blendfile_load("modifier_stack" SEP_STR "array_test.blend")) {
+    return;
+  }
+  const Object *object = static_cast<const Object *>(bfile->main->objects.first);
+  ASSERT_NE(object, nullptr);
+  ASSERT_NE(object->data, nullptr);
+
+  /* Blocks are read at indexed offsets through the seek table of the compressed file. */
+  const std::string filepath = this->write_file("bhead_index_compressed.blend", G_FILE_COMPRESS);
+  EXPECT_EQ(this->link_object_data_name(filepath, *object),
+            static_cast<const ID *>(object->data)->name);
+}
+
 }  // namespace blender
@@ -0,0 +1,130 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_filereader.hh"
+#include "BLI_listbase.hh"
+#include "BLI_vector.hh"
+
+#include "BLO_undofile.hh"
+
+#include "BKE_undo_system.hh"
+
+namespace blender::tests {
+
+/** Write a memfile the way `writefile.cc` does, one chunk per element of `chunks`. */
+static void memfile_write(MemFile &memfile, MemFile *reference, Span<std::string> chunks)
+{
+  MemFileWriteData mem_data{};
+  mem_data.written_memfile = &memfile;
+  mem_data.reference_memfile = reference;
+  mem_data.reference_current_chunk = reference ? static_cast<MemFileChunk *>(
+                                                    reference->chunks.first) :
+                                                nullptr;
+  for (const std::string &chunk : chunks) {
+    BLO_memfile_chunk_add(&mem_data, chunk.data(), chunk.size());
+  }
+}
+
+static std::string memfile_read(MemFile &memfile)
+{
+  /* The reader does not handle reading past the end. */
+  size_t size = 0;
+  for (const MemFileChunk &chunk : memfile.chunks) {
+    size += chunk.size;
+  }
+  std::string result(size, '\0');
+  FileReader *reader = BLO_memfile_new_filereader(&memfile, STEP_UNDO);
+  EXPECT_EQ(reader->read(reader, result.data(), size), int64_t(size));
+  reader->close(reader);
+  return result;
+}
+
+/** Chunk content that compresses well, but differs for every `seed`. */
+static std::string compressible_chunk(const int seed)
+{
+  std::string chunk;
+  for (int i = 0; i < 64; i++) {
+    chunk += "chunk " + std::to_string(seed) + " line " + std::to_string(i) + "\n";
+  }
+  return chunk;
+}
+
+TEST(memfile_undo, SharedChunks)
+{
+  const std::string a = compressible_chunk(0);
+  const std::string b = compressible_chunk(1);
+  const std::string c = compressible_chunk(2);
+
+  MemFile first{};
+  memfile_write(first, nullptr, {a, b});
+  EXPECT_EQ(first.size, a.size() + b.size());
+
+  /* Inserting data shifts all following chunks, they are still shared by content. */
+  MemFile second{};
+  memfile_write(second, &first, {c, a, b});
+  EXPECT_EQ(second.size, c.size());
+  const MemFileChunk *first_b = static_cast<const MemFileChunk *>(first.chunks.last);
+  const MemFileChunk *second_b = static_cast<const MemFileChunk *>(second.chunks.last);
+  EXPECT_EQ(second_b->data, first_b->data);
+  EXPECT_FALSE(second_b->is_identical);
+
+  /* Merging transfers the size of the shared data to the remaining memfile. */
+  BLO_memfile_merge(&first, &second);
+  EXPECT_EQ(second.size, a.size() + b.size() + c.size());
+  EXPECT_EQ(memfile_read(second), c + a + b);
+
+  BLO_memfile_free(&second);
+}
+
+TEST(memfile_undo, CompressedChunks)
+{
+  const std::string a = compressible_chunk(0);
+  const std::string b = compressible_chunk(1);
+  const std::string c = compressible_chunk(2);
+
+  MemFile first{};
+  memfile_write(first, nullptr, {a, b});
+  MemFile second{};
+  memfile_write(second, &first, {a, c});
+
+  /* Only `b` is used by the first memfile alone. */
+  const size_t first_size = first.size;
+  BLO_memfile_compress(&first);
+  EXPECT_EQ(memfile_read(second), a + c);
+  EXPECT_LT(first.size, first_size);
+  EXPECT_GT(first.size, a.size());
+  EXPECT_EQ(second.size, c.size());
+
+  /* Reading decompresses the data, and its size is counted again. */
+  EXPECT_EQ(memfile_read(first), a + b);
+  EXPECT_EQ(first.size, first_size);
+
+  BLO_memfile_free(&first);
+  BLO_memfile_free(&second);
+}
+
+TEST(memfile_undo, CompressedChunksNotOwned)
+{
+  const std::string a = compressible_chunk(0);
+  const std::string b = compressible_chunk(1);
+
+  MemFile first{};
+  memfile_write(first, nullptr, {a});
+  MemFile second{};
+  memfile_write(second, &first, {b, a});
+  EXPECT_EQ(second.size, b.size());
+
+  /* `a` is only used by the second memfile now, but it is not counted in its size. Compressing
+   * it must not change the size of the second memfile beyond the data it owns. */
+  BLO_memfile_free(&first);
+  BLO_memfile_compress(&second);
+  EXPECT_EQ(memfile_read(second), b + a);
+  EXPECT_EQ(second.size, b.size());
+
+  BLO_memfile_free(&second);
+}
+
+}  // namespace blender::tests
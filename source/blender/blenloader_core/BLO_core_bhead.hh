@@ -101,6 +101,11 @@ enum {
    * (written to #BLENDER_STARTUP_FILE & #BLENDER_USERPREF_FILE).
    */
   BLO_CODE_USER = BLEND_MAKE_ID('U', 'S', 'E', 'R'),
+  /**
+   * Index of the ID blocks in the file, written right before #BLO_CODE_ENDB
+   * (ignored for regular file reading, see #BHeadIndex).
+   */
+  BLO_CODE_IDIX = BLEND_MAKE_ID('I', 'D', 'I', 'X'),
   /**
    * Terminate reading (no data).
    */
@@ -115,6 +120,20 @@ enum {
  */
 std::optional<BHead> BLO_readfile_read_bhead(FileReader *file, BHeadType type);
 
+/** Size of the stored block header of the given type. */
+inline int64_t BLO_bhead_size(const BHeadType type)
+{
+  switch (type) {
+    case BHeadType::BHead4:
+      return sizeof(BHead4);
+    case BHeadType::SmallBHead8:
+      return sizeof(SmallBHead8);
+    case BHeadType::LargeBHead8:
+      return sizeof(LargeBHead8);
+  }
+  return sizeof(LargeBHead8);
+}
+
 /**
  * Converts a BHead.old pointer from 64 to 32 bit. This can't work in the general case, but only
  * when the lower 32 bits of all relevant 64 bit pointers are different. Otherwise two different
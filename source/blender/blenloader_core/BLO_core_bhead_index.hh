@@ -0,0 +1,124 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <optional>
+
+#include "BLI_map.hh"
+#include "BLI_span.hh"
+#include "BLI_string_ref.hh"
+#include "BLI_sys_types.hh"
+#include "BLI_vector.hh"
+
+namespace blender {
+
+struct FileReader;
+
+/**
+ * One ID block of the file, see #BHeadIndex.
+ */
+struct BHeadIndexEntry {
+  /** File offset of the #BHead of the ID. */
+  int64_t bhead_offset;
+  /** #BHead.old of the ID block, used to resolve ID pointers without reading all blocks. */
+  uint64_t old;
+  /** #BHead.code of the ID block. */
+  int32_t code;
+  /**
+   * Index of the entry of the #ID_LI block that owns this ID (link placeholders and packed linked
+   * IDs), or -1 for local IDs and libraries.
+   */
+  int32_t library_index;
+  /** Offset of the null terminated ID name (including the ID code prefix) in the names buffer. */
+  int64_t name_offset;
+  /**
+   * Range in the dependencies buffer of the #BHead.old values of the IDs used by this ID. IDs
+   * that are not in the index (e.g. because they are not written) are skipped by readers.
+   */
+  int64_t dependencies_offset;
+  int64_t dependencies_num;
+};
+
+/**
+ * Index of the ID blocks in a blend-file, stored in a #BLO_CODE_IDIX block right before
+ * #BLO_CODE_ENDB. Readers that only need a few IDs, e.g. when linking from a library, can seek
+ * to their blocks directly instead of parsing every #BHead in the file, which is especially
+ * expensive for compressed files.
+ *
+ * The block is located using a #BHeadIndexFooter written after #BLO_CODE_ENDB, which readers not
+ * aware of the index never get to. All offsets are in the uncompressed file.
+ */
+class BHeadIndex {
+ public:
+  /** File offset of the #BLO_CODE_GLOB block, or -1. */
+  int64_t glob_offset = -1;
+  /** File offset of the #BLO_CODE_DNA1 block, or -1. */
+  int64_t dna_offset = -1;
+
+ private:
+  Vector<BHeadIndexEntry> entries_;
+  /** No inline buffer, so that #entry_by_name_ keys stay valid when the index is moved. */
+  Vector<char, 0> names_;
+  Vector<uint64_t> dependencies_;
+  /** Only built by #deserialize, the names buffer may still grow while adding entries. */
+  Map<StringRef, int> entry_by_name_;
+  Map<uint64_t, int> entry_by_old_;
+
+ public:
+  /** \return The index of the new entry. */
+  int add(int64_t bhead_offset,
+          uint64_t old,
+          int code,
+          int library_index,
+          StringRef idname,
+          Span<uint64_t> dependencies = {});
+
+  Span<BHeadIndexEntry> entries() const
+  {
+    return entries_;
+  }
+
+  /** Name of the ID including the ID code prefix, like #ID.name. */
+  StringRef name(const BHeadIndexEntry &entry) const
+  {
+    return names_.data() + entry.name_offset;
+  }
+
+  /** #BHead.old values of the IDs used by the ID, see #BHeadIndexEntry.dependencies_offset. */
+  Span<uint64_t> dependencies(const BHeadIndexEntry &entry) const
+  {
+    return dependencies_.as_span().slice(entry.dependencies_offset, entry.dependencies_num);
+  }
+
+  const BHeadIndexEntry *lookup_name(StringRef idname) const;
+  const BHeadIndexEntry *lookup_old(uint64_t old) const;
+
+  /** Data of the #BLO_CODE_IDIX block. */
+  Vector<char> serialize() const;
+  /** \return The index, or none when the data is invalid or from an unknown version. */
+  static std::optional<BHeadIndex> deserialize(Span<char> data);
+};
+
+/**
+ * Written at the very end of the file, after #BLO_CODE_ENDB. The footer is smaller than any
+ * #BHead, so readers that continue reading after #BLO_CODE_ENDB just find the end of the file.
+ */
+struct BHeadIndexFooter {
+  char magic[4];
+  uint32_t version;
+  /** File offset of the #BLO_CODE_IDIX block. */
+  int64_t index_offset;
+};
+
+#define BHEAD_INDEX_MAGIC "BIDX"
+#define BHEAD_INDEX_VERSION 2
+
+/**
+ * Read the #BHeadIndexFooter at the end of a seekable file. The read position is changed.
+ * \return The file offset of the #BLO_CODE_IDIX block, or none if the file has no index.
+ */
+std::optional<int64_t> BLO_bhead_index_offset_read(FileReader *file);
+
+}  // namespace blender
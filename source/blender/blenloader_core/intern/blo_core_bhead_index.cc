@@ -0,0 +1,151 @@
+/* SPDX-FileCopyrightText: 2025 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstring>
+
+#include "BLI_filereader.hh"
+
+#include "BLO_core_bhead_index.hh"
+
+namespace blender {
+
+/** Fixed size part of the #BLO_CODE_IDIX block data, followed by the entries and names. */
+struct BHeadIndexHeader {
+  uint32_t version;
+  uint32_t entries_num;
+  int64_t glob_offset;
+  int64_t dna_offset;
+  int64_t names_size;
+  int64_t dependencies_num;
+};
+
+int BHeadIndex::add(const int64_t bhead_offset,
+                    const uint64_t old,
+                    const int code,
+                    const int library_index,
+                    const StringRef idname,
+                    const Span<uint64_t> dependencies)
+{
+  BHeadIndexEntry entry;
+  entry.bhead_offset = bhead_offset;
+  entry.old = old;
+  entry.code = code;
+  entry.library_index = library_index;
+  entry.name_offset = names_.size();
+  names_.extend(idname.data(), idname.size());
+  names_.append('\0');
+  entry.dependencies_offset = dependencies_.size();
+  entry.dependencies_num = dependencies.size();
+  dependencies_.extend(dependencies);
+
+  const int index = entries_.append_and_get_index(entry);
+  entry_by_old_.add(old, index);
+  return index;
+}
+
+const BHeadIndexEntry *BHeadIndex::lookup_name(const StringRef idname) const
+{
+  const int index = entry_by_name_.lookup_default(idname, -1);
+  return index == -1 ? nullptr : &entries_[index];
+}
+
+const BHeadIndexEntry *BHeadIndex::lookup_old(const uint64_t old) const
+{
+  const int index = entry_by_old_.lookup_default(old, -1);
+  return index == -1 ? nullptr : &entries_[index];
+}
+
+Vector<char> BHeadIndex::serialize() const
+{
+  BHeadIndexHeader header;
+  header.version = BHEAD_INDEX_VERSION;
+  header.entries_num = uint32_t(entries_.size());
+  header.glob_offset = glob_offset;
+  header.dna_offset = dna_offset;
+  header.names_size = names_.size();
+  header.dependencies_num = dependencies_.size();
+
+  Vector<char> data;
+  data.reserve(sizeof(header) + entries_.as_span().size_in_bytes() +
+               dependencies_.as_span().size_in_bytes() + names_.size());
+  data.extend(reinterpret_cast<const char *>(&header), sizeof(header));
+  data.extend(reinterpret_cast<const char *>(entries_.data()),
+              entries_.as_span().size_in_bytes());
+  data.extend(reinterpret_cast<const char *>(dependencies_.data()),
+              dependencies_.as_span().size_in_bytes());
+  data.extend(names_.as_span());
+  return data;
+}
+
+std::optional<BHeadIndex> BHeadIndex::deserialize(const Span<char> data)
+{
+  BHeadIndexHeader header;
+  if (data.size() < int64_t(sizeof(header))) {
+    return std::nullopt;
+  }
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.version != BHEAD_INDEX_VERSION || header.names_size < 0 ||
+      header.dependencies_num < 0 || header.dependencies_num > data.size())
+  {
+    return std::nullopt;
+  }
+  const int64_t entries_size = int64_t(header.entries_num) * int64_t(sizeof(BHeadIndexEntry));
+  const int64_t dependencies_size = header.dependencies_num * int64_t(sizeof(uint64_t));
+  if (data.size() !=
+      int64_t(sizeof(header)) + entries_size + dependencies_size + header.names_size)
+  {
+    return std::nullopt;
+  }
+
+  BHeadIndex index;
+  index.glob_offset = header.glob_offset;
+  index.dna_offset = header.dna_offset;
+  index.entries_.resize(header.entries_num);
+  memcpy(index.entries_.data(), data.data() + sizeof(header), entries_size);
+  index.dependencies_.resize(header.dependencies_num);
+  memcpy(index.dependencies_.data(),
+         data.data() + sizeof(header) + entries_size,
+         dependencies_size);
+  index.names_.extend(data.drop_front(sizeof(header) + entries_size + dependencies_size));
+  if (!index.names_.is_empty() && index.names_.last() != '\0') {
+    return std::nullopt;
+  }
+
+  for (const int i : index.entries_.index_range()) {
+    const BHeadIndexEntry &entry = index.entries_[i];
+    if (entry.name_offset < 0 || entry.name_offset >= index.names_.size() ||
+        entry.library_index < -1 || entry.library_index >= index.entries_.size() ||
+        entry.bhead_offset < 0 || entry.dependencies_offset < 0 ||
+        entry.dependencies_num < 0 ||
+        entry.dependencies_num > index.dependencies_.size() - entry.dependencies_offset)
+    {
+      return std::nullopt;
+    }
+    index.entry_by_name_.add(index.name(entry), i);
+    index.entry_by_old_.add(entry.old, i);
+  }
+  return index;
+}
+
+std::optional<int64_t> BLO_bhead_index_offset_read(FileReader *file)
+{
+  if (file->seek == nullptr) {
+    return std::nullopt;
+  }
+  BHeadIndexFooter footer;
+  if (file->seek(file, -int64_t(sizeof(footer)), SEEK_END) == -1) {
+    return std::nullopt;
+  }
+  if (file->read(file, &footer, sizeof(footer)) != sizeof(footer)) {
+    return std::nullopt;
+  }
+  if (memcmp(footer.magic, BHEAD_INDEX_MAGIC, sizeof(footer.magic)) != 0 ||
+      footer.version != BHEAD_INDEX_VERSION || footer.index_offset < 0)
+  {
+    return std::nullopt;
+  }
+  return footer.index_offset;
+}
+
+}  // namespace blender
@@ -115,6 +115,12 @@ class Context {
    * executing as soon as possible. */
   virtual bool is_canceled() const;
 
+  /* Returns the size of the tiles in which operations that declare a kernel radius are evaluated
+   * along with the pixel operations they depend on, or zero if tiled evaluation is disabled. Tiles
+   * are bands of rows that span the width of the image and contain about the square of the tile
+   * size of pixels. This is only supported on the CPU, see Operation::evaluate_tiled. */
+  virtual int get_tile_size() const;
+
   /* Get the normalized render percentage of the active scene. */
   float get_render_percentage() const;
 
@@ -0,0 +1,96 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+#include "BLI_cpp_type.hh"
+#include "BLI_generic_span.hh"
+#include "BLI_map.hh"
+#include "BLI_set.hh"
+#include "BLI_vector.hh"
+
+namespace blender::compositor {
+
+/* ------------------------------------------------------------------------------------------------
+ * CPU Buffer Pool Key.
+ */
+class CPUBufferPoolKey {
+ public:
+  const CPPType *type;
+  int64_t size;
+
+  CPUBufferPoolKey(const CPPType &type, int64_t size);
+
+  uint64_t hash() const;
+};
+
+bool operator==(const CPUBufferPoolKey &a, const CPUBufferPoolKey &b);
+
+/* ------------------------------------------------------------------------------------------------
+ * CPU Buffer Pool.
+ *
+ * The CPU counterpart of gpu::TexturePool, which is used by CPU results allocated from the pool.
+ * Buffers are acquired from the pool and are released back to it when no longer used, after which
+ * they can be acquired again by any result of the same type and size. The reset() method should be
+ * called after every evaluation, and it frees the buffers which were not acquired for a number of
+ * evaluations. So repeated evaluations of the same node tree do not allocate any buffers once the
+ * pool was filled by the first evaluation.
+ *
+ * The pool is shared by all compositor instances and can be used from multiple threads. */
+class CPUBufferPool {
+ public:
+  /* Allocation statistics of the pool, mostly useful for debugging and benchmarking. */
+  struct Statistics {
+    /* Buffers which are currently acquired and their total size in bytes. */
+    int64_t acquired_buffers_num = 0;
+    int64_t acquired_bytes = 0;
+    /* Buffers which are in the pool waiting to be acquired and their total size in bytes. */
+    int64_t pooled_buffers_num = 0;
+    int64_t pooled_bytes = 0;
+    /* Number of acquisitions which needed a new allocation and those which reused a buffer since
+     * the pool was last freed. */
+    int64_t allocations_num = 0;
+    int64_t reuses_num = 0;
+  };
+
+ private:
+  /* The number of resets after which a buffer which was not acquired is freed. */
+  static constexpr int max_unused_cycles_ = 8;
+
+  struct PooledBuffer {
+    void *data;
+    int unused_cycles_count = 0;
+  };
+
+  mutable std::mutex mutex_;
+  /* Buffers in the pool, bucketed by their type and size. */
+  Map<CPUBufferPoolKey, Vector<PooledBuffer>> pool_;
+  /* Buffers which are acquired and not released yet. */
+  Set<const void *> acquired_;
+  Statistics statistics_;
+
+ public:
+  ~CPUBufferPool();
+
+  /* Returns the pool which is shared by all compositor instances. */
+  static CPUBufferPool &get();
+
+  /* Acquire a buffer of the given number of default constructed elements of the given type. The
+   * values are unspecified for trivial types, just like those of a newly allocated array. */
+  GMutableSpan acquire(const CPPType &type, int64_t size);
+
+  /* Release a buffer which was returned by acquire() back into the pool so it can be reused. */
+  void release(GMutableSpan buffer);
+
+  /* Free buffers which were not acquired in the last few resets, or all of the buffers in the pool
+   * if force_free is true. Acquired buffers are never freed. */
+  void reset(bool force_free = false);
+
+  Statistics statistics() const;
+};
+
+}  // namespace blender::compositor
@@ -0,0 +1,40 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "COM_context.hh"
+#include "COM_domain.hh"
+#include "COM_input_descriptor.hh"
+#include "COM_result.hh"
+#include "COM_simple_operation.hh"
+
+namespace blender::compositor {
+
+/* ------------------------------------------------------------------------------------------------
+ * Half Float Expansion Operation
+ *
+ * A simple operation that expands a half float image, see ResultStorageType::CPUHalfImage, into
+ * an image of the same type stored in full precision. Added as the first input processor of inputs
+ * which do not accept half float images or need to be converted or realized, so that other input
+ * processors and operations need not handle half float images. Half float images are generally
+ * only read by operations that accept them, so this is rarely needed. */
+class HalfFloatExpansionOperation : public SimpleOperation {
+ public:
+  HalfFloatExpansionOperation(Context &context, ResultType type);
+
+  void execute() override;
+
+  /* Determine if a half float expansion operation is needed for the input with the given result
+   * and descriptor in an operation with the given operation domain. If it is not needed, return a
+   * null pointer. If it is needed, return an instance of the operation. This is the case if the
+   * input is a half float image and the input does not accept half float images, or if it needs
+   * to be converted or realized. */
+  static SimpleOperation *construct_if_needed(Context &context,
+                                              const Result &input_result,
+                                              const InputDescriptor &input_descriptor,
+                                              const Domain &operation_domain);
+};
+
+}  // namespace blender::compositor
@@ -65,6 +65,10 @@ class InputDescriptor {
   /* If true, the input will not be implicitly converted to the type of the input and will be
    * passed as is. */
   bool skip_type_conversion = false;
+  /* If true, the input can be a half float image, see ResultStorageType::CPUHalfImage, which the
+   * operation reads directly. Otherwise, or if the input needs to be converted or realized, half
+   * float images are expanded to full precision before any other input processor. */
+  bool accepts_half_float_image = false;
 };
 
 }  // namespace blender::compositor
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include "BLI_map.hh"
 #include "BLI_set.hh"
@@ -68,14 +69,35 @@ class MultiFunctionProcedureOperation : public PixelOperation {
                                   const ComputeContext &compute_context);
 
   /* Calls the multi-function procedure executor on the domain of the operator passing in the
-   * inputs and outputs as parameters. */
+   * inputs and outputs as parameters. Some outputs with half precision are stored as half float
+   * images, see ResultStorageType::CPUHalfImage and the should_store_as_half_float_image method,
+   * and inputs accept half float images, in which case, the procedure is called in chunks,
+   * converting the chunks of half float images at the boundaries of the procedure, see the
+   * execute_on_half_float_images method. */
   void execute() override;
 
+  /* Every output pixel is computed from the input pixels at the same location, so the operation
+   * declares a zero kernel radius, unless it operates on single values. */
+  std::optional<int> get_kernel_radius() override;
+
  private:
   /* Builds the procedure by going over the nodes in the compile unit, calling their
    * multi-functions and creating any necessary inputs or outputs to the operation/procedure. */
   void build_procedure();
 
+  /* Calls the multi-function procedure executor on chunks of the domain of the given size in
+   * parallel, where the chunks of half float inputs are converted to full precision before the
+   * call and the chunks of half float outputs are converted to half precision after the call. The
+   * outputs are expected to be allocated already. */
+  void execute_on_half_float_images(int64_t size);
+
+  /* Returns true if the output with the given identifier should be stored as a half float image.
+   * That's the case for outputs with half precision whose type supports it and which are only
+   * read by other pixel operations, unless the operation operates on single values or is
+   * evaluated in tiles. Other operations would need to expand the image to full precision, which
+   * would need more memory than storing it in full precision in the first place. */
+  bool should_store_as_half_float_image(StringRef identifier);
+
   /* Get the variables corresponding to the inputs of the given node. The variables can be those
    * that were returned by a previous call to a multi-function, those that were generated as
    * constants for unlinked inputs, or those that were added as inputs to the operation/procedure
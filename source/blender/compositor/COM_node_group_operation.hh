@@ -131,8 +131,12 @@ class NodeGroupOperation : public Operation {
  private:
   /* Compile the given node into a node operation, map each input to the result of the output
    * linked to it, update the compile state, add the newly created operation to the operations
-   * stream, and evaluate the operation. */
-  void evaluate_node(const bNode &node, CompileState &compile_state);
+   * stream, and evaluate the operation. If a deferred pixel operation is given, it is evaluated
+   * before the node operation, or along with it in tiles if possible, see the evaluate_tiled
+   * method of the Operation class. */
+  void evaluate_node(const bNode &node,
+                     CompileState &compile_state,
+                     PixelOperation *deferred_pixel_operation = nullptr);
 
   /* Constructs and returns a node operation that represents to the given node. */
   NodeOperation *get_node_operation(const bNode &node);
@@ -149,8 +153,10 @@ class NodeGroupOperation : public Operation {
   /* Compile the pixel compile unit into a pixel operation, map each input of the operation to
    * the result of the output linked to it, update the compile state, add the newly created
    * operation to the operations stream, evaluate the operation, and finally reset the pixel
-   * compile unit. */
-  void evaluate_pixel_compile_unit(CompileState &compile_state);
+   * compile unit. If defer_evaluation is true, the operation is returned instead of evaluated,
+   * such that the caller evaluates it later, otherwise, nullptr is returned. */
+  PixelOperation *evaluate_pixel_compile_unit(CompileState &compile_state,
+                                              bool defer_evaluation = false);
 
   /* Map each input of the pixel operation to the result of the output linked to it. This might
    * also correct the reference counts of the results, see the implementation for more details. */
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "BLI_map.hh"
@@ -72,6 +73,8 @@ class Operation {
   /* A mapping between each input of the operation identified by its identifier and an ordered list
    * of simple operations to process that input. */
   Map<StringRef, ProcessorsVector> input_processors_;
+  /* True while the operation is evaluated for a single tile, see the evaluate_tile method. */
+  bool is_evaluating_tile_ = false;
 
  public:
   Operation(Context &context);
@@ -100,6 +103,34 @@ class Operation {
   /* Returns a reference to the compositor context. */
   Context &context() const;
 
+  /* Returns the radius in pixels of the neighborhood of input pixels that each output pixel of the
+   * operation depends on, or nullopt if the operation can't be evaluated in tiles. An operation
+   * that declares a kernel radius computes every output pixel only from the input pixels within
+   * that radius of it, regardless of the size of its domain. So pixel operations declare a zero
+   * radius. See the evaluate_tiled method for more information. */
+  virtual std::optional<int> get_kernel_radius();
+
+  /* Returns true if the given producer operation can be evaluated along with this operation in
+   * tiles using the evaluate_tiled method. That is the case if this operation declares a kernel
+   * radius, the producer declares a zero radius, the results of the producer are only used by this
+   * operation, and all image inputs of both operations are in the same domain. */
+  bool can_evaluate_tiled(Operation &producer);
+
+  /* Evaluate the given producer operation along with this operation in tiles of the given size,
+   * see Context::get_tile_size. For each tile, the producer is evaluated on views of its inputs
+   * that cover the rows of the tile extended by the kernel radius of this operation, then this
+   * operation is evaluated on the results of the producer and views of its other inputs, and
+   * finally, the rows of the tile are copied into the results of this operation. Consequently, the
+   * results of the producer are never allocated for the whole domain. This should only be called
+   * if can_evaluate_tiled returned true.
+   *
+   * Only a single pixel operation is evaluated along with this operation. Chains of filters are
+   * not fused, since node operations are evaluated right after they are compiled, so the results
+   * of this operation are always allocated for the whole domain. Tiles also span the width of the
+   * image, so tiling only happens for images that have more rows than a single tile, see
+   * Context::get_tile_size. */
+  void evaluate_tiled(Operation &producer, int tile_size);
+
  protected:
   /* Compute the operation domain of this operation. By default, this implements a default logic
    * that infers the operation domain from the inputs, which may be overridden for a different
@@ -135,6 +166,11 @@ class Operation {
   /* Allocates all needed outputs that are not yet allocated and default initialize them. */
   void allocate_default_remaining_outputs();
 
+  /* Returns true if the operation is currently evaluated for a single tile along with a consumer
+   * operation, see the evaluate_tiled method. Results computed for a tile only live until the
+   * consumer processed the tile. */
+  bool is_evaluating_tile() const;
+
  private:
   /* Given the identifier of an input of the operation and a processor operation:
    * - Add the given processor to the list of input processors for the input.
@@ -144,6 +180,16 @@ class Operation {
    * - Evaluate the processor. */
   void add_and_evaluate_input_processor(StringRef identifier, SimpleOperation *processor);
 
+  /* Returns the domain of all image inputs of this operation and the given producer operation
+   * except those computed by the producer, or nullopt if they are not in the same domain or if no
+   * such input exists. See the can_evaluate_tiled method. */
+  std::optional<Domain> compute_tiled_domain(Operation &producer);
+
+  /* Identical to evaluate, but the inputs are mapped to the given results for the duration of the
+   * evaluation, which are released instead of the results mapped to the inputs, and the data of
+   * the operation is not logged. See the evaluate_tiled method. */
+  void evaluate_tile(Map<StringRef, Result> &inputs);
+
   /* Release the results that are mapped to the inputs of the operation. This is called after the
    * evaluation of the operation to declare that the results are no longer needed by this
    * operation. */
@@ -102,6 +102,9 @@ class PixelOperation : public Operation {
   VectorSet<const bNodeSocket *> preview_outputs_;
   /* A vector set that stores all output sockets that will be logged to the node evaluator log. */
   VectorSet<const bNodeSocket *> logged_outputs_;
+  /* A vector set that stores the identifiers of the outputs of the operation which are only read
+   * by other pixel operations. Computed in the compute_results_reference_counts method. */
+  VectorSet<std::string> outputs_only_read_by_pixel_operations_;
   /* True if the operation operates on single values, that is, all of its inputs and outputs are
    * single values. */
   const bool is_single_value_;
@@ -149,9 +152,16 @@ class PixelOperation : public Operation {
    * Additionally, results that are used as node previews gets an extra reference count because
    * they are referenced and released by the compute_preview method.
    *
+   * The outputs whose linked inputs all belong to pixel nodes are also recorded, see the
+   * outputs_only_read_by_pixel_operations_ member.
+   *
    * The node execution schedule is given as an input. */
   void compute_results_reference_counts(const Schedule &schedule);
 
+  /* Returns true if the output with the given identifier is only read by other pixel operations.
+   * Only valid after the compute_results_reference_counts method was called. */
+  bool is_output_only_read_by_pixel_operations(StringRef identifier) const;
+
   /* Setter for needs_node_previews_. */
   void set_needs_node_previews(const bool needed);
 };
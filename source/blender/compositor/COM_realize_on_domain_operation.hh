@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include "COM_context.hh"
 #include "COM_domain.hh"
 #include "COM_input_descriptor.hh"
@@ -41,6 +43,13 @@ class RealizeOnDomainOperation : public SimpleOperation {
                                               const InputDescriptor &input_descriptor,
                                               const Domain &operation_domain);
 
+  /* Computes the domain that the input with the given result and descriptor will be realized on
+   * in an operation with the given operation domain, or nullopt if no realization is needed. See
+   * construct_if_needed for more information. */
+  static std::optional<Domain> compute_target_domain(const Result &input_result,
+                                                     const InputDescriptor &input_descriptor,
+                                                     const Domain &operation_domain);
+
  protected:
   /* The operation domain is just the target domain. */
   Domain compute_domain() override;
@@ -16,6 +16,7 @@
 #include "BLI_generic_pointer.hh"
 #include "BLI_generic_span.hh"
 #include "BLI_implicit_sharing_ptr.hh"
+#include "BLI_index_range.hh"
 #include "BLI_math_interp.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_quaternion_types.hh"
@@ -23,6 +24,7 @@
 #include "BLI_math_vector_c.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_memory_utils.hh"
+#include "BLI_span.hh"
 #include "BLI_string_ref.hh"
 
 #include "GPU_shader.hh"
@@ -89,6 +91,13 @@ enum class ResultStorageType : uint8_t {
   GPUImage,
   /* Stored as an image in a buffer on the CPU. */
   CPUImage,
+  /* Stored as an image in a buffer of half floats on the CPU, where each channel of a pixel is
+   * stored as a half float. This is only used for float types with half precision, see the
+   * supports_half_float_image method, and is read through the cpu_half_data method. It is only
+   * used for results which are read by operations that accept half float images, should such an
+   * input still need conversion or realization, it is expanded to full precision by an input
+   * processor, see the HalfFloatExpansionOperation class. */
+  CPUHalfImage,
 };
 
 using Color = ColorSceneLinear4f<eAlpha::Premultiplied>;
@@ -127,8 +136,8 @@ class Result {
   Context *context_ = nullptr;
   /* The base type of the result's image or single value. */
   ResultType type_ = ResultType::Float;
-  /* The precision of the result's data. Only relevant for GPU textures. CPU buffers and single
-   * values are always stored using full precision. */
+  /* The precision of the result's data. Only relevant for GPU textures and CPU half float images.
+   * Other CPU buffers and single values are always stored using full precision. */
   ResultPrecision precision_ = ResultPrecision::Half;
   /* The type of storage used to hold the data. Used to correctly interpret the data union. */
   ResultStorageType storage_type_ = ResultStorageType::SingleValue;
@@ -139,7 +148,8 @@ class Result {
      * texture for most types, but can be a 2D texture array for large types like float4x4 where
      * each column will be stored in a layer. */
     gpu::Texture *gpu_texture_;
-    /* A reference to the result's image data managed by the sharing info. */
+    /* A reference to the result's image data managed by the sharing info. For half float images,
+     * this is a span of uint16_t storing each channel of each pixel. */
     GSpan cpu_data_;
   };
   /* Implicit sharing info manages the result's data, allowing it to be shared between multiple
@@ -213,6 +223,10 @@ class Result {
    * fourth channel during processing. */
   static gpu::TextureFormat gpu_texture_format(ResultType type, ResultPrecision precision);
 
+  /* Returns true if images of the given type can be stored as half float images on the CPU, see
+   * ResultStorageType::CPUHalfImage. */
+  static bool supports_half_float_image(ResultType type);
+
   /* Returns the GPU data format that corresponds to the give result type. */
   static eGPUDataFormat gpu_data_format(const ResultType type);
 
@@ -254,14 +268,17 @@ class Result {
    *
    * The data is allocated on the CPU or GPU depending on the given storage_type. A nullopt may be
    * passed to storage_type, in which case, the data will be allocated on the device of the
-   * result's context as specified by context.use_gpu().
+   * result's context as specified by context.use_gpu(). CPUHalfImage can only be passed for types
+   * that support it, see the supports_half_float_image method, and should only be used by
+   * operations that compute results which will mostly be read by operations that accept half
+   * float images, since other operations expand them to full precision.
    *
-   * If from_pool is true, GPU textures will be allocated from the texture pool of the context,
-   * otherwise, a new texture will be allocated. Pooling should not be used for persistent results
-   * that might span more than one evaluation, like cached resources. While pooling should be used
-   * for most other cases where the result will be allocated then later released in the same
-   * evaluation. Some types do not support pooling, since they require array textures which are not
-   * supported by the texture pool. */
+   * If from_pool is true, GPU textures will be allocated from the texture pool of the context and
+   * CPU data will be acquired from the CPUBufferPool, otherwise, new data will be allocated.
+   * Pooling should not be used for persistent results that might span more than one evaluation,
+   * like cached resources. While pooling should be used for most other cases where the result will
+   * be allocated then later released in the same evaluation. Some types do not support pooling on
+   * the GPU, since they require array textures which are not supported by the texture pool. */
   void allocate_texture(const Domain domain,
                         const bool from_pool = true,
                         const std::optional<ResultStorageType> storage_type = std::nullopt);
@@ -284,6 +301,12 @@ class Result {
    * GPU. */
   Result download_to_cpu() const;
 
+  /* Creates and allocates a new result that matches the type and precision of this result and
+   * stores the data of this half float image in full precision. The result is assumed to be a
+   * half float image. See the allocate_texture method for more information on the from_pool
+   * parameters. */
+  Result expand_half_float_image(const bool from_pool) const;
+
   /* Bind the GPU texture of the result to the texture image unit with the given name in the
    * currently bound given shader. This also inserts a memory barrier for texture fetches to ensure
    * any prior writes to the texture are reflected before reading from it. The unbind_as_texture
@@ -330,8 +353,12 @@ class Result {
    * implicit sharing info is provided, the buffer is assumed to be external, has a lifetime that
    * covers the entire evaluation of the compositor, and will thus not be freed. The domain will be
    * set to have the data and display size as the given size. The given buffer should have a format
-   * that is compatible with the result. */
-  void share_data(const void *data, int2 size, ImplicitSharingPtr<> sharing_info = nullptr);
+   * that is compatible with the result, that is, a uint16_t per channel if storage_type is
+   * CPUHalfImage, and a value of the type of the result otherwise. */
+  void share_data(const void *data,
+                  int2 size,
+                  ImplicitSharingPtr<> sharing_info = nullptr,
+                  ResultStorageType storage_type = ResultStorageType::CPUImage);
 
   /* Sets the transformation of the domain of the result to the given transformation. */
   void set_transformation(const float3x3 &transformation);
@@ -401,11 +428,18 @@ class Result {
   GSpan cpu_data() const;
   GMutableSpan cpu_data_for_write();
 
+  /* Returns the channels of the pixels of a half float image. See ResultStorageType. */
+  Span<uint16_t> cpu_half_data() const;
+  MutableSpan<uint16_t> cpu_half_data_for_write();
+
   const ImplicitSharingPtr<> &sharing_info() const;
 
   /* Returns true if the result is a single value and false of it is an image. */
   bool is_single_value() const;
 
+  /* Returns true if the result is an image stored as half floats on the CPU. */
+  bool is_half_float_image() const;
+
   /* It is important to call update_single_value_data after adjusting the single value. See that
    * method for more information. */
   GPointer single_value() const;
@@ -451,6 +485,13 @@ class Result {
    * stores a value of the given template type. */
   template<typename T> void store_pixel(const int2 &texel, const T &pixel_value);
 
+  /* Returns the pixels in the given range of x coordinates of the row at the given y coordinate,
+   * such that kernels can process contiguous row segments instead of loading and storing single
+   * pixels, see the parallel_for_row_segments function. Assumes the result stores a value of the
+   * given template type. */
+  template<typename T> Span<T> row_segment(int y, IndexRange x_range) const;
+  template<typename T> MutableSpan<T> row_segment_for_write(int y, IndexRange x_range);
+
   /* Samples the result at the given normalized coordinates with the given interpolation and
    * boundary extension. The interpolation is ignored for non float types that do not support
    * interpolation. The jacobian represents the change of the given coordinates across space, if
@@ -524,6 +565,25 @@ BLI_INLINE_METHOD GMutableSpan Result::cpu_data_for_write()
   return GMutableSpan(cpu_data_.type(), const_cast<void *>(cpu_data_.data()), cpu_data_.size());
 }
 
+BLI_INLINE_METHOD bool Result::is_half_float_image() const
+{
+  return storage_type_ == ResultStorageType::CPUHalfImage;
+}
+
+BLI_INLINE_METHOD Span<uint16_t> Result::cpu_half_data() const
+{
+  BLI_assert(storage_type_ == ResultStorageType::CPUHalfImage);
+  return cpu_data_.typed<uint16_t>();
+}
+
+BLI_INLINE_METHOD MutableSpan<uint16_t> Result::cpu_half_data_for_write()
+{
+  BLI_assert(storage_type_ == ResultStorageType::CPUHalfImage);
+  BLI_assert(sharing_info_ && sharing_info_->is_mutable());
+  return MutableSpan<uint16_t>(const_cast<uint16_t *>(cpu_data_.typed<uint16_t>().data()),
+                               cpu_data_.size());
+}
+
 template<typename T> BLI_INLINE_METHOD const T &Result::get_single_value() const
 {
   BLI_assert(this->is_allocated());
@@ -650,6 +710,23 @@ BLI_INLINE_METHOD void Result::store_pixel(const int2 &texel, const T &pixel_val
   this->cpu_data_for_write().typed<T>()[this->get_pixel_index(texel)] = pixel_value;
 }
 
+template<typename T>
+BLI_INLINE_METHOD Span<T> Result::row_segment(const int y, const IndexRange x_range) const
+{
+  BLI_assert(x_range.is_empty() || x_range.last() < domain_.data_size.x);
+  return this->cpu_data().typed<T>().slice(this->get_pixel_index(int2(x_range.start(), y)),
+                                           x_range.size());
+}
+
+template<typename T>
+BLI_INLINE_METHOD MutableSpan<T> Result::row_segment_for_write(const int y,
+                                                               const IndexRange x_range)
+{
+  BLI_assert(x_range.is_empty() || x_range.last() < domain_.data_size.x);
+  return this->cpu_data_for_write().typed<T>().slice(
+      this->get_pixel_index(int2(x_range.start(), y)), x_range.size());
+}
+
 struct EWASamplingData {
   const Result &result;
   const Extension extension_mode_x;
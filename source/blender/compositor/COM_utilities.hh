@@ -89,4 +89,20 @@ template<typename Function> inline void parallel_for(const int2 range, const Fun
   });
 }
 
+/* Executes the given function in parallel over contiguous segments of the rows of the given 2D
+ * range. The given function gets the y coordinate of the row and the range of x coordinates of
+ * the segment as arguments, and can access the pixels of the segment as spans using the
+ * row_segment methods of the Result class. As opposed to parallel_for, per row work can be done
+ * once per segment, and the loop over the pixels of the segment is visible to the compiler, so it
+ * can be vectorized. */
+template<typename Function>
+inline void parallel_for_row_segments(const int2 range, const Function &function)
+{
+  threading::parallel_for(IndexRange(range.y), 1, [&](const IndexRange sub_y_range) {
+    for (const int64_t y : sub_y_range) {
+      function(int(y), IndexRange(range.x));
+    }
+  });
+}
+
 }  // namespace blender::compositor
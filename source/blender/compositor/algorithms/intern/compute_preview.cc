@@ -30,6 +30,14 @@ namespace blender::compositor {
 
 static void compute_preview_cpu(Context &context, const Result &input, ImBuf *output)
 {
+  /* Half float images can't be read per pixel, so compute the preview of an expanded copy. */
+  if (input.is_half_float_image()) {
+    Result expanded_input = input.expand_half_float_image(true);
+    compute_preview_cpu(context, expanded_input, output);
+    expanded_input.release();
+    return;
+  }
+
   const int2 input_size = input.domain().data_size;
   const int2 preview_size = int2(output->x, output->y);
 
@@ -5,7 +5,10 @@
 #include <type_traits>
 
 #include "BLI_assert.hh"
+#include "BLI_index_range.hh"
+#include "BLI_math_base.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 
 #include "GPU_shader.hh"
 
@@ -23,32 +26,42 @@ namespace blender::compositor {
 template<typename T>
 static void blur_pass(const Result &input, const Result &weights, Result &output)
 {
-
-  /* Notice that the size is transposed, see the note on the horizontal pass method for more
-   * information on the reasoning behind this. */
-  const int2 size = int2(output.domain().data_size.y, output.domain().data_size.x);
-  parallel_for(size, [&](const int2 texel) {
+  const int2 size = input.domain().data_size;
+  const Span<float> weights_row = weights.row_segment<float>(
+      0, IndexRange(weights.domain().data_size.x));
+  parallel_for_row_segments(size, [&](const int y, const IndexRange x_range) {
     /* Use float4 for Color types since Color does not support arithmetic. */
     using AccumulateT = std::conditional_t<std::is_same_v<T, Color>, float4, T>;
-    AccumulateT accumulated_value = AccumulateT(0);
-
-    /* First, compute the contribution of the center pixel. */
-    AccumulateT center_value = AccumulateT(input.load_pixel_extended<T>(texel));
-    accumulated_value += center_value * weights.load_pixel<float>(int2(0));
-
-    /* Then, compute the contributions of the pixel to the right and left, noting that the
-     * weights texture only stores the weights for the positive half, but since the filter is
-     * symmetric, the same weight is used for the negative half and we add both of their
-     * contributions. */
-    for (int i = 1; i < weights.domain().data_size.x; i++) {
-      float weight = weights.load_pixel<float>(int2(i, 0));
-      accumulated_value += AccumulateT(input.load_pixel_extended<T>(texel + int2(i, 0))) * weight;
-      accumulated_value += AccumulateT(input.load_pixel_extended<T>(texel + int2(-i, 0))) * weight;
-    }
 
-    /* Write the color using the transposed texel. See the horizontal_pass method for more
-     * information on the rational behind this. */
-    output.store_pixel(int2(texel.y, texel.x), T(accumulated_value));
+    /* Loads the pixel at the given x coordinate of the row, clamping to the row bounds to extend
+     * it. */
+    const Span<T> row = input.row_segment<T>(y, IndexRange(size.x));
+    const int64_t last_x = size.x - 1;
+    auto load = [&](const int64_t x) {
+      return AccumulateT(row[math::clamp(x, int64_t(0), last_x)]);
+    };
+
+    for (const int64_t x : x_range) {
+      AccumulateT accumulated_value = AccumulateT(0);
+
+      /* First, compute the contribution of the center pixel. */
+      AccumulateT center_value = AccumulateT(row[x]);
+      accumulated_value += center_value * weights_row[0];
+
+      /* Then, compute the contributions of the pixel to the right and left, noting that the
+       * weights texture only stores the weights for the positive half, but since the filter is
+       * symmetric, the same weight is used for the negative half and we add both of their
+       * contributions. */
+      for (int i = 1; i < weights_row.size(); i++) {
+        float weight = weights_row[i];
+        accumulated_value += load(x + i) * weight;
+        accumulated_value += load(x - i) * weight;
+      }
+
+      /* Write the color using the transposed texel. See the horizontal_pass method for more
+       * information on the rational behind this. */
+      output.store_pixel(int2(y, x), T(accumulated_value));
+    }
   });
 }
 
@@ -67,6 +67,11 @@ bool Context::is_canceled() const
   return false;
 }
 
+int Context::get_tile_size() const
+{
+  return 0;
+}
+
 float Context::get_render_percentage() const
 {
   return get_render_data().size / 100.0f;
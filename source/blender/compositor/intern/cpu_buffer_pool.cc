@@ -0,0 +1,142 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <cstdint>
+#include <mutex>
+
+#include "BLI_assert.hh"
+#include "BLI_cpp_type.hh"
+#include "BLI_generic_span.hh"
+#include "BLI_hash.hh"
+
+#include "MEM_guardedalloc.h"
+
+#include "COM_cpu_buffer_pool.hh"
+
+namespace blender::compositor {
+
+/* --------------------------------------------------------------------
+ * CPU Buffer Pool Key.
+ */
+
+CPUBufferPoolKey::CPUBufferPoolKey(const CPPType &type, const int64_t size)
+    : type(&type), size(size)
+{
+}
+
+uint64_t CPUBufferPoolKey::hash() const
+{
+  return get_default_hash(this->type, this->size);
+}
+
+bool operator==(const CPUBufferPoolKey &a, const CPUBufferPoolKey &b)
+{
+  return a.type == b.type && a.size == b.size;
+}
+
+/* --------------------------------------------------------------------
+ * CPU Buffer Pool.
+ */
+
+static int64_t buffer_size_in_bytes(const CPUBufferPoolKey &key)
+{
+  return key.size * key.type->size;
+}
+
+CPUBufferPool::~CPUBufferPool()
+{
+  this->reset(true);
+}
+
+CPUBufferPool &CPUBufferPool::get()
+{
+  static CPUBufferPool pool;
+  return pool;
+}
+
+GMutableSpan CPUBufferPool::acquire(const CPPType &type, const int64_t size)
+{
+  const CPUBufferPoolKey key(type, size);
+
+  std::scoped_lock lock(mutex_);
+
+  void *data = nullptr;
+  Vector<PooledBuffer> *buffers = pool_.lookup_ptr(key);
+  if (buffers && !buffers->is_empty()) {
+    data = buffers->pop_last().data;
+    if (buffers->is_empty()) {
+      pool_.remove(key);
+    }
+    statistics_.pooled_buffers_num--;
+    statistics_.pooled_bytes -= buffer_size_in_bytes(key);
+    statistics_.reuses_num++;
+  }
+  else {
+    data = MEM_new_array_uninitialized_aligned(size, type.size, type.alignment, __func__);
+    statistics_.allocations_num++;
+  }
+  type.default_construct_n(data, size);
+
+  acquired_.add_new(data);
+  statistics_.acquired_buffers_num++;
+  statistics_.acquired_bytes += buffer_size_in_bytes(key);
+
+  return GMutableSpan(type, data, size);
+}
+
+void CPUBufferPool::release(GMutableSpan buffer)
+{
+  const CPUBufferPoolKey key(buffer.type(), buffer.size());
+  buffer.type().destruct_n(buffer.data(), buffer.size());
+
+  std::scoped_lock lock(mutex_);
+
+  BLI_assert_msg(acquired_.contains(buffer.data()),
+                 "Unacquired buffer passed to CPUBufferPool::release().");
+  acquired_.remove(buffer.data());
+  statistics_.acquired_buffers_num--;
+  statistics_.acquired_bytes -= buffer_size_in_bytes(key);
+
+  /* The last released buffer is the first to be acquired again, since its memory is more likely
+   * to still be cached. This also lets excess buffers of the bucket be freed by reset(). */
+  pool_.lookup_or_add_default(key).append({buffer.data()});
+  statistics_.pooled_buffers_num++;
+  statistics_.pooled_bytes += buffer_size_in_bytes(key);
+}
+
+void CPUBufferPool::reset(const bool force_free)
+{
+  std::scoped_lock lock(mutex_);
+
+  pool_.remove_if([&](auto item) {
+    Vector<PooledBuffer> &buffers = item.value;
+    /* Reverse iterate buffers, to make sure we only reorder known good ones. */
+    for (int64_t i = buffers.size() - 1; i >= 0; i--) {
+      PooledBuffer &buffer = buffers[i];
+      if (buffer.unused_cycles_count >= max_unused_cycles_ || force_free) {
+        MEM_delete_void(buffer.data);
+        buffers.remove_and_reorder(i);
+        statistics_.pooled_buffers_num--;
+        statistics_.pooled_bytes -= buffer_size_in_bytes(item.key);
+      }
+      else {
+        buffer.unused_cycles_count++;
+      }
+    }
+    return buffers.is_empty();
+  });
+
+  if (force_free) {
+    statistics_.allocations_num = 0;
+    statistics_.reuses_num = 0;
+  }
+}
+
+CPUBufferPool::Statistics CPUBufferPool::statistics() const
+{
+  std::scoped_lock lock(mutex_);
+  return statistics_;
+}
+
+}  // namespace blender::compositor
@@ -0,0 +1,50 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "COM_context.hh"
+#include "COM_domain.hh"
+#include "COM_half_float_expansion_operation.hh"
+#include "COM_input_descriptor.hh"
+#include "COM_realize_on_domain_operation.hh"
+#include "COM_result.hh"
+
+namespace blender::compositor {
+
+HalfFloatExpansionOperation::HalfFloatExpansionOperation(Context &context, const ResultType type)
+    : SimpleOperation(context)
+{
+  this->declare_input_descriptor(InputDescriptor{type});
+  this->populate_result(type);
+}
+
+void HalfFloatExpansionOperation::execute()
+{
+  Result expanded_input = this->get_input().expand_half_float_image(true);
+  this->get_result().share_data(expanded_input);
+  expanded_input.release();
+}
+
+SimpleOperation *HalfFloatExpansionOperation::construct_if_needed(
+    Context &context,
+    const Result &input_result,
+    const InputDescriptor &input_descriptor,
+    const Domain &operation_domain)
+{
+  if (!input_result.is_half_float_image()) {
+    return nullptr;
+  }
+
+  const bool needs_conversion = !input_descriptor.skip_type_conversion &&
+                                input_result.type() != input_descriptor.type;
+  const bool needs_realization = RealizeOnDomainOperation::compute_target_domain(
+                                     input_result, input_descriptor, operation_domain)
+                                     .has_value();
+  if (input_descriptor.accepts_half_float_image && !needs_conversion && !needs_realization) {
+    return nullptr;
+  }
+
+  return new HalfFloatExpansionOperation(context, input_result.type());
+}
+
+}  // namespace blender::compositor
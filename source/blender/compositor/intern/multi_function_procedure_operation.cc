@@ -3,17 +3,22 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 
 #include "BLI_assert.hh"
 #include "BLI_cpp_type.hh"
+#include "BLI_generic_array.hh"
 #include "BLI_generic_span.hh"
 #include "BLI_index_mask.hh"
 #include "BLI_map.hh"
 #include "BLI_math_base.hh"
 #include "BLI_math_euler.hh"
+#include "BLI_math_half.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 #include "BLI_vector_set.hh"
 
@@ -61,11 +66,39 @@ void MultiFunctionProcedureOperation::execute()
 {
   const Domain domain = is_single_value_ ? Domain(int2(1)) : this->compute_domain();
   const int64_t size = int64_t(domain.data_size.x) * domain.data_size.y;
+
+  /* Allocate the outputs first, since their storage decides how the procedure is called. */
+  bool has_half_float_images = false;
+  for (int i = 0; i < procedure_.params().size(); i++) {
+    if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Input) {
+      const Result &input = get_input(parameter_identifiers_[i]);
+      has_half_float_images |= !is_single_value_ && input.is_half_float_image();
+      continue;
+    }
+
+    Result &output = get_result(parameter_identifiers_[i]);
+    if (is_single_value_) {
+      output.allocate_single_value();
+    }
+    else if (this->should_store_as_half_float_image(parameter_identifiers_[i])) {
+      output.allocate_texture(domain, true, ResultStorageType::CPUHalfImage);
+      has_half_float_images = true;
+    }
+    else {
+      output.allocate_texture(domain);
+    }
+  }
+
+  if (has_half_float_images) {
+    this->execute_on_half_float_images(size);
+    return;
+  }
+
   const IndexMask mask = IndexMask(size);
   mf::ParamsBuilder parameter_builder{*procedure_executor_, &mask};
 
-  /* For each of the parameters, either add an input or an output depending on its interface type,
-   * allocating the outputs when needed. */
+  /* For each of the parameters, either add an input or an output depending on its interface
+   * type. */
   for (int i = 0; i < procedure_.params().size(); i++) {
     if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Input) {
       const Result &input = get_input(parameter_identifiers_[i]);
@@ -87,12 +120,10 @@ void MultiFunctionProcedureOperation::execute()
     else {
       Result &output = get_result(parameter_identifiers_[i]);
       if (is_single_value_) {
-        output.allocate_single_value();
         parameter_builder.add_uninitialized_single_output(
             GMutableSpan(output.get_cpp_type(), output.single_value().get(), 1));
       }
       else {
-        output.allocate_texture(domain);
         parameter_builder.add_uninitialized_single_output(output.cpu_data_for_write());
       }
     }
@@ -102,6 +133,100 @@ void MultiFunctionProcedureOperation::execute()
   procedure_executor_->call_auto(mask, parameter_builder, context_builder);
 }
 
+/* The number of pixels which are processed at once when the inputs or outputs of the operation
+ * are half float images. Chosen such that the full precision copies of the chunk stay in the
+ * cache. */
+static constexpr int64_t half_float_chunk_size = 4096;
+
+void MultiFunctionProcedureOperation::execute_on_half_float_images(const int64_t size)
+{
+  threading::parallel_for(IndexRange(size), half_float_chunk_size, [&](const IndexRange chunk) {
+    const IndexMask mask = IndexMask(chunk.size());
+    mf::ParamsBuilder parameter_builder{*procedure_executor_, &mask};
+
+    /* Full precision copies of the chunk for each of the half float images. Reserved such that
+     * the buffers are not moved while the parameters reference them. */
+    Vector<GArray<>> buffers;
+    buffers.reserve(procedure_.params().size());
+    /* The half float outputs along with the buffers their chunk is computed into. */
+    Vector<std::pair<Result *, const GArray<> *>> half_float_outputs;
+
+    for (int i = 0; i < procedure_.params().size(); i++) {
+      if (procedure_.params()[i].type == mf::ParamType::InterfaceType::Input) {
+        const Result &input = get_input(parameter_identifiers_[i]);
+        if (input.is_single_value()) {
+          parameter_builder.add_readonly_single_input(input.single_value());
+        }
+        else if (input.is_half_float_image()) {
+          const int64_t channels_count = input.channels_count();
+          buffers.append_as(input.get_cpp_type(), chunk.size());
+          GArray<> &buffer = buffers.last();
+          math::half_to_float_array(
+              input.cpu_half_data().slice(chunk.start() * channels_count,
+                                          chunk.size() * channels_count).data(),
+              static_cast<float *>(buffer.data()),
+              chunk.size() * channels_count);
+          parameter_builder.add_readonly_single_input(buffer.as_span());
+        }
+        else {
+          parameter_builder.add_readonly_single_input(input.cpu_data().slice(chunk));
+        }
+      }
+      else {
+        Result &output = get_result(parameter_identifiers_[i]);
+        if (output.is_half_float_image()) {
+          buffers.append_as(output.get_cpp_type(), chunk.size());
+          GArray<> &buffer = buffers.last();
+          parameter_builder.add_uninitialized_single_output(buffer.as_mutable_span());
+          half_float_outputs.append({&output, &buffer});
+        }
+        else {
+          parameter_builder.add_uninitialized_single_output(
+              output.cpu_data_for_write().slice(chunk));
+        }
+      }
+    }
+
+    mf::ContextBuilder context_builder;
+    procedure_executor_->call(mask, parameter_builder, context_builder);
+
+    for (const auto &[output, buffer] : half_float_outputs) {
+      const int64_t channels_count = output->channels_count();
+      math::float_to_half_array(static_cast<const float *>(buffer->data()),
+                                output->cpu_half_data_for_write()
+                                    .slice(chunk.start() * channels_count,
+                                           chunk.size() * channels_count)
+                                    .data(),
+                                chunk.size() * channels_count);
+    }
+  });
+}
+
+bool MultiFunctionProcedureOperation::should_store_as_half_float_image(const StringRef identifier)
+{
+  /* Results computed for a tile are only read while the tile is in the cache, so there is no
+   * bandwidth to save by storing them as half floats. */
+  if (is_single_value_ || this->is_evaluating_tile()) {
+    return false;
+  }
+
+  if (!this->is_output_only_read_by_pixel_operations(identifier)) {
+    return false;
+  }
+
+  const Result &output = this->get_result(identifier);
+  return output.precision() == ResultPrecision::Half &&
+         Result::supports_half_float_image(output.type());
+}
+
+std::optional<int> MultiFunctionProcedureOperation::get_kernel_radius()
+{
+  if (is_single_value_) {
+    return std::nullopt;
+  }
+  return 0;
+}
+
 void MultiFunctionProcedureOperation::build_procedure()
 {
   for (const bNode *node : compile_state_.get_pixel_compile_unit()) {
@@ -416,6 +541,8 @@ mf::Variable *MultiFunctionProcedureOperation::get_multi_function_input_variable
    * cheaper. */
   InputDescriptor input_descriptor = input_descriptor_from_input_socket(&input_socket);
   input_descriptor.type = get_node_socket_result_type(&output_socket);
+  /* Half float images are expanded to full precision in chunks during execution. */
+  input_descriptor.accepts_half_float_image = true;
   declare_input_descriptor(input_identifier, input_descriptor);
 
   mf::Variable &variable = procedure_builder_.add_input_parameter(
@@ -93,15 +93,23 @@ void NodeGroupOperation::execute()
       break;
     }
 
+    PixelOperation *deferred_pixel_operation = nullptr;
     if (compile_state.should_compile_pixel_compile_unit(*node)) {
-      this->evaluate_pixel_compile_unit(compile_state);
+      /* Defer the evaluation of the pixel operation to the node that needs it, such that they
+       * might be evaluated together in tiles. Not done when logging, since pixel operations log
+       * their data based on the pixel compile unit, which is reset after compilation. */
+      const bool defer_evaluation = !is_pixel_node(*node) &&
+                                    this->context().get_tile_size() > 0 &&
+                                    !this->context().nodes_evaluation_log();
+      deferred_pixel_operation = this->evaluate_pixel_compile_unit(compile_state,
+                                                                   defer_evaluation);
     }
 
     if (is_pixel_node(*node)) {
       compile_state.add_node_to_pixel_compile_unit(*node);
     }
     else {
-      this->evaluate_node(*node, compile_state);
+      this->evaluate_node(*node, compile_state, deferred_pixel_operation);
     }
   }
 
@@ -126,7 +134,9 @@ NodeGroupOutputTypes NodeGroupOperation::needed_output_types() const
   return needed_output_types_;
 }
 
-void NodeGroupOperation::evaluate_node(const bNode &node, CompileState &compile_state)
+void NodeGroupOperation::evaluate_node(const bNode &node,
+                                       CompileState &compile_state,
+                                       PixelOperation *deferred_pixel_operation)
 {
   NodeOperation *operation = this->get_node_operation(node);
   operation->set_compute_context(compute_context_);
@@ -147,6 +157,14 @@ void NodeGroupOperation::evaluate_node(const bNode &node, CompileState &compile_
 
   operation->compute_results_reference_counts(compile_state.get_schedule());
 
+  if (deferred_pixel_operation) {
+    if (operation->can_evaluate_tiled(*deferred_pixel_operation)) {
+      operation->evaluate_tiled(*deferred_pixel_operation, this->context().get_tile_size());
+      return;
+    }
+    deferred_pixel_operation->evaluate();
+  }
+
   operation->evaluate();
 }
 
@@ -229,7 +247,8 @@ static PixelOperation *create_pixel_operation(Context &context,
   return new ShaderOperation(context, compile_state, compute_context);
 }
 
-void NodeGroupOperation::evaluate_pixel_compile_unit(CompileState &compile_state)
+PixelOperation *NodeGroupOperation::evaluate_pixel_compile_unit(CompileState &compile_state,
+                                                                const bool defer_evaluation)
 {
   PixelCompileUnit &compile_unit = compile_state.get_pixel_compile_unit();
 
@@ -254,11 +273,10 @@ void NodeGroupOperation::evaluate_pixel_compile_unit(CompileState &compile_state
     this->evaluate_pixel_compile_unit(compile_state);
 
     compile_state.get_pixel_compile_unit() = end_compile_unit;
-    this->evaluate_pixel_compile_unit(compile_state);
 
     /* No need to continue, the above recursive calls will eventually exist the loop and do the
      * actual compilation. */
-    return;
+    return this->evaluate_pixel_compile_unit(compile_state, defer_evaluation);
   }
 
   PixelOperation *operation = create_pixel_operation(
@@ -276,9 +294,13 @@ void NodeGroupOperation::evaluate_pixel_compile_unit(CompileState &compile_state
 
   operation->compute_results_reference_counts(compile_state.get_schedule());
 
-  operation->evaluate();
+  if (!defer_evaluation) {
+    operation->evaluate();
+  }
 
   compile_state.reset_pixel_compile_unit();
+
+  return defer_evaluation ? operation : nullptr;
 }
 
 void NodeGroupOperation::map_pixel_operation_inputs_to_their_results(PixelOperation *operation,
@@ -2,15 +2,20 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <algorithm>
 #include <limits>
 #include <memory>
+#include <optional>
 
+#include "BLI_generic_span.hh"
+#include "BLI_index_range.hh"
 #include "BLI_map.hh"
 #include "BLI_string_ref.hh"
 
 #include "COM_context.hh"
 #include "COM_conversion_operation.hh"
 #include "COM_domain.hh"
+#include "COM_half_float_expansion_operation.hh"
 #include "COM_input_descriptor.hh"
 #include "COM_operation.hh"
 #include "COM_realize_on_domain_operation.hh"
@@ -59,6 +64,235 @@ Context &Operation::context() const
   return context_;
 }
 
+std::optional<int> Operation::get_kernel_radius()
+{
+  return std::nullopt;
+}
+
+bool Operation::can_evaluate_tiled(Operation &producer)
+{
+  if (!this->get_kernel_radius().has_value() || producer.get_kernel_radius() != 0) {
+    return false;
+  }
+
+  /* The data of the operations would be logged for a single tile. */
+  if (this->context().nodes_evaluation_log()) {
+    return false;
+  }
+
+  /* The results of the producer are only computed for a single tile at a time, so they can't be
+   * used by any other operation. */
+  bool uses_producer_results = false;
+  for (const Result &result : producer.results_.values()) {
+    int users_count = 0;
+    for (const auto item : results_mapped_to_inputs_.items()) {
+      if (item.value != &result) {
+        continue;
+      }
+      /* The operation might read a single pixel of the result as a single value. */
+      if (this->get_input_descriptor(item.key).expects_single_value) {
+        return false;
+      }
+      users_count++;
+    }
+    if (result.reference_count() != users_count) {
+      return false;
+    }
+    uses_producer_results |= users_count != 0;
+  }
+
+  return uses_producer_results && this->compute_tiled_domain(producer).has_value();
+}
+
+/* Returns true if the given result is one of the given results. */
+static bool is_one_of_results(const Result &result, const Map<std::string, Result> &results)
+{
+  for (const Result &other_result : results.values()) {
+    if (&other_result == &result) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::optional<Domain> Operation::compute_tiled_domain(Operation &producer)
+{
+  std::optional<Domain> domain;
+  for (Operation *operation : {&producer, this}) {
+    for (const auto item : operation->results_mapped_to_inputs_.items()) {
+      const Result &input = *item.value;
+      if (input.is_single_value() || is_one_of_results(input, producer.results_)) {
+        continue;
+      }
+
+      /* Tiles of inputs only share the rows of the inputs, so the inputs can't be processed in a
+       * way that depends on their whole data. */
+      if (operation->get_input_descriptor(item.key).expects_single_value) {
+        return std::nullopt;
+      }
+
+      if (!domain.has_value()) {
+        domain = input.domain();
+      }
+      else if (input.domain() != *domain) {
+        return std::nullopt;
+      }
+    }
+  }
+  return domain;
+}
+
+/* Creates a result that can be released once and shares the given rows of the given result, or
+ * its value if it is a single value. */
+static Result create_tile_input(Context &context, const Result &input, const IndexRange rows)
+{
+  Result tile_input = context.create_result(input.type(), input.precision());
+  if (input.is_single_value()) {
+    tile_input.share_data(input);
+  }
+  else {
+    const int width = input.domain().data_size.x;
+    if (input.is_half_float_image()) {
+      const int64_t row_size = width * input.channels_count();
+      const Span<uint16_t> data = input.cpu_half_data().slice(rows.start() * row_size,
+                                                              rows.size() * row_size);
+      tile_input.share_data(
+          data.data(), int2(width, rows.size()), nullptr, ResultStorageType::CPUHalfImage);
+    }
+    else {
+      const GSpan data = input.cpu_data().slice(rows.start() * width, rows.size() * width);
+      tile_input.share_data(data.data(), int2(width, rows.size()));
+    }
+
+    Domain domain = input.domain();
+    domain.data_size.y = rows.size();
+    tile_input.domain() = domain;
+  }
+  tile_input.set_reference_count(1);
+  return tile_input;
+}
+
+void Operation::evaluate_tiled(Operation &producer, const int tile_size)
+{
+  const Domain domain = *this->compute_tiled_domain(producer);
+  const int2 size = domain.data_size;
+  const int radius = *this->get_kernel_radius();
+
+  /* Make sure tiles are large enough compared to the kernel radius, since the extra rows are
+   * computed for every tile. */
+  const int64_t tile_pixels_count = int64_t(tile_size) * tile_size;
+  const int tile_rows_count = int(
+      std::max({tile_pixels_count / size.x, int64_t(radius) * 4, int64_t(1)}));
+  if (tile_rows_count >= size.y) {
+    producer.evaluate();
+    this->evaluate();
+    return;
+  }
+
+  /* The results of this operation for the whole domain, which the tiles are copied into. */
+  Map<std::string, Result> results;
+
+  for (int64_t tile_start = 0; tile_start < size.y; tile_start += tile_rows_count) {
+    if (this->context().is_canceled()) {
+      break;
+    }
+
+    const IndexRange tile_rows = IndexRange::from_begin_end(
+        tile_start, std::min(tile_start + tile_rows_count, int64_t(size.y)));
+    const IndexRange extended_rows = IndexRange::from_begin_end(
+        std::max(tile_rows.first() - radius, int64_t(0)),
+        std::min(tile_rows.one_after_last() + radius, int64_t(size.y)));
+
+    Map<StringRef, Result> producer_inputs;
+    for (const auto item : producer.results_mapped_to_inputs_.items()) {
+      producer_inputs.add_new(item.key,
+                              create_tile_input(this->context(), *item.value, extended_rows));
+    }
+    producer.evaluate_tile(producer_inputs);
+
+    /* The results of the producer are already computed for the extended rows only. */
+    Map<StringRef, Result> inputs;
+    for (const auto item : results_mapped_to_inputs_.items()) {
+      const bool is_producer_result = is_one_of_results(*item.value, producer.results_);
+      inputs.add_new(item.key,
+                     create_tile_input(this->context(),
+                                       *item.value,
+                                       is_producer_result ? extended_rows.index_range() :
+                                                            extended_rows));
+    }
+    this->evaluate_tile(inputs);
+
+    /* Free the results of the producer without changing their reference count, since they will
+     * be computed again for the next tile. */
+    producer.free_results();
+
+    for (const auto item : results_.items()) {
+      Result &tile_result = item.value;
+      if (!tile_result.is_allocated()) {
+        continue;
+      }
+
+      Result &result = results.lookup_or_add_cb(item.key, [&]() {
+        Result result = this->context().create_result(tile_result.type(),
+                                                      tile_result.precision());
+        result.set_reference_count(1);
+        return result;
+      });
+
+      if (tile_result.is_single_value()) {
+        if (!result.is_allocated()) {
+          result.share_data(tile_result);
+        }
+        tile_result.free();
+        continue;
+      }
+
+      if (!result.is_allocated()) {
+        Domain result_domain = tile_result.domain();
+        result_domain.data_size = size;
+        result.allocate_texture(result_domain);
+      }
+
+      /* Copy the rows of the tile, skipping the extra rows at the start. */
+      const int64_t rows_offset = tile_rows.first() - extended_rows.first();
+      const GSpan source = tile_result.cpu_data().slice(rows_offset * size.x,
+                                                        tile_rows.size() * size.x);
+      GMutableSpan target = result.cpu_data_for_write().slice(tile_rows.first() * size.x,
+                                                              tile_rows.size() * size.x);
+      source.type().copy_assign_n(source.data(), target.data(), source.size());
+      tile_result.free();
+    }
+  }
+
+  for (const auto item : results.items()) {
+    this->get_result(item.key).share_data(item.value);
+    item.value.free();
+  }
+
+  producer.release_inputs();
+  this->release_inputs();
+  this->context().evaluate_operation_post();
+}
+
+void Operation::evaluate_tile(Map<StringRef, Result> &inputs)
+{
+  const Map<StringRef, Result *> results_mapped_to_inputs = results_mapped_to_inputs_;
+  for (const auto item : inputs.items()) {
+    results_mapped_to_inputs_.lookup(item.key) = &item.value;
+  }
+
+  /* Input processors of the previous tile were already evaluated and released. */
+  input_processors_.clear();
+
+  is_evaluating_tile_ = true;
+  this->evaluate_input_processors();
+  this->execute();
+  this->release_inputs();
+  is_evaluating_tile_ = false;
+
+  results_mapped_to_inputs_ = results_mapped_to_inputs;
+}
+
 Domain Operation::compute_domain()
 {
   /* Default to an identity domain in case no domain input was found, most likely because all
@@ -101,6 +335,18 @@ void Operation::evaluate_input_processors()
    * value of all inputs, so previous input processors for all inputs needs to be added and
    * evaluated first. */
 
+  /* Half float images are expanded first, such that the other input processors need not handle
+   * them. Expansion doesn't change the domain of the input, so the operation domain can be
+   * computed before it. */
+  for (const StringRef &identifier : results_mapped_to_inputs_.keys()) {
+    SimpleOperation *expansion = HalfFloatExpansionOperation::construct_if_needed(
+        this->context(),
+        this->get_input(identifier),
+        this->get_input_descriptor(identifier),
+        this->compute_domain());
+    this->add_and_evaluate_input_processor(identifier, expansion);
+  }
+
   for (const StringRef &identifier : results_mapped_to_inputs_.keys()) {
     SimpleOperation *conversion = ConversionOperation::construct_if_needed(
         this->context(), this->get_input(identifier), this->get_input_descriptor(identifier));
@@ -143,6 +389,11 @@ void Operation::allocate_default_remaining_outputs()
   }
 }
 
+bool Operation::is_evaluating_tile() const
+{
+  return is_evaluating_tile_;
+}
+
 void Operation::add_and_evaluate_input_processor(StringRef identifier, SimpleOperation *processor)
 {
   /* Allow null inputs to facilitate construct_if_needed pattern of addition. For instance, see the
@@ -188,16 +188,26 @@ int PixelOperation::get_internal_input_reference_count(const StringRef &identifi
 
 void PixelOperation::compute_results_reference_counts(const Schedule &schedule)
 {
+  outputs_only_read_by_pixel_operations_.clear();
   for (const auto item : output_sockets_to_output_identifiers_map_.items()) {
-    int reference_count = number_of_inputs_linked_to_output_conditioned(
+    /* We only consider inputs that are not part of the pixel operations, because inputs that are
+     * part of the pixel operations are internal and do not deal with the result directly. */
+    auto is_external_input = [&](const bNodeSocket &input) {
+      return schedule.nodes.contains(&input.owner_node()) &&
+             !schedule.unneeded_inputs.contains(&input) &&
+             !compile_state_.get_pixel_compile_unit().contains(&input.owner_node());
+    };
+    int reference_count = number_of_inputs_linked_to_output_conditioned(*item.key,
+                                                                        is_external_input);
+
+    /* Pixel nodes are compiled into other pixel operations. */
+    const bool is_read_by_other_operations = is_output_linked_to_input_conditioned(
         *item.key, [&](const bNodeSocket &input) {
-          /* We only consider inputs that are not part of the pixel operations, because inputs
-           * that are part of the pixel operations are internal and do not deal with the result
-           * directly. */
-          return schedule.nodes.contains(&input.owner_node()) &&
-                 !schedule.unneeded_inputs.contains(&input) &&
-                 !compile_state_.get_pixel_compile_unit().contains(&input.owner_node());
+          return is_external_input(input) && !is_pixel_node(input.owner_node());
         });
+    if (reference_count != 0 && !is_read_by_other_operations) {
+      outputs_only_read_by_pixel_operations_.add(item.value);
+    }
 
     if (preview_outputs_.contains(item.key)) {
       reference_count++;
@@ -211,6 +221,11 @@ void PixelOperation::compute_results_reference_counts(const Schedule &schedule)
   }
 }
 
+bool PixelOperation::is_output_only_read_by_pixel_operations(const StringRef identifier) const
+{
+  return outputs_only_read_by_pixel_operations_.contains_as(identifier);
+}
+
 void PixelOperation::set_needs_node_previews(const bool needed)
 {
   needs_node_previews_ = needed;
@@ -3,10 +3,13 @@
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
 #include <limits>
+#include <optional>
 
+#include "BLI_index_range.hh"
 #include "BLI_math_matrix.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_utildefines.hh"
 
 #include "GPU_shader.hh"
@@ -244,14 +247,20 @@ static void realize_on_domain(const Result &input, Result &output, const float3x
 {
   const RealizationOptions realization_options = input.get_realization_options();
   const float2x2 jacobian(transformation);
-  parallel_for(output.domain().data_size, [&](const int2 texel) {
-    const float2 coordinates = math::transform_point(transformation, float2(texel));
-    T sample = input.sample<T>(coordinates,
-                               realization_options.interpolation,
-                               realization_options.extension_x,
-                               realization_options.extension_y,
-                               jacobian);
-    output.store_pixel(texel, sample);
+  const int2 size = output.domain().data_size;
+  parallel_for_row_segments(size, [&](const int y, const IndexRange x_range) {
+    /* The transformation is affine, so the coordinates of the pixels of the row are computed by
+     * stepping from the start of the row along the transformed x axis. */
+    const float2 row_start = math::transform_point(transformation, float2(0.0f, float(y)));
+    MutableSpan<T> output_row = output.row_segment_for_write<T>(y, x_range);
+    for (const int64_t i : x_range.index_range()) {
+      const float2 coordinates = row_start + jacobian.x * float(x_range[i]);
+      output_row[i] = input.sample<T>(coordinates,
+                                      realization_options.interpolation,
+                                      realization_options.extension_x,
+                                      realization_options.extension_y,
+                                      jacobian);
+    }
   });
 }
 
@@ -285,26 +294,25 @@ Domain RealizeOnDomainOperation::compute_domain()
   return target_domain_;
 }
 
-SimpleOperation *RealizeOnDomainOperation::construct_if_needed(
-    Context &context,
+std::optional<Domain> RealizeOnDomainOperation::compute_target_domain(
     const Result &input_result,
     const InputDescriptor &input_descriptor,
     const Domain &operation_domain)
 {
   /* This input doesn't need realization, the operation is not needed. */
   if (input_descriptor.realization_mode == InputRealizationMode::None) {
-    return nullptr;
+    return std::nullopt;
   }
 
   /* The input expects a single value and if no single value is provided, it will be ignored and a
    * default value will be used, so no need to realize it and the operation is not needed. */
   if (input_descriptor.expects_single_value) {
-    return nullptr;
+    return std::nullopt;
   }
 
   /* Input result is a single value and does not need realization, the operation is not needed. */
   if (input_result.is_single_value()) {
-    return nullptr;
+    return std::nullopt;
   }
 
   /* If we are realizing on the operation domain, then our target domain is the operation domain,
@@ -321,10 +329,25 @@ SimpleOperation *RealizeOnDomainOperation::construct_if_needed(
   /* The input have an almost identical domain to the realized target domain, so no need to realize
    * it and the operation is not needed. */
   if (Domain::is_equal(input_result.domain(), realized_target_domain)) {
+    return std::nullopt;
+  }
+
+  return realized_target_domain;
+}
+
+SimpleOperation *RealizeOnDomainOperation::construct_if_needed(
+    Context &context,
+    const Result &input_result,
+    const InputDescriptor &input_descriptor,
+    const Domain &operation_domain)
+{
+  const std::optional<Domain> target_domain = compute_target_domain(
+      input_result, input_descriptor, operation_domain);
+  if (!target_domain.has_value()) {
     return nullptr;
   }
 
-  return new RealizeOnDomainOperation(context, realized_target_domain, input_descriptor.type);
+  return new RealizeOnDomainOperation(context, *target_domain, input_descriptor.type);
 }
 
 }  // namespace blender::compositor
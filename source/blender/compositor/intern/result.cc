@@ -12,10 +12,12 @@
 #include "BLI_generic_array.hh"
 #include "BLI_generic_pointer.hh"
 #include "BLI_generic_span.hh"
+#include "BLI_math_half.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_quaternion_types.hh"
 #include "BLI_math_vector_types.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 
 #include "BLT_translation.hh"
 
@@ -27,6 +29,7 @@
 #include "NOD_geometry_nodes_bundle.hh"
 
 #include "COM_context.hh"
+#include "COM_cpu_buffer_pool.hh"
 #include "COM_derived_resources.hh"
 #include "COM_domain.hh"
 #include "COM_result.hh"
@@ -78,6 +81,38 @@ bool Result::is_single_value_only_type(ResultType type)
   return true;
 }
 
+bool Result::supports_half_float_image(ResultType type)
+{
+  switch (type) {
+    case ResultType::Float:
+    case ResultType::Float2:
+    case ResultType::Float3:
+    case ResultType::Float4:
+    case ResultType::Color:
+      return true;
+    case ResultType::Int:
+    case ResultType::Int2:
+    case ResultType::Int3:
+    case ResultType::Int4:
+    case ResultType::Bool:
+    case ResultType::Float4x4:
+    case ResultType::Menu:
+    case ResultType::Quaternion:
+    case ResultType::String:
+    case ResultType::Object:
+    case ResultType::Image:
+    case ResultType::Font:
+    case ResultType::Scene:
+    case ResultType::Text:
+    case ResultType::Mask:
+    case ResultType::Bundle:
+      return false;
+  }
+
+  BLI_assert_unreachable();
+  return false;
+}
+
 gpu::TextureFormat Result::gpu_texture_format(ResultType type, ResultPrecision precision)
 {
   switch (precision) {
@@ -541,6 +576,27 @@ class GPUData {
   }
 };
 
+/* Implicit sharing info of CPU data acquired from the CPU buffer pool, which releases the data
+ * back into the pool when it is no longer used. */
+class PooledCPUData : public ImplicitSharingInfo {
+ public:
+  GMutableSpan data;
+
+  PooledCPUData(const CPPType &type, const int64_t size)
+      : data(CPUBufferPool::get().acquire(type, size))
+  {
+  }
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("PooledCPUData");
+
+ private:
+  void delete_self_with_data() override
+  {
+    CPUBufferPool::get().release(this->data);
+    delete this;
+  }
+};
+
 void Result::allocate_texture(const Domain domain,
                               const bool from_pool,
                               const std::optional<ResultStorageType> storage_type)
@@ -563,9 +619,21 @@ void Result::allocate_texture(const Domain domain,
     return;
   }
 
-  storage_type_ = ResultStorageType::CPUImage;
-  const int64_t array_size = int64_t(domain_.data_size.x) * int64_t(domain_.data_size.y);
-  auto *new_array = new ImplicitSharedValue<GArray<>>(this->get_cpp_type(), array_size);
+  const int64_t pixels_count = int64_t(domain_.data_size.x) * int64_t(domain_.data_size.y);
+  const bool use_half_float = storage_type == ResultStorageType::CPUHalfImage;
+  BLI_assert(!use_half_float || Result::supports_half_float_image(this->type()));
+  storage_type_ = use_half_float ? ResultStorageType::CPUHalfImage : ResultStorageType::CPUImage;
+  const CPPType &cpp_type = use_half_float ? CPPType::get<uint16_t>() : this->get_cpp_type();
+  const int64_t array_size = use_half_float ? pixels_count * this->channels_count() :
+                                              pixels_count;
+  if (from_pool) {
+    auto *new_data = new PooledCPUData(cpp_type, array_size);
+    sharing_info_ = ImplicitSharingPtr<>(new_data);
+    cpu_data_ = new_data->data;
+    return;
+  }
+
+  auto *new_array = new ImplicitSharedValue<GArray<>>(cpp_type, array_size);
   sharing_info_ = ImplicitSharingPtr<>(new_array);
   cpu_data_ = new_array->data.as_span();
 }
@@ -655,6 +723,25 @@ void Result::allocate_invalid()
   this->allocate_single_value();
 }
 
+Result Result::expand_half_float_image(const bool from_pool) const
+{
+  BLI_assert(storage_type_ == ResultStorageType::CPUHalfImage);
+  BLI_assert(this->is_allocated());
+
+  Result result = Result(*context_, this->type(), this->precision());
+  result.allocate_texture(this->domain(), from_pool, ResultStorageType::CPUImage);
+
+  /* All supported types are stored as contiguous floats, one for each channel. */
+  const Span<uint16_t> source = this->cpu_half_data();
+  float *target = static_cast<float *>(result.cpu_data_for_write().data());
+  threading::parallel_for(source.index_range(), 16384, [&](const IndexRange sub_range) {
+    math::half_to_float_array(
+        source.slice(sub_range).data(), target + sub_range.start(), sub_range.size());
+  });
+
+  return result;
+}
+
 Result Result::upload_to_gpu(const bool from_pool) const
 {
   BLI_assert(storage_type_ == ResultStorageType::CPUImage);
@@ -1009,13 +1096,23 @@ void Result::share_data(gpu::Texture *texture, ImplicitSharingPtr<> sharing_info
   sharing_info_ = std::move(sharing_info);
 }
 
-void Result::share_data(const void *data, const int2 size, ImplicitSharingPtr<> sharing_info)
+void Result::share_data(const void *data,
+                        const int2 size,
+                        ImplicitSharingPtr<> sharing_info,
+                        const ResultStorageType storage_type)
 {
   BLI_assert(!this->is_allocated());
+  BLI_assert(ELEM(storage_type, ResultStorageType::CPUImage, ResultStorageType::CPUHalfImage));
 
-  const int64_t array_size = int64_t(size.x) * int64_t(size.y);
-  cpu_data_ = GSpan(this->get_cpp_type(), data, array_size);
-  storage_type_ = ResultStorageType::CPUImage;
+  const int64_t pixels_count = int64_t(size.x) * int64_t(size.y);
+  if (storage_type == ResultStorageType::CPUHalfImage) {
+    BLI_assert(Result::supports_half_float_image(this->type()));
+    cpu_data_ = GSpan(CPPType::get<uint16_t>(), data, pixels_count * this->channels_count());
+  }
+  else {
+    cpu_data_ = GSpan(this->get_cpp_type(), data, pixels_count);
+  }
+  storage_type_ = storage_type;
   domain_ = Domain(size);
   sharing_info_ = std::move(sharing_info);
 }
@@ -1080,6 +1177,7 @@ void Result::free()
       gpu_texture_ = nullptr;
       break;
     case ResultStorageType::CPUImage:
+    case ResultStorageType::CPUHalfImage:
       cpu_data_ = GSpan();
       break;
   }
@@ -1131,6 +1229,8 @@ bool Result::is_allocated() const
       return this->gpu_texture();
     case ResultStorageType::CPUImage:
       return this->cpu_data().data();
+    case ResultStorageType::CPUHalfImage:
+      return this->cpu_half_data().data();
   }
 
   return false;
@@ -1190,6 +1290,9 @@ int64_t Result::size_in_bytes() const
   if (this->is_single_value()) {
     return pixel_size;
   }
+  if (this->is_half_float_image()) {
+    return this->cpu_half_data().size_in_bytes();
+  }
   const int2 image_size = this->domain().data_size;
   return pixel_size * image_size.x * image_size.y;
 }
@@ -72,6 +72,15 @@ void DEG_graph_relations_update(Depsgraph *graph);
 /** Tag all relations in the database for update. */
 void DEG_relations_tag_update(Main *bmain);
 
+/**
+ * Tag relations of the given ID for update, when the change does not affect relations of other
+ * IDs (for example, adding or removing a modifier of an object).
+ *
+ * On the next relations update only the nodes and relations of the tagged IDs are rebuilt where
+ * possible, falling back to rebuilding the whole graph otherwise.
+ */
+void DEG_id_relations_tag_update(Main *bmain, ID *id);
+
 /* Add Dependencies  ----------------------------- */
 
 /**
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include "BLI_set.hh"
+
 namespace blender {
 
 struct Base;
@@ -23,6 +25,7 @@ namespace deg {
 
 struct Depsgraph;
 class DepsgraphBuilderCache;
+struct IDNode;
 
 class DepsgraphBuilder {
  public:
@@ -58,6 +61,10 @@ class DepsgraphBuilder {
 bool deg_check_id_in_depsgraph(const Depsgraph *graph, ID *id_orig);
 bool deg_check_base_in_depsgraph(const Depsgraph *graph, Base *base);
 void deg_graph_build_finalize(Main *bmain, Depsgraph *graph);
+/* Finalize the graph after only the given ID nodes were rebuilt on relations update. */
+void deg_graph_build_finalize_incremental(Main *bmain,
+                                          Depsgraph *graph,
+                                          const Set<IDNode *> &rebuilt_id_nodes);
 
 }  // namespace deg
 }  // namespace blender
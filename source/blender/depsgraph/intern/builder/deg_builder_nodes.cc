@@ -558,6 +558,88 @@ void DepsgraphNodeBuilder::end_build()
   update_invalid_cow_pointers();
 }
 
+void DepsgraphNodeBuilder::begin_build_incremental(Scene *scene,
+                                                   ViewLayer *view_layer,
+                                                   const Set<IDNode *> &id_nodes)
+{
+  /* Match the state set up by #build_view_layer. */
+  scene_ = scene;
+  view_layer_ = view_layer;
+  view_layer_index_ = 0;
+
+  for (IDNode *id_node : graph_->id_nodes) {
+    /* Evaluated copies stay owned by the ID nodes, only the state which is compared against after
+     * the build is remembered. It is also needed for the kept IDs, as #add_id_node might still be
+     * called for them. */
+    IDInfo id_info{};
+    id_info.previously_visible_components_mask = id_node->visible_components_mask;
+    id_info.previous_eval_flags = id_node->eval_flags;
+    id_info.previous_customdata_masks = id_node->customdata_masks;
+    id_info_hash_.add_new(id_node->id_orig_session_uid, std::move(id_info));
+
+    if (!id_nodes.contains(id_node)) {
+      id_node->previous_eval_flags = id_node->eval_flags;
+      id_node->previous_customdata_masks = id_node->customdata_masks;
+      built_map_.tag_built(id_node->id_orig,
+                           BuilderMap::TAG_COMPLETE |
+                               BuilderMap::TAG_COLLECTION_CHILDREN_HIERARCHY);
+    }
+  }
+
+  Set<OperationNode *> removed_operations;
+  for (IDNode *id_node : id_nodes) {
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        if (graph_->entry_tags.contains(op_node)) {
+          saved_entry_tags_.append_as(op_node);
+        }
+        if (op_node->flag & DEPSOP_FLAG_NEEDS_UPDATE) {
+          needs_update_operations_.append_as(op_node);
+        }
+        removed_operations.add_new(op_node);
+      }
+      delete comp_node;
+    }
+    id_node->components.clear();
+  }
+
+  graph_->operations.remove_if(
+      [&](OperationNode *op_node) { return removed_operations.contains(op_node); });
+  graph_->entry_tags.remove_if(
+      [&](OperationNode *op_node) { return removed_operations.contains(op_node); });
+}
+
+void DepsgraphNodeBuilder::build_object_incremental(Object *object)
+{
+  const IDNode *id_node = find_id_node(&object->id);
+
+  /* Base index matches the one #build_view_layer assigns to the object. */
+  int base_index = -1;
+  int index = 0;
+  BKE_view_layer_synced_ensure(*bmain_, scene_, view_layer_);
+  for (Base &base : *BKE_view_layer_object_bases_get(view_layer_)) {
+    if (!need_pull_base_into_graph(&base)) {
+      continue;
+    }
+    if (base.object == object) {
+      base_index = index;
+      break;
+    }
+    index++;
+  }
+
+  build_object(base_index, object, id_node->linked_state, id_node->is_visible_on_build);
+}
+
+void DepsgraphNodeBuilder::end_build_incremental(const bool has_new_id_nodes)
+{
+  tag_previously_tagged_nodes();
+  /* Only newly pulled in IDs can invalidate pointers of the existing evaluated copies. */
+  if (has_new_id_nodes) {
+    update_invalid_cow_pointers();
+  }
+}
+
 void DepsgraphNodeBuilder::build_id(ID *id, const bool force_be_visible)
 {
   if (id == nullptr) {
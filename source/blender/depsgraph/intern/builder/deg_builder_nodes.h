@@ -97,6 +97,19 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void begin_build();
   virtual void end_build();
 
+  /**
+   * Begin rebuilding nodes of the given objects in an already built graph of the view layer.
+   *
+   * The components of the given ID nodes are removed (their evaluated copies are kept), and all
+   * other IDs of the graph are considered built, so that their nodes are kept as-is.
+   */
+  void begin_build_incremental(Scene *scene,
+                               ViewLayer *view_layer,
+                               const Set<IDNode *> &id_nodes);
+  /* Re-create nodes of an object whose components were removed by #begin_build_incremental. */
+  void build_object_incremental(Object *object);
+  void end_build_incremental(bool has_new_id_nodes);
+
   /**
    * `id_cow_self` is the user of `id_pointer`,
    * see also `LibraryIDLinkCallbackData` struct definition.
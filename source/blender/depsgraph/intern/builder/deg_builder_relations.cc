@@ -350,7 +350,7 @@ void DepsgraphRelationBuilder::add_customdata_mask(Object *object,
       BLI_assert_msg(0, "ID should always be valid");
     }
     else {
-      id_node->customdata_masks |= customdata_masks;
+      id_node->add_eval_request(stack_.current_id(), 0, customdata_masks);
     }
   }
 }
@@ -362,17 +362,30 @@ void DepsgraphRelationBuilder::add_special_eval_flag(ID *id, uint32_t flag)
     BLI_assert_msg(0, "ID should always be valid");
   }
   else {
-    id_node->eval_flags |= flag;
+    id_node->add_eval_request(stack_.current_id(), flag, DEGCustomDataMeshMasks());
   }
 }
 
+bool DepsgraphRelationBuilder::check_is_built_and_tag(ID *id, const int tag)
+{
+  const ID *user_id = stack_.current_id();
+  /* Roots of an incremental build are not pulled in by anything, they keep their users. */
+  if (user_id != id && (user_id != nullptr || !is_incremental_build_)) {
+    IDNode *id_node = graph_->find_id_node(id);
+    if (id_node != nullptr) {
+      id_node->builder_users.add(user_id);
+    }
+  }
+  return check_is_built_and_tag(id, tag);
+}
+
 Relation *DepsgraphRelationBuilder::add_time_relation(TimeSourceNode *timesrc,
                                                       Node *node_to,
                                                       const char *description,
                                                       int flags)
 {
   if (timesrc && node_to) {
-    return graph_->add_new_relation(timesrc, node_to, description, flags);
+    return add_new_relation(timesrc, node_to, description, flags);
   }
 
   DEG_DEBUG_PRINTF((blender::Depsgraph *)graph_,
@@ -394,13 +407,26 @@ void DepsgraphRelationBuilder::add_visibility_relation(ID *id_from, ID *id_to)
   add_relation(from_key, to_key, "visibility");
 }
 
+Relation *DepsgraphRelationBuilder::add_new_relation(Node *node_from,
+                                                     Node *node_to,
+                                                     const char *description,
+                                                     int flags)
+{
+  Relation *rel = graph_->add_new_relation(node_from, node_to, description, flags);
+  /* Relations which already existed keep their original owner. */
+  if (rel->owner_id == nullptr) {
+    rel->owner_id = stack_.current_id();
+  }
+  return rel;
+}
+
 Relation *DepsgraphRelationBuilder::add_operation_relation(OperationNode *node_from,
                                                            OperationNode *node_to,
                                                            const char *description,
                                                            int flags)
 {
   if (node_from && node_to) {
-    return graph_->add_new_relation(node_from, node_to, description, flags);
+    return add_new_relation(node_from, node_to, description, flags);
   }
 
   DEG_DEBUG_PRINTF((blender::Depsgraph *)graph_,
@@ -515,6 +541,20 @@ Depsgraph *DepsgraphRelationBuilder::getGraph()
 
 void DepsgraphRelationBuilder::begin_build() {}
 
+void DepsgraphRelationBuilder::begin_build_incremental(Scene *scene,
+                                                       const Set<IDNode *> &id_nodes)
+{
+  scene_ = scene;
+  is_incremental_build_ = true;
+  for (IDNode *id_node : graph_->id_nodes) {
+    if (!id_nodes.contains(id_node)) {
+      built_map_.tag_built(id_node->id_orig,
+                           BuilderMap::TAG_COMPLETE |
+                               BuilderMap::TAG_COLLECTION_CHILDREN_HIERARCHY);
+    }
+  }
+}
+
 void DepsgraphRelationBuilder::build_id(ID *id)
 {
   if (id == nullptr) {
@@ -619,7 +659,7 @@ void DepsgraphRelationBuilder::build_id(ID *id)
 
 void DepsgraphRelationBuilder::build_generic_id(ID *id)
 {
-  if (built_map_.check_is_built_and_tag(id)) {
+  if (check_is_built_and_tag(id)) {
     return;
   }
 
@@ -641,7 +681,7 @@ void DepsgraphRelationBuilder::build_idproperties(IDProperty *id_property)
 void DepsgraphRelationBuilder::build_collection(LayerCollection *from_layer_collection,
                                                 Collection *collection)
 {
-  if (!built_map_.check_is_built_and_tag(collection, BuilderMap::TAG_COLLECTION_PROPERTIES)) {
+  if (!check_is_built_and_tag(collection, BuilderMap::TAG_COLLECTION_PROPERTIES)) {
     build_idproperties(collection->id.properties);
     build_idproperties(collection->id.system_properties);
     build_parameters(&collection->id);
@@ -655,9 +695,7 @@ void DepsgraphRelationBuilder::build_collection(LayerCollection *from_layer_coll
      * outside of the layer collection properly recurses into all the nested objects and
      * collections. */
 
-    if (!built_map_.check_is_built_and_tag(collection,
-                                           BuilderMap::TAG_COLLECTION_CHILDREN_HIERARCHY))
-    {
+    if (!check_is_built_and_tag(collection, BuilderMap::TAG_COLLECTION_CHILDREN_HIERARCHY)) {
       const ComponentKey collection_hierarchy_key{&collection->id, NodeType::HIERARCHY};
       OperationNode *collection_hierarchy_exit =
           this->find_node(collection_hierarchy_key)->get_exit_operation();
@@ -684,7 +722,7 @@ void DepsgraphRelationBuilder::build_collection(LayerCollection *from_layer_coll
     return;
   }
 
-  if (built_map_.check_is_built_and_tag(collection)) {
+  if (check_is_built_and_tag(collection)) {
     return;
   }
 
@@ -736,7 +774,7 @@ void DepsgraphRelationBuilder::build_collection(LayerCollection *from_layer_coll
 
 void DepsgraphRelationBuilder::build_object(Object *object)
 {
-  if (built_map_.check_is_built_and_tag(object)) {
+  if (check_is_built_and_tag(object)) {
     return;
   }
 
@@ -1694,8 +1732,7 @@ void DepsgraphRelationBuilder::build_animdata_fcurve_target(
     add_relation(adt_key, pose_init_key, "Animation -> Prop", RELATION_CHECK_BEFORE_ADD);
     return;
   }
-  graph_->add_new_relation(
-      operation_from, operation_to, "Animation -> Prop", RELATION_CHECK_BEFORE_ADD);
+  add_new_relation(operation_from, operation_to, "Animation -> Prop", RELATION_CHECK_BEFORE_ADD);
   /* It is possible that animation is writing to a nested ID data-block,
    * need to make sure animation is evaluated after target ID is copied. */
   const IDNode *id_node_from = operation_from->owner->owner;
@@ -1855,7 +1892,7 @@ void DepsgraphRelationBuilder::build_animdata_force(ID *id)
 
 void DepsgraphRelationBuilder::build_action(bAction *dna_action)
 {
-  if (built_map_.check_is_built_and_tag(dna_action)) {
+  if (check_is_built_and_tag(dna_action)) {
     return;
   }
 
@@ -2256,7 +2293,7 @@ void DepsgraphRelationBuilder::build_dimensions(Object *object)
 
 void DepsgraphRelationBuilder::build_world(World *world)
 {
-  if (built_map_.check_is_built_and_tag(world)) {
+  if (check_is_built_and_tag(world)) {
     return;
   }
 
@@ -2497,7 +2534,7 @@ void DepsgraphRelationBuilder::build_particle_systems(Object *object)
 
 void DepsgraphRelationBuilder::build_particle_settings(ParticleSettings *part)
 {
-  if (built_map_.check_is_built_and_tag(part)) {
+  if (check_is_built_and_tag(part)) {
     return;
   }
 
@@ -2558,7 +2595,7 @@ void DepsgraphRelationBuilder::build_particle_system_visualization_object(Object
 /* Shapekeys */
 void DepsgraphRelationBuilder::build_shapekeys(Key *key)
 {
-  if (built_map_.check_is_built_and_tag(key)) {
+  if (check_is_built_and_tag(key)) {
     return;
   }
 
@@ -2713,7 +2750,7 @@ void DepsgraphRelationBuilder::build_object_data_geometry(Object *object)
 
 void DepsgraphRelationBuilder::build_object_data_geometry_datablock(ID *obdata)
 {
-  if (built_map_.check_is_built_and_tag(obdata)) {
+  if (check_is_built_and_tag(obdata)) {
     return;
   }
 
@@ -2915,7 +2952,7 @@ void DepsgraphRelationBuilder::build_object_data_empty(Object *object)
 
 void DepsgraphRelationBuilder::build_armature(bArmature *armature)
 {
-  if (built_map_.check_is_built_and_tag(armature)) {
+  if (check_is_built_and_tag(armature)) {
     return;
   }
 
@@ -2948,7 +2985,7 @@ void DepsgraphRelationBuilder::build_armature_bone_collections(Span<BoneCollecti
 
 void DepsgraphRelationBuilder::build_camera(Camera *camera)
 {
-  if (built_map_.check_is_built_and_tag(camera)) {
+  if (check_is_built_and_tag(camera)) {
     return;
   }
 
@@ -2976,7 +3013,7 @@ void DepsgraphRelationBuilder::build_camera(Camera *camera)
 /* Lights */
 void DepsgraphRelationBuilder::build_light(Light *lamp)
 {
-  if (built_map_.check_is_built_and_tag(lamp)) {
+  if (check_is_built_and_tag(lamp)) {
     return;
   }
 
@@ -3072,7 +3109,7 @@ void DepsgraphRelationBuilder::build_nodetree(bNodeTree *ntree)
   if (ntree == nullptr) {
     return;
   }
-  if (built_map_.check_is_built_and_tag(ntree)) {
+  if (check_is_built_and_tag(ntree)) {
     return;
   }
 
@@ -3226,7 +3263,7 @@ void DepsgraphRelationBuilder::build_material(Material *material, ID *owner)
     add_relation(material_key, owner_shading_key, "Material -> Owner Shading");
   }
 
-  if (built_map_.check_is_built_and_tag(material)) {
+  if (check_is_built_and_tag(material)) {
     return;
   }
 
@@ -3266,7 +3303,7 @@ void DepsgraphRelationBuilder::build_materials(ID *owner, Material **materials,
 /* Recursively build graph for texture */
 void DepsgraphRelationBuilder::build_texture(Tex *texture)
 {
-  if (built_map_.check_is_built_and_tag(texture)) {
+  if (check_is_built_and_tag(texture)) {
     return;
   }
 
@@ -3311,7 +3348,7 @@ void DepsgraphRelationBuilder::build_texture(Tex *texture)
 
 void DepsgraphRelationBuilder::build_image(Image *image)
 {
-  if (built_map_.check_is_built_and_tag(image)) {
+  if (check_is_built_and_tag(image)) {
     return;
   }
 
@@ -3324,7 +3361,7 @@ void DepsgraphRelationBuilder::build_image(Image *image)
 
 void DepsgraphRelationBuilder::build_cachefile(CacheFile *cache_file)
 {
-  if (built_map_.check_is_built_and_tag(cache_file)) {
+  if (check_is_built_and_tag(cache_file)) {
     return;
   }
 
@@ -3357,7 +3394,7 @@ void DepsgraphRelationBuilder::build_cachefile(CacheFile *cache_file)
 
 void DepsgraphRelationBuilder::build_mask(Mask *mask)
 {
-  if (built_map_.check_is_built_and_tag(mask)) {
+  if (check_is_built_and_tag(mask)) {
     return;
   }
 
@@ -3398,7 +3435,7 @@ void DepsgraphRelationBuilder::build_mask(Mask *mask)
 
 void DepsgraphRelationBuilder::build_freestyle_linestyle(FreestyleLineStyle *linestyle)
 {
-  if (built_map_.check_is_built_and_tag(linestyle)) {
+  if (check_is_built_and_tag(linestyle)) {
     return;
   }
 
@@ -3414,7 +3451,7 @@ void DepsgraphRelationBuilder::build_freestyle_linestyle(FreestyleLineStyle *lin
 
 void DepsgraphRelationBuilder::build_movieclip(MovieClip *clip)
 {
-  if (built_map_.check_is_built_and_tag(clip)) {
+  if (check_is_built_and_tag(clip)) {
     return;
   }
 
@@ -3429,7 +3466,7 @@ void DepsgraphRelationBuilder::build_movieclip(MovieClip *clip)
 
 void DepsgraphRelationBuilder::build_lightprobe(LightProbe *probe)
 {
-  if (built_map_.check_is_built_and_tag(probe)) {
+  if (check_is_built_and_tag(probe)) {
     return;
   }
 
@@ -3443,7 +3480,7 @@ void DepsgraphRelationBuilder::build_lightprobe(LightProbe *probe)
 
 void DepsgraphRelationBuilder::build_speaker(Speaker *speaker)
 {
-  if (built_map_.check_is_built_and_tag(speaker)) {
+  if (check_is_built_and_tag(speaker)) {
     return;
   }
 
@@ -3463,7 +3500,7 @@ void DepsgraphRelationBuilder::build_speaker(Speaker *speaker)
 
 void DepsgraphRelationBuilder::build_sound(bSound *sound)
 {
-  if (built_map_.check_is_built_and_tag(sound)) {
+  if (check_is_built_and_tag(sound)) {
     return;
   }
 
@@ -3550,7 +3587,7 @@ void DepsgraphRelationBuilder::build_scene_sequencer(Scene *scene)
   if (scene->ed == nullptr) {
     return;
   }
-  if (built_map_.check_is_built_and_tag(scene, BuilderMap::TAG_SCENE_SEQUENCER)) {
+  if (check_is_built_and_tag(scene, BuilderMap::TAG_SCENE_SEQUENCER)) {
     return;
   }
 
@@ -3597,7 +3634,7 @@ void DepsgraphRelationBuilder::build_scene_speakers(Scene *scene, ViewLayer *vie
 
 void DepsgraphRelationBuilder::build_vfont(VFont *vfont)
 {
-  if (built_map_.check_is_built_and_tag(vfont)) {
+  if (check_is_built_and_tag(vfont)) {
     return;
   }
 
@@ -3661,6 +3698,8 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
     return;
   }
 
+  const BuilderStack::ScopedEntry stack_entry = stack_.trace(*id_orig);
+
   OperationKey copy_on_write_key(id_orig, NodeType::COPY_ON_EVAL, OperationCode::COPY_ON_EVAL);
   /* XXX: This is a quick hack to make Alt-A to work. */
   // add_relation(time_source_key, copy_on_write_key, "Fluxgate capacitor hack");
@@ -3715,7 +3754,7 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
      * copy of ID. */
     OperationNode *op_entry = comp_node->get_entry_operation();
     if (op_entry != nullptr) {
-      Relation *rel = graph_->add_new_relation(op_cow, op_entry, "Copy-on-Eval Dependency");
+      Relation *rel = add_new_relation(op_cow, op_entry, "Copy-on-Eval Dependency");
       rel->flag |= rel_flag;
     }
     /* All dangling operations should also be executed after copy-on-evaluation. */
@@ -3724,7 +3763,7 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
         continue;
       }
       if (op_node->inlinks.is_empty()) {
-        Relation *rel = graph_->add_new_relation(op_cow, op_node, "Copy-on-Eval Dependency");
+        Relation *rel = add_new_relation(op_cow, op_node, "Copy-on-Eval Dependency");
         rel->flag |= rel_flag;
       }
       else {
@@ -3740,7 +3779,7 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
           }
         }
         if (!has_same_comp_dependency) {
-          Relation *rel = graph_->add_new_relation(op_cow, op_node, "Copy-on-Eval Dependency");
+          Relation *rel = add_new_relation(op_cow, op_node, "Copy-on-Eval Dependency");
           rel->flag |= rel_flag;
         }
       }
@@ -87,6 +87,10 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
 
   void begin_build();
 
+  /* Begin rebuilding relations of the given ID nodes in an already built graph of the scene. All
+   * other IDs of the graph are considered built, so that their relations are kept as-is. */
+  void begin_build_incremental(Scene *scene, const Set<IDNode *> &id_nodes);
+
   template<typename KeyFrom, typename KeyTo>
   Relation *add_relation(const KeyFrom &key_from,
                          const KeyTo &key_to,
@@ -315,6 +319,12 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
                                    const char *description,
                                    int flags = 0);
 
+  /* Add relation to the graph, recording the ID which is currently being built as its owner. */
+  Relation *add_new_relation(Node *node_from,
+                             Node *node_to,
+                             const char *description,
+                             int flags = 0);
+
   template<typename KeyType>
   DepsNodeHandle create_node_handle(const KeyType &key, const char *default_name = "");
 
@@ -345,8 +355,18 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
 
   static void constraint_walk(bConstraint *con, ID **idpoin, bool is_reference, void *user_data);
 
+  /* Same as #BuilderMap::check_is_built_and_tag, additionally records the ID which is currently
+   * being built as a user of the given ID, see #IDNode::builder_users. */
+  bool check_is_built_and_tag(ID *id, int tag = BuilderMap::TAG_COMPLETE);
+  template<typename T>
+  bool check_is_built_and_tag(T *datablock, int tag = BuilderMap::TAG_COMPLETE)
+  {
+    return this->check_is_built_and_tag(&datablock->id, tag);
+  }
+
   /* State which demotes currently built entities. */
   Scene *scene_;
+  bool is_incremental_build_ = false;
 
   BuilderMap built_map_;
   RNANodeQuery rna_node_query_;
@@ -169,6 +169,8 @@ void DepsgraphRelationBuilder::build_driver_relations(IDNode *id_node)
     return;
   }
 
+  const BuilderStack::ScopedEntry stack_entry = stack_.trace(*id_orig);
+
   /* Mapping from RNA prefix -> set of driver descriptors: */
   Map<std::string, Vector<DriverDescriptor>> driver_groups;
 
@@ -49,7 +49,7 @@ void DepsgraphRelationBuilder::build_scene_camera(Scene *scene)
 
 void DepsgraphRelationBuilder::build_scene_parameters(Scene *scene)
 {
-  if (built_map_.check_is_built_and_tag(scene, BuilderMap::TAG_PARAMETERS)) {
+  if (check_is_built_and_tag(scene, BuilderMap::TAG_PARAMETERS)) {
     return;
   }
 
@@ -70,7 +70,7 @@ void DepsgraphRelationBuilder::build_scene_parameters(Scene *scene)
 
 void DepsgraphRelationBuilder::build_scene_compositor(Scene *scene)
 {
-  if (built_map_.check_is_built_and_tag(scene, BuilderMap::TAG_SCENE_COMPOSITOR)) {
+  if (check_is_built_and_tag(scene, BuilderMap::TAG_SCENE_COMPOSITOR)) {
     return;
   }
 
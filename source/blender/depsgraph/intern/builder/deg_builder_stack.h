@@ -118,6 +118,17 @@ class BuilderStack {
 
   void print_backtrace(std::ostream &stream);
 
+  /* The ID which is currently being built: the innermost ID entry of the stack. */
+  const ID *current_id() const
+  {
+    for (int i = stack_.size() - 1; i >= 0; i--) {
+      if (stack_[i].id_ != nullptr) {
+        return stack_[i].id_;
+      }
+    }
+    return nullptr;
+  }
+
   template<class... Args> ScopedEntry trace(const Args &...args)
   {
     stack_.append_as(args...);
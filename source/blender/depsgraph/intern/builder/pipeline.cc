@@ -87,10 +87,7 @@ AbstractBuilderPipeline::AbstractBuilderPipeline(blender::Depsgraph *graph)
 
 void AbstractBuilderPipeline::build()
 {
-  double start_time = 0.0;
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    start_time = BLI_time_now_seconds();
-  }
+  timings_ = {};
 
   build_step_sanity_check();
   build_step_nodes();
@@ -101,9 +98,7 @@ void AbstractBuilderPipeline::build()
     do_sanity_checks(deg_graph_, ids_build_by_node_builder_, ids_build_by_relations_builder_);
   }
 
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    printf("Depsgraph built in %f seconds.\n", BLI_time_now_seconds() - start_time);
-  }
+  deg_graph_->debug.end_graph_build(timings_, false);
 }
 
 void AbstractBuilderPipeline::build_step_sanity_check()
@@ -115,6 +110,8 @@ void AbstractBuilderPipeline::build_step_sanity_check()
 
 void AbstractBuilderPipeline::build_step_nodes()
 {
+  const double start_time = BLI_time_now_seconds();
+
   /* Generate all the nodes in the graph first */
   std::unique_ptr<DepsgraphNodeBuilder> node_builder = construct_node_builder();
   node_builder->begin_build();
@@ -124,10 +121,14 @@ void AbstractBuilderPipeline::build_step_nodes()
   if (need_sanity_checks()) {
     ids_build_by_node_builder_ = node_builder->get_built_ids();
   }
+
+  timings_.nodes = BLI_time_now_seconds() - start_time;
 }
 
 void AbstractBuilderPipeline::build_step_relations()
 {
+  const double start_time = BLI_time_now_seconds();
+
   /* Hook up relationships between operations - to determine evaluation order. */
   std::unique_ptr<DepsgraphRelationBuilder> relation_builder = construct_relation_builder();
   relation_builder->begin_build();
@@ -138,12 +139,20 @@ void AbstractBuilderPipeline::build_step_relations()
   if (need_sanity_checks()) {
     ids_build_by_relations_builder_ = relation_builder->get_built_ids();
   }
+
+  timings_.relations = BLI_time_now_seconds() - start_time;
 }
 
 void AbstractBuilderPipeline::build_step_finalize()
 {
+  const double start_time = BLI_time_now_seconds();
+
   /* Detect and solve cycles. */
   deg_graph_detect_cycles(deg_graph_);
+
+  const double cycles_end_time = BLI_time_now_seconds();
+  timings_.cycles = cycles_end_time - start_time;
+
   /* Simplify the graph by removing redundant relations (to optimize
    * traversal later). */
   /* TODO: it would be useful to have an option to disable this in cases where
@@ -165,6 +174,11 @@ void AbstractBuilderPipeline::build_step_finalize()
 #endif
   /* Relations are up to date. */
   deg_graph_->need_update_relations = false;
+  deg_graph_->need_update_all_relations = false;
+  deg_graph_->relations_update_ids.clear();
+  deg_graph_->is_built_from_view_layer = supports_incremental_update();
+
+  timings_.finalize = BLI_time_now_seconds() - cycles_end_time;
 }
 
 std::unique_ptr<DepsgraphNodeBuilder> AbstractBuilderPipeline::construct_node_builder()
@@ -177,5 +191,10 @@ std::unique_ptr<DepsgraphRelationBuilder> AbstractBuilderPipeline::construct_rel
   return std::make_unique<DepsgraphRelationBuilder>(bmain_, deg_graph_, &builder_cache_);
 }
 
+bool AbstractBuilderPipeline::supports_incremental_update() const
+{
+  return false;
+}
+
 }  // namespace deg
 }  // namespace blender
@@ -10,6 +10,8 @@
 
 #include "deg_builder_cache.h"
 
+#include "intern/debug/deg_debug.h"
+
 #include "BLI_set.hh"
 
 namespace blender {
@@ -50,6 +52,10 @@ class AbstractBuilderPipeline {
   virtual std::unique_ptr<DepsgraphNodeBuilder> construct_node_builder();
   virtual std::unique_ptr<DepsgraphRelationBuilder> construct_relation_builder();
 
+  /* Whether the built graph matches the one built by a relations update, so that later relations
+   * updates are allowed to only rebuild the changed IDs. */
+  virtual bool supports_incremental_update() const;
+
   virtual void build_step_sanity_check();
   void build_step_nodes();
   void build_step_relations();
@@ -60,6 +66,8 @@ class AbstractBuilderPipeline {
 
   Set<const ID *> ids_build_by_node_builder_;
   Set<const ID *> ids_build_by_relations_builder_;
+
+  DepsgraphBuildTimings timings_;
 };
 
 }  // namespace deg
@@ -57,4 +57,10 @@ std::unique_ptr<DepsgraphRelationBuilder> AllObjectsBuilderPipeline::construct_r
   return std::make_unique<AllObjectsRelationBuilder>(bmain_, deg_graph_, &builder_cache_);
 }
 
+bool AllObjectsBuilderPipeline::supports_incremental_update() const
+{
+  /* Relations updates only build the objects of the view layer which are needed. */
+  return false;
+}
+
 }  // namespace blender::deg
@@ -22,6 +22,7 @@ class AllObjectsBuilderPipeline : public ViewLayerBuilderPipeline {
  protected:
   std::unique_ptr<DepsgraphNodeBuilder> construct_node_builder() override;
   std::unique_ptr<DepsgraphRelationBuilder> construct_relation_builder() override;
+  bool supports_incremental_update() const override;
 };
 
 }  // namespace blender::deg
@@ -0,0 +1,385 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "pipeline_incremental.h"
+
+#include <optional>
+
+#include "BLI_time.hh"
+#include "BLI_utildefines.hh"
+
+#include "BKE_collision.h"
+#include "BKE_effect.h"
+#include "BKE_global.hh"
+
+#include "DNA_modifier_types.h"
+#include "DNA_object_force_types.h"
+#include "DNA_object_types.h"
+#include "DNA_particle_types.h"
+
+#include "DEG_depsgraph.hh"
+#include "DEG_depsgraph_debug.hh"
+#include "DEG_depsgraph_physics.hh"
+
+#include "deg_builder.h"
+#include "deg_builder_cycle.h"
+#include "deg_builder_key.h"
+#include "deg_builder_nodes.h"
+#include "deg_builder_relations.h"
+
+#include "intern/depsgraph.hh"
+#include "intern/depsgraph_relation.hh"
+#include "intern/node/deg_node.hh"
+#include "intern/node/deg_node_component.hh"
+#include "intern/node/deg_node_id.hh"
+#include "intern/node/deg_node_operation.hh"
+
+namespace blender::deg {
+
+namespace {
+
+/* Endpoint of a relation between a rebuilt ID and the rest of the graph. */
+struct SavedRelationEndpoint {
+  /* Node which is kept in the graph, nullptr when the endpoint belongs to a rebuilt ID. */
+  Node *node = nullptr;
+  /* Key of the operation of the rebuilt ID. */
+  std::optional<PersistentOperationKey> operation_key;
+  /* Whether the operation was the entry or exit of its component. Allows to re-link relations
+   * which were added to the whole component, even if the operation is gone after rebuild. */
+  bool is_component_entry = false;
+  bool is_component_exit = false;
+};
+
+struct SavedRelation {
+  SavedRelationEndpoint from;
+  SavedRelationEndpoint to;
+  const char *name;
+  int flag;
+  const ID *owner_id;
+};
+
+}  // namespace
+
+static bool is_node_of_id_nodes(const Node *node, const Set<IDNode *> &id_nodes)
+{
+  /* Besides operations, relations only ever start at the time source. */
+  if (node->type != NodeType::OPERATION) {
+    return false;
+  }
+  const OperationNode *op_node = static_cast<const OperationNode *>(node);
+  return id_nodes.contains(op_node->owner->owner);
+}
+
+static SavedRelationEndpoint save_relation_endpoint(Node *node, const Set<IDNode *> &id_nodes)
+{
+  SavedRelationEndpoint endpoint;
+  if (!is_node_of_id_nodes(node, id_nodes)) {
+    endpoint.node = node;
+    return endpoint;
+  }
+  OperationNode *op_node = static_cast<OperationNode *>(node);
+  endpoint.operation_key.emplace(op_node);
+  endpoint.is_component_entry = (op_node->owner->get_entry_operation() == op_node);
+  endpoint.is_component_exit = (op_node->owner->get_exit_operation() == op_node);
+  return endpoint;
+}
+
+static Node *restore_relation_endpoint(const Depsgraph *graph,
+                                       const SavedRelationEndpoint &endpoint)
+{
+  if (endpoint.node != nullptr) {
+    return endpoint.node;
+  }
+  const OperationKey &key = *endpoint.operation_key;
+  const IDNode *id_node = graph->find_id_node(key.id);
+  if (id_node == nullptr) {
+    return nullptr;
+  }
+  ComponentNode *comp_node = id_node->find_component(key.component_type, key.component_name);
+  if (comp_node == nullptr) {
+    return nullptr;
+  }
+  OperationNode *op_node = comp_node->find_operation(key.opcode, key.name, key.name_tag);
+  if (op_node != nullptr) {
+    return op_node;
+  }
+  if (endpoint.is_component_entry) {
+    return comp_node->get_entry_operation();
+  }
+  if (endpoint.is_component_exit) {
+    return comp_node->get_exit_operation();
+  }
+  return nullptr;
+}
+
+static bool is_object_in_physics_relations(const Depsgraph *graph, const Object *object)
+{
+  if (graph->physics_relations_effector != nullptr) {
+    for (ListBaseT<EffectorRelation> *relations : graph->physics_relations_effector->values()) {
+      for (EffectorRelation &relation : *relations) {
+        if (relation.ob == object) {
+          return true;
+        }
+      }
+    }
+  }
+  for (int i = 0; i < DEG_PHYSICS_COLLISION_NUM; i++) {
+    if (graph->physics_relations_collision[i] == nullptr) {
+      continue;
+    }
+    for (ListBaseT<CollisionRelation> *relations : graph->physics_relations_collision[i]->values())
+    {
+      for (CollisionRelation &relation : *relations) {
+        if (relation.ob == object) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+static bool is_effector_settings(const PartDeflect *pd)
+{
+  return pd != nullptr && pd->forcefield != PFIELD_NULL;
+}
+
+/* Check whether nodes and relations of the object are only built by the object itself, and the
+ * object does not affect any state which is shared by the whole graph. */
+static bool object_can_be_rebuilt_in_place(const Object *object)
+{
+  /* Meta-balls of the same family are evaluated together. */
+  if (object->type == OB_MBALL) {
+    return false;
+  }
+  /* Light linking is gathered into a cache of the whole graph. */
+  if (object->light_linking != nullptr) {
+    return false;
+  }
+  /* Rigid body nodes of the object are built by the scene. */
+  if (object->rigidbody_object != nullptr || object->rigidbody_constraint != nullptr) {
+    return false;
+  }
+  /* Effectors and colliders are gathered into the physics relations caches. */
+  if (is_effector_settings(object->pd) || (object->pd != nullptr && object->pd->deflect)) {
+    return false;
+  }
+  for (const ParticleSystem &psys : object->particlesystem) {
+    if (psys.part != nullptr &&
+        (is_effector_settings(psys.part->pd) || is_effector_settings(psys.part->pd2)))
+    {
+      return false;
+    }
+  }
+  for (const ModifierData &md : object->modifiers) {
+    if (ELEM(md.type, eModifierType_Collision, eModifierType_Fluid, eModifierType_DynamicPaint)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+IncrementalBuilderPipeline::IncrementalBuilderPipeline(blender::Depsgraph *graph)
+    : deg_graph_(reinterpret_cast<Depsgraph *>(graph)),
+      bmain_(deg_graph_->bmain),
+      scene_(deg_graph_->scene),
+      view_layer_(deg_graph_->view_layer)
+{
+}
+
+bool IncrementalBuilderPipeline::can_rebuild_in_place()
+{
+  /* Transitive reduction is done on the whole graph. */
+  if (G.debug_value == 799) {
+    return false;
+  }
+  for (ID *id : deg_graph_->relations_update_ids) {
+    IDNode *id_node = deg_graph_->find_id_node(id);
+    if (id_node == nullptr) {
+      /* The ID is not a part of the graph, it can only be pulled in by other rebuilt IDs. */
+      continue;
+    }
+    if (id->id_type() != ID_OB || id_node->linked_state == DEG_ID_LINKED_VIA_SET) {
+      return false;
+    }
+    Object *object = id_cast<Object *>(id);
+    if (!object_can_be_rebuilt_in_place(object) ||
+        is_object_in_physics_relations(deg_graph_, object))
+    {
+      return false;
+    }
+    /* Operations which are added to the object by builders of other IDs would be lost. */
+    for (const ComponentNode *comp_node : id_node->components.values()) {
+      for (const OperationNode *op_node : comp_node->operations) {
+        if (ELEM(op_node->opcode,
+                 OperationCode::ID_PROPERTY,
+                 OperationCode::RIGIDBODY_TRANSFORM_COPY))
+        {
+          return false;
+        }
+      }
+    }
+    objects_.append(object);
+    id_nodes_.add_new(id_node);
+  }
+  return true;
+}
+
+bool IncrementalBuilderPipeline::build()
+{
+  if (!can_rebuild_in_place()) {
+    return false;
+  }
+  if (objects_.is_empty()) {
+    deg_graph_->need_update_relations = false;
+    deg_graph_->relations_update_ids.clear();
+    return true;
+  }
+
+  const double start_time = BLI_time_now_seconds();
+
+  Set<const ID *> ids;
+  for (const Object *object : objects_) {
+    ids.add_new(&object->id);
+  }
+
+  /* Unlink all relations of the rebuilt IDs. Relations added by their builders are re-created by
+   * the relation builder, the rest is stored to be re-linked to the new nodes.
+   *
+   * Cycles are solved from scratch afterwards, so that a relation which is not a part of a cycle
+   * anymore is used again. The relations which are kept are reset in the same pass, the new ones
+   * are created without the flag. */
+  Vector<SavedRelation> saved_relations;
+  Vector<Relation *> unlinked_relations;
+  auto gather_relations = [&](Node *node) {
+    for (Relation *rel : node->outlinks) {
+      const bool is_owned = rel->owner_id != nullptr && ids.contains(rel->owner_id);
+      if (!is_owned && !is_node_of_id_nodes(rel->from, id_nodes_) &&
+          !is_node_of_id_nodes(rel->to, id_nodes_))
+      {
+        rel->flag &= ~RELATION_FLAG_CYCLIC;
+        continue;
+      }
+      unlinked_relations.append(rel);
+      if (is_owned) {
+        continue;
+      }
+      saved_relations.append({save_relation_endpoint(rel->from, id_nodes_),
+                              save_relation_endpoint(rel->to, id_nodes_),
+                              rel->name,
+                              rel->flag & ~RELATION_FLAG_CYCLIC,
+                              rel->owner_id});
+    }
+  };
+  if (deg_graph_->time_source != nullptr) {
+    gather_relations(deg_graph_->time_source);
+  }
+  for (OperationNode *op_node : deg_graph_->operations) {
+    gather_relations(op_node);
+  }
+  for (Relation *rel : unlinked_relations) {
+    rel->unlink();
+  }
+
+  /* Rebuild nodes of the objects. Any ID node which is added is pulled in by them. */
+  const int64_t num_id_nodes = deg_graph_->id_nodes.size();
+  Set<IDNode *> rebuilt_id_nodes = id_nodes_;
+  {
+    DepsgraphNodeBuilder node_builder(bmain_, deg_graph_, &builder_cache_);
+    node_builder.begin_build_incremental(scene_, view_layer_, id_nodes_);
+    for (Object *object : objects_) {
+      node_builder.build_object_incremental(object);
+    }
+    for (IDNode *id_node : deg_graph_->id_nodes.as_span().drop_front(num_id_nodes)) {
+      rebuilt_id_nodes.add_new(id_node);
+    }
+    node_builder.end_build_incremental(rebuilt_id_nodes.size() != id_nodes_.size());
+  }
+
+  /* Revoke everything the rebuilt IDs requested from the other IDs when they were built the last
+   * time, their relation builders request it again. This is done after the node builder stored the
+   * previous flags and masks, so that the changes are detected on finalize. */
+  Vector<IDNode *> maybe_unused_id_nodes;
+  for (IDNode *id_node : deg_graph_->id_nodes) {
+    id_node->remove_eval_requests(ids);
+    if (id_node->builder_users.is_empty()) {
+      continue;
+    }
+    for (const ID *id : ids) {
+      id_node->builder_users.remove(id);
+    }
+    if (id_node->builder_users.is_empty()) {
+      maybe_unused_id_nodes.append(id_node);
+    }
+  }
+  for (IDNode *id_node : deg_graph_->id_nodes.as_span().drop_front(num_id_nodes)) {
+    maybe_unused_id_nodes.append(id_node);
+  }
+
+  const double nodes_end_time = BLI_time_now_seconds();
+  timings_.nodes = nodes_end_time - start_time;
+
+  for (const SavedRelation &saved_relation : saved_relations) {
+    Node *node_from = restore_relation_endpoint(deg_graph_, saved_relation.from);
+    Node *node_to = restore_relation_endpoint(deg_graph_, saved_relation.to);
+    if (node_from == nullptr || node_to == nullptr) {
+      /* Operation does not exist anymore, same as a full build would not add the relation. */
+      continue;
+    }
+    Relation *rel = deg_graph_->add_new_relation(
+        node_from, node_to, saved_relation.name, saved_relation.flag);
+    rel->owner_id = saved_relation.owner_id;
+  }
+  {
+    DepsgraphRelationBuilder relation_builder(bmain_, deg_graph_, &builder_cache_);
+    relation_builder.begin_build_incremental(scene_, rebuilt_id_nodes);
+    for (Object *object : objects_) {
+      relation_builder.build_object(object);
+    }
+    for (IDNode *id_node : rebuilt_id_nodes) {
+      relation_builder.build_id(id_node->id_orig);
+    }
+    for (IDNode *id_node : rebuilt_id_nodes) {
+      relation_builder.build_copy_on_write_relations(id_node);
+      relation_builder.build_driver_relations(id_node);
+    }
+  }
+
+  /* IDs which are not used by any ID anymore are not a part of a fully built graph. Removing them
+   * from the graph is not supported, so fall back to a full build. */
+  for (const IDNode *id_node : maybe_unused_id_nodes) {
+    if (id_node->builder_users.is_empty()) {
+      DEG_DEBUG_PRINTF(reinterpret_cast<blender::Depsgraph *>(deg_graph_),
+                       BUILD,
+                       "%s: %s is not used anymore.\n",
+                       __func__,
+                       id_node->id_orig->name);
+      return false;
+    }
+  }
+
+  const double relations_end_time = BLI_time_now_seconds();
+  timings_.relations = relations_end_time - nodes_end_time;
+
+  deg_graph_detect_cycles(deg_graph_);
+
+  const double cycles_end_time = BLI_time_now_seconds();
+  timings_.cycles = cycles_end_time - relations_end_time;
+
+  deg_graph_build_finalize_incremental(bmain_, deg_graph_, rebuilt_id_nodes);
+  DEG_graph_tag_on_visible_update(reinterpret_cast<blender::Depsgraph *>(deg_graph_), false);
+  deg_graph_->need_update_relations = false;
+  deg_graph_->relations_update_ids.clear();
+
+  timings_.finalize = BLI_time_now_seconds() - cycles_end_time;
+
+  deg_graph_->debug.end_graph_build(timings_, true);
+  return true;
+}
+
+}  // namespace blender::deg
@@ -0,0 +1,74 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include "deg_builder_cache.h"
+
+#include "intern/debug/deg_debug.h"
+
+#include "BLI_set.hh"
+#include "BLI_vector.hh"
+
+namespace blender {
+
+struct Depsgraph;
+struct Main;
+struct Object;
+struct Scene;
+struct ViewLayer;
+
+namespace deg {
+
+struct Depsgraph;
+struct IDNode;
+
+/* Pipeline which updates relations of a graph built by #ViewLayerBuilderPipeline in place, only
+ * rebuilding the IDs which were tagged with #DEG_id_relations_tag_update.
+ *
+ * It runs through the following steps:
+ * - check that all tagged IDs can be rebuilt separately from the rest of the graph
+ * - store and unlink relations between the tagged IDs and the rest of the graph
+ * - rebuild nodes of the tagged IDs, keeping all other nodes
+ * - re-link the stored relations and rebuild relations of the tagged IDs
+ * - check that no ID was left unused by the tagged IDs
+ * - finalize
+ *
+ * Nodes and relations of all other IDs are kept as-is. Relations are owned by the ID which was
+ * being built when they were added (see #Relation::owner_id), so the relations of the tagged IDs
+ * are rebuilt by their builders, and the relations which other IDs have with them are re-linked
+ * to the new nodes. The same goes for the special evaluation flags and custom data masks the
+ * tagged IDs requested from other IDs (see #IDNode::eval_requests). */
+class IncrementalBuilderPipeline {
+ public:
+  IncrementalBuilderPipeline(blender::Depsgraph *graph);
+
+  /* Returns false when the tagged IDs can not be rebuilt in place, in which case the graph is to
+   * be fully rebuilt. This is mostly known upfront, without modifying the graph. Only IDs which
+   * are not used anymore after the rebuild are detected afterwards, as they can not be removed
+   * from the graph in place. */
+  bool build();
+
+ protected:
+  Depsgraph *deg_graph_;
+  Main *bmain_;
+  Scene *scene_;
+  ViewLayer *view_layer_;
+  DepsgraphBuilderCache builder_cache_;
+
+  /* Objects whose nodes and relations are rebuilt, and their ID nodes. */
+  Vector<Object *> objects_;
+  Set<IDNode *> id_nodes_;
+
+  DepsgraphBuildTimings timings_;
+
+  bool can_rebuild_in_place();
+};
+
+}  // namespace deg
+}  // namespace blender
@@ -24,4 +24,9 @@ void ViewLayerBuilderPipeline::build_relations(DepsgraphRelationBuilder &relatio
   relation_builder.build_view_layer(scene_, view_layer_, DEG_ID_LINKED_DIRECTLY);
 }
 
+bool ViewLayerBuilderPipeline::supports_incremental_update() const
+{
+  return true;
+}
+
 }  // namespace blender::deg
@@ -19,6 +19,7 @@ class ViewLayerBuilderPipeline : public AbstractBuilderPipeline {
  protected:
   void build_nodes(DepsgraphNodeBuilder &node_builder) override;
   void build_relations(DepsgraphRelationBuilder &relation_builder) override;
+  bool supports_incremental_update() const override;
 };
 
 }  // namespace blender::deg
@@ -53,6 +53,34 @@ double DepsgraphDebug::total_evaluation_time() const
   return graph_evaluation_total_time_;
 }
 
+void DepsgraphDebug::end_graph_build(const DepsgraphBuildTimings &timings,
+                                     const bool is_incremental)
+{
+  last_build_timings = timings;
+  total_build_timings += timings;
+  if (is_incremental) {
+    num_incremental_builds++;
+  }
+  else {
+    num_full_builds++;
+  }
+
+  if ((G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) == 0) {
+    return;
+  }
+
+  printf("Depsgraph%s%s%s %s in %f seconds (nodes %f, relations %f, cycles %f, finalize %f).\n",
+         name.empty() ? "" : " [",
+         name.c_str(),
+         name.empty() ? "" : "]",
+         is_incremental ? "incrementally rebuilt" : "built",
+         timings.total(),
+         timings.nodes,
+         timings.relations,
+         timings.cycles,
+         timings.finalize);
+}
+
 bool terminal_do_color()
 {
   return (G.debug & G_DEBUG_DEPSGRAPH_PRETTY) != 0;
@@ -14,6 +14,32 @@
 
 namespace blender::deg {
 
+/* Time spent in the phases of a dependency graph build, in seconds. */
+struct DepsgraphBuildTimings {
+  /* Creation of ID, component and operation nodes. */
+  double nodes = 0.0;
+  /* Creation of relations between operations, including copy-on-evaluation and drivers. */
+  double relations = 0.0;
+  /* Detection and solving of dependency cycles. */
+  double cycles = 0.0;
+  /* Visibility flush, removal of unused no-op nodes and re-tagging of IDs. */
+  double finalize = 0.0;
+
+  double total() const
+  {
+    return nodes + relations + cycles + finalize;
+  }
+
+  DepsgraphBuildTimings &operator+=(const DepsgraphBuildTimings &other)
+  {
+    nodes += other.nodes;
+    relations += other.relations;
+    cycles += other.cycles;
+    finalize += other.finalize;
+    return *this;
+  }
+};
+
 class DepsgraphDebug {
  public:
   DepsgraphDebug();
@@ -25,6 +51,16 @@ class DepsgraphDebug {
 
   double total_evaluation_time() const;
 
+  /* Store timings of a finished build of the graph relations, and print them when build or time
+   * debugging is enabled. */
+  void end_graph_build(const DepsgraphBuildTimings &timings, bool is_incremental);
+
+  /* Timings of the last build, and accumulated over all builds of this graph. */
+  DepsgraphBuildTimings last_build_timings;
+  DepsgraphBuildTimings total_build_timings;
+  int num_full_builds = 0;
+  int num_incremental_builds = 0;
+
   /* NOTE: Corresponds to G_DEBUG_DEPSGRAPH_* flags. */
   int flags;
 
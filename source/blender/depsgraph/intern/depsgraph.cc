@@ -43,6 +43,8 @@ Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluati
     : time_source(nullptr),
       has_animated_visibility(false),
       need_update_relations(true),
+      need_update_all_relations(true),
+      is_built_from_view_layer(false),
       need_update_nodes_visibility(true),
       need_tag_id_on_graph_visibility_update(true),
       need_tag_id_on_graph_visibility_time_update(false),
@@ -106,6 +106,15 @@ struct Depsgraph {
 
   /* Indicates whether relations needs to be updated. */
   bool need_update_relations;
+  /* Indicates that the relations update can not be limited to the IDs in
+   * #relations_update_ids, for example because the set of bases changed. */
+  bool need_update_all_relations;
+  /* IDs whose nodes and relations are to be rebuilt on the next relations update, when only
+   * specific IDs were tagged for a relations update. */
+  Set<ID *> relations_update_ids;
+  /* The graph was built from its view layer, the same way a relations update rebuilds it. Only
+   * such graphs can be updated incrementally. */
+  bool is_built_from_view_layer;
 
   /* Indicates whether indirect effect of nodes on a directly visible ones needs to be updated. */
   bool need_update_nodes_visibility;
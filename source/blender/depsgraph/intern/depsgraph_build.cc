@@ -34,6 +34,7 @@
 #include "builder/pipeline_compositor.h"
 #include "builder/pipeline_from_collection.h"
 #include "builder/pipeline_from_ids.h"
+#include "builder/pipeline_incremental.h"
 #include "builder/pipeline_render.h"
 #include "builder/pipeline_view_layer.h"
 
@@ -316,12 +317,8 @@ void DEG_graph_build_from_collection(Depsgraph *graph, Collection *collection)
   builder.build();
 }
 
-void DEG_graph_tag_relations_update(Depsgraph *graph)
+static void graph_tag_scene_bases_update(deg::Depsgraph *deg_graph)
 {
-  DEG_DEBUG_PRINTF(graph, TAG, "%s: Tagging relations for update.\n", __func__);
-  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
-  deg_graph->need_update_relations = true;
-
   /* NOTE: When relations are updated, it's quite possible that we've got new bases in the scene.
    * This means, we need to re-create flat array of bases in view layer. */
   /* TODO(sergey): It is expected that bases manipulation tags scene for update to tag bases array
@@ -337,6 +334,16 @@ void DEG_graph_tag_relations_update(Depsgraph *graph)
   }
 }
 
+void DEG_graph_tag_relations_update(Depsgraph *graph)
+{
+  DEG_DEBUG_PRINTF(graph, TAG, "%s: Tagging relations for update.\n", __func__);
+  deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
+  deg_graph->need_update_relations = true;
+  deg_graph->need_update_all_relations = true;
+
+  graph_tag_scene_bases_update(deg_graph);
+}
+
 void DEG_graph_relations_update(Depsgraph *graph)
 {
   deg::Depsgraph *deg_graph = reinterpret_cast<deg::Depsgraph *>(graph);
@@ -344,6 +351,19 @@ void DEG_graph_relations_update(Depsgraph *graph)
     /* Graph is up to date, nothing to do. */
     return;
   }
+  if (!deg_graph->need_update_all_relations && deg_graph->is_built_from_view_layer) {
+    deg::IncrementalBuilderPipeline builder(graph);
+    if (builder.build()) {
+      if (G.debug & G_DEBUG_DEPSGRAPH_BUILD) {
+        DEG_debug_graph_relations_validate(
+            graph, deg_graph->bmain, deg_graph->scene, deg_graph->view_layer);
+      }
+      return;
+    }
+    DEG_DEBUG_PRINTF(
+        graph, BUILD, "%s: Tagged IDs can not be rebuilt in place, rebuilding graph.\n", __func__);
+    graph_tag_scene_bases_update(deg_graph);
+  }
   DEG_graph_build_from_view_layer(graph);
 }
 
@@ -355,4 +375,13 @@ void DEG_relations_tag_update(Main *bmain)
   }
 }
 
+void DEG_id_relations_tag_update(Main *bmain, ID *id)
+{
+  DEG_GLOBAL_DEBUG_PRINTF(TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  for (deg::Depsgraph *depsgraph : deg::get_all_registered_graphs(bmain)) {
+    depsgraph->need_update_relations = true;
+    depsgraph->relations_update_ids.add(id);
+  }
+}
+
 }  // namespace blender
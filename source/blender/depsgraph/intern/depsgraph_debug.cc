@@ -22,9 +22,11 @@
 #include "intern/depsgraph_relation.hh"
 #include "intern/node/deg_node_component.hh"
 #include "intern/node/deg_node_id.hh"
+#include "intern/node/deg_node_operation.hh"
 #include "intern/node/deg_node_time.hh"
 
 #include "BLI_math_bits.hh"
+#include "BLI_set.hh"
 
 namespace blender {
 
@@ -52,6 +54,63 @@ const char *DEG_debug_name_get(Depsgraph *depsgraph)
   return deg_graph->debug.name.c_str();
 }
 
+static std::string debug_node_identifier(const deg::Node *node)
+{
+  if (node->type == deg::NodeType::OPERATION) {
+    return static_cast<const deg::OperationNode *>(node)->full_identifier();
+  }
+  return node->identifier();
+}
+
+static void debug_graph_collect(const deg::Depsgraph *graph,
+                                Set<std::string> &r_operations,
+                                Set<std::string> &r_relations,
+                                Set<std::string> &r_id_states)
+{
+  for (const deg::IDNode *id_node : graph->id_nodes) {
+    const deg::DEGCustomDataMeshMasks &masks = id_node->customdata_masks;
+    r_id_states.add(std::string(id_node->id_orig->name) + ": eval flags " +
+                    std::to_string(id_node->eval_flags) + ", custom data masks " +
+                    std::to_string(masks.vert_mask) + " " + std::to_string(masks.edge_mask) +
+                    " " + std::to_string(masks.face_mask) + " " +
+                    std::to_string(masks.loop_mask) + " " + std::to_string(masks.poly_mask));
+  }
+
+  auto add_relations = [&](const deg::Node *node) {
+    for (const deg::Relation *rel : node->outlinks) {
+      r_relations.add(debug_node_identifier(rel->from) + " -> " +
+                      debug_node_identifier(rel->to) + " (" + rel->name + ")");
+    }
+  };
+  if (graph->time_source != nullptr) {
+    add_relations(graph->time_source);
+  }
+  for (const deg::OperationNode *op_node : graph->operations) {
+    r_operations.add(op_node->full_identifier());
+    add_relations(op_node);
+  }
+}
+
+static bool debug_compare_sets(const char *what,
+                               const Set<std::string> &set1,
+                               const Set<std::string> &set2)
+{
+  bool is_equal = true;
+  for (const std::string &str : set1) {
+    if (!set2.contains(str)) {
+      fprintf(stderr, "Depsgraph comparison: %s only in first graph: %s\n", what, str.c_str());
+      is_equal = false;
+    }
+  }
+  for (const std::string &str : set2) {
+    if (!set1.contains(str)) {
+      fprintf(stderr, "Depsgraph comparison: %s only in second graph: %s\n", what, str.c_str());
+      is_equal = false;
+    }
+  }
+  return is_equal;
+}
+
 bool DEG_debug_compare(const Depsgraph *graph1, const Depsgraph *graph2)
 {
   BLI_assert(graph1 != nullptr);
@@ -59,15 +118,22 @@ bool DEG_debug_compare(const Depsgraph *graph1, const Depsgraph *graph2)
   const deg::Depsgraph *deg_graph1 = reinterpret_cast<const deg::Depsgraph *>(graph1);
   const deg::Depsgraph *deg_graph2 = reinterpret_cast<const deg::Depsgraph *>(graph2);
   if (deg_graph1->operations.size() != deg_graph2->operations.size()) {
-    return false;
+    fprintf(stderr,
+            "Depsgraph comparison: %d vs. %d operations\n",
+            int(deg_graph1->operations.size()),
+            int(deg_graph2->operations.size()));
   }
-  /* TODO(sergey): Currently we only do real stupid check,
-   * which is fast but which isn't 100% reliable.
-   *
-   * Would be cool to make it more robust, but it's good enough
-   * for now. Also, proper graph check is actually NP-complex
-   * problem. */
-  return true;
+  /* NOTE: Nodes are compared by their identifiers, which is enough to tell graphs built from the
+   * same data apart, without solving the general (NP-complete) graph comparison problem. */
+  Set<std::string> operations1, operations2;
+  Set<std::string> relations1, relations2;
+  Set<std::string> id_states1, id_states2;
+  debug_graph_collect(deg_graph1, operations1, relations1, id_states1);
+  debug_graph_collect(deg_graph2, operations2, relations2, id_states2);
+  const bool operations_equal = debug_compare_sets("operation", operations1, operations2);
+  const bool relations_equal = debug_compare_sets("relation", relations1, relations2);
+  const bool id_states_equal = debug_compare_sets("ID state", id_states1, id_states2);
+  return operations_equal && relations_equal && id_states_equal;
 }
 
 bool DEG_debug_graph_relations_validate(Depsgraph *graph,
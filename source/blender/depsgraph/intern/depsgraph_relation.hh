@@ -8,7 +8,11 @@
 
 #pragma once
 
-namespace blender::deg {
+namespace blender {
+
+struct ID;
+
+namespace deg {
 
 struct Node;
 
@@ -46,6 +50,11 @@ struct Relation {
   /* relationship attributes */
   const char *name; /* label for debugging */
   int flag = 0;     /* Bitmask of RelationFlag. */
+
+  /* ID whose builder added this relation, nullptr when it was added outside of any ID builder.
+   * Allows to rebuild only the relations of the IDs which changed. */
+  const ID *owner_id = nullptr;
 };
 
-}  // namespace blender::deg
+}  // namespace deg
+}  // namespace blender
@@ -8,6 +8,7 @@
  * Evaluation engine entry-points for Depsgraph Engine.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 
@@ -17,12 +18,14 @@
 #include "BLI_gsqueue.hh"
 #include "BLI_task_c.hh"
 #include "BLI_time.hh"
+#include "BLI_vector.hh"
 
 #include "BKE_global.hh"
 
 #include "DNA_modifier_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
 
 #include "DEG_depsgraph.hh"
 #include "DEG_depsgraph_query.hh"
@@ -77,14 +80,35 @@ enum class EvaluationStage {
   SINGLE_THREADED_WORKAROUND,
 };
 
+/* Operations which were never measured are assumed to take this long, so that the length of a
+ * chain of operations still counts towards its priority. */
+constexpr float operation_cost_default = 1e-6f;
+/* Weight of the latest measurement in the running cost estimate of an operation. */
+constexpr float operation_cost_smoothing = 0.25f;
+
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
+  /* Evaluate the operations with the longest critical path first, instead of in the order in
+   * which they became ready. Requires measuring the time of every operation, so this is only done
+   * when enabled in the experimental preferences. */
+  bool do_priority_scheduling;
   EvaluationStage stage;
   bool need_update_pending_parents = true;
   bool need_single_thread_pass = false;
 };
 
+void update_operation_cost(OperationNode *operation_node, const float time)
+{
+  if (operation_node->cost_estimate < 0.0f) {
+    operation_node->cost_estimate = time;
+  }
+  else {
+    operation_node->cost_estimate += operation_cost_smoothing *
+                                     (time - operation_node->cost_estimate);
+  }
+}
+
 void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
 {
   blender::Depsgraph *depsgraph = reinterpret_cast<blender::Depsgraph *>(state->graph);
@@ -92,10 +116,16 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
   /* Perform operation. */
-  if (state->do_stats) {
+  if (state->do_stats || state->do_priority_scheduling) {
     const double start_time = BLI_time_now_seconds();
     operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += BLI_time_now_seconds() - start_time;
+    const double time = BLI_time_now_seconds() - start_time;
+    if (state->do_stats) {
+      operation_node->stats.current_time += time;
+    }
+    if (state->do_priority_scheduling) {
+      update_operation_cost(operation_node, float(time));
+    }
   }
   else {
     operation_node->evaluate(depsgraph);
@@ -113,14 +143,42 @@ void deg_task_run_func(TaskPool *pool, void *taskdata)
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = static_cast<DepsgraphEvalState *>(userdata_v);
 
-  /* Evaluate node. */
   OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
-  evaluate_node(state, operation_node);
 
-  /* Schedule children. */
-  schedule_children(state, operation_node, [&](OperationNode *node) {
-    BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
-  });
+  if (!state->do_priority_scheduling) {
+    /* Evaluate node. */
+    evaluate_node(state, operation_node);
+
+    /* Schedule children. */
+    schedule_children(state, operation_node, [&](OperationNode *node) {
+      BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
+    });
+    return;
+  }
+
+  /* Continue with the ready child which has the longest critical path in this task, so that the
+   * most expensive chain of operations is evaluated without waiting for other tasks. The other
+   * ready children are pushed to the pool. This needs no synchronization between tasks. */
+  Vector<OperationNode *, 16> ready_children;
+  while (operation_node != nullptr) {
+    evaluate_node(state, operation_node);
+
+    ready_children.clear();
+    schedule_children(
+        state, operation_node, [&](OperationNode *node) { ready_children.append(node); });
+
+    operation_node = nullptr;
+    for (OperationNode *child : ready_children) {
+      if (operation_node == nullptr || child->priority > operation_node->priority) {
+        operation_node = child;
+      }
+    }
+    for (OperationNode *child : ready_children) {
+      if (child != operation_node) {
+        BLI_task_pool_push(pool, deg_task_run_func, child, false, nullptr);
+      }
+    }
+  }
 }
 
 bool check_operation_node_visible(const DepsgraphEvalState *state, OperationNode *op_node)
@@ -196,6 +254,60 @@ void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
   }
 }
 
+bool is_operation_pending(const DepsgraphEvalState *state, Node *node)
+{
+  if (node->type != NodeType::OPERATION) {
+    return false;
+  }
+  OperationNode *op_node = static_cast<OperationNode *>(node);
+  if ((op_node->flag & DEPSOP_FLAG_NEEDS_UPDATE) == 0) {
+    return false;
+  }
+  return check_operation_node_visible(state, op_node);
+}
+
+/* Calculate the critical path length of every operation which is yet to be evaluated, based on the
+ * measured costs of the operations. Operations are visited from the sinks of the graph towards its
+ * sources, using custom_flags to count children which were not visited yet. */
+void calculate_operation_priorities(DepsgraphEvalState *state)
+{
+  Vector<OperationNode *> stack;
+  for (OperationNode *node : state->graph->operations) {
+    node->priority = 0.0f;
+    node->custom_flags = 0;
+    if (!is_operation_pending(state, node)) {
+      continue;
+    }
+    for (const Relation *rel : node->outlinks) {
+      if ((rel->flag & RELATION_FLAG_CYCLIC) == 0 && is_operation_pending(state, rel->to)) {
+        node->custom_flags++;
+      }
+    }
+    if (node->custom_flags == 0) {
+      stack.append(node);
+    }
+  }
+
+  while (!stack.is_empty()) {
+    OperationNode *node = stack.pop_last();
+    /* At this point the priority holds the longest path among the children. */
+    if (!node->is_noop()) {
+      node->priority += node->cost_estimate < 0.0f ? operation_cost_default :
+                                                     node->cost_estimate;
+    }
+    for (Relation *rel : node->inlinks) {
+      if ((rel->flag & RELATION_FLAG_CYCLIC) != 0 || !is_operation_pending(state, rel->from)) {
+        continue;
+      }
+      OperationNode *parent = static_cast<OperationNode *>(rel->from);
+      parent->priority = std::max(parent->priority, node->priority);
+      if (--parent->custom_flags == 0) {
+        stack.append(parent);
+      }
+    }
+  }
+}
+
 bool is_metaball_object_operation(const OperationNode *operation_node)
 {
   const ComponentNode *component_node = operation_node->owner;
@@ -355,9 +467,27 @@ void evaluate_graph_threaded_stage(DepsgraphEvalState *state,
 
   calculate_pending_parents_if_needed(state);
 
-  schedule_graph(state, [&](OperationNode *node) {
+  if (!state->do_priority_scheduling) {
+    schedule_graph(state, [&](OperationNode *node) {
+      BLI_task_pool_push(task_pool, deg_task_run_func, node, false, nullptr);
+    });
+    BLI_task_pool_work_and_wait(task_pool);
+    return;
+  }
+
+  /* Priorities depend on the operations which are pending in this stage. */
+  calculate_operation_priorities(state);
+
+  /* Push the operations which are ready first in the order of their priority. */
+  Vector<OperationNode *> ready_nodes;
+  schedule_graph(state, [&](OperationNode *node) { ready_nodes.append(node); });
+  std::stable_sort(
+      ready_nodes.begin(), ready_nodes.end(), [](const OperationNode *a, const OperationNode *b) {
+        return a->priority > b->priority;
+      });
+  for (OperationNode *node : ready_nodes) {
     BLI_task_pool_push(task_pool, deg_task_run_func, node, false, nullptr);
-  });
+  }
   BLI_task_pool_work_and_wait(task_pool);
 }
 
@@ -449,6 +579,9 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  /* There is nothing to prioritize without threads. */
+  state.do_priority_scheduling = USER_EXPERIMENTAL_TEST(&U, use_depsgraph_priority_scheduling) &&
+                                 (G.debug & G_DEBUG_DEPSGRAPH_NO_THREADS) == 0;
 
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
@@ -135,8 +135,15 @@ OperationNode *ComponentNode::add_operation(const DepsEvalOperationCb &op,
     op_node = static_cast<OperationNode *>(factory->create_node(this->owner->id_orig, "", name));
 
     /* register opnode in this component's operation set */
-    OperationIDKey key(opcode, op_node->name, name_tag);
-    operations_map->add(key, op_node);
+    if (operations_map != nullptr) {
+      OperationIDKey key(opcode, op_node->name, name_tag);
+      operations_map->add(key, op_node);
+    }
+    else {
+      /* Component of an ID which was kept from the previous build when only some of the IDs are
+       * rebuilt on relations update. */
+      operations.append(op_node);
+    }
 
     /* Set back-link. */
     op_node->owner = this;
@@ -245,6 +252,10 @@ OperationNode *ComponentNode::get_exit_operation()
 
 void ComponentNode::finalize_build(Depsgraph * /*graph*/)
 {
+  if (operations_map == nullptr) {
+    /* Already finalized by a previous build. */
+    return;
+  }
   operations.reserve(operations_map->size());
   for (OperationNode *op_node : operations_map->values()) {
     operations.append(op_node);
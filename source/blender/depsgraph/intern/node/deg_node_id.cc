@@ -46,6 +46,8 @@ void IDNode::init(const ID *id, const char * /*subdata*/)
   previous_eval_flags = 0;
   customdata_masks = DEGCustomDataMeshMasks();
   previous_customdata_masks = DEGCustomDataMeshMasks();
+  eval_requests.clear();
+  builder_users.clear();
   linked_state = DEG_ID_LINKED_INDIRECTLY;
   is_visible_on_build = true;
   is_enabled_on_eval = true;
@@ -164,6 +166,40 @@ void IDNode::tag_update(Depsgraph *graph, eUpdateSource source)
   }
 }
 
+void IDNode::add_eval_request(const ID *requester_id,
+                              const uint32_t flags,
+                              const DEGCustomDataMeshMasks &masks)
+{
+  eval_flags |= flags;
+  customdata_masks |= masks;
+  /* Requests of the same ID usually come in a row, so search from the back. */
+  for (int64_t i = eval_requests.size() - 1; i >= 0; i--) {
+    EvalRequest &request = eval_requests[i];
+    if (request.requester_id == requester_id) {
+      request.eval_flags |= flags;
+      request.customdata_masks |= masks;
+      return;
+    }
+  }
+  eval_requests.append({requester_id, flags, masks});
+}
+
+void IDNode::remove_eval_requests(const Set<const ID *> &requester_ids)
+{
+  const int64_t removed_num = eval_requests.remove_if([&](const EvalRequest &request) {
+    return requester_ids.contains(request.requester_id);
+  });
+  if (removed_num == 0) {
+    return;
+  }
+  eval_flags = 0;
+  customdata_masks = DEGCustomDataMeshMasks();
+  for (const EvalRequest &request : eval_requests) {
+    eval_flags |= request.eval_flags;
+    customdata_masks |= request.customdata_masks;
+  }
+}
+
 void IDNode::finalize_build(Depsgraph *graph)
 {
   /* Finalize build of all components. */
@@ -13,8 +13,10 @@
 #include "DNA_ID.h"
 
 #include "BLI_map.hh"
+#include "BLI_set.hh"
 #include "BLI_string_ref.hh"
 #include "BLI_sys_types.hh"
+#include "BLI_vector.hh"
 
 namespace blender::deg {
 
@@ -66,6 +68,14 @@ struct IDNode : public Node {
 
   IDComponentsMask get_visible_components_mask() const;
 
+  /* Request special evaluation flags and custom data masks on behalf of the builder of the
+   * requester ID, nullptr when requested outside of any ID builder. */
+  void add_eval_request(const ID *requester_id,
+                        uint32_t flags,
+                        const DEGCustomDataMeshMasks &masks);
+  /* Revoke requests of the given IDs, recomputing the accumulated flags and masks. */
+  void remove_eval_requests(const Set<const ID *> &requester_ids);
+
   /* Type of the ID stored separately, so it's possible to perform check whether evaluated copy is
    * needed without de-referencing the id_cow (which is not safe when ID is NOT covered by
    * copy-on-evaluation and has been deleted from the main database.) */
@@ -97,6 +107,20 @@ struct IDNode : public Node {
   DEGCustomDataMeshMasks customdata_masks;
   DEGCustomDataMeshMasks previous_customdata_masks;
 
+  /* Requests which were accumulated into the flags and masks above, so that the requests of an ID
+   * can be revoked when its relations are rebuilt in place. */
+  struct EvalRequest {
+    const ID *requester_id;
+    uint32_t eval_flags;
+    DEGCustomDataMeshMasks customdata_masks;
+  };
+  Vector<EvalRequest, 0> eval_requests;
+
+  /* IDs whose relation builders pulled this ID into the graph, nullptr when it was pulled in
+   * outside of any ID builder (for example, directly by the view layer). An ID without users is
+   * not a part of the graph anymore after the relations of its users are rebuilt in place. */
+  Set<const ID *> builder_users;
+
   eDepsNode_LinkedState_Type linked_state;
 
   /* Indicates the data-block is to be considered visible in the evaluated scene.
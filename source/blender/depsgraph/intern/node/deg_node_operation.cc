@@ -213,7 +213,7 @@ const char *operationCodeAsString(OperationCode opcode)
   return "UNKNOWN";
 }
 
-OperationNode::OperationNode() : name_tag(-1), flag(0) {}
+OperationNode::OperationNode() : cost_estimate(-1.0f), priority(0.0f), name_tag(-1), flag(0) {}
 
 std::string OperationNode::identifier() const
 {
@@ -294,6 +294,14 @@ struct OperationNode : public Node {
   uint32_t num_links_pending;
   bool scheduled;
 
+  /* Running estimate of the evaluation time of this operation in seconds, negative when it was
+   * never measured. Kept across evaluations and used to prioritize scheduling. */
+  float cost_estimate;
+  /* Length of the critical path starting at this operation: its own cost plus the most expensive
+   * chain of operations which are waiting for it. Operations with the highest priority are
+   * dispatched first. */
+  float priority;
+
   /* Identifier for the operation being performed. */
   OperationCode opcode;
   int name_tag;
@@ -316,6 +316,7 @@ class Context : public compositor::Context {
   {
     switch (get_scene().r.compositor_precision) {
       case SCE_COMPOSITOR_PRECISION_AUTO:
+      case SCE_COMPOSITOR_PRECISION_HALF:
         return compositor::ResultPrecision::Half;
       case SCE_COMPOSITOR_PRECISION_FULL:
         return compositor::ResultPrecision::Full;
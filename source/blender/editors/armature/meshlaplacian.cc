@@ -1593,7 +1593,15 @@ static void harmonic_coordinates_bind(MeshDeformModifierData *mmd, MeshDeformBin
   mdb->totalphi = MEM_new_array_zeroed<float>(mdb->size3, "MeshDeformBindTotalPhi");
   mdb->boundisect = MEM_new_array_zeroed<MDefBoundIsect *[6]>(mdb->size3, "MDefBoundIsect");
   mdb->semibound = MEM_new_array_zeroed<int>(mdb->size3, "MDefSemiBound");
-  mdb->bvhdata = mdb->cagemesh->bvh_corner_tris();
+  /* The cage tree is only used for the many ray-casts of the binding, which are faster with a
+   * tree built using the surface area heuristic. */
+  mdb->bvhdata = bke::bvhtree_from_mesh_corner_tris_ex(mdb->cagemesh->vert_positions(),
+                                                       mdb->cagemesh->faces(),
+                                                       mdb->cagemesh->corner_verts(),
+                                                       mdb->cagemesh->corner_tris(),
+                                                       IndexMask(mdb->cagemesh->faces_num),
+                                                       true,
+                                                       true);
   mdb->bvhtree = mdb->bvhdata.tree;
   mdb->inside = MEM_new_array_zeroed<int>(mdb->verts_num, "MDefInside");
 
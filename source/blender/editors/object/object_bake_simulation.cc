@@ -329,6 +329,11 @@ static void bake_geometry_nodes_startjob(void *customdata, wmJobWorkerStatus *wo
       }
 
       int64_t &written_size = size_by_bake.lookup_or_add(&request, 0);
+      const NodesModifierBake *node_bake = nmd.find_bake(request.bake_id);
+      const bool use_compression = node_bake && node_bake->flag & NODES_MODIFIER_BAKE_COMPRESS;
+      const bake::BlobCompression compression = use_compression ?
+                                                    bake::BlobCompression::ZstdFiltered :
+                                                    bake::BlobCompression::None;
 
       if (request.path.has_value()) {
         char meta_path[FILE_MAX];
@@ -338,6 +343,7 @@ static void bake_geometry_nodes_startjob(void *customdata, wmJobWorkerStatus *wo
                       (frame_file_name + ".json").c_str());
         BLI_file_ensure_parent_dir_exists(meta_path);
         bake::DiskBlobWriter blob_writer{request.path->blobs_dir, frame_file_name};
+        blob_writer.set_compression(compression);
         fstream meta_file{meta_path, std::ios::out};
         bake::serialize_bake(frame_cache.values, blob_writer, *request.blob_sharing, meta_file);
         written_size += blob_writer.written_size();
@@ -347,6 +353,7 @@ static void bake_geometry_nodes_startjob(void *customdata, wmJobWorkerStatus *wo
         PackedBake &packed_data = packed_data_by_bake.lookup_or_add_default(&request);
 
         bake::MemoryBlobWriter blob_writer{frame_file_name};
+        blob_writer.set_compression(compression);
         std::ostringstream meta_file{std::ios::binary};
         bake::serialize_bake(frame_cache.values, blob_writer, *request.blob_sharing, meta_file);
 
@@ -71,6 +71,34 @@ static bool memfile_undosys_poll(bContext *C)
   return true;
 }
 
+/**
+ * Memfile sizes change when their data is compressed or decompressed again on read, see
+ * #BLO_memfile_compress. Must only be called when no compression is pending.
+ */
+static void memfile_undosys_update_sizes(UndoStack *ustack)
+{
+  for (UndoStep &us_iter : ustack->steps) {
+    if (us_iter.type == BKE_UNDOSYS_TYPE_MEMFILE) {
+      us_iter.data_size = reinterpret_cast<MemFileUndoStep *>(&us_iter)->data->memfile.size;
+    }
+  }
+}
+
+/**
+ * Compress the memfile step before `us_prev`: the previous step is used as reference when writing
+ * new steps and is the most likely to be loaded on undo, older ones are "cold".
+ */
+static void memfile_undosys_compress_cold_step(UndoStack *ustack, MemFileUndoStep *us_prev)
+{
+  /* Writing the new step waited for the compression of older steps. */
+  memfile_undosys_update_sizes(ustack);
+
+  UndoStep *us_cold = BKE_undosys_step_same_type_prev(&us_prev->step);
+  if (us_cold != nullptr) {
+    BLO_memfile_compress(&reinterpret_cast<MemFileUndoStep *>(us_cold)->data->memfile);
+  }
+}
+
 static bool memfile_undosys_step_encode(bContext * /*C*/, Main *bmain, UndoStep *us_p)
 {
   MemFileUndoStep *us = reinterpret_cast<MemFileUndoStep *>(us_p);
@@ -88,6 +116,10 @@ static bool memfile_undosys_step_encode(bContext * /*C*/, Main *bmain, UndoStep
   us->data = BKE_memfile_undo_encode(bmain, us_prev ? us_prev->data : nullptr);
   us->step.data_size = us->data->undo_size;
 
+  if ((U.undo_flag & USER_UNDO_COMPRESS_MEMFILE) && us_prev) {
+    memfile_undosys_compress_cold_step(ustack, us_prev);
+  }
+
   /* Store the fact that we should not re-use old data with that undo step, and reset the Main
    * flag. */
   us->step.use_old_bmain_data = !bmain->use_memfile_full_barrier;
@@ -188,6 +220,8 @@ static void memfile_undosys_step_decode(
 
   MemFileUndoStep *us = reinterpret_cast<MemFileUndoStep *>(us_p);
   BKE_memfile_undo_decode(us->data, undo_direction, use_old_bmain_data, C);
+  /* Reading may have decompressed data of the step. */
+  memfile_undosys_update_sizes(ED_undo_stack_get());
 
   for (UndoStep *us_iter = us_p->next; us_iter; us_iter = us_iter->next) {
     if (BKE_UNDOSYS_TYPE_IS_MEMFILE_SKIP(us_iter->type)) {
@@ -315,6 +349,8 @@ static void memfile_undosys_step_free(UndoStep *us_p)
     if (us_next_p != nullptr) {
       MemFileUndoStep *us_next = reinterpret_cast<MemFileUndoStep *>(us_next_p);
       BLO_memfile_merge(&us->data->memfile, &us_next->data->memfile);
+      /* The next step now accounts for the data it shared with the freed one. */
+      us_next_p->data_size = us_next->data->memfile.size;
     }
   }
 
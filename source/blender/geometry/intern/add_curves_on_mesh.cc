@@ -65,16 +65,18 @@ static void find_curve_neighbors(const Span<float3> root_positions,
 {
   PRF_scope(ProfileCategory::Default);
   const int tot_added_curves = root_positions.size();
+  Array<KDTreeNearest<float3>> all_nearest(int64_t(tot_added_curves) * max_neighbors);
+  Array<int> all_found_neighbors(tot_added_curves);
+  kdtree_find_nearest_n_batch<float3>(
+      &old_roots_kdtree, root_positions, max_neighbors, all_nearest, all_found_neighbors);
+
   Array<NeighborCurves> neighbors_per_curve(tot_added_curves);
   threading::parallel_for(IndexRange(tot_added_curves), 128, [&](const IndexRange range) {
     for (const int i : range) {
-      const float3 root = root_positions[i];
-      std::array<KDTreeNearest<float3>, max_neighbors> nearest_n;
-      const int found_neighbors = kdtree_find_nearest_n<float3>(
-          &old_roots_kdtree, root, nearest_n.data(), max_neighbors);
+      const Span<KDTreeNearest<float3>> nearest_n = all_nearest.as_span().slice(
+          int64_t(i) * max_neighbors, all_found_neighbors[i]);
       float tot_weight = 0.0f;
-      for (const int neighbor_i : IndexRange(found_neighbors)) {
-        KDTreeNearest<float3> &nearest = nearest_n[neighbor_i];
+      for (const KDTreeNearest<float3> &nearest : nearest_n) {
         const float weight = 1.0f / std::max(nearest.dist, 0.00001f);
         tot_weight += weight;
         neighbors_per_curve[i].append({nearest.index, weight});
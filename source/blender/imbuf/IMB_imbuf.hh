@@ -368,6 +368,16 @@ enum class IMBScaleFilter {
    * better results when scaling down by more than 2x.
    */
   Box,
+  /**
+   * Mitchell-Netravali cubic filter (B = C = 1/3). Smooth results with little ringing,
+   * properly filtered when scaling down.
+   */
+  Mitchell,
+  /**
+   * Lanczos filter with a radius of 3 pixels. Sharpest results, properly filtered when scaling
+   * down, but may produce slight ringing around high contrast edges. Slowest.
+   */
+  Lanczos3,
 };
 
 void IMB_scale_box(const float *src_buffer,
@@ -14,6 +14,8 @@
 #include <cstring>
 #include <string>
 
+#include <fmt/format.h>
+
 #include "DNA_ID.h"
 #include "DNA_color_types.h"
 #include "DNA_image_types.h"
@@ -22,6 +24,7 @@
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
+#include "DNA_userdef_types.h"
 
 #include "IMB_filetype.hh"
 #include "IMB_filter.hh"
@@ -34,11 +37,13 @@
 #include "BLI_colorspace.hh"
 #include "BLI_fileops.hh"
 #include "BLI_listbase.hh"
+#include "BLI_map.hh"
 #include "BLI_math_color.hh"
 #include "BLI_math_color_c.hh"
 #include "BLI_math_matrix.hh"
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_mutex.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_rect.hh"
 #include "BLI_string.hh"
@@ -101,6 +106,22 @@ static VectorSet<StringRefNull> &g_all_view_names()
   return g_all_view_names_;
 }
 
+/* Display processors for drawing, approximated by a 3D LUT where possible. See
+ * #get_display_buffer_lut_processor. */
+struct DisplayLUTCache {
+  Mutex mutex;
+  /* Number of requests for display parameters which do not have a processor yet. */
+  Map<std::string, int> requests_num;
+  /* Either the LUT processor, or the exact processor when the LUT is not accurate enough. */
+  Map<std::string, std::shared_ptr<const ocio::CPUProcessor>> processors;
+};
+
+static DisplayLUTCache &g_display_lut_cache()
+{
+  static DisplayLUTCache g_display_lut_cache_;
+  return g_display_lut_cache_;
+}
+
 #define DISPLAY_BUFFER_CHANNELS 4
 
 /* ** list of all supported color spaces, displays and views */
@@ -278,8 +299,17 @@ static bool colormanage_load_config(ocio::Config &config)
   return ok;
 }
 
+static void colormanage_free_display_lut_cache()
+{
+  DisplayLUTCache &cache = g_display_lut_cache();
+  std::lock_guard lock(cache.mutex);
+  cache.requests_num.clear();
+  cache.processors.clear();
+}
+
 static void colormanage_free_config()
 {
+  colormanage_free_display_lut_cache();
   g_config() = nullptr;
   g_all_view_names().clear();
 }
@@ -455,6 +485,100 @@ static bool get_display_emulation(const ColorManagedDisplaySettings &display_set
   return true;
 }
 
+static std::string display_parameters_key(const ocio::DisplayParameters &display_parameters)
+{
+  return fmt::format("{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}",
+                     display_parameters.from_colorspace.c_str(),
+                     display_parameters.view.c_str(),
+                     display_parameters.display.c_str(),
+                     display_parameters.look.c_str(),
+                     display_parameters.scale,
+                     display_parameters.exponent,
+                     display_parameters.temperature,
+                     display_parameters.tint,
+                     display_parameters.use_white_balance,
+                     display_parameters.use_hdr_buffer,
+                     display_parameters.use_hdr_display,
+                     display_parameters.is_image_output,
+                     display_parameters.use_display_emulation,
+                     display_parameters.use_scope_space,
+                     display_parameters.inverse);
+}
+
+/**
+ * Get the display processor for drawing, approximated by a 3D LUT. Baking the LUT costs about as
+ * much as applying the exact transform to a small image, so it is only baked when the same display
+ * parameters are requested again. That way changing the exposure or gamma interactively does not
+ * bake a LUT for every intermediate value. Transforms which the LUT can not approximate closely
+ * enough keep using the exact processor.
+ */
+static std::shared_ptr<const ocio::CPUProcessor> get_display_buffer_lut_processor(
+    const ocio::DisplayParameters &display_parameters)
+{
+  /* Half of the quantization step of 8 bit displays. */
+  constexpr float max_error = 0.5f / 255.0f;
+  /* Number of display parameter combinations after which the cache is cleared. */
+  constexpr int64_t max_cached_processors = 16;
+  constexpr int64_t max_counted_requests = 256;
+
+  /* Exposure is applied in scene linear, before the view transform. For scene linear input it is
+   * applied to the input of the LUT instead, so that the LUT does not need to cover the range of
+   * inputs of every exposure, and the same LUT is used for all of them. */
+  if (display_parameters.scale != 1.0f && !display_parameters.use_white_balance &&
+      IMB_colormanagement_space_name_is_scene_linear(display_parameters.from_colorspace.c_str()))
+  {
+    ocio::DisplayParameters unscaled_display_parameters = display_parameters;
+    unscaled_display_parameters.scale = 1.0f;
+    const std::shared_ptr<const ocio::CPUProcessor> processor = get_display_buffer_lut_processor(
+        unscaled_display_parameters);
+    if (const ocio::LUTCPUProcessor *lut_processor = dynamic_cast<const ocio::LUTCPUProcessor *>(
+            processor.get()))
+    {
+      return lut_processor->with_input_scale(display_parameters.scale);
+    }
+    return g_config()->get_display_cpu_processor(display_parameters);
+  }
+
+  DisplayLUTCache &cache = g_display_lut_cache();
+  const std::string key = display_parameters_key(display_parameters);
+  {
+    std::lock_guard lock(cache.mutex);
+    if (const std::shared_ptr<const ocio::CPUProcessor> *processor = cache.processors.lookup_ptr(
+            key))
+    {
+      return *processor;
+    }
+    if (cache.requests_num.size() >= max_counted_requests) {
+      cache.requests_num.clear();
+    }
+    if (cache.requests_num.lookup_or_add(key, 0)++ == 0) {
+      return g_config()->get_display_cpu_processor(display_parameters);
+    }
+  }
+
+  std::shared_ptr<const ocio::CPUProcessor> processor = g_config()->get_display_cpu_processor(
+      display_parameters);
+  if (!processor || processor->is_noop()) {
+    return processor;
+  }
+  if (std::unique_ptr<ocio::LUTCPUProcessor> lut_processor = ocio::LUTCPUProcessor::create(
+          *processor, max_error))
+  {
+    processor = std::move(lut_processor);
+  }
+  else {
+    CLOG_DEBUG(&LOG, "Display transform is not approximated by a LUT: %s", key.c_str());
+  }
+
+  std::lock_guard lock(cache.mutex);
+  if (cache.processors.size() >= max_cached_processors) {
+    cache.processors.clear();
+    cache.requests_num.clear();
+  }
+  /* Another thread may have baked the LUT of the same parameters in the meantime. */
+  return cache.processors.lookup_or_add(key, std::move(processor));
+}
+
 static std::shared_ptr<const ocio::CPUProcessor> get_display_buffer_processor(
     const ColorManagedDisplaySettings &display_settings,
     const char *look,
@@ -488,6 +612,12 @@ static std::shared_ptr<const ocio::CPUProcessor> get_display_buffer_processor(
                                                  false;
   display_parameters.use_scope_space = (target == DISPLAY_SPACE_SCOPE);
 
+  if (target == DISPLAY_SPACE_DRAW && !inverse && !display_parameters.use_hdr_display &&
+      USER_EXPERIMENTAL_TEST(&U, use_display_transform_lut))
+  {
+    return get_display_buffer_lut_processor(display_parameters);
+  }
+
   return g_config()->get_display_cpu_processor(display_parameters);
 }
 
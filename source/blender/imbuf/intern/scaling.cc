@@ -7,7 +7,8 @@
  * \ingroup imbuf
  */
 
-#include "BLI_math_interp.hh"
+#include "BLI_array.hh"
+#include "BLI_math_base.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_task.hh"
 #include "BLI_utildefines.hh"
@@ -92,6 +93,140 @@ static void to_static_pixel_type(const BufferT *src_buffer,
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Weight Tables
+ *
+ * Which source pixels contribute to a destination pixel, and with which weights, only depends on
+ * the image sizes. So the scaling functions below run as two separable passes, which compute
+ * these weights once per axis instead of for every pixel.
+ * \{ */
+
+/**
+ * Weights for scaling one dimension. Destination pixel `i` is the weighted sum of `sizes[i]`
+ * consecutive source pixels starting at `starts[i]`, with weights starting at `i * taps`.
+ */
+struct FilterWeights {
+  int taps = 0;
+  Array<int> starts;
+  Array<int> sizes;
+  Array<float> weights;
+};
+
+/**
+ * Weights for scaling one dimension by interpolating between two source pixels. Destination pixel
+ * `i` interpolates between the source pixels `indices[i]` with the factor `factors[i]`.
+ */
+struct LinearWeights {
+  Array<int2> indices;
+  Array<float> factors;
+};
+
+template<typename BufferT> static float load_channel(const BufferT value)
+{
+  return float(value);
+}
+
+static void store_channel(const float value, float *dst)
+{
+  *dst = value;
+}
+
+static void store_channel(const float value, uchar *dst)
+{
+  /* Adding 0.5 and truncating is much faster than #math::round in the inner loops, and only
+   * differs for the largest float below 0.5. */
+  *dst = uchar(math::clamp(value, 0.0f, 255.0f) + 0.5f);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Box Scaling
+ *
+ * The weights are computed by stepping through the source pixels of a single row or column once,
+ * accumulating the covered area of every source pixel. Horizontal passes load and store whole
+ * pixels, vertical passes process whole rows so that their inner loops are contiguous.
+ * \{ */
+
+/**
+ * Area weights for scaling down. The sum of the weighted source pixels has to be multiplied by
+ * `r_inv_add`, which is the inverse of the number of source pixels per destination pixel.
+ */
+static FilterWeights compute_box_down_weights(const int src_len,
+                                              const int dst_len,
+                                              float &r_inv_add)
+{
+  const float add = (src_len - 0.01f) / dst_len;
+  r_inv_add = 1.0f / add;
+
+  FilterWeights result;
+  result.taps = int(math::ceil(add)) + 2;
+  result.starts.reinitialize(dst_len);
+  result.sizes.reinitialize(dst_len);
+  result.weights.reinitialize(int64_t(dst_len) * result.taps);
+
+  float sample = 0.0f;
+  /* The first source pixel that is not fully covered by previous destination pixels yet. */
+  int src_i = 0;
+  for (const int i : IndexRange(dst_len)) {
+    MutableSpan<float> weights = result.weights.as_mutable_span().slice(i * result.taps,
+                                                                        result.taps);
+    int size = 0;
+    int start = src_i;
+    if (i > 0) {
+      /* The part of the last source pixel of the previous destination pixel that it did not
+       * cover, `sample` is negative here. */
+      start = src_i - 1;
+      weights[size++] = -sample;
+    }
+    sample += add;
+    while (sample >= 1.0f) {
+      sample -= 1.0f;
+      weights[size++] = 1.0f;
+      src_i++;
+    }
+    weights[size++] = sample;
+    src_i++;
+    sample -= 1.0f;
+
+    BLI_assert(size <= result.taps && start + size <= src_len);
+    weights.drop_front(size).fill(0.0f);
+    result.starts[i] = start;
+    result.sizes[i] = size;
+  }
+  return result;
+}
+
+/** Linear interpolation weights for scaling up, with the factor clamped at the first pixel. */
+static LinearWeights compute_box_up_weights(const int src_len, const int dst_len)
+{
+  const float add = (src_len - 0.001f) / dst_len;
+
+  LinearWeights result;
+  result.indices.reinitialize(dst_len);
+  result.factors.reinitialize(dst_len);
+
+  float sample = -0.5f + add * 0.5f;
+  int2 pair(0, 1);
+  int next = 0;
+  if (src_len > 2) {
+    next += 2;
+  }
+  for (const int i : IndexRange(dst_len)) {
+    if (sample >= 1.0f) {
+      sample -= 1.0f;
+      pair = int2(pair[1], next);
+      if (next + 1 < src_len) {
+        next++;
+      }
+    }
+    result.indices[i] = pair;
+    result.factors[i] = math::max(sample, 0.0f);
+    sample += add;
+  }
+  return result;
+}
+
 template<typename BufferT>
 static void scale_down_x_func(const BufferT *src_buffer,
                               const int2 src_size,
@@ -102,37 +237,23 @@ static void scale_down_x_func(const BufferT *src_buffer,
                               bool threaded)
 {
   const int newx = dst_size.x;
-  const int ibufx = src_size.x;
   const int ibufy = src_size.y;
+  float inv_add;
+  const FilterWeights weights = compute_box_down_weights(src_size.x, newx, inv_add);
   to_static_pixel_type(src_buffer, channels, dst_buffer, [&]<typename T>(const T *src, T *dst) {
-    const float add = (ibufx - 0.01f) / newx;
-    const float inv_add = 1.0f / add;
-
     const int grain_size = threaded ? 32 : ibufy;
     threading::parallel_for(IndexRange(ibufy), grain_size, [&](IndexRange range) {
       for (const int y : range) {
-        const T *src_ptr = src + (int64_t(y) * src_stride);
-        T *dst_ptr = dst + (int64_t(y) * newx);
-        float sample = 0.0f;
-        float4 val(0.0f);
-
-        for (int x = 0; x < newx; x++) {
-          float4 nval = -val * sample;
-          sample += add;
-          while (sample >= 1.0f) {
-            sample -= 1.0f;
-            nval += load_pixel(src_ptr);
-            src_ptr++;
+        const T *src_row = src + (int64_t(y) * src_stride);
+        T *dst_row = dst + (int64_t(y) * newx);
+        for (const int x : IndexRange(newx)) {
+          const T *src_ptr = src_row + weights.starts[x];
+          const float *pixel_weights = &weights.weights[int64_t(x) * weights.taps];
+          float4 sum(0.0f);
+          for (const int j : IndexRange(weights.sizes[x])) {
+            sum += pixel_weights[j] * load_pixel(src_ptr + j);
           }
-
-          val = load_pixel(src_ptr);
-          src_ptr++;
-
-          float4 pix = (nval + sample * val) * inv_add;
-          store_pixel(pix, dst_ptr);
-          dst_ptr++;
-
-          sample -= 1.0f;
+          store_pixel(sum * inv_add, dst_row + x);
         }
       }
     });
@@ -148,40 +269,28 @@ static void scale_down_y_func(const BufferT *src_buffer,
                               bool threaded)
 {
   const int newy = dst_size.y;
-  const int ibufx = src_size.x;
-  const int ibufy = src_size.y;
-  to_static_pixel_type(src_buffer, channels, dst_buffer, [&]<typename T>(const T *src, T *dst) {
-    const float add = (ibufy - 0.01f) / newy;
-    const float inv_add = 1.0f / add;
-
-    const int grain_size = threaded ? 32 : ibufx;
-    threading::parallel_for(IndexRange(ibufx), grain_size, [&](IndexRange range) {
-      for (const int x : range) {
-        const T *src_ptr = src + x;
-        T *dst_ptr = dst + x;
-        float sample = 0.0f;
-        float4 val(0.0f);
-
-        for (int y = 0; y < newy; y++) {
-          float4 nval = -val * sample;
-          sample += add;
-          while (sample >= 1.0f) {
-            sample -= 1.0f;
-            nval += load_pixel(src_ptr);
-            src_ptr += ibufx;
-          }
-
-          val = load_pixel(src_ptr);
-          src_ptr += ibufx;
-
-          float4 pix = (nval + sample * val) * inv_add;
-          store_pixel(pix, dst_ptr);
-          dst_ptr += ibufx;
+  const int64_t row_len = int64_t(src_size.x) * channels;
+  float inv_add;
+  const FilterWeights weights = compute_box_down_weights(src_size.y, newy, inv_add);
 
-          sample -= 1.0f;
+  const int grain_size = threaded ? 32 : newy;
+  threading::parallel_for(IndexRange(newy), grain_size, [&](IndexRange range) {
+    Array<float> sum(row_len);
+    for (const int y : range) {
+      sum.fill(0.0f);
+      const float *row_weights = &weights.weights[int64_t(y) * weights.taps];
+      for (const int j : IndexRange(weights.sizes[y])) {
+        const float weight = row_weights[j];
+        const BufferT *src_row = src_buffer + (int64_t(weights.starts[y]) + j) * row_len;
+        for (int64_t i = 0; i < row_len; i++) {
+          sum[i] += weight * load_channel(src_row[i]);
         }
       }
-    });
+      BufferT *dst_row = dst_buffer + int64_t(y) * row_len;
+      for (int64_t i = 0; i < row_len; i++) {
+        store_channel(sum[i] * inv_add, &dst_row[i]);
+      }
+    }
   });
 }
 
@@ -198,7 +307,6 @@ static void scale_up_x_func(const BufferT *src_buffer,
   const int ibufx = src_size.x;
   const int ibufy = src_size.y;
   to_static_pixel_type(src_buffer, channels, dst_buffer, [&]<typename T>(const T *src, T *dst) {
-    const float add = (ibufx - 0.001f) / newx;
     /* Special case: source is 1px wide (see #70356). */
     if (ibufx == 1) [[unlikely]] {
       for (int y = ibufy; y > 0; y--) {
@@ -210,35 +318,16 @@ static void scale_up_x_func(const BufferT *src_buffer,
       }
     }
     else {
+      const LinearWeights weights = compute_box_up_weights(ibufx, newx);
       const int grain_size = threaded ? 32 : ibufy;
       threading::parallel_for(IndexRange(ibufy), grain_size, [&](IndexRange range) {
         for (const int y : range) {
-          float sample = -0.5f + add * 0.5f;
-          int counter = 0;
-          const T *src_ptr = src + (int64_t(y) * src_stride);
-          T *dst_ptr = dst + (int64_t(y) * newx);
-          float4 val = load_pixel(src_ptr);
-          float4 nval = load_pixel(src_ptr + 1);
-          float4 diff = nval - val;
-          if (ibufx > 2) {
-            src_ptr += 2;
-            counter += 2;
-          }
-          for (int x = 0; x < newx; x++) {
-            if (sample >= 1.0f) {
-              sample -= 1.0f;
-              val = nval;
-              nval = load_pixel(src_ptr);
-              diff = nval - val;
-              if (counter + 1 < ibufx) {
-                src_ptr++;
-                counter++;
-              }
-            }
-            float4 pix = val + math::max(sample, 0.0f) * diff;
-            store_pixel(pix, dst_ptr);
-            dst_ptr++;
-            sample += add;
+          const T *src_row = src + (int64_t(y) * src_stride);
+          T *dst_row = dst + (int64_t(y) * newx);
+          for (const int x : IndexRange(newx)) {
+            const float4 val = load_pixel(src_row + weights.indices[x][0]);
+            const float4 nval = load_pixel(src_row + weights.indices[x][1]);
+            store_pixel(val + weights.factors[x] * (nval - val), dst_row + x);
           }
         }
       });
@@ -255,52 +344,29 @@ static void scale_up_y_func(const BufferT *src_buffer,
                             bool threaded)
 {
   const int newy = dst_size.y;
-  const int ibufx = src_size.x;
   const int ibufy = src_size.y;
-  to_static_pixel_type(src_buffer, channels, dst_buffer, [&]<typename T>(const T *src, T *dst) {
-    const float add = (ibufy - 0.001f) / newy;
-    /* Special case: source is 1px high (see #70356). */
-    if (ibufy == 1) [[unlikely]] {
-      for (int y = newy; y > 0; y--) {
-        memcpy(reinterpret_cast<void *>(dst), src, sizeof(T) * ibufx);
-        dst += ibufx;
-      }
+  const int64_t row_len = int64_t(src_size.x) * channels;
+  /* Special case: source is 1px high (see #70356). */
+  if (ibufy == 1) [[unlikely]] {
+    for (int y = newy; y > 0; y--) {
+      memcpy(dst_buffer, src_buffer, sizeof(BufferT) * row_len);
+      dst_buffer += row_len;
     }
-    else {
-      const int grain_size = threaded ? 32 : ibufx;
-      threading::parallel_for(IndexRange(ibufx), grain_size, [&](IndexRange range) {
-        for (const int x : range) {
-          float sample = -0.5f + add * 0.5f;
-          int counter = 0;
-          const T *src_ptr = src + x;
-          T *dst_ptr = dst + x;
-
-          float4 val = load_pixel(src_ptr);
-          float4 nval = load_pixel(src_ptr + ibufx);
-          float4 diff = nval - val;
-          if (ibufy > 2) {
-            src_ptr += ibufx * 2;
-            counter += 2;
-          }
+    return;
+  }
 
-          for (int y = 0; y < newy; y++) {
-            if (sample >= 1.0f) {
-              sample -= 1.0f;
-              val = nval;
-              nval = load_pixel(src_ptr);
-              diff = nval - val;
-              if (counter + 1 < ibufy) {
-                src_ptr += ibufx;
-                ++counter;
-              }
-            }
-            float4 pix = val + math::max(sample, 0.0f) * diff;
-            store_pixel(pix, dst_ptr);
-            dst_ptr += ibufx;
-            sample += add;
-          }
-        }
-      });
+  const LinearWeights weights = compute_box_up_weights(ibufy, newy);
+  const int grain_size = threaded ? 32 : newy;
+  threading::parallel_for(IndexRange(newy), grain_size, [&](IndexRange range) {
+    for (const int y : range) {
+      const BufferT *src_row = src_buffer + int64_t(weights.indices[y][0]) * row_len;
+      const BufferT *src_next_row = src_buffer + int64_t(weights.indices[y][1]) * row_len;
+      const float factor = weights.factors[y];
+      BufferT *dst_row = dst_buffer + int64_t(y) * row_len;
+      for (int64_t i = 0; i < row_len; i++) {
+        const float val = load_channel(src_row[i]);
+        store_channel(val + factor * (load_channel(src_next_row[i]) - val), &dst_row[i]);
+      }
     }
   });
 }
@@ -348,6 +414,8 @@ static void imb_scale_box(const BufferT *src_buffer,
   MEM_delete(tmp_buffer);
 }
 
+/** \} */
+
 void IMB_scale_box(const float *src_buffer,
                    const int2 src_size,
                    const int channels,
@@ -430,6 +498,121 @@ static void scale_nearest_func(const BufferT *src_buffer,
   });
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Bilinear Scaling
+ *
+ * Bilinear interpolation at the destination pixel centers, like #math::interpolate_bilinear_fl
+ * with extended edges. Source rows are first interpolated horizontally, then pairs of these rows
+ * are interpolated vertically. When scaling up, consecutive destination rows mostly use the same
+ * source rows, so each thread keeps the last two horizontally interpolated rows around.
+ * \{ */
+
+static LinearWeights compute_bilinear_weights(const int src_len, const int dst_len)
+{
+  const float factor = float(src_len) / dst_len;
+
+  LinearWeights result;
+  result.indices.reinitialize(dst_len);
+  result.factors.reinitialize(dst_len);
+  for (const int i : IndexRange(dst_len)) {
+    const float u = (float(i) + 0.5f) * factor - 0.5f;
+    const float u_floor = math::floor(u);
+    const int x = int(u_floor);
+    result.indices[i] = int2(math::clamp(x, 0, src_len - 1), math::clamp(x + 1, 0, src_len - 1));
+    result.factors[i] = u - u_floor;
+  }
+  return result;
+}
+
+template<int Channels, typename BufferT>
+static void bilinear_interpolate_row(const BufferT *src_row,
+                                     const LinearWeights &weights,
+                                     float *dst_row)
+{
+  for (const int x : weights.factors.index_range()) {
+    const BufferT *src_a = src_row + int64_t(weights.indices[x][0]) * Channels;
+    const BufferT *src_b = src_row + int64_t(weights.indices[x][1]) * Channels;
+    const float factor = weights.factors[x];
+    for (int c = 0; c < Channels; c++) {
+      dst_row[int64_t(x) * Channels + c] = (1.0f - factor) * load_channel(src_a[c]) +
+                                           factor * load_channel(src_b[c]);
+    }
+  }
+}
+
+template<int Channels, typename BufferT>
+static void scale_bilinear(const BufferT *src_buffer,
+                           const int2 src_size,
+                           BufferT *dst_buffer,
+                           const int2 dst_size,
+                           bool threaded)
+{
+  const LinearWeights weights_x = compute_bilinear_weights(src_size.x, dst_size.x);
+  const LinearWeights weights_y = compute_bilinear_weights(src_size.y, dst_size.y);
+  const int64_t src_row_len = int64_t(src_size.x) * Channels;
+  const int64_t row_len = int64_t(dst_size.x) * Channels;
+
+  const int grain_size = threaded ? 32 : dst_size.y;
+  if (dst_size.y <= src_size.y) {
+    /* Destination rows rarely share source rows when scaling down, so caching the interpolated
+     * rows would only add memory traffic. */
+    threading::parallel_for(IndexRange(dst_size.y), grain_size, [&](IndexRange y_range) {
+      for (const int y : y_range) {
+        const BufferT *src_row_a = src_buffer + weights_y.indices[y][0] * src_row_len;
+        const BufferT *src_row_b = src_buffer + weights_y.indices[y][1] * src_row_len;
+        const float factor_y = weights_y.factors[y];
+        BufferT *dst_row = dst_buffer + int64_t(y) * row_len;
+        for (const int x : IndexRange(dst_size.x)) {
+          const int64_t offset_a = int64_t(weights_x.indices[x][0]) * Channels;
+          const int64_t offset_b = int64_t(weights_x.indices[x][1]) * Channels;
+          const float factor_x = weights_x.factors[x];
+          for (int c = 0; c < Channels; c++) {
+            const float a = (1.0f - factor_x) * load_channel(src_row_a[offset_a + c]) +
+                            factor_x * load_channel(src_row_a[offset_b + c]);
+            const float b = (1.0f - factor_x) * load_channel(src_row_b[offset_a + c]) +
+                            factor_x * load_channel(src_row_b[offset_b + c]);
+            store_channel((1.0f - factor_y) * a + factor_y * b,
+                          &dst_row[int64_t(x) * Channels + c]);
+          }
+        }
+      }
+    });
+    return;
+  }
+
+  threading::parallel_for(IndexRange(dst_size.y), grain_size, [&](IndexRange y_range) {
+    Array<float> rows(row_len * 2);
+    int2 rows_src_y(-1);
+    auto find_row = [&](const int src_y) {
+      return rows_src_y[0] == src_y ? 0 : (rows_src_y[1] == src_y ? 1 : -1);
+    };
+    /* Get the slot of the interpolated source row, without overwriting the `keep_slot`. */
+    auto ensure_row = [&](const int src_y, const int keep_slot) {
+      int slot = find_row(src_y);
+      if (slot == -1) {
+        slot = keep_slot == 0 ? 1 : 0;
+        bilinear_interpolate_row<Channels>(
+            src_buffer + src_y * src_row_len, weights_x, &rows[slot * row_len]);
+        rows_src_y[slot] = src_y;
+      }
+      return slot;
+    };
+
+    for (const int y : y_range) {
+      const int2 src_y = weights_y.indices[y];
+      const int slot_a = ensure_row(src_y[0], find_row(src_y[1]));
+      const int slot_b = ensure_row(src_y[1], slot_a);
+      const float *row_a = &rows[slot_a * row_len];
+      const float *row_b = &rows[slot_b * row_len];
+      const float factor = weights_y.factors[y];
+      BufferT *dst_row = dst_buffer + int64_t(y) * row_len;
+      for (int64_t i = 0; i < row_len; i++) {
+        store_channel((1.0f - factor) * row_a[i] + factor * row_b[i], &dst_row[i]);
+      }
+    }
+  });
+}
+
 template<typename BufferT>
 static void scale_bilinear(const BufferT *src_buffer,
                            const int2 src_size,
@@ -438,32 +621,218 @@ static void scale_bilinear(const BufferT *src_buffer,
                            const int2 dst_size,
                            bool threaded)
 {
-  const int newx = dst_size.x;
-  const int newy = dst_size.y;
+  auto scale = [&]<int Channels>() {
+    scale_bilinear<Channels>(src_buffer, src_size, dst_buffer, dst_size, threaded);
+  };
+  switch (channels) {
+    case 1:
+      scale.template operator()<1>();
+      break;
+    case 2:
+      scale.template operator()<2>();
+      break;
+    case 3:
+      scale.template operator()<3>();
+      break;
+    default:
+      BLI_assert(channels == 4);
+      scale.template operator()<4>();
+      break;
+  }
+}
 
-  const int grain_size = threaded ? 32 : newy;
-  threading::parallel_for(IndexRange(newy), grain_size, [&](IndexRange y_range) {
-    float factor_x = float(src_size.x) / newx;
-    float factor_y = float(src_size.y) / newy;
+/** \} */
 
-    for (const int y : y_range) {
-      float v = (float(y) + 0.5f) * factor_y - 0.5f;
-      for (int x = 0; x < newx; x++) {
-        float u = (float(x) + 0.5f) * factor_x - 0.5f;
-        int64_t offset = int64_t(y) * newx + x;
-        if constexpr (std::is_same_v<BufferT, uchar>) {
-          *reinterpret_cast<uchar4 *>(dst_buffer + offset * 4) = math::interpolate_bilinear_byte(
-              src_buffer, src_size.x, src_size.y, u, v);
+/* -------------------------------------------------------------------- */
+/** \name Separable Filter Scaling
+ *
+ * Two-pass scaling with a filter kernel, first horizontally into a temporary float buffer and
+ * then vertically. The filter weights only depend on the image sizes, so they are computed once
+ * per pass. When scaling down, the kernel is widened by the scale factor to avoid aliasing.
+ *
+ * The inner loops are written over contiguous channels of whole rows, so that they can be
+ * vectorized by the compiler.
+ * \{ */
+
+static float filter_support(const IMBScaleFilter filter)
+{
+  return filter == IMBScaleFilter::Lanczos3 ? 3.0f : 2.0f;
+}
+
+static float filter_eval(const IMBScaleFilter filter, float x)
+{
+  x = math::abs(x);
+  if (filter == IMBScaleFilter::Lanczos3) {
+    if (x < 1e-6f) {
+      return 1.0f;
+    }
+    if (x >= 3.0f) {
+      return 0.0f;
+    }
+    const float pi_x = float(M_PI) * x;
+    return 3.0f * math::sin(pi_x) * math::sin(pi_x / 3.0f) / (pi_x * pi_x);
+  }
+  /* Mitchell-Netravali with B = C = 1/3. */
+  constexpr float B = 1.0f / 3.0f;
+  constexpr float C = 1.0f / 3.0f;
+  if (x < 1.0f) {
+    return ((12.0f - 9.0f * B - 6.0f * C) * x * x * x + (-18.0f + 12.0f * B + 6.0f * C) * x * x +
+            (6.0f - 2.0f * B)) /
+           6.0f;
+  }
+  if (x < 2.0f) {
+    return ((-B - 6.0f * C) * x * x * x + (6.0f * B + 30.0f * C) * x * x +
+            (-12.0f * B - 48.0f * C) * x + (8.0f * B + 24.0f * C)) /
+           6.0f;
+  }
+  return 0.0f;
+}
+
+static FilterWeights compute_filter_weights(const int src_len,
+                                            const int dst_len,
+                                            const IMBScaleFilter filter)
+{
+  const float src_per_dst = float(src_len) / float(dst_len);
+  /* Widen the kernel when scaling down, so that every source pixel contributes. */
+  const float kernel_scale = std::max(src_per_dst, 1.0f);
+  const float radius = filter_support(filter) * kernel_scale;
+
+  FilterWeights result;
+  result.taps = int(math::ceil(radius)) * 2 + 1;
+  result.starts.reinitialize(dst_len);
+  result.sizes.reinitialize(dst_len);
+  result.weights.reinitialize(int64_t(dst_len) * result.taps);
+
+  for (const int i : IndexRange(dst_len)) {
+    const float center = (float(i) + 0.5f) * src_per_dst;
+    /* Source pixels outside of the image are left out, the remaining weights are normalized. */
+    const int start = std::clamp(int(math::floor(center - radius + 0.5f)), 0, src_len - 1);
+    const int end = std::min(int(math::floor(center + radius + 0.5f)), src_len);
+    const int size = std::min(std::max(end - start, 1), result.taps);
+    MutableSpan<float> weights = result.weights.as_mutable_span().slice(i * result.taps,
+                                                                        result.taps);
+    float weight_sum = 0.0f;
+    for (const int j : IndexRange(size)) {
+      const float weight = filter_eval(filter, (float(start + j) + 0.5f - center) / kernel_scale);
+      weights[j] = weight;
+      weight_sum += weight;
+    }
+    if (weight_sum != 0.0f) {
+      for (const int j : IndexRange(size)) {
+        weights[j] /= weight_sum;
+      }
+    }
+    else {
+      weights[0] = 1.0f;
+    }
+    weights.drop_front(size).fill(0.0f);
+    result.starts[i] = start;
+    result.sizes[i] = size;
+  }
+  return result;
+}
+
+/** Scale rows from `src` to the temporary float buffer `dst`, keeping the number of rows. */
+template<int Channels, typename BufferT>
+static void scale_filter_x(const BufferT *src,
+                           const int2 src_size,
+                           const int src_stride,
+                           float *dst,
+                           const int dst_width,
+                           const FilterWeights &weights,
+                           const bool threaded)
+{
+  const int grain_size = threaded ? 16 : src_size.y;
+  threading::parallel_for(IndexRange(src_size.y), grain_size, [&](const IndexRange range) {
+    for (const int y : range) {
+      const BufferT *src_row = src + int64_t(y) * src_stride * Channels;
+      float *dst_row = dst + int64_t(y) * dst_width * Channels;
+      for (const int x : IndexRange(dst_width)) {
+        const BufferT *src_pixel = src_row + int64_t(weights.starts[x]) * Channels;
+        const float *pixel_weights = &weights.weights[int64_t(x) * weights.taps];
+        float sum[Channels] = {0.0f};
+        for (const int j : IndexRange(weights.sizes[x])) {
+          const float weight = pixel_weights[j];
+          for (int c = 0; c < Channels; c++) {
+            sum[c] += weight * load_channel(src_pixel[j * Channels + c]);
+          }
         }
-        else {
-          float *pixel = dst_buffer + channels * offset;
-          math::interpolate_bilinear_fl(src_buffer, pixel, src_size.x, src_size.y, channels, u, v);
+        for (int c = 0; c < Channels; c++) {
+          dst_row[int64_t(x) * Channels + c] = sum[c];
         }
       }
     }
   });
 }
 
+/** Scale columns from the temporary float buffer `src` to `dst`, rows are processed whole. */
+template<typename BufferT>
+static void scale_filter_y(const float *src,
+                           const int channels,
+                           BufferT *dst,
+                           const int2 dst_size,
+                           const FilterWeights &weights,
+                           const bool threaded)
+{
+  const int64_t row_len = int64_t(dst_size.x) * channels;
+  const int grain_size = threaded ? 16 : dst_size.y;
+  threading::parallel_for(IndexRange(dst_size.y), grain_size, [&](const IndexRange range) {
+    Array<float> sum(row_len);
+    for (const int y : range) {
+      sum.fill(0.0f);
+      const float *pixel_weights = &weights.weights[int64_t(y) * weights.taps];
+      for (const int j : IndexRange(weights.sizes[y])) {
+        const float weight = pixel_weights[j];
+        const float *src_row = src + (int64_t(weights.starts[y]) + j) * row_len;
+        for (int64_t i = 0; i < row_len; i++) {
+          sum[i] += weight * src_row[i];
+        }
+      }
+      BufferT *dst_row = dst + int64_t(y) * row_len;
+      for (int64_t i = 0; i < row_len; i++) {
+        store_channel(sum[i], &dst_row[i]);
+      }
+    }
+  });
+}
+
+template<typename BufferT>
+static void scale_filter(const BufferT *src_buffer,
+                         const int2 src_size,
+                         const int channels,
+                         BufferT *dst_buffer,
+                         const int2 dst_size,
+                         const IMBScaleFilter filter,
+                         const bool threaded)
+{
+  const FilterWeights weights_x = compute_filter_weights(src_size.x, dst_size.x, filter);
+  const FilterWeights weights_y = compute_filter_weights(src_size.y, dst_size.y, filter);
+
+  Array<float> tmp(int64_t(channels) * dst_size.x * src_size.y, NoInitialization());
+  auto scale_x = [&]<int Channels>() {
+    scale_filter_x<Channels>(
+        src_buffer, src_size, src_size.x, tmp.data(), dst_size.x, weights_x, threaded);
+  };
+  switch (channels) {
+    case 1:
+      scale_x.template operator()<1>();
+      break;
+    case 2:
+      scale_x.template operator()<2>();
+      break;
+    case 3:
+      scale_x.template operator()<3>();
+      break;
+    default:
+      BLI_assert(channels == 4);
+      scale_x.template operator()<4>();
+      break;
+  }
+  scale_filter_y(tmp.data(), channels, dst_buffer, dst_size, weights_y, threaded);
+}
+
+/** \} */
+
 bool IMB_scale(ImBuf *ibuf, const int2 new_size, IMBScaleFilter filter, bool threaded)
 {
   BLI_assert_msg(new_size.x > 0 && new_size.y > 0,
@@ -525,6 +894,22 @@ bool IMB_scale(ImBuf *ibuf, const int2 new_size, IMBScaleFilter filter, bool thr
       }
       break;
     }
+    case IMBScaleFilter::Mitchell:
+    case IMBScaleFilter::Lanczos3: {
+      if (const float *src = ibuf->float_data()) {
+        float *dst = MEM_new_array_uninitialized<float>(
+            size_t(ibuf->channels) * new_size.x * new_size.y, __func__);
+        scale_filter(src, src_size, ibuf->channels, dst, new_size, filter, threaded);
+        ibuf->assign_float_data(dst);
+      }
+      if (const uchar *src = ibuf->byte_data()) {
+        uchar *dst = MEM_new_array_uninitialized<uchar>(size_t(new_size.x) * new_size.y * 4,
+                                                        __func__);
+        scale_filter(src, src_size, 4, dst, new_size, filter, threaded);
+        ibuf->assign_byte_data(dst);
+      }
+      break;
+    }
   }
   ibuf->float_buffer.colorspace = float_colorspace;
   ibuf->byte_buffer.colorspace = byte_colorspace;
@@ -596,6 +981,16 @@ ImBuf *IMB_scale_into_new(const ImBuf *ibuf,
       }
       break;
     }
+    case IMBScaleFilter::Mitchell:
+    case IMBScaleFilter::Lanczos3: {
+      if (const float *src = ibuf->float_data()) {
+        scale_filter(src, src_size, ibuf->channels, dst_float, new_size, filter, threaded);
+      }
+      if (const uchar *src = ibuf->byte_data()) {
+        scale_filter(src, src_size, 4, dst_byte, new_size, filter, threaded);
+      }
+      break;
+    }
   }
 
   dst->byte_buffer.colorspace = ibuf->byte_buffer.colorspace;
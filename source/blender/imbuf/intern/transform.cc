@@ -15,6 +15,7 @@
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector_c.hh"
 #include "BLI_rect.hh"
+#include "BLI_simd.hh"
 #include "BLI_task.hh"
 
 #include "IMB_imbuf.hh"
@@ -24,6 +25,9 @@ namespace blender {
 
 namespace imbuf::transform {
 
+/** Size of the square destination tiles that are processed as a single task. */
+static constexpr int64_t transform_tile_size = 64;
+
 struct TransformContext {
   const ImBuf *src;
   ImBuf *dst;
@@ -47,6 +51,74 @@ struct TransformContext {
   /* Cropping region in source image pixel space. */
   rctf src_crop;
 
+  /**
+   * Range of destination pixels in `x_range` of a scanline for which `inside(uv)` is true, where
+   * `uv = uv_row + x * add_x`. The inside region is the axis aligned rectangle `[lo, hi)`, so the
+   * span is contiguous. It is computed analytically and then refined with `inside` at the span
+   * ends, so that the result matches testing every pixel individually.
+   */
+  template<typename InsideFn>
+  IndexRange scanline_span(const float2 &uv_row,
+                           const IndexRange x_range,
+                           const float2 &lo,
+                           const float2 &hi,
+                           const InsideFn &inside) const
+  {
+    if (x_range.is_empty()) {
+      return x_range;
+    }
+    double x_min = double(x_range.first());
+    double x_max = double(x_range.one_after_last());
+    for (int axis = 0; axis < 2; axis++) {
+      const double step = add_x[axis];
+      const double origin = uv_row[axis];
+      if (step == 0.0) {
+        if (origin < lo[axis] || origin >= hi[axis]) {
+          x_max = x_min;
+        }
+        continue;
+      }
+      const double t0 = (lo[axis] - origin) / step;
+      const double t1 = (hi[axis] - origin) / step;
+      x_min = std::max(x_min, std::ceil(std::min(t0, t1)));
+      x_max = std::min(x_max, std::floor(std::max(t0, t1)) + 1.0);
+    }
+
+    auto is_inside = [&](const int64_t x) { return inside(uv_row + float(x) * add_x); };
+    const double range_start = double(x_range.first());
+    const double range_end = double(x_range.one_after_last());
+    int64_t start = int64_t(math::clamp(x_min, range_start, range_end));
+    int64_t end = int64_t(math::clamp(x_max, range_start, range_end));
+    if (start >= end) {
+      /* Rounding may hide a span of a pixel or two, look around the analytic estimate. */
+      start = std::min(start, x_range.last());
+      end = start;
+      for (const int64_t x : {start - 1, start, start + 1}) {
+        if (x_range.contains(x) && is_inside(x)) {
+          start = x;
+          end = x + 1;
+          break;
+        }
+      }
+      if (start == end) {
+        return IndexRange(x_range.first(), 0);
+      }
+    }
+    while (start < end && !is_inside(start)) {
+      start++;
+    }
+    while (start > x_range.first() && is_inside(start - 1)) {
+      start--;
+    }
+    while (end > start && !is_inside(end - 1)) {
+      end--;
+    }
+    while (end < x_range.one_after_last() && is_inside(end)) {
+      end++;
+    }
+    return IndexRange::from_begin_end(start, end);
+  }
+
   void init(const float3x3 &transform_matrix, const bool has_source_crop)
   {
     start_uv = transform_matrix.location().xy();
@@ -239,13 +311,79 @@ template<int SrcChannels> static void store_sample(const float *sample, float *d
   }
 }
 
-/* Process a block of destination image scanlines. */
+/**
+ * Bilinear sampling of a 4 channel float image without any edge handling, the caller ensures
+ * that all four texels are inside the image. The weights and the order of the operations are
+ * the same as in #math::interpolate_bilinear_wrapmode_fl, so for the same `u` and `v` the result
+ * is bit-identical to #math::interpolate_bilinear_fl.
+ */
+static void sample_bilinear_interior_fl4(const float *buffer,
+                                         const int width,
+                                         const float u,
+                                         const float v,
+                                         float *r_sample)
+{
+  const int x1 = int(u);
+  const int x2 = int(u + 1);
+  const int y1 = int(v);
+  const int y2 = int(v + 1);
+  const float *row1 = buffer + (int64_t(width) * y1 + x1) * 4;
+  const float *row2 = buffer + (int64_t(width) * y2 + x1) * 4;
+  const float *row3 = buffer + (int64_t(width) * y1 + x2) * 4;
+  const float *row4 = buffer + (int64_t(width) * y2 + x2) * 4;
+
+  const float a = u - floorf(u);
+  const float b = v - floorf(v);
+  const float a_b = a * b;
+  const float ma_b = (1.0f - a) * b;
+  const float a_mb = a * (1.0f - b);
+  const float ma_mb = (1.0f - a) * (1.0f - b);
+
+#if BLI_HAVE_SSE2
+  __m128 rgba1 = _mm_loadu_ps(row1);
+  __m128 rgba2 = _mm_loadu_ps(row2);
+  __m128 rgba3 = _mm_loadu_ps(row3);
+  __m128 rgba4 = _mm_loadu_ps(row4);
+  rgba1 = _mm_mul_ps(_mm_set1_ps(ma_mb), rgba1);
+  rgba2 = _mm_mul_ps(_mm_set1_ps(ma_b), rgba2);
+  rgba3 = _mm_mul_ps(_mm_set1_ps(a_mb), rgba3);
+  rgba4 = _mm_mul_ps(_mm_set1_ps(a_b), rgba4);
+  __m128 rgba13 = _mm_add_ps(rgba1, rgba3);
+  __m128 rgba24 = _mm_add_ps(rgba2, rgba4);
+  __m128 rgba = _mm_add_ps(rgba13, rgba24);
+  _mm_storeu_ps(r_sample, rgba);
+#else
+  for (int i = 0; i < 4; i++) {
+    r_sample[i] = ma_mb * row1[i] + a_mb * row3[i] + ma_b * row2[i] + a_b * row4[i];
+  }
+#endif
+}
+
+/* Sample one pixel per destination pixel in `x_span` of a scanline, without cropping. */
+template<eIMBInterpolationFilterMode Filter, typename T, int SrcChannels, bool WrapUV>
+static void process_scanline_span(const TransformContext &ctx,
+                                  const float2 &uv_row,
+                                  const IndexRange x_span,
+                                  T *output)
+{
+  for (int xi : x_span) {
+    const float2 uv = uv_row + xi * ctx.add_x;
+    T sample[4];
+    sample_image<Filter, T, SrcChannels, WrapUV>(ctx.src, uv.x, uv.y, sample);
+    store_sample<SrcChannels>(sample, output);
+    output += 4;
+  }
+}
+
+/* Process a tile of destination image scanlines. */
 template<eIMBInterpolationFilterMode Filter,
          typename T,
          int SrcChannels,
          bool CropSource,
          bool WrapUV>
-static void process_scanlines(const TransformContext &ctx, IndexRange y_range)
+static void process_scanlines(const TransformContext &ctx,
+                              const IndexRange y_range,
+                              const IndexRange x_range)
 {
   if constexpr (Filter == IMB_FILTER_BOX) {
 
@@ -268,9 +406,9 @@ static void process_scanlines(const TransformContext &ctx, IndexRange y_range)
     const float2 sub_step_y = ctx.add_y / sub_count_y;
 
     for (int yi : y_range) {
-      T *output = init_pixel_pointer<T>(ctx.dst, ctx.dst_region_x_range.first(), yi);
+      T *output = init_pixel_pointer<T>(ctx.dst, x_range.first(), yi);
       float2 uv_row = uv_start + yi * ctx.add_y;
-      for (int xi : ctx.dst_region_x_range) {
+      for (int xi : x_range) {
         const float2 uv = uv_row + xi * ctx.add_x;
         float sample[4] = {};
 
@@ -300,34 +438,77 @@ static void process_scanlines(const TransformContext &ctx, IndexRange y_range)
     /* One sample per pixel.
      * NOTE: sample at pixel center for proper filtering. */
     float2 uv_start = ctx.start_uv + ctx.add_x * 0.5f + ctx.add_y * 0.5f;
+    const float2 src_size(ctx.src->x, ctx.src->y);
     for (int yi : y_range) {
-      T *output = init_pixel_pointer<T>(ctx.dst, ctx.dst_region_x_range.first(), yi);
-      float2 uv_row = uv_start + yi * ctx.add_y;
-      for (int xi : ctx.dst_region_x_range) {
-        float2 uv = uv_row + xi * ctx.add_x;
-        if (!CropSource || !should_discard(ctx, uv)) {
-          T sample[4];
-          sample_image<Filter, T, SrcChannels, WrapUV>(ctx.src, uv.x, uv.y, sample);
-          store_sample<SrcChannels>(sample, output);
+      const float2 uv_row = uv_start + yi * ctx.add_y;
+
+      /* Pixels outside of the crop region are left untouched, so only the span of the scanline
+       * that maps into the crop region has to be processed. */
+      IndexRange x_span = x_range;
+      if constexpr (CropSource) {
+        x_span = ctx.scanline_span(
+            uv_row,
+            x_range,
+            float2(ctx.src_crop.xmin, ctx.src_crop.ymin),
+            float2(ctx.src_crop.xmax, ctx.src_crop.ymax),
+            [&](const float2 &uv) { return !should_discard(ctx, uv); });
+      }
+      if (x_span.is_empty()) {
+        continue;
+      }
+      T *output = init_pixel_pointer<T>(ctx.dst, x_span.first(), yi);
+
+      if constexpr (Filter == IMB_FILTER_BILINEAR && std::is_same_v<T, float> &&
+                    SrcChannels == 4 && !WrapUV)
+      {
+        /* Sample the part of the span where all four texels are inside of the source image
+         * without any edge handling. Sample coordinates are offset by half a pixel after
+         * stepping along the row, in the same order as #process_scanline_span and
+         * #sample_image, so that both paths sample at exactly the same location. */
+        const IndexRange interior = ctx.scanline_span(
+            uv_row, x_span, float2(0.5f), src_size - 0.5f, [&](const float2 &uv) {
+              const float2 texel = uv - 0.5f;
+              return texel.x >= 0.0f && texel.x + 1 < src_size.x && texel.y >= 0.0f &&
+                     texel.y + 1 < src_size.y;
+            });
+        if (!interior.is_empty()) {
+          const IndexRange before = IndexRange::from_begin_end(x_span.first(), interior.first());
+          const IndexRange after = IndexRange::from_begin_end(interior.one_after_last(),
+                                                              x_span.one_after_last());
+          process_scanline_span<Filter, T, SrcChannels, WrapUV>(ctx, uv_row, before, output);
+          output += before.size() * 4;
+
+          const float *src_buffer = ctx.src->float_data();
+          for (int xi : interior) {
+            const float2 uv = uv_row + xi * ctx.add_x;
+            sample_bilinear_interior_fl4(
+                src_buffer, ctx.src->x, uv.x - 0.5f, uv.y - 0.5f, output);
+            output += 4;
+          }
+
+          process_scanline_span<Filter, T, SrcChannels, WrapUV>(ctx, uv_row, after, output);
+          continue;
         }
-        output += 4;
       }
+      process_scanline_span<Filter, T, SrcChannels, WrapUV>(ctx, uv_row, x_span, output);
     }
   }
 }
 
 template<eIMBInterpolationFilterMode Filter, typename T, int SrcChannels>
-static void transform_scanlines(const TransformContext &ctx, IndexRange y_range)
+static void transform_scanlines(const TransformContext &ctx,
+                                IndexRange y_range,
+                                IndexRange x_range)
 {
   switch (ctx.mode) {
     case IMB_TRANSFORM_MODE_REGULAR:
-      process_scanlines<Filter, T, SrcChannels, false, false>(ctx, y_range);
+      process_scanlines<Filter, T, SrcChannels, false, false>(ctx, y_range, x_range);
       break;
     case IMB_TRANSFORM_MODE_CROP_SRC:
-      process_scanlines<Filter, T, SrcChannels, true, false>(ctx, y_range);
+      process_scanlines<Filter, T, SrcChannels, true, false>(ctx, y_range, x_range);
       break;
     case IMB_TRANSFORM_MODE_WRAP_REPEAT:
-      process_scanlines<Filter, T, SrcChannels, false, true>(ctx, y_range);
+      process_scanlines<Filter, T, SrcChannels, false, true>(ctx, y_range, x_range);
       break;
     default:
       BLI_assert_unreachable();
@@ -336,30 +517,32 @@ static void transform_scanlines(const TransformContext &ctx, IndexRange y_range)
 }
 
 template<eIMBInterpolationFilterMode Filter>
-static void transform_scanlines_filter(const TransformContext &ctx, IndexRange y_range)
+static void transform_scanlines_filter(const TransformContext &ctx,
+                                       IndexRange y_range,
+                                       IndexRange x_range)
 {
   int channels = ctx.src->channels;
 
   if (ctx.dst->float_data() && ctx.src->float_data()) {
     /* Float pixels. */
     if (channels == 4) {
-      transform_scanlines<Filter, float, 4>(ctx, y_range);
+      transform_scanlines<Filter, float, 4>(ctx, y_range, x_range);
     }
     else if (channels == 3) {
-      transform_scanlines<Filter, float, 3>(ctx, y_range);
+      transform_scanlines<Filter, float, 3>(ctx, y_range, x_range);
     }
     else if (channels == 2) {
-      transform_scanlines<Filter, float, 2>(ctx, y_range);
+      transform_scanlines<Filter, float, 2>(ctx, y_range, x_range);
     }
     else if (channels == 1) {
-      transform_scanlines<Filter, float, 1>(ctx, y_range);
+      transform_scanlines<Filter, float, 1>(ctx, y_range, x_range);
     }
   }
 
   if (ctx.dst->byte_data() && ctx.src->byte_data()) {
     /* Byte pixels. */
     if (channels == 4) {
-      transform_scanlines<Filter, uchar, 4>(ctx, y_range);
+      transform_scanlines<Filter, uchar, 4>(ctx, y_range, x_range);
     }
   }
 }
@@ -479,21 +662,35 @@ void IMB_transform(const ImBuf *src,
   }
   ctx.init(transform_matrix, crop);
 
-  threading::parallel_for(ctx.dst_region_y_range, 8, [&](IndexRange y_range) {
-    if (filter == IMB_FILTER_NEAREST) {
-      transform_scanlines_filter<IMB_FILTER_NEAREST>(ctx, y_range);
-    }
-    else if (filter == IMB_FILTER_BILINEAR) {
-      transform_scanlines_filter<IMB_FILTER_BILINEAR>(ctx, y_range);
-    }
-    else if (filter == IMB_FILTER_CUBIC_BSPLINE) {
-      transform_scanlines_filter<IMB_FILTER_CUBIC_BSPLINE>(ctx, y_range);
-    }
-    else if (filter == IMB_FILTER_CUBIC_MITCHELL) {
-      transform_scanlines_filter<IMB_FILTER_CUBIC_MITCHELL>(ctx, y_range);
-    }
-    else if (filter == IMB_FILTER_BOX) {
-      transform_scanlines_filter<IMB_FILTER_BOX>(ctx, y_range);
+  /* Process the destination in tiles, so that rotated transforms read a compact region of the
+   * source image at a time. */
+  const int64_t tiles_x = (ctx.dst_region_x_range.size() + transform_tile_size - 1) /
+                          transform_tile_size;
+  const int64_t tiles_y = (ctx.dst_region_y_range.size() + transform_tile_size - 1) /
+                          transform_tile_size;
+  threading::parallel_for(IndexRange(tiles_x * tiles_y), 1, [&](IndexRange tile_range) {
+    for (const int64_t tile : tile_range) {
+      const IndexRange x_range = ctx.dst_region_x_range
+                                     .drop_front((tile % tiles_x) * transform_tile_size)
+                                     .take_front(transform_tile_size);
+      const IndexRange y_range = ctx.dst_region_y_range
+                                     .drop_front((tile / tiles_x) * transform_tile_size)
+                                     .take_front(transform_tile_size);
+      if (filter == IMB_FILTER_NEAREST) {
+        transform_scanlines_filter<IMB_FILTER_NEAREST>(ctx, y_range, x_range);
+      }
+      else if (filter == IMB_FILTER_BILINEAR) {
+        transform_scanlines_filter<IMB_FILTER_BILINEAR>(ctx, y_range, x_range);
+      }
+      else if (filter == IMB_FILTER_CUBIC_BSPLINE) {
+        transform_scanlines_filter<IMB_FILTER_CUBIC_BSPLINE>(ctx, y_range, x_range);
+      }
+      else if (filter == IMB_FILTER_CUBIC_MITCHELL) {
+        transform_scanlines_filter<IMB_FILTER_CUBIC_MITCHELL>(ctx, y_range, x_range);
+      }
+      else if (filter == IMB_FILTER_BOX) {
+        transform_scanlines_filter<IMB_FILTER_BOX>(ctx, y_range, x_range);
+      }
     }
   });
 
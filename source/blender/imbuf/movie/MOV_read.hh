@@ -141,6 +141,14 @@ IDProperty *MOV_load_metadata(MovieReader *anim);
  */
 void MOV_set_multiview_suffix(MovieReader *anim, const char *suffix);
 
+/**
+ * Sets the memory limit in bytes of the decoded frames which are kept from the most recently
+ * decoded GOP (group of pictures). This makes decoding frames in reverse order or jumping back
+ * by a few frames cheap, since the frames are not decoded again from the previous key frame.
+ * The cache is disabled by default.
+ */
+void MOV_set_gop_cache_limit(MovieReader *anim, size_t limit);
+
 /* -------------------------------------------------------------------- */
 /** \name Movie proxy related functionality
  * \{ */
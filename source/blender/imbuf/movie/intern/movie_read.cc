@@ -60,6 +60,7 @@ static CLG_LogRef LOG = {"video.read"};
 
 #ifdef WITH_FFMPEG
 static void free_anim_ffmpeg(MovieReader *anim);
+static void ffmpeg_gop_cache_trim(MovieReader *anim);
 #endif
 
 static bool anim_getnew(MovieReader *anim);
@@ -195,6 +196,14 @@ void MOV_set_multiview_suffix(MovieReader *anim, const char *suffix)
   STRNCPY(anim->suffix, suffix);
 }
 
+void MOV_set_gop_cache_limit(MovieReader *anim, const size_t limit)
+{
+  anim->gop_cache_limit = limit;
+#ifdef WITH_FFMPEG
+  ffmpeg_gop_cache_trim(anim);
+#endif
+}
+
 #ifdef WITH_FFMPEG
 
 static double ffmpeg_stream_start_time_get(const AVStream *stream)
@@ -718,7 +727,7 @@ static void ffmpeg_postprocess(MovieReader *anim, AVFrame *input, ImBuf *ibuf)
 
   if (flag_is_set(anim->ib_flags, ImBufFlags::Deinterlace)) {
     if (ffmpeg_deinterlace(anim->pFrameDeinterlaced,
-                           anim->pFrame,
+                           input,
                            anim->pCodecCtx->pix_fmt,
                            anim->pCodecCtx->width,
                            anim->pCodecCtx->height) < 0)
@@ -852,6 +861,100 @@ static AVFrame *ffmpeg_frame_by_pts_get(MovieReader *anim, int64_t pts_to_search
   return best_frame;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name GOP Cache
+ *
+ * Frames are decoded sequentially from the key frame of their GOP, so when seeking backwards,
+ * all frames from the key frame up to the requested one have to be decoded again. This makes
+ * reverse playback and scrubbing of long GOP movies very slow. To avoid this, the frames which
+ * are decoded are kept until a frame of the next GOP is decoded. The frames hold references to
+ * the decoded picture, so they are not copied, and are converted to an #ImBuf on request like
+ * any other decoded frame.
+ * \{ */
+
+static size_t ffmpeg_gop_cache_frame_size(const AVFrame *frame)
+{
+  const int size = av_image_get_buffer_size(
+      AVPixelFormat(frame->format), frame->width, frame->height, 1);
+  return std::max(size, 0);
+}
+
+static void ffmpeg_gop_cache_clear(MovieReader *anim)
+{
+  for (AVFrame *frame : anim->gop_cache_frames) {
+    av_frame_free(&frame);
+  }
+  anim->gop_cache_frames.clear();
+  anim->gop_cache_memory = 0;
+}
+
+/* Free frames until the cache fits its memory limit. The oldest frames are freed first, those
+ * are the furthest from the frames which are decoded next. */
+static void ffmpeg_gop_cache_trim(MovieReader *anim)
+{
+  int64_t frames_to_free = 0;
+  while (frames_to_free < anim->gop_cache_frames.size() &&
+         anim->gop_cache_memory > anim->gop_cache_limit)
+  {
+    AVFrame *frame = anim->gop_cache_frames[frames_to_free];
+    anim->gop_cache_memory -= ffmpeg_gop_cache_frame_size(frame);
+    av_frame_free(&frame);
+    frames_to_free++;
+  }
+  anim->gop_cache_frames.remove(0, frames_to_free);
+}
+
+/* Store the frame which was just decoded into `anim->pFrame`. */
+static void ffmpeg_gop_cache_store(MovieReader *anim, const bool is_key_frame)
+{
+  if (anim->gop_cache_limit == 0 || anim->never_seek_decode_one_frame) {
+    return;
+  }
+
+  /* Frames of the previous GOP are not needed anymore when playing forward, and when playing
+   * backwards the next requested frame is in the new GOP. */
+  if (is_key_frame) {
+    ffmpeg_gop_cache_clear(anim);
+  }
+
+  /* Frames are kept in presentation order, which is the order in which they are decoded, unless
+   * the decoder was flushed by a seek in the middle of a GOP. */
+  const int64_t pts = av_get_pts_from_frame(anim->pFrame);
+  if (!anim->gop_cache_frames.is_empty() &&
+      av_get_pts_from_frame(anim->gop_cache_frames.last()) >= pts)
+  {
+    ffmpeg_gop_cache_clear(anim);
+  }
+
+  AVFrame *frame = av_frame_clone(anim->pFrame);
+  if (frame == nullptr) {
+    return;
+  }
+  anim->gop_cache_frames.append(frame);
+  anim->gop_cache_memory += ffmpeg_gop_cache_frame_size(frame);
+  ffmpeg_gop_cache_trim(anim);
+}
+
+/* Return the cached frame which matches `pts_to_search`, nullptr if there is no such frame. */
+static AVFrame *ffmpeg_gop_cache_lookup(MovieReader *anim, int64_t pts_to_search)
+{
+  /* As noted in #ffmpeg_frame_by_pts_get, the frame duration is not reliable, so a frame ends
+   * where the next one starts. The last frame is skipped, it is the frame at the decoder position,
+   * which is handled without the cache. */
+  const Span<AVFrame *> frames = anim->gop_cache_frames;
+  for (const int64_t i : frames.index_range().drop_back(1)) {
+    const int64_t frame_start = av_get_pts_from_frame(frames[i]);
+    const int64_t frame_end = av_get_pts_from_frame(frames[i + 1]);
+    if (ffmpeg_pts_isect(frame_start, frame_end, pts_to_search)) {
+      final_frame_log(anim, frame_start, frame_end, "GOP cache");
+      return frames[i];
+    }
+  }
+  return nullptr;
+}
+
+/** \} */
+
 static void ffmpeg_decode_store_frame_pts(MovieReader *anim)
 {
   anim->cur_pts = av_get_pts_from_frame(anim->pFrame);
@@ -863,6 +966,10 @@ static void ffmpeg_decode_store_frame_pts(MovieReader *anim)
 #  endif
   {
     anim->cur_key_frame_pts = anim->cur_pts;
+    ffmpeg_gop_cache_store(anim, true);
+  }
+  else {
+    ffmpeg_gop_cache_store(anim, false);
   }
 
   av_log(anim->pFormatCtx,
@@ -1214,6 +1321,10 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position)
   double pts_time_base = av_q2d(v_st->time_base);
   int64_t start_pts = v_st->start_time;
 
+  /* Frame from the GOP cache, in which case the decoder position is not changed, so that the
+   * decoder can continue to decode following frames without seeking. */
+  AVFrame *cached_frame = nullptr;
+
   if (anim->never_seek_decode_one_frame) {
     /* If we must only ever decode one frame, and never seek, do so here. */
     if (!anim->pFrame_complete) {
@@ -1232,6 +1343,9 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position)
            start_pts);
 
     if (ffmpeg_must_decode(anim, position)) {
+      cached_frame = ffmpeg_gop_cache_lookup(anim, pts_to_search);
+    }
+    if (cached_frame == nullptr && ffmpeg_must_decode(anim, position)) {
       if (ffmpeg_must_seek(anim, position)) {
         ffmpeg_seek_to_key_frame(anim, position, pts_to_search);
       }
@@ -1266,7 +1380,8 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position)
     cur_frame_final->assign_byte_data(buffer_data);
   }
 
-  AVFrame *final_frame = ffmpeg_frame_by_pts_get(anim, pts_to_search);
+  AVFrame *final_frame = cached_frame ? cached_frame :
+                                        ffmpeg_frame_by_pts_get(anim, pts_to_search);
   if (final_frame == nullptr) {
     /* No valid frame was decoded for requested PTS, fall back on most recent decoded frame, even
      * if it is incorrect. */
@@ -1304,7 +1419,9 @@ static ImBuf *ffmpeg_fetchibuf(MovieReader *anim, int position)
     cur_frame_final->byte_buffer.colorspace = colormanage_colorspace_get_named(anim->colorspace);
   }
 
-  anim->cur_position = position;
+  if (cached_frame == nullptr) {
+    anim->cur_position = position;
+  }
 
   return cur_frame_final;
 }
@@ -1323,6 +1440,7 @@ static void free_anim_ffmpeg(MovieReader *anim)
     av_frame_free(&anim->pFrame);
     av_frame_free(&anim->pFrame_backup);
     av_frame_free(&anim->pFrameRGB);
+    ffmpeg_gop_cache_clear(anim);
     if (anim->pFrameDeinterlaced->data[0] != nullptr) {
       MEM_delete(anim->pFrameDeinterlaced->data[0]);
     }
@@ -1427,15 +1545,12 @@ ImBuf *MOV_decode_frame(MovieReader *anim, int position, IMB_Proxy_Size preview_
 #ifdef WITH_FFMPEG
   if (anim->state == MovieReader::State::Valid) {
     ibuf = ffmpeg_fetchibuf(anim, position);
-    if (ibuf) {
-      anim->cur_position = position;
-    }
   }
 #endif
 
   if (ibuf) {
     ibuf->filepath = anim->filepath;
-    ibuf->fileframe = anim->cur_position + 1;
+    ibuf->fileframe = position + 1;
   }
   return ibuf;
 }
@@ -11,6 +11,8 @@
 
 #include <cstdint>
 
+#include "BLI_vector.hh"
+
 #include "IMB_imbuf_enums.h"
 
 struct AVFormatContext;
@@ -81,8 +83,17 @@ struct MovieReader {
    * ffmpeg crashes/aborts when trying to seek within them
    * (https://trac.ffmpeg.org/ticket/10755). */
   bool never_seek_decode_one_frame = false;
+
+  /* Decoded frames of the most recently decoded GOP in presentation order. Frames before the
+   * decoder position are returned from here, instead of seeking back to the key frame and
+   * decoding the GOP again. */
+  Vector<AVFrame *> gop_cache_frames;
+  size_t gop_cache_memory = 0;
 #endif
 
+  /* Memory limit of the GOP cache in bytes, the cache is disabled when zero. */
+  size_t gop_cache_limit = 0;
+
   char proxy_dir[768] = {};
 
   int proxies_tried = 0;
@@ -10,6 +10,7 @@
 #include "OCIO_display.hh"
 #include "OCIO_gpu_shader_binder.hh"
 #include "OCIO_look.hh"
+#include "OCIO_lut_cpu_processor.hh"
 #include "OCIO_matrix.hh"
 #include "OCIO_packed_image.hh"
 #include "OCIO_role_names.hh"
@@ -0,0 +1,84 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <memory>
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "MEM_guardedalloc.h"
+
+#include "OCIO_cpu_processor.hh"
+
+namespace blender::ocio {
+
+/**
+ * Processor which approximates another processor with a 3D LUT, baked once and then applied with
+ * tetrahedral interpolation. This is much cheaper than evaluating the full transform for every
+ * pixel, which makes a difference for display transforms of large images.
+ *
+ * The LUT is sampled on a logarithmic 1D shaper of the input values, so that it has enough
+ * precision for dark colors and covers values above 1. The shaper domain is
+ * [0, #LUTCPUProcessor::max_input], values outside of it are clamped. Only the RGB channels are
+ * transformed, alpha is left unchanged.
+ *
+ * The LUT is meant for SDR displays: only output values in [0, 1] are required to match the
+ * approximated processor.
+ */
+class LUTCPUProcessor : public CPUProcessor {
+ public:
+  /* Number of lattice points along every axis of the LUT. */
+  static constexpr int lut_size = 65;
+  /* Offset of input values in the shaper, which defines the precision of dark colors. */
+  static constexpr float shaper_offset = 1.0f / 256.0f;
+  /* Lattice index of the input value 1, so that the clipping of display transforms at 1 is exactly
+   * on a lattice point. The lattice points above cover the range up to #max_input. */
+  static constexpr int shaper_one_index = 40;
+
+ private:
+  /* Lattice of output colors, with the red axis varying fastest. The fourth component is padding
+   * for SIMD loads. Shared by the processors with a different input scale. */
+  std::shared_ptr<const Array<float4>> lut_;
+  /* Scale of the input values before the LUT is applied. */
+  float input_scale_ = 1.0f;
+
+ public:
+  /**
+   * Bake the LUT of the given processor. The LUT is compared against the processor for a set of
+   * test colors, and nullptr is returned when the difference of the outputs clamped to [0, 1] is
+   * larger than the given maximum error. The test colors include negative values and values
+   * above the shaper domain, so that processors which are not constant where the input is
+   * clamped are not approximated.
+   */
+  static std::unique_ptr<LUTCPUProcessor> create(const CPUProcessor &processor, float max_error);
+
+  /**
+   * Processor which multiplies the input values by the given scale before applying the same LUT.
+   * Matches a processor which applies the scale before the baked transform, like the exposure of
+   * display transforms of scene linear input does.
+   */
+  std::unique_ptr<LUTCPUProcessor> with_input_scale(float scale) const;
+
+  /** Largest input value which is not clamped by the shaper. */
+  static float max_input();
+
+  bool is_noop() const override
+  {
+    return false;
+  }
+
+  void apply_rgb(float rgb[3]) const override;
+  void apply_rgba(float rgba[4]) const override;
+
+  void apply_rgba_predivide(float rgba[4]) const override;
+
+  void apply(const PackedImage &image) const override;
+  void apply_predivide(const PackedImage &image) const override;
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("LUTCPUProcessor");
+};
+
+}  // namespace blender::ocio
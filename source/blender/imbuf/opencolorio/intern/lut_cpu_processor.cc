@@ -0,0 +1,334 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <algorithm>
+#include <cmath>
+
+#include "BLI_assert.hh"
+#include "BLI_rand.hh"
+#include "BLI_simd.hh"
+#include "BLI_utildefines.hh"
+
+#include "OCIO_lut_cpu_processor.hh"
+#include "OCIO_packed_image.hh"
+
+namespace blender::ocio {
+
+/* Number of random colors the LUT is compared against the processor for. */
+static constexpr int test_colors_num = 4096;
+/* Range of the test values outside of the shaper domain, in stops. Negative values go from minus
+ * the shaper offset to -1, values above the domain up to 64 times its maximum. */
+static constexpr float test_negative_stops = 8.0f;
+static constexpr float test_above_domain_stops = 6.0f;
+
+/* -------------------------------------------------------------------- */
+/** \name Shaper
+ *
+ * Maps input values to continuous lattice coordinates as log2(x + offset), scaled such that the
+ * lattice point #LUTCPUProcessor::shaper_one_index is the input value 1.
+ * \{ */
+
+struct Shaper {
+  float log_min;
+  float step;
+  float inv_step;
+  float max_input;
+};
+
+static Shaper shaper_create()
+{
+  Shaper shaper;
+  shaper.log_min = std::log2(LUTCPUProcessor::shaper_offset);
+  shaper.step = (std::log2(1.0f + LUTCPUProcessor::shaper_offset) - shaper.log_min) /
+                LUTCPUProcessor::shaper_one_index;
+  shaper.inv_step = 1.0f / shaper.step;
+  shaper.max_input = std::exp2(shaper.log_min +
+                               (LUTCPUProcessor::lut_size - 1) * shaper.step) -
+                     LUTCPUProcessor::shaper_offset;
+  return shaper;
+}
+
+static const Shaper &shaper_get()
+{
+  static const Shaper shaper = shaper_create();
+  return shaper;
+}
+
+static float shaper_input_to_lattice(const Shaper &shaper, const float value)
+{
+  /* Written such that NaN is mapped to zero. */
+  const float clamped_value = value > 0.0f ? std::min(value, shaper.max_input) : 0.0f;
+  const float coord = (std::log2(clamped_value + LUTCPUProcessor::shaper_offset) -
+                       shaper.log_min) *
+                      shaper.inv_step;
+  return std::clamp(coord, 0.0f, float(LUTCPUProcessor::lut_size - 1));
+}
+
+static float shaper_lattice_to_input(const Shaper &shaper, const float coord)
+{
+  return std::exp2(shaper.log_min + coord * shaper.step) - LUTCPUProcessor::shaper_offset;
+}
+
+/**
+ * Random test value for the accuracy check, mostly in the shaper domain. One in ten values is
+ * negative and one in ten is above the domain, so that transforms which are not constant where
+ * the shaper clamps the input fail the check.
+ */
+static float shaper_test_value(const Shaper &shaper, RandomNumberGenerator &rng)
+{
+  const float kind = rng.get_float();
+  if (kind < 0.1f) {
+    return -LUTCPUProcessor::shaper_offset * std::exp2(rng.get_float() * test_negative_stops);
+  }
+  if (kind < 0.2f) {
+    return shaper.max_input * std::exp2(rng.get_float() * test_above_domain_stops);
+  }
+  return shaper_lattice_to_input(shaper, rng.get_float() * (LUTCPUProcessor::lut_size - 1));
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Tetrahedral Interpolation
+ * \{ */
+
+static void lut_interpolate(const float4 *lut,
+                            const float input_scale,
+                            const float rgb[3],
+                            float r_rgb[3])
+{
+  constexpr int size = LUTCPUProcessor::lut_size;
+  constexpr int64_t stride_r = 1;
+  constexpr int64_t stride_g = size;
+  constexpr int64_t stride_b = int64_t(size) * size;
+
+  const Shaper &shaper = shaper_get();
+  int index[3];
+  float frac[3];
+  for (int i = 0; i < 3; i++) {
+    const float coord = shaper_input_to_lattice(shaper, rgb[i] * input_scale);
+    index[i] = std::min(int(coord), size - 2);
+    frac[i] = coord - index[i];
+  }
+  const float fr = frac[0];
+  const float fg = frac[1];
+  const float fb = frac[2];
+
+  /* The lattice cube is split into six tetrahedra along its diagonal, all of which contain the
+   * first and the last corner of the cube. The tetrahedron containing the color is given by the
+   * order of the fractions, and the color is interpolated from its four corners. */
+  int64_t offset1, offset2;
+  float w0, w1, w2, w3;
+  if (fr > fg) {
+    if (fg > fb) {
+      offset1 = stride_r;
+      offset2 = stride_r + stride_g;
+      w0 = 1.0f - fr, w1 = fr - fg, w2 = fg - fb, w3 = fb;
+    }
+    else if (fr > fb) {
+      offset1 = stride_r;
+      offset2 = stride_r + stride_b;
+      w0 = 1.0f - fr, w1 = fr - fb, w2 = fb - fg, w3 = fg;
+    }
+    else {
+      offset1 = stride_b;
+      offset2 = stride_r + stride_b;
+      w0 = 1.0f - fb, w1 = fb - fr, w2 = fr - fg, w3 = fg;
+    }
+  }
+  else {
+    if (fb > fg) {
+      offset1 = stride_b;
+      offset2 = stride_g + stride_b;
+      w0 = 1.0f - fb, w1 = fb - fg, w2 = fg - fr, w3 = fr;
+    }
+    else if (fb > fr) {
+      offset1 = stride_g;
+      offset2 = stride_g + stride_b;
+      w0 = 1.0f - fg, w1 = fg - fb, w2 = fb - fr, w3 = fr;
+    }
+    else {
+      offset1 = stride_g;
+      offset2 = stride_r + stride_g;
+      w0 = 1.0f - fg, w1 = fg - fr, w2 = fr - fb, w3 = fb;
+    }
+  }
+  constexpr int64_t offset3 = stride_r + stride_g + stride_b;
+
+  const float4 *corner = lut + index[2] * stride_b + index[1] * stride_g + index[0];
+#if BLI_HAVE_SSE2
+  __m128 result = _mm_mul_ps(_mm_loadu_ps(&corner[0].x), _mm_set1_ps(w0));
+  result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&corner[offset1].x), _mm_set1_ps(w1)));
+  result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&corner[offset2].x), _mm_set1_ps(w2)));
+  result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(&corner[offset3].x), _mm_set1_ps(w3)));
+  float4 color;
+  _mm_storeu_ps(&color.x, result);
+#else
+  const float4 color = corner[0] * w0 + corner[offset1] * w1 + corner[offset2] * w2 +
+                       corner[offset3] * w3;
+#endif
+  r_rgb[0] = color.x;
+  r_rgb[1] = color.y;
+  r_rgb[2] = color.z;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name LUT Processor
+ * \{ */
+
+float LUTCPUProcessor::max_input()
+{
+  return shaper_get().max_input;
+}
+
+std::unique_ptr<LUTCPUProcessor> LUTCPUProcessor::create(const CPUProcessor &processor,
+                                                         const float max_error)
+{
+  const Shaper &shaper = shaper_get();
+  const int64_t lattice_size = int64_t(lut_size) * lut_size * lut_size;
+
+  /* Evaluate the processor for all lattice points at once, which is much faster than evaluating
+   * it one point at a time. */
+  Array<float> lattice(lattice_size * 3);
+  float *lattice_color = lattice.data();
+  for (int b = 0; b < lut_size; b++) {
+    for (int g = 0; g < lut_size; g++) {
+      for (int r = 0; r < lut_size; r++, lattice_color += 3) {
+        lattice_color[0] = shaper_lattice_to_input(shaper, r);
+        lattice_color[1] = shaper_lattice_to_input(shaper, g);
+        lattice_color[2] = shaper_lattice_to_input(shaper, b);
+      }
+    }
+  }
+  processor.apply(PackedImage(lattice.data(),
+                              lut_size,
+                              size_t(lut_size) * lut_size,
+                              3,
+                              BitDepth::BIT_DEPTH_F32,
+                              sizeof(float),
+                              3 * sizeof(float),
+                              3 * sizeof(float) * lut_size));
+
+  std::shared_ptr<Array<float4>> lut = std::make_shared<Array<float4>>(lattice_size);
+  for (const int64_t i : IndexRange(lattice_size)) {
+    const float3 color(&lattice[i * 3]);
+    if (!std::isfinite(color.x) || !std::isfinite(color.y) || !std::isfinite(color.z)) {
+      return nullptr;
+    }
+    (*lut)[i] = float4(color, 0.0f);
+  }
+  std::unique_ptr<LUTCPUProcessor> lut_processor = std::make_unique<LUTCPUProcessor>();
+  lut_processor->lut_ = std::move(lut);
+
+  /* Transforms with sharp discontinuities between lattice points can not be approximated by the
+   * LUT, neither can transforms which still change where the input is clamped by the shaper. Check
+   * the result against the processor before using it. */
+  RandomNumberGenerator rng(0);
+  for (int i = 0; i < test_colors_num; i++) {
+    float expected[3];
+    for (int c = 0; c < 3; c++) {
+      expected[c] = shaper_test_value(shaper, rng);
+    }
+    float result[3] = {expected[0], expected[1], expected[2]};
+    processor.apply_rgb(expected);
+    lut_processor->apply_rgb(result);
+    for (int c = 0; c < 3; c++) {
+      const float difference = std::clamp(result[c], 0.0f, 1.0f) -
+                               std::clamp(expected[c], 0.0f, 1.0f);
+      /* Written such that NaN fails the check. */
+      if (!(std::abs(difference) <= max_error)) {
+        return nullptr;
+      }
+    }
+  }
+
+  return lut_processor;
+}
+
+std::unique_ptr<LUTCPUProcessor> LUTCPUProcessor::with_input_scale(const float scale) const
+{
+  std::unique_ptr<LUTCPUProcessor> lut_processor = std::make_unique<LUTCPUProcessor>();
+  lut_processor->lut_ = lut_;
+  lut_processor->input_scale_ = input_scale_ * scale;
+  return lut_processor;
+}
+
+void LUTCPUProcessor::apply_rgb(float rgb[3]) const
+{
+  lut_interpolate(lut_->data(), input_scale_, rgb, rgb);
+}
+
+void LUTCPUProcessor::apply_rgba(float rgba[4]) const
+{
+  lut_interpolate(lut_->data(), input_scale_, rgba, rgba);
+}
+
+void LUTCPUProcessor::apply_rgba_predivide(float rgba[4]) const
+{
+  if (ELEM(rgba[3], 1.0f, 0.0f)) {
+    apply_rgba(rgba);
+    return;
+  }
+
+  const float alpha = rgba[3];
+  const float inv_alpha = 1.0f / alpha;
+
+  rgba[0] *= inv_alpha;
+  rgba[1] *= inv_alpha;
+  rgba[2] *= inv_alpha;
+
+  apply_rgba(rgba);
+
+  rgba[0] *= alpha;
+  rgba[1] *= alpha;
+  rgba[2] *= alpha;
+}
+
+void LUTCPUProcessor::apply(const PackedImage &image) const
+{
+  if (image.get_bit_depth() != BitDepth::BIT_DEPTH_F32 || image.get_num_channels() < 3) {
+    return;
+  }
+  BLI_assert(image.get_chan_stride_in_bytes() == sizeof(float));
+
+  const size_t width = image.get_width();
+  const size_t height = image.get_height();
+  const size_t x_stride = image.get_x_stride_in_bytes();
+  const size_t y_stride = image.get_y_stride_in_bytes();
+  char *data = static_cast<char *>(image.get_data());
+
+  for (size_t y = 0; y < height; y++) {
+    for (size_t x = 0; x < width; x++) {
+      float *pixel = reinterpret_cast<float *>(data + y * y_stride + x * x_stride);
+      lut_interpolate(lut_->data(), input_scale_, pixel, pixel);
+    }
+  }
+}
+
+void LUTCPUProcessor::apply_predivide(const PackedImage &image) const
+{
+  if (image.get_bit_depth() != BitDepth::BIT_DEPTH_F32 || image.get_num_channels() < 4) {
+    apply(image);
+    return;
+  }
+  BLI_assert(image.get_chan_stride_in_bytes() == sizeof(float));
+
+  const size_t width = image.get_width();
+  const size_t height = image.get_height();
+  const size_t x_stride = image.get_x_stride_in_bytes();
+  const size_t y_stride = image.get_y_stride_in_bytes();
+  char *data = static_cast<char *>(image.get_data());
+
+  for (size_t y = 0; y < height; y++) {
+    for (size_t x = 0; x < width; x++) {
+      apply_rgba_predivide(reinterpret_cast<float *>(data + y * y_stride + x * x_stride));
+    }
+  }
+}
+
+/** \} */
+
+}  // namespace blender::ocio
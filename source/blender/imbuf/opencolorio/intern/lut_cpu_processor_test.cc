@@ -0,0 +1,131 @@
+/* SPDX-FileCopyrightText: 2026 Blender Authors
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "OCIO_lut_cpu_processor.hh"
+
+#include "fallback/fallback_cpu_processor.hh"
+
+#include "testing/testing.h"
+
+namespace blender::ocio {
+
+static void clip_to_unit_range(float dst[3], const float src[3])
+{
+  for (int i = 0; i < 3; i++) {
+    dst[i] = std::clamp(src[i], 0.0f, 1.0f);
+  }
+}
+
+static void threshold(float dst[3], const float src[3])
+{
+  for (int i = 0; i < 3; i++) {
+    dst[i] = src[i] > 0.3f ? 1.0f : 0.0f;
+  }
+}
+
+static void absolute_value(float dst[3], const float src[3])
+{
+  for (int i = 0; i < 3; i++) {
+    dst[i] = std::min(std::abs(src[i]), 1.0f);
+  }
+}
+
+/** Tone mapping which reaches the display white point far above the shaper domain. */
+static void tone_map_wide_range(float dst[3], const float src[3])
+{
+  for (int i = 0; i < 3; i++) {
+    dst[i] = std::max(src[i], 0.0f) / (std::max(src[i], 0.0f) + 1000.0f);
+  }
+}
+
+template<int Stops> static void exposure_to_srgb(float dst[3], const float src[3])
+{
+  const float scale = std::exp2(float(Stops));
+  float scaled[3] = {src[0] * scale, src[1] * scale, src[2] * scale};
+  linearrgb_to_srgb_v3_v3(dst, scaled);
+}
+
+TEST(ocio_lut_cpu_processor, linear_to_srgb)
+{
+  const FallbackLinearRGBToSRGBCPUProcessor processor;
+  std::unique_ptr<LUTCPUProcessor> lut_processor = LUTCPUProcessor::create(processor, 2e-3f);
+  ASSERT_NE(lut_processor, nullptr);
+
+  const float colors[][3] = {
+      {0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.18f, 0.5f, 0.02f}, {2.0f, 0.001f, 10.0f}};
+  for (const float *color : colors) {
+    float expected[4] = {color[0], color[1], color[2], 0.5f};
+    float result[4] = {color[0], color[1], color[2], 0.5f};
+    processor.apply_rgba(expected);
+    lut_processor->apply_rgba(result);
+    for (int i = 0; i < 3; i++) {
+      EXPECT_NEAR(result[i], expected[i], 2e-3f * std::max(1.0f, expected[i]));
+    }
+    EXPECT_EQ(result[3], 0.5f);
+  }
+}
+
+TEST(ocio_lut_cpu_processor, clipping)
+{
+  /* The value 1 is on a lattice point, so clipping at 1 is exact, even though linear parts of the
+   * transform are only approximated by the logarithmic lattice. */
+  const FallbackCustomCPUProcessor<clip_to_unit_range> processor;
+  std::unique_ptr<LUTCPUProcessor> lut_processor = LUTCPUProcessor::create(processor, 3e-3f);
+  ASSERT_NE(lut_processor, nullptr);
+
+  float color[3] = {1.0f, 4.0f, LUTCPUProcessor::max_input() * 2.0f};
+  lut_processor->apply_rgb(color);
+  EXPECT_NEAR(color[0], 1.0f, 1e-4f);
+  EXPECT_NEAR(color[1], 1.0f, 1e-4f);
+  EXPECT_NEAR(color[2], 1.0f, 1e-4f);
+}
+
+TEST(ocio_lut_cpu_processor, negative_exposure)
+{
+  /* Values above 1 are clipped by the display, so a negative exposure can be baked as long as the
+   * inputs which map to 1 are in the shaper domain. */
+  const FallbackCustomCPUProcessor<exposure_to_srgb<-4>> processor;
+  EXPECT_NE(LUTCPUProcessor::create(processor, 2e-3f), nullptr);
+  const FallbackCustomCPUProcessor<exposure_to_srgb<-10>> dark_processor;
+  EXPECT_EQ(LUTCPUProcessor::create(dark_processor, 2e-3f), nullptr);
+}
+
+TEST(ocio_lut_cpu_processor, input_scale)
+{
+  /* Scaling the input of the LUT covers any exposure. */
+  const FallbackLinearRGBToSRGBCPUProcessor processor;
+  std::unique_ptr<LUTCPUProcessor> lut_processor = LUTCPUProcessor::create(processor, 2e-3f);
+  ASSERT_NE(lut_processor, nullptr);
+  std::unique_ptr<LUTCPUProcessor> dark_lut_processor = lut_processor->with_input_scale(
+      std::exp2(-10.0f));
+
+  const FallbackCustomCPUProcessor<exposure_to_srgb<-10>> dark_processor;
+  const float colors[][3] = {{0.0f, 10.0f, 100.0f}, {1000.0f, 1024.0f, 5000.0f}};
+  for (const float *color : colors) {
+    float expected[3] = {color[0], color[1], color[2]};
+    float result[3] = {color[0], color[1], color[2]};
+    dark_processor.apply_rgb(expected);
+    dark_lut_processor->apply_rgb(result);
+    for (int i = 0; i < 3; i++) {
+      EXPECT_NEAR(std::min(result[i], 1.0f), std::min(expected[i], 1.0f), 2e-3f);
+    }
+  }
+}
+
+TEST(ocio_lut_cpu_processor, out_of_domain)
+{
+  const FallbackCustomCPUProcessor<tone_map_wide_range> processor;
+  EXPECT_EQ(LUTCPUProcessor::create(processor, 2e-3f), nullptr);
+
+  const FallbackCustomCPUProcessor<absolute_value> negative_processor;
+  EXPECT_EQ(LUTCPUProcessor::create(negative_processor, 2e-3f), nullptr);
+}
+
+TEST(ocio_lut_cpu_processor, discontinuity)
+{
+  const FallbackCustomCPUProcessor<threshold> processor;
+  EXPECT_EQ(LUTCPUProcessor::create(processor, 1e-3f), nullptr);
+}
+
+}  // namespace blender::ocio
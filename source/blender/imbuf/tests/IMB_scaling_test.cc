@@ -5,6 +5,7 @@
 #include "testing/testing.h"
 
 #include "BLI_math_vector_types.hh"
+#include "BLI_timeit.hh"
 
 #include "IMB_imbuf.hh"
 
@@ -299,4 +300,105 @@ TEST_F(ImBufScalingTest, threaded_2x_smaller_fl4)
   IMB_freeImBuf(res);
 }
 
+static ImBuf *create_constant_test_image(int width, int height, bool use_float)
+{
+  ImBuf *img = IMB_allocImBuf(width, height, use_float ? ImBufFlags::FloatData :
+                                                         ImBufFlags::ByteData);
+  const int64_t pixels = int64_t(width) * height;
+  if (use_float) {
+    float4 *col = reinterpret_cast<float4 *>(img->float_data_for_write());
+    std::fill_n(col, pixels, float4(0.25f, 0.5f, 0.75f, 1.0f));
+  }
+  else {
+    uchar4 *col = reinterpret_cast<uchar4 *>(img->byte_data_for_write());
+    std::fill_n(col, pixels, uchar4(40, 120, 200, 255));
+  }
+  return img;
+}
+
+TEST_F(ImBufScalingTest, filter_constant_image)
+{
+  for (const IMBScaleFilter filter : {IMBScaleFilter::Mitchell, IMBScaleFilter::Lanczos3}) {
+    for (const int2 size : {int2(3, 2), int2(7, 5), int2(37, 29)}) {
+      ImBuf *res = create_constant_test_image(13, 11, false);
+      IMB_scale(res, size, filter, true);
+      const uchar4 *got = reinterpret_cast<const uchar4 *>(res->byte_data());
+      for (int i = 0; i < size.x * size.y; i++) {
+        EXPECT_EQ(uint4(got[i]), uint4(40, 120, 200, 255));
+      }
+      IMB_freeImBuf(res);
+
+      res = create_constant_test_image(13, 11, true);
+      IMB_scale(res, size, filter, false);
+      const float4 *got_fl = reinterpret_cast<const float4 *>(res->float_data());
+      for (int i = 0; i < size.x * size.y; i++) {
+        EXPECT_V4_NEAR(got_fl[i], float4(0.25f, 0.5f, 0.75f, 1.0f), EPS);
+      }
+      IMB_freeImBuf(res);
+    }
+  }
+}
+
+TEST_F(ImBufScalingTest, mitchell_2x_smaller_fl3)
+{
+  ImBuf *res = create_6x2_test_image_fl(3);
+  IMB_scale(res, int2(3, 1), IMBScaleFilter::Mitchell, false);
+  const float3 *got = reinterpret_cast<const float3 *>(res->float_data());
+  /* Symmetric filter footprint around the center pixel keeps the linear gradient. */
+  EXPECT_V3_NEAR(got[1], float3(3.375f, 3.5f, 3.625f), EPS);
+  EXPECT_LT(got[0].x, got[1].x);
+  EXPECT_LT(got[1].x, got[2].x);
+  IMB_freeImBuf(res);
+}
+
+TEST_F(ImBufScalingTest, lanczos3_2x_smaller_fl4)
+{
+  ImBuf *res = create_6x2_test_image_fl(4);
+  IMB_scale(res, int2(3, 1), IMBScaleFilter::Lanczos3, true);
+  const float4 *got = reinterpret_cast<const float4 *>(res->float_data());
+  EXPECT_V4_NEAR(got[1], float4(3.375f, 3.5f, 3.625f, 3.75f), EPS);
+  EXPECT_LT(got[0].x, got[1].x);
+  EXPECT_LT(got[1].x, got[2].x);
+  IMB_freeImBuf(res);
+}
+
+TEST_F(ImBufScalingTest, lanczos3_into_new)
+{
+  ImBuf *img = create_6x2_test_image();
+  ImBuf *res = IMB_scale_into_new(img, int2(3, 1), IMBScaleFilter::Lanczos3, false);
+  ASSERT_NE(res, nullptr);
+  ASSERT_NE(res->byte_data(), nullptr);
+  EXPECT_EQ(res->x, 3);
+  EXPECT_EQ(res->y, 1);
+  IMB_freeImBuf(res);
+  IMB_freeImBuf(img);
+}
+
+/* Enable to compare performance of the scaling filters. */
+#if 0
+TEST_F(ImBufScalingTest, performance)
+{
+  const int2 src_size(3840, 2160);
+  for (const bool use_float : {false, true}) {
+    for (const int2 size : {int2(1920, 1080), int2(5000, 3000)}) {
+      for (const IMBScaleFilter filter : {IMBScaleFilter::Nearest,
+                                          IMBScaleFilter::Bilinear,
+                                          IMBScaleFilter::Box,
+                                          IMBScaleFilter::Mitchell,
+                                          IMBScaleFilter::Lanczos3})
+      {
+        ImBuf *img = create_constant_test_image(src_size.x, src_size.y, use_float);
+        {
+          SCOPED_TIMER(std::string(use_float ? "float " : "byte ") + std::to_string(size.x) +
+                       "x" + std::to_string(size.y) + " filter " +
+                       std::to_string(int(filter)));
+          IMB_scale(img, size, filter, true);
+        }
+        IMB_freeImBuf(img);
+      }
+    }
+  }
+}
+#endif
+
 }  // namespace blender::imbuf::tests
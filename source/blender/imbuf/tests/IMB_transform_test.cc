@@ -5,8 +5,11 @@
 #include "testing/testing.h"
 
 #include "BLI_color_types.hh"
+#include "BLI_math_interp.hh"
 #include "BLI_math_matrix.hh"
 #include "BLI_math_quaternion_types.hh"
+#include "BLI_rect.hh"
+#include "BLI_timeit.hh"
 
 #include "IMB_imbuf.hh"
 
@@ -158,4 +161,118 @@ TEST_F(ImBufTransformTest, nearest_very_large_scale)
   IMB_freeImBuf(res);
 }
 
+static ImBuf *create_gradient_test_image_fl(int width, int height)
+{
+  ImBuf *img = IMB_allocImBuf(width, height, ImBufFlags::FloatData);
+  float4 *col = reinterpret_cast<float4 *>(img->float_data_for_write());
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      col[y * width + x] = float4(x * 0.01f, y * 0.02f, (x ^ y) * 0.003f, 1.0f);
+    }
+  }
+  return img;
+}
+
+/**
+ * Compare the result of a bilinear transform with sampling each destination pixel individually
+ * with #math::interpolate_bilinear_fl, at the coordinates #IMB_transform uses.
+ */
+static void expect_bilinear_matches_sampling(const float3x3 &matrix)
+{
+  ImBuf *src = create_gradient_test_image_fl(150, 110);
+  ImBuf *res = IMB_allocImBuf(170, 130, ImBufFlags::FloatData);
+  IMB_transform(src, res, IMB_TRANSFORM_MODE_REGULAR, IMB_FILTER_BILINEAR, matrix, nullptr);
+
+  const float2 add_x = matrix.x_axis().xy();
+  const float2 add_y = matrix.y_axis().xy();
+  const float2 start = matrix.location().xy() + add_x * 0.5f + add_y * 0.5f;
+  const float4 *got = reinterpret_cast<const float4 *>(res->float_data());
+  int mismatches = 0;
+  for (int y = 0; y < res->y; y++) {
+    const float2 uv_row = start + y * add_y;
+    for (int x = 0; x < res->x; x++) {
+      const float2 uv = uv_row + x * add_x;
+      const float4 expect = math::interpolate_bilinear_fl(
+          src->float_data(), src->x, src->y, uv.x - 0.5f, uv.y - 0.5f);
+      if (got[y * res->x + x] != expect) {
+        mismatches++;
+      }
+    }
+  }
+  EXPECT_EQ(mismatches, 0);
+  IMB_freeImBuf(src);
+  IMB_freeImBuf(res);
+}
+
+TEST_F(ImBufTransformTest, bilinear_rotated_matches_sampling)
+{
+  /* Large enough for several tiles, the interior fast path and the edge handling of the
+   * bilinear sampler must give exactly the same result as sampling each pixel individually. */
+  expect_bilinear_matches_sampling(
+      math::from_loc_rot_scale<float3x3>(float2(-20.0f, 15.0f), 0.3f, float2(1.1f, 0.9f)));
+  /* Fractional steps, where rounding of the sample coordinates differs most easily. */
+  expect_bilinear_matches_sampling(
+      math::from_loc_rot_scale<float3x3>(float2(0.1f, -0.3f), -0.7f, float2(0.37f, 0.61f)));
+  /* Without rotation the sample coordinates of a row are constant along the Y axis. */
+  expect_bilinear_matches_sampling(
+      math::from_loc_rot_scale<float3x3>(float2(-3.3f, 2.7f), 0.0f, float2(0.9f, 0.85f)));
+}
+
+/* Measure the bilinear transform of float images, which uses the interior fast path. The images
+ * are small to keep the test fast, increase their sizes for more representative timings. */
+TEST_F(ImBufTransformTest, bilinear_performance)
+{
+  ImBuf *src = create_gradient_test_image_fl(960, 540);
+  ImBuf *res = IMB_allocImBuf(1280, 720, ImBufFlags::FloatData);
+  for (const float angle : {0.0f, 0.3f}) {
+    const float3x3 matrix = math::from_loc_rot_scale<float3x3>(
+        float2(-10.0f, 20.0f), angle, float2(0.75f));
+    SCOPED_TIMER("bilinear float 960x540 to 1280x720 angle " + std::to_string(angle));
+    IMB_transform(src, res, IMB_TRANSFORM_MODE_REGULAR, IMB_FILTER_BILINEAR, matrix, nullptr);
+  }
+  IMB_freeImBuf(src);
+  IMB_freeImBuf(res);
+}
+
+TEST_F(ImBufTransformTest, crop_rotated_keeps_outside_pixels)
+{
+  ImBuf *src = create_gradient_test_image_fl(150, 110);
+  ImBuf *res = IMB_allocImBuf(170, 130, ImBufFlags::FloatData);
+  const float4 untouched(-1.0f);
+  float4 *got = reinterpret_cast<float4 *>(res->float_data_for_write());
+  std::fill_n(got, res->x * res->y, untouched);
+
+  const float3x3 matrix = math::from_loc_rot_scale<float3x3>(
+      float2(-20.0f, 15.0f), 0.3f, float2(1.1f, 0.9f));
+  rctf crop;
+  BLI_rctf_init(&crop, 10.0f, 120.0f, 5.0f, 90.0f);
+  IMB_transform(src, res, IMB_TRANSFORM_MODE_CROP_SRC, IMB_FILTER_NEAREST, matrix, &crop);
+
+  const float2 add_x = matrix.x_axis().xy();
+  const float2 add_y = matrix.y_axis().xy();
+  const float2 start = matrix.location().xy() + add_x * 0.5f + add_y * 0.5f;
+  int inside_count = 0;
+  for (int y = 0; y < res->y; y++) {
+    const float2 uv_row = start + y * add_y;
+    for (int x = 0; x < res->x; x++) {
+      const float2 uv = uv_row + x * add_x;
+      const bool inside = uv.x >= crop.xmin && uv.x < crop.xmax && uv.y >= crop.ymin &&
+                          uv.y < crop.ymax;
+      const float4 value = got[y * res->x + x];
+      if (inside) {
+        inside_count++;
+        const float4 expect = math::interpolate_nearest_border_fl(
+            src->float_data(), src->x, src->y, uv.x, uv.y);
+        EXPECT_EQ(value, expect);
+      }
+      else {
+        EXPECT_EQ(value, untouched);
+      }
+    }
+  }
+  EXPECT_GT(inside_count, 0);
+  IMB_freeImBuf(src);
+  IMB_freeImBuf(res);
+}
+
 }  // namespace blender::imbuf::tests
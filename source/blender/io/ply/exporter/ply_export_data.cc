@@ -10,54 +10,106 @@
 #include "ply_data.hh"
 #include "ply_file_buffer.hh"
 
+#include "BLI_array.hh"
 #include "BLI_math_vector.hh"
+#include "BLI_task.hh"
 
 namespace blender::io::ply {
 
+/** Number of elements that are formatted into one temporary buffer. */
+static constexpr int64_t chunk_size = 32768;
+/** Number of chunks that are formatted in parallel before they are written to the file. */
+static constexpr int64_t chunks_per_batch = 64;
+
+/**
+ * Write `tot_count` elements, each written by `function` independently from other elements.
+ * Chunks of elements are formatted in parallel into temporary buffers, which are then added to
+ * the output in order, so the result is the same as writing the elements one by one. The output
+ * is written to the file after every batch of chunks, to bound the memory usage.
+ */
+template<typename Function>
+static void ply_parallel_chunked_output(FileBuffer &buffer,
+                                        const int64_t tot_count,
+                                        const Function &function)
+{
+  const int64_t chunk_count = (tot_count + chunk_size - 1) / chunk_size;
+  if (chunk_count <= 1) {
+    for (int64_t i = 0; i < tot_count; i++) {
+      function(buffer, i);
+    }
+    return;
+  }
+  for (int64_t batch_start = 0; batch_start < chunk_count; batch_start += chunks_per_batch) {
+    const IndexRange batch = IndexRange::from_begin_end(
+        batch_start, std::min(batch_start + chunks_per_batch, chunk_count));
+    Array<std::unique_ptr<FileBuffer>> buffers(batch.size());
+    threading::parallel_for(batch.index_range(), 1, [&](const IndexRange range) {
+      for (const int64_t r : range) {
+        const int64_t i_start = batch[r] * chunk_size;
+        const int64_t i_end = std::min(i_start + chunk_size, tot_count);
+        buffers[r] = buffer.create_memory_buffer();
+        for (int64_t i = i_start; i < i_end; i++) {
+          function(*buffers[r], i);
+        }
+      }
+    });
+    for (std::unique_ptr<FileBuffer> &chunk_buffer : buffers) {
+      buffer.append_from(*chunk_buffer);
+    }
+    buffer.write_to_file();
+  }
+}
+
 void write_vertices(FileBuffer &buffer, const PlyData &ply_data)
 {
-  for (int i = 0; i < ply_data.vertices.size(); i++) {
-    buffer.write_vertex(ply_data.vertices[i].x, ply_data.vertices[i].y, ply_data.vertices[i].z);
+  ply_parallel_chunked_output(buffer, ply_data.vertices.size(), [&](FileBuffer &buf, int64_t i) {
+    buf.write_vertex(ply_data.vertices[i].x, ply_data.vertices[i].y, ply_data.vertices[i].z);
 
     if (!ply_data.vertex_normals.is_empty()) {
-      buffer.write_vertex_normal(ply_data.vertex_normals[i].x,
-                                 ply_data.vertex_normals[i].y,
-                                 ply_data.vertex_normals[i].z);
+      buf.write_vertex_normal(ply_data.vertex_normals[i].x,
+                              ply_data.vertex_normals[i].y,
+                              ply_data.vertex_normals[i].z);
     }
 
     if (!ply_data.vertex_colors.is_empty()) {
       /* PLY colors currently are exported as bytes, make sure inputs are clamped. */
       float4 color = math::clamp(ply_data.vertex_colors[i], 0.0f, 1.0f) * 255.0f;
-      buffer.write_vertex_color(uchar(color.x), uchar(color.y), uchar(color.z), uchar(color.w));
+      buf.write_vertex_color(uchar(color.x), uchar(color.y), uchar(color.z), uchar(color.w));
     }
 
     if (!ply_data.uv_coordinates.is_empty()) {
-      buffer.write_UV(ply_data.uv_coordinates[i].x, ply_data.uv_coordinates[i].y);
+      buf.write_UV(ply_data.uv_coordinates[i].x, ply_data.uv_coordinates[i].y);
     }
 
     for (const PlyCustomAttribute &attr : ply_data.vertex_custom_attr) {
-      buffer.write_data(attr.data[i]);
+      buf.write_data(attr.data[i]);
     }
 
-    buffer.write_vertex_end();
-  }
+    buf.write_vertex_end();
+  });
   buffer.write_to_file();
 }
 
 void write_faces(FileBuffer &buffer, const PlyData &ply_data)
 {
-  const uint32_t *indices = ply_data.face_vertices.data();
-  for (uint32_t face_size : ply_data.face_sizes) {
-    buffer.write_face(char(face_size), Span<uint32_t>(indices, face_size));
-    indices += face_size;
+  Array<int64_t> face_starts(ply_data.face_sizes.size());
+  int64_t face_start = 0;
+  for (const int64_t i : ply_data.face_sizes.index_range()) {
+    face_starts[i] = face_start;
+    face_start += ply_data.face_sizes[i];
   }
+  ply_parallel_chunked_output(buffer, ply_data.face_sizes.size(), [&](FileBuffer &buf, int64_t i) {
+    const uint32_t face_size = ply_data.face_sizes[i];
+    buf.write_face(char(face_size),
+                   ply_data.face_vertices.as_span().slice(face_starts[i], face_size));
+  });
   buffer.write_to_file();
 }
 void write_edges(FileBuffer &buffer, const PlyData &ply_data)
 {
-  for (const std::pair<int, int> &edge : ply_data.edges) {
-    buffer.write_edge(edge.first, edge.second);
-  }
+  ply_parallel_chunked_output(buffer, ply_data.edges.size(), [&](FileBuffer &buf, int64_t i) {
+    buf.write_edge(ply_data.edges[i].first, ply_data.edges[i].second);
+  });
   buffer.write_to_file();
 }
 }  // namespace blender::io::ply
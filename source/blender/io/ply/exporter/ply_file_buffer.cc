@@ -30,6 +30,19 @@ FileBuffer::FileBuffer(const char *filepath, size_t buffer_chunk_size)
   }
 }
 
+FileBuffer::FileBuffer(size_t buffer_chunk_size)
+    : buffer_chunk_size_(buffer_chunk_size), filepath_(nullptr), outfile_(nullptr)
+{
+}
+
+void FileBuffer::append_from(FileBuffer &other)
+{
+  blocks_.insert(blocks_.end(),
+                 std::make_move_iterator(other.blocks_.begin()),
+                 std::make_move_iterator(other.blocks_.end()));
+  other.blocks_.clear();
+}
+
 void FileBuffer::write_to_file()
 {
   for (const VectorChar &b : blocks_) {
@@ -12,6 +12,8 @@
 #include "BLI_utility_mixins.hh"
 #include "BLI_vector.hh"
 
+#include <memory>
+
 #include <fmt/format.h>
 
 namespace blender::io::ply {
@@ -32,6 +34,8 @@ class FileBuffer : private NonMovable {
 
  public:
   FileBuffer(const char *filepath, size_t buffer_chunk_size = 64 * 1024);
+  /** Creates a buffer that is only kept in memory, see #create_memory_buffer. */
+  explicit FileBuffer(size_t buffer_chunk_size);
 
   virtual ~FileBuffer() = default;
 
@@ -40,6 +44,15 @@ class FileBuffer : private NonMovable {
 
   void close_file();
 
+  /**
+   * Creates an in-memory buffer of the same format, so that parts of the output can be formatted
+   * in parallel and added in order with #append_from.
+   */
+  virtual std::unique_ptr<FileBuffer> create_memory_buffer() const = 0;
+
+  /** Moves the contents of another buffer to the end of this buffer. */
+  void append_from(FileBuffer &other);
+
   virtual void write_vertex(float x, float y, float z) = 0;
 
   virtual void write_UV(float u, float v) = 0;
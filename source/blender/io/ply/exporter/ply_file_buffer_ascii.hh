@@ -15,6 +15,8 @@ class FileBufferAscii : public FileBuffer {
   using FileBuffer::FileBuffer;
 
  public:
+  std::unique_ptr<FileBuffer> create_memory_buffer() const override;
+
   void write_vertex(float x, float y, float z) override;
 
   void write_UV(float u, float v) override;
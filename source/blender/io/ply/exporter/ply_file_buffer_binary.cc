@@ -11,6 +11,11 @@
 #include "BLI_math_vector_types.hh"
 
 namespace blender::io::ply {
+std::unique_ptr<FileBuffer> FileBufferBinary::create_memory_buffer() const
+{
+  return std::make_unique<FileBufferBinary>(size_t(64 * 1024));
+}
+
 void FileBufferBinary::write_vertex(float x, float y, float z)
 {
   float3 vector(x, y, z);
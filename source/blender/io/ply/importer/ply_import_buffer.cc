@@ -5,6 +5,7 @@
 #include "ply_import_buffer.hh"
 
 #include "BLI_fileops.hh"
+#include "BLI_mmap.hh"
 
 #include <algorithm>
 #include <cstdio>
@@ -28,6 +29,9 @@ PlyReadBuffer::PlyReadBuffer(const char *file_path, size_t read_buffer_size)
 
 PlyReadBuffer::~PlyReadBuffer()
 {
+  if (mmap_file_ != nullptr) {
+    BLI_mmap_free(mmap_file_);
+  }
   if (file_ != nullptr) {
     fclose(file_);
   }
@@ -36,6 +40,53 @@ PlyReadBuffer::~PlyReadBuffer()
 void PlyReadBuffer::after_header(bool is_binary)
 {
   is_binary_ = is_binary;
+  if (is_binary_ && file_ != nullptr) {
+    /* Fixed size binary records can be decoded in parallel straight from the mapped file.
+     * Mapping seeks to the end of the file, so restore the read position afterwards. */
+    const int64_t position = BLI_ftell(file_);
+    mmap_file_ = BLI_mmap_open(fileno(file_));
+    BLI_fseek(file_, position, SEEK_SET);
+  }
+}
+
+size_t PlyReadBuffer::file_position() const
+{
+  return buffer_file_offset_ + pos_;
+}
+
+Span<uint8_t> PlyReadBuffer::mapped_bytes() const
+{
+  if (mmap_file_ == nullptr) {
+    return {};
+  }
+  const size_t position = this->file_position();
+  const size_t length = BLI_mmap_get_length(mmap_file_);
+  if (position >= length) {
+    return {};
+  }
+  const uint8_t *data = static_cast<const uint8_t *>(BLI_mmap_get_pointer(mmap_file_));
+  return Span<uint8_t>(data + position, int64_t(length - position));
+}
+
+void PlyReadBuffer::skip_mapped_bytes(size_t size)
+{
+  BLI_assert(size <= size_t(this->mapped_bytes().size()));
+  if (pos_ + size <= size_t(buf_used_)) {
+    pos_ += int(size);
+    return;
+  }
+  /* Continue reading after the skipped bytes, discarding the buffer. */
+  const size_t position = this->file_position() + size;
+  BLI_fseek(file_, int64_t(position), SEEK_SET);
+  buffer_file_offset_ = position;
+  pos_ = 0;
+  buf_used_ = 0;
+  at_eof_ = false;
+}
+
+bool PlyReadBuffer::mapped_io_error() const
+{
+  return mmap_file_ != nullptr && BLI_mmap_any_io_error(mmap_file_);
 }
 
 Span<char> PlyReadBuffer::read_line()
@@ -92,6 +143,7 @@ bool PlyReadBuffer::refill_buffer()
   }
 
   /* Move any leftover to start of buffer. */
+  buffer_file_offset_ += pos_;
   int keep = buf_used_ - pos_;
   if (keep > 0) {
     memmove(buffer_.data(), buffer_.data() + pos_, keep);
@@ -13,6 +13,10 @@
 #include "BLI_array.hh"
 #include "BLI_span.hh"
 
+namespace blender {
+struct BLI_mmap_file;
+}
+
 namespace blender::io::ply {
 
 /**
@@ -38,10 +42,27 @@ class PlyReadBuffer {
    */
   bool read_bytes(void *dst, size_t size);
 
+  /**
+   * In binary mode, returns the rest of the file from the current position, without copying it.
+   * Returns an empty span when the file could not be memory-mapped.
+   */
+  Span<uint8_t> mapped_bytes() const;
+
+  /** Moves the current position past bytes that were processed through #mapped_bytes. */
+  void skip_mapped_bytes(size_t size);
+
+  /** Whether reading memory-mapped data failed because of an IO error. */
+  bool mapped_io_error() const;
+
  private:
   bool refill_buffer();
+  /** Position in the file of the next byte that #read_bytes returns. */
+  size_t file_position() const;
 
   FILE *file_ = nullptr;
+  BLI_mmap_file *mmap_file_ = nullptr;
+  /** Position in the file of the start of #buffer_. */
+  size_t buffer_file_offset_ = 0;
   Array<char> buffer_;
   int pos_ = 0;
   int buf_used_ = 0;
@@ -10,12 +10,15 @@
 #include "ply_data.hh"
 #include "ply_import_buffer.hh"
 
+#include "BLI_array.hh"
 #include "BLI_endian_switch.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 
 #include "fast_float.h"
 
 #include <charconv>
+#include <cstring>
 
 #include "CLG_log.h"
 
@@ -196,22 +199,35 @@ template<typename T> static T get_binary_value(PlyDataTypes type, const uint8_t
   return val;
 }
 
-static const char *parse_row_binary(PlyReadBuffer &file,
-                                    const PlyHeader &header,
-                                    const PlyElement &element,
-                                    Vector<uint8_t> &r_scratch,
-                                    Vector<float> &r_values)
+/** Reads a value that does not have to be writable, like data of the memory-mapped file. */
+template<typename T>
+static T get_binary_value(PlyDataTypes type, const uint8_t *&r_ptr, const bool big_endian)
+{
+  if (!big_endian) {
+    return get_binary_value<T>(type, r_ptr);
+  }
+  const int size = data_type_size[type];
+  uint8_t bytes[8];
+  memcpy(bytes, r_ptr, size);
+  endian_switch(bytes, size);
+  r_ptr += size;
+  const uint8_t *ptr = bytes;
+  return get_binary_value<T>(type, ptr);
+}
+
+/**
+ * Converts a row of a fixed size element to floats. For big endian files the row is copied to
+ * the scratch buffer first, the row data itself is not modified.
+ */
+static const char *decode_row_binary(const uint8_t *row,
+                                     const PlyHeader &header,
+                                     const PlyElement &element,
+                                     MutableSpan<uint8_t> r_scratch,
+                                     MutableSpan<float> r_values)
 {
-  if (element.stride == 0) {
-    return "Vertex/Edge element contains list properties, this is not supported";
-  }
   BLI_assert(r_scratch.size() == element.stride);
   BLI_assert(r_values.size() == element.properties.size());
-  if (!file.read_bytes(r_scratch.data(), r_scratch.size())) {
-    return "Could not read row of binary property";
-  }
-
-  const uint8_t *ptr = r_scratch.data();
+  const uint8_t *ptr = row;
   if (header.type == PlyFormatType::BINARY_LE) {
     /* Little endian: just read/convert the values. */
     for (int i = 0, n = int(element.properties.size()); i != n; i++) {
@@ -222,6 +238,10 @@ static const char *parse_row_binary(PlyReadBuffer &file,
   }
   else if (header.type == PlyFormatType::BINARY_BE) {
     /* Big endian: read, switch endian, convert the values. */
+    if (row != r_scratch.data()) {
+      memcpy(r_scratch.data(), row, element.stride);
+      ptr = r_scratch.data();
+    }
     for (int i = 0, n = int(element.properties.size()); i != n; i++) {
       const PlyProperty &prop = element.properties[i];
       endian_switch(const_cast<uint8_t *>(ptr), data_type_size[prop.type]);
@@ -235,6 +255,21 @@ static const char *parse_row_binary(PlyReadBuffer &file,
   return nullptr;
 }
 
+static const char *parse_row_binary(PlyReadBuffer &file,
+                                    const PlyHeader &header,
+                                    const PlyElement &element,
+                                    Vector<uint8_t> &r_scratch,
+                                    Vector<float> &r_values)
+{
+  if (element.stride == 0) {
+    return "Vertex/Edge element contains list properties, this is not supported";
+  }
+  if (!file.read_bytes(r_scratch.data(), r_scratch.size())) {
+    return "Could not read row of binary property";
+  }
+  return decode_row_binary(r_scratch.data(), header, element, r_scratch, r_values);
+}
+
 static const char *load_vertex_element(PlyReadBuffer &file,
                                        const PlyHeader &header,
                                        const PlyElement &element,
@@ -273,15 +308,15 @@ static const char *load_vertex_element(PlyReadBuffer &file,
     data->vertex_custom_attr.append(attr);
   }
 
-  data->vertices.reserve(element.count);
+  data->vertices.resize(element.count);
   if (has_color) {
-    data->vertex_colors.reserve(element.count);
+    data->vertex_colors.resize(element.count);
   }
   if (has_normal) {
-    data->vertex_normals.reserve(element.count);
+    data->vertex_normals.resize(element.count);
   }
   if (has_uv) {
-    data->uv_coordinates.reserve(element.count);
+    data->uv_coordinates.resize(element.count);
   }
 
   float4 color_norm = {1, 1, 1, 1};
@@ -294,31 +329,13 @@ static const char *load_vertex_element(PlyReadBuffer &file,
     color_norm.w = data_type_normalizer[element.properties[alpha_index].type];
   }
 
-  Vector<float> value_vec(element.properties.size());
-  Vector<uint8_t> scratch;
-  if (header.type != PlyFormatType::ASCII) {
-    scratch.resize(element.stride);
-  }
-
-  for (int i = 0; i < element.count; i++) {
-
-    const char *error = nullptr;
-    if (header.type == PlyFormatType::ASCII) {
-      error = parse_row_ascii(file, value_vec);
-    }
-    else {
-      error = parse_row_binary(file, header, element, scratch, value_vec);
-    }
-    if (error != nullptr) {
-      return error;
-    }
-
+  auto store_vertex = [&](const int i, const Span<float> value_vec) {
     /* Vertex coord */
     float3 vertex3;
     vertex3.x = value_vec[vertex_index.x];
     vertex3.y = value_vec[vertex_index.y];
     vertex3.z = value_vec[vertex_index.z];
-    data->vertices.append(vertex3);
+    data->vertices[i] = vertex3;
 
     /* Vertex color */
     if (has_color) {
@@ -332,7 +349,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       else {
         colors4.w = 1.0f;
       }
-      data->vertex_colors.append(colors4);
+      data->vertex_colors[i] = colors4;
     }
 
     /* If normals */
@@ -341,7 +358,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       normals3.x = value_vec[normal_index.x];
       normals3.y = value_vec[normal_index.y];
       normals3.z = value_vec[normal_index.z];
-      data->vertex_normals.append(normals3);
+      data->vertex_normals[i] = normals3;
     }
 
     /* If uv */
@@ -349,7 +366,7 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       float2 uvmap;
       uvmap.x = value_vec[uv_index.x];
       uvmap.y = value_vec[uv_index.y];
-      data->uv_coordinates.append(uvmap);
+      data->uv_coordinates[i] = uvmap;
     }
 
     /* Custom attributes */
@@ -357,6 +374,51 @@ static const char *load_vertex_element(PlyReadBuffer &file,
       float value = value_vec[custom_attr_indices[ci]];
       data->vertex_custom_attr[ci].data[i] = value;
     }
+  };
+
+  /* Binary rows have a fixed size, decode them in parallel straight from the mapped file. */
+  const Span<uint8_t> mapped = header.type == PlyFormatType::ASCII ? Span<uint8_t>() :
+                                                                      file.mapped_bytes();
+  const int64_t rows_size = int64_t(element.stride) * element.count;
+  if (element.stride > 0 && rows_size <= mapped.size()) {
+    threading::parallel_for(IndexRange(element.count), 4096, [&](const IndexRange range) {
+      Array<float, 16> value_vec(element.properties.size());
+      Array<uint8_t, 64> scratch(element.stride);
+      for (const int i : range) {
+        decode_row_binary(mapped.data() + int64_t(i) * element.stride,
+                          header,
+                          element,
+                          scratch,
+                          value_vec);
+        store_vertex(i, value_vec);
+      }
+    });
+    file.skip_mapped_bytes(rows_size);
+    if (file.mapped_io_error()) {
+      return "Could not read row of binary property";
+    }
+    return nullptr;
+  }
+
+  Vector<float> value_vec(element.properties.size());
+  Vector<uint8_t> scratch;
+  if (header.type != PlyFormatType::ASCII) {
+    scratch.resize(element.stride);
+  }
+
+  for (int i = 0; i < element.count; i++) {
+
+    const char *error = nullptr;
+    if (header.type == PlyFormatType::ASCII) {
+      error = parse_row_ascii(file, value_vec);
+    }
+    else {
+      error = parse_row_binary(file, header, element, scratch, value_vec);
+    }
+    if (error != nullptr) {
+      return error;
+    }
+    store_vertex(i, value_vec);
   }
   return nullptr;
 }
@@ -392,6 +454,111 @@ static void skip_property(PlyReadBuffer &file,
   }
 }
 
+/**
+ * Loads binary faces from the memory-mapped file. The face sizes are found serially, and the
+ * vertex indices are decoded in parallel afterwards. Returns false without reading anything if
+ * the element layout is not supported, i.e. when it has other list properties.
+ */
+static bool load_face_element_mapped(PlyReadBuffer &file,
+                                     const PlyHeader &header,
+                                     const PlyElement &element,
+                                     const int prop_index,
+                                     PlyData *data,
+                                     const char *&r_error)
+{
+  const Span<uint8_t> mapped = file.mapped_bytes();
+  if (mapped.is_empty()) {
+    return false;
+  }
+  /* Size of the other properties, before and after the vertex indices of each face. */
+  int64_t before_size = 0, after_size = 0;
+  for (const int j : element.properties.index_range()) {
+    const PlyProperty &prop = element.properties[j];
+    if (j == prop_index) {
+      continue;
+    }
+    if (prop.count_type != PlyDataTypes::NONE) {
+      return false;
+    }
+    (j < prop_index ? before_size : after_size) += data_type_size[prop.type];
+  }
+
+  const PlyProperty &prop = element.properties[prop_index];
+  const bool big_endian = header.type == PlyFormatType::BINARY_BE;
+  const int64_t count_size = data_type_size[prop.count_type];
+  const int64_t index_size = data_type_size[prop.type];
+
+  /* Positions in the file and in the face vertices of the first face of every block. */
+  constexpr int faces_per_block = 4096;
+  struct FaceBlock {
+    int64_t file_offset;
+    int64_t corner_offset;
+  };
+  Vector<FaceBlock> blocks;
+
+  const int64_t corners_start = data->face_vertices.size();
+  int64_t offset = 0;
+  int64_t corners_num = 0;
+  for (int i = 0; i < element.count; i++) {
+    if (i % faces_per_block == 0) {
+      blocks.append({offset, corners_start + corners_num});
+    }
+    offset += before_size;
+    if (offset + count_size > mapped.size()) {
+      r_error = "Could not read row of binary property";
+      return true;
+    }
+    const uint8_t *ptr = mapped.data() + offset;
+    const uint32_t count = get_binary_value<uint32_t>(prop.count_type, ptr, big_endian);
+    if (count < 1 || count > 255) {
+      r_error = "Invalid face size, must be between 1 and 255";
+      return true;
+    }
+    offset += count_size + count * index_size + after_size;
+    if (offset > mapped.size()) {
+      r_error = "Could not read row of binary property";
+      return true;
+    }
+    /* Previous python based importer was accepting faces with fewer
+     * than 3 vertices, and silently dropping them. */
+    if (count < 3) {
+      CLOG_WARN(&LOG, "PLY Importer: ignoring face %i (%u vertices)", i, count);
+      continue;
+    }
+    data->face_sizes.append(count);
+    corners_num += count;
+  }
+
+  data->face_vertices.resize(corners_start + corners_num);
+  threading::parallel_for(blocks.index_range(), 1, [&](const IndexRange range) {
+    for (const int64_t block : range) {
+      const int64_t faces_start = block * faces_per_block;
+      const int64_t faces_end = std::min<int64_t>(faces_start + faces_per_block, element.count);
+      const uint8_t *ptr = mapped.data() + blocks[block].file_offset;
+      uint32_t *dst = data->face_vertices.data() + blocks[block].corner_offset;
+      for (int64_t i = faces_start; i < faces_end; i++) {
+        ptr += before_size;
+        const uint32_t count = get_binary_value<uint32_t>(prop.count_type, ptr, big_endian);
+        if (count < 3) {
+          ptr += count * index_size;
+        }
+        else {
+          for (uint32_t j = 0; j < count; j++) {
+            *dst++ = get_binary_value<uint32_t>(prop.type, ptr, big_endian);
+          }
+        }
+        ptr += after_size;
+      }
+    }
+  });
+
+  file.skip_mapped_bytes(offset);
+  if (file.mapped_io_error()) {
+    r_error = "Could not read row of binary property";
+  }
+  return true;
+}
+
 static const char *load_face_element(PlyReadBuffer &file,
                                      const PlyHeader &header,
                                      const PlyElement &element,
@@ -415,6 +582,13 @@ static const char *load_face_element(PlyReadBuffer &file,
   data->face_vertices.reserve(int64_t(element.count) * 3);
   data->face_sizes.reserve(element.count);
 
+  if (header.type != PlyFormatType::ASCII) {
+    const char *error = nullptr;
+    if (load_face_element_mapped(file, header, element, prop_index, data, error)) {
+      return error;
+    }
+  }
+
   if (header.type == PlyFormatType::ASCII) {
     for (int i = 0; i < element.count; i++) {
       /* Read line */
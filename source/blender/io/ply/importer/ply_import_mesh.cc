@@ -17,6 +17,7 @@
 #include "BLI_math_color_c.hh"
 #include "BLI_math_vector_c.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 
 #include "IO_validate.hh"
 
@@ -74,19 +75,28 @@ Mesh *convert_ply_to_mesh(PlyData &data, const PLYImportParams &params)
     /* Fill in face data. */
     int64_t offset = 0;
     for (const int64_t i : data.face_sizes.index_range()) {
-      const int64_t size = data.face_sizes[i];
       face_offsets[i] = offset;
-      for (int64_t j = 0; j < size; j++) {
-        uint32_t v = data.face_vertices[offset + j];
-        if (!validate::index_in_range(v, mesh->verts_num)) {
-          CLOG_WARN(
-              &LOG, "Invalid PLY vertex index in face %" PRId64 " loop %" PRId64 ": %u", i, j, v);
-          v = 0;
+      offset += data.face_sizes[i];
+    }
+    face_offsets.last() = offset;
+    const OffsetIndices<int> faces(face_offsets);
+    threading::parallel_for(faces.index_range(), 4096, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        const IndexRange face = faces[i];
+        for (const int64_t j : face.index_range()) {
+          uint32_t v = data.face_vertices[face[j]];
+          if (!validate::index_in_range(v, mesh->verts_num)) {
+            CLOG_WARN(&LOG,
+                      "Invalid PLY vertex index in face %" PRId64 " loop %" PRId64 ": %u",
+                      i,
+                      j,
+                      v);
+            v = 0;
+          }
+          corner_verts[face[j]] = v;
         }
-        corner_verts[offset + j] = v;
       }
-      offset += size;
-    }
+    });
   }
 
   /* Vertex colors */
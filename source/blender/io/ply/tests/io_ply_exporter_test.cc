@@ -6,6 +6,7 @@
 #include "tests/blendfile_loading_base_test.h"
 
 #include "BLI_fileops.hh"
+#include "BLI_math_vector.hh"
 #include "BLI_string.hh"
 
 #include "BKE_appdir.hh"
@@ -417,6 +418,85 @@ TEST_F(PLYExportTest, WriteVertexNormalsBinary)
   }
 }
 
+/** Data with enough elements to be written in multiple chunks of elements in parallel. */
+static PlyData create_large_ply_data()
+{
+  constexpr int verts_num = 100000;
+  PlyData ply_data;
+  ply_data.vertex_custom_attr.append(PlyCustomAttribute("weight", verts_num));
+  for (const int i : IndexRange(verts_num)) {
+    const float f = i * 0.37f;
+    ply_data.vertices.append({f, -f, 1.0f / (i + 1)});
+    ply_data.vertex_normals.append({0.0f, 0.6f, 0.8f});
+    ply_data.vertex_colors.append({float(i % 256) / 255.0f, 0.5f, 1.5f, -0.5f});
+    ply_data.uv_coordinates.append({f * 0.01f, 0.25f});
+    ply_data.vertex_custom_attr[0].data[i] = f * 2.0f;
+    ply_data.edges.append({i, (i + 1) % verts_num});
+    /* Faces of varying size. */
+    const int face_size = 3 + i % 3;
+    ply_data.face_sizes.append(face_size);
+    for (const int j : IndexRange(face_size)) {
+      ply_data.face_vertices.append((i + j) % verts_num);
+    }
+  }
+  return ply_data;
+}
+
+/** Writes the elements one after another, which the parallel output has to match. */
+static void write_serial(FileBuffer &buffer, const PlyData &ply_data)
+{
+  for (const int i : ply_data.vertices.index_range()) {
+    buffer.write_vertex(ply_data.vertices[i].x, ply_data.vertices[i].y, ply_data.vertices[i].z);
+    buffer.write_vertex_normal(
+        ply_data.vertex_normals[i].x, ply_data.vertex_normals[i].y, ply_data.vertex_normals[i].z);
+    const float4 color = math::clamp(ply_data.vertex_colors[i], 0.0f, 1.0f) * 255.0f;
+    buffer.write_vertex_color(uchar(color.x), uchar(color.y), uchar(color.z), uchar(color.w));
+    buffer.write_UV(ply_data.uv_coordinates[i].x, ply_data.uv_coordinates[i].y);
+    buffer.write_data(ply_data.vertex_custom_attr[0].data[i]);
+    buffer.write_vertex_end();
+  }
+  const uint32_t *indices = ply_data.face_vertices.data();
+  for (const uint32_t face_size : ply_data.face_sizes) {
+    buffer.write_face(char(face_size), Span<uint32_t>(indices, face_size));
+    indices += face_size;
+  }
+  for (const std::pair<int, int> &edge : ply_data.edges) {
+    buffer.write_edge(edge.first, edge.second);
+  }
+  buffer.write_to_file();
+}
+
+TEST_F(PLYExportTest, WriteParallelMatchesSerial)
+{
+  const PlyData ply_data = create_large_ply_data();
+  const std::string parallel_path = get_temp_ply_filename("parallel.ply");
+  const std::string serial_path = get_temp_ply_filename("serial.ply");
+  for (const bool ascii : {true, false}) {
+    auto create_buffer = [&](const std::string &filepath) -> std::unique_ptr<FileBuffer> {
+      if (ascii) {
+        return std::make_unique<FileBufferAscii>(filepath.c_str());
+      }
+      return std::make_unique<FileBufferBinary>(filepath.c_str());
+    };
+
+    std::unique_ptr<FileBuffer> parallel_buffer = create_buffer(parallel_path);
+    write_vertices(*parallel_buffer, ply_data);
+    write_faces(*parallel_buffer, ply_data);
+    write_edges(*parallel_buffer, ply_data);
+    parallel_buffer->close_file();
+
+    std::unique_ptr<FileBuffer> serial_buffer = create_buffer(serial_path);
+    write_serial(*serial_buffer, ply_data);
+    serial_buffer->close_file();
+
+    const std::string parallel_result = read_temp_file_in_string(parallel_path);
+    const std::string serial_result = read_temp_file_in_string(serial_path);
+    ASSERT_FALSE(serial_result.empty());
+    EXPECT_EQ(parallel_result.size(), serial_result.size());
+    EXPECT_TRUE(parallel_result == serial_result);
+  }
+}
+
 class PLYExportPLYDataTest : public PLYExportTest {
  public:
   PlyData load_ply_data_from_blendfile(const std::string &blendfile, PLYExportParams &params)
@@ -6,12 +6,14 @@
  * \ingroup stl
  */
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 
 #include "BKE_mesh.hh"
 
 #include "BLI_array.hh"
+#include "BLI_mmap.hh"
 
 #include "DNA_mesh_types.h"
 
@@ -47,13 +49,30 @@ Mesh *read_stl_binary(FILE *file, const bool use_custom_normals)
     return nullptr;
   }
 
-  Array<PackedTriangle> tris_buf(chunk_size);
   STLMeshHelper stl_mesh(num_tris, use_custom_normals);
+
+  /* Triangles have a fixed size, so they can be read from the mapped file in parallel. */
+  if (BLI_mmap_file *mmap_file = BLI_mmap_open(fileno(file))) {
+    const size_t tris_offset = BINARY_HEADER_SIZE + sizeof(uint32_t);
+    const size_t file_size = BLI_mmap_get_length(mmap_file);
+    const int64_t mapped_tris_num = std::min<int64_t>(
+        num_tris, (file_size - std::min(file_size, tris_offset)) / sizeof(PackedTriangle));
+    const char *file_data = static_cast<const char *>(BLI_mmap_get_pointer(mmap_file));
+    stl_mesh.add_triangles(
+        Span(reinterpret_cast<const PackedTriangle *>(file_data + tris_offset), mapped_tris_num));
+    const bool io_error = BLI_mmap_any_io_error(mmap_file);
+    BLI_mmap_free(mmap_file);
+    if (io_error) {
+      CLOG_ERROR(&LOG, "STL Importer: failed to read mapped file");
+      return nullptr;
+    }
+    return stl_mesh.to_mesh();
+  }
+
+  Array<PackedTriangle> tris_buf(chunk_size);
   size_t num_read_tris;
   while ((num_read_tris = fread(tris_buf.data(), sizeof(PackedTriangle), chunk_size, file))) {
-    for (size_t i = 0; i < num_read_tris; i++) {
-      stl_mesh.add_triangle(tris_buf[i]);
-    }
+    stl_mesh.add_triangles(tris_buf.as_span().take_front(num_read_tris));
   }
 
   return stl_mesh.to_mesh();
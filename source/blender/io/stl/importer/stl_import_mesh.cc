@@ -8,8 +8,13 @@
 
 #include "BKE_mesh.hh"
 
+#include "BLI_array.hh"
 #include "BLI_array_utils.hh"
+#include "BLI_index_mask.hh"
+#include "BLI_map.hh"
+#include "BLI_offset_indices.hh"
 #include "BLI_span.hh"
+#include "BLI_task.hh"
 
 #include "DNA_mesh_types.h"
 
@@ -27,57 +32,192 @@ namespace io::stl {
 STLMeshHelper::STLMeshHelper(int tris_num, bool use_custom_normals)
     : use_custom_normals_(use_custom_normals)
 {
-  degenerate_tris_num_ = 0;
-  duplicate_tris_num_ = 0;
-  tris_.reserve(tris_num);
-  /* Upper bound (all vertices are unique). */
-  verts_.reserve(int64_t(tris_num) * 3);
+  corner_positions_.reserve(int64_t(tris_num) * 3);
   if (use_custom_normals) {
-    loop_normals_.reserve(int64_t(tris_num) * 3);
+    tri_normals_.reserve(tris_num);
   }
 }
 
-bool STLMeshHelper::add_triangle(const PackedTriangle &data)
+void STLMeshHelper::add_triangle(const PackedTriangle &data)
 {
-  int v1_id = verts_.index_of_or_add(data.vertices[0]);
-  int v2_id = verts_.index_of_or_add(data.vertices[1]);
-  int v3_id = verts_.index_of_or_add(data.vertices[2]);
-  if ((v1_id == v2_id) || (v1_id == v3_id) || (v2_id == v3_id)) {
-    degenerate_tris_num_++;
-    return false;
-  }
-  if (!tris_.add({v1_id, v2_id, v3_id})) {
-    duplicate_tris_num_++;
-    return false;
+  corner_positions_.extend({data.vertices[0], data.vertices[1], data.vertices[2]});
+  if (use_custom_normals_) {
+    tri_normals_.append(data.normal);
   }
+}
 
+void STLMeshHelper::add_triangles(const Span<PackedTriangle> tris)
+{
+  const int64_t tris_start = corner_positions_.size() / 3;
+  corner_positions_.resize(corner_positions_.size() + tris.size() * 3);
   if (use_custom_normals_) {
-    loop_normals_.append_n_times(data.normal, 3);
+    tri_normals_.resize(tri_normals_.size() + tris.size());
+  }
+  threading::parallel_for(tris.index_range(), 4096, [&](const IndexRange range) {
+    for (const int64_t i : range) {
+      const PackedTriangle &tri = tris[i];
+      const int64_t dst = tris_start + i;
+      corner_positions_[dst * 3 + 0] = tri.vertices[0];
+      corner_positions_[dst * 3 + 1] = tri.vertices[1];
+      corner_positions_[dst * 3 + 2] = tri.vertices[2];
+      if (use_custom_normals_) {
+        tri_normals_[dst] = tri.normal;
+      }
+    }
+  });
+}
+
+/**
+ * For every index in the mask, find the smallest index in the mask with an equal value.
+ *
+ * This gives the same result as adding the values to a #VectorSet in order, but works in
+ * parallel: the indices are distributed to buckets by the hash of their value, keeping their
+ * order. Equal values end up in the same bucket, so every bucket is deduplicated independently
+ * with a small hash table, which only ever exists for the buckets that are currently processed.
+ */
+template<typename T>
+static void find_first_occurrences(const Span<T> values,
+                                   const IndexMask &mask,
+                                   MutableSpan<int> r_first)
+{
+  /* Use enough buckets for their hash tables to fit into the cache. */
+  constexpr int64_t bucket_size = 4096;
+  int bucket_bits = 0;
+  while (bucket_bits < 12 && (bucket_size << bucket_bits) < mask.size()) {
+    bucket_bits++;
   }
-  return true;
+  const int buckets_num = 1 << bucket_bits;
+  const auto bucket_of = [&](const int64_t i) {
+    if (bucket_bits == 0) {
+      return 0;
+    }
+    /* Use the upper bits of the mixed hash, the hash tables of the buckets use the lower ones. */
+    const uint64_t hash = uint64_t(DefaultHash<T>{}(values[i])) * 0x9E3779B97F4A7C15ull;
+    return int(hash >> (64 - bucket_bits));
+  };
+
+  /* Count the indices of every chunk of the mask per bucket. The counts are stored by bucket
+   * first, so that their prefix sum gives the start of every chunk in every bucket. */
+  const int64_t chunk_size = std::max<int64_t>(int64_t(buckets_num) * 64, 1 << 16);
+  const int64_t chunks_num = std::max<int64_t>((mask.size() + chunk_size - 1) / chunk_size, 1);
+  const auto chunk_mask = [&](const int64_t chunk) {
+    return mask.slice(IndexRange::from_begin_end(
+        chunk * chunk_size, std::min((chunk + 1) * chunk_size, mask.size())));
+  };
+  Array<int> offsets(buckets_num * chunks_num + 1, 0);
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+    for (const int64_t chunk : range) {
+      chunk_mask(chunk).foreach_index(
+          [&](const int64_t i) { offsets[bucket_of(i) * chunks_num + chunk]++; });
+    }
+  });
+  offset_indices::accumulate_counts_to_offsets(offsets);
+
+  Array<int> bucket_indices(mask.size());
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+    for (const int64_t chunk : range) {
+      chunk_mask(chunk).foreach_index([&](const int64_t i) {
+        bucket_indices[offsets[bucket_of(i) * chunks_num + chunk]++] = int(i);
+      });
+    }
+  });
+
+  /* Scattering advanced every offset to the start of the next chunk, so the end of a bucket is
+   * stored at its last chunk now, and its start at the last chunk of the previous bucket. */
+  threading::parallel_for(IndexRange(buckets_num), 1, [&](const IndexRange range) {
+    Map<T, int> first_by_value;
+    for (const int64_t bucket : range) {
+      const int end = offsets[(bucket + 1) * chunks_num - 1];
+      const int start = bucket == 0 ? 0 : offsets[bucket * chunks_num - 1];
+      first_by_value.clear();
+      first_by_value.reserve(end - start);
+      for (const int i : bucket_indices.as_span().slice(start, end - start)) {
+        r_first[i] = first_by_value.lookup_or_add(values[i], i);
+      }
+    }
+  });
 }
 
 Mesh *STLMeshHelper::to_mesh()
 {
-  if (degenerate_tris_num_ > 0) {
-    CLOG_WARN(&LOG, "Removed %d degenerate triangles during import", degenerate_tris_num_);
+  const int corners_num = int(corner_positions_.size());
+  const int tris_num = corners_num / 3;
+  IndexMaskMemory memory;
+
+  /* Merge duplicate vertices, numbering them in order of their first occurrence. The first
+   * occurrences are replaced by the vertex indices in place, to avoid another per corner array. */
+  Array<int> corner_verts(corners_num);
+  find_first_occurrences(corner_positions_.as_span(), IndexRange(corners_num), corner_verts);
+  const IndexMask unique_corners = IndexMask::from_predicate(
+      IndexRange(corners_num), memory, [&](const int corner) {
+        return corner_verts[corner] == corner;
+      });
+  unique_corners.foreach_index(
+      [&](const int corner, const int vert) { corner_verts[corner] = vert; },
+      exec_mode::parallel);
+  /* The first occurrence of a duplicate corner is a unique corner, which stores its vertex now. */
+  unique_corners.complement(IndexRange(corners_num), memory)
+      .foreach_index(
+          [&](const int corner) { corner_verts[corner] = corner_verts[corner_verts[corner]]; },
+          exec_mode::parallel);
+
+  /* Remove degenerate triangles, and triangles that use the same vertices as a previous one. */
+  const IndexMask valid_tris = IndexMask::from_predicate(
+      IndexRange(tris_num), memory, [&](const int tri) {
+        const int v1 = corner_verts[tri * 3 + 0];
+        const int v2 = corner_verts[tri * 3 + 1];
+        const int v3 = corner_verts[tri * 3 + 2];
+        return v1 != v2 && v1 != v3 && v2 != v3;
+      });
+  Array<int3> tri_keys(tris_num);
+  valid_tris.foreach_index(
+      [&](const int tri) {
+        int3 key(corner_verts[tri * 3 + 0], corner_verts[tri * 3 + 1], corner_verts[tri * 3 + 2]);
+        /* Triangles are the same regardless of the order of their vertices. */
+        std::sort(&key.x, &key.x + 3);
+        tri_keys[tri] = key;
+      },
+      exec_mode::parallel);
+  Array<int> tri_first(tris_num);
+  find_first_occurrences(tri_keys.as_span(), valid_tris, tri_first);
+  const IndexMask unique_tris = IndexMask::from_predicate(
+      valid_tris, memory, [&](const int tri) { return tri_first[tri] == tri; });
+
+  const int degenerate_tris_num = tris_num - int(valid_tris.size());
+  const int duplicate_tris_num = int(valid_tris.size() - unique_tris.size());
+  if (degenerate_tris_num > 0) {
+    CLOG_WARN(&LOG, "Removed %d degenerate triangles during import", degenerate_tris_num);
   }
-  if (duplicate_tris_num_ > 0) {
-    CLOG_WARN(&LOG, "Removed %d duplicate triangles during import", duplicate_tris_num_);
+  if (duplicate_tris_num > 0) {
+    CLOG_WARN(&LOG, "Removed %d duplicate triangles during import", duplicate_tris_num);
   }
 
-  Mesh *mesh = BKE_mesh_new_nomain(verts_.size(), 0, tris_.size(), tris_.size() * 3);
-  mesh->vert_positions_for_write().copy_from(verts_);
+  const int result_tris_num = int(unique_tris.size());
+  Mesh *mesh = BKE_mesh_new_nomain(
+      int(unique_corners.size()), 0, result_tris_num, result_tris_num * 3);
+  array_utils::gather(
+      corner_positions_.as_span(), unique_corners, mesh->vert_positions_for_write());
   offset_indices::fill_constant_group_size(3, 0, mesh->face_offsets_for_write());
-  array_utils::copy(tris_.as_span().cast<int>(), mesh->corner_verts_for_write());
+  MutableSpan<int> mesh_corner_verts = mesh->corner_verts_for_write();
+  unique_tris.foreach_index(
+      [&](const int tri, const int pos) {
+        mesh_corner_verts.slice(pos * 3, 3).copy_from(corner_verts.as_span().slice(tri * 3, 3));
+      },
+      exec_mode::parallel);
 
   bke::mesh_smooth_set(*mesh, false);
 
   /* NOTE: edges must be calculated first before setting custom normals. */
   bke::mesh_calc_edges(*mesh, false, false);
 
-  if (use_custom_normals_ && loop_normals_.size() == mesh->corners_num) {
-    bke::mesh_set_custom_normals(*mesh, loop_normals_);
+  if (use_custom_normals_ && tri_normals_.size() == tris_num) {
+    Array<float3> corner_normals(mesh->corners_num);
+    unique_tris.foreach_index(
+        [&](const int tri, const int pos) {
+          corner_normals.as_mutable_span().slice(pos * 3, 3).fill(tri_normals_[tri]);
+        },
+        exec_mode::parallel);
+    bke::mesh_set_custom_normals(*mesh, corner_normals);
   }
 
   return mesh;
@@ -11,8 +11,8 @@
 #include <cstdint>
 
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_vector.hh"
-#include "BLI_vector_set.hh"
 #include "stl_data.hh"
 
 namespace blender {
@@ -20,51 +20,23 @@ namespace blender {
 struct Mesh;
 
 namespace io::stl {
-class Triangle {
- public:
-  int v1, v2, v3;
-  /* Based on an old version of Python's frozen-set hash
-   * https://web.archive.org/web/20220520211017/https://stackoverflow.com/questions/20832279/python-frozenset-hashing-algorithm-implementation
-   */
-  uint64_t hash() const
-  {
-    uint64_t res = 1927868237UL;
-    res *= 4;
-    res ^= (v1 ^ (v1 << 16) ^ 89869747UL) * 3644798167UL;
-    res ^= (v2 ^ (v2 << 16) ^ 89869747UL) * 3644798167UL;
-    res ^= (v3 ^ (v3 << 16) ^ 89869747UL) * 3644798167UL;
-    return res * 69069U + 907133923UL;
-  }
-  friend bool operator==(const Triangle &a, const Triangle &b)
-  {
-    bool i = (a.v1 == b.v1) && (a.v2 == b.v2) && (a.v3 == b.v3);
-    bool j = (a.v1 == b.v1) && (a.v3 == b.v2) && (a.v2 == b.v3);
-    bool k = (a.v2 == b.v1) && (a.v1 == b.v2) && (a.v3 == b.v3);
-
-    bool l = (a.v2 == b.v1) && (a.v3 == b.v2) && (a.v1 == b.v3);
-    bool m = (a.v3 == b.v1) && (a.v1 == b.v2) && (a.v2 == b.v3);
-    bool n = (a.v3 == b.v1) && (a.v2 == b.v2) && (a.v1 == b.v3);
-
-    return i || j || k || l || m || n;
-  }
-};
 
 class STLMeshHelper {
  private:
-  VectorSet<float3> verts_;
-  VectorSet<Triangle> tris_;
-  Vector<float3> loop_normals_;
-  int degenerate_tris_num_;
-  int duplicate_tris_num_;
+  /** Vertex positions of all triangles, three per triangle, before merging duplicates. */
+  Vector<float3> corner_positions_;
+  Vector<float3> tri_normals_;
   const bool use_custom_normals_;
 
  public:
   STLMeshHelper(int tris_num, bool use_custom_normals);
 
-  /* Creates a new triangle from specified vertex locations,
-   * duplicate vertices and triangles are merged.
+  /* Adds a new triangle from specified vertex locations,
+   * duplicate vertices and triangles are merged in #to_mesh.
    */
-  bool add_triangle(const PackedTriangle &data);
+  void add_triangle(const PackedTriangle &data);
+  /** Same as #add_triangle for many triangles at once, reading them in parallel. */
+  void add_triangles(Span<PackedTriangle> tris);
 
   Mesh *to_mesh();
 };
@@ -6,8 +6,10 @@
  * \ingroup obj
  */
 
+#include <atomic>
 #include <cstdio>
 #include <memory>
+#include <mutex>
 #include <system_error>
 
 #include "DNA_collection_types.h"
@@ -169,7 +171,7 @@ static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_a
   /* Parallelization is over meshes/objects, which means
    * we have to have the output text buffer for each object,
    * and write them all into the file at the end. */
-  size_t count = exportable_as_mesh.size();
+  const int64_t count = exportable_as_mesh.size();
   Array<FormatHandler> buffers(count);
 
   /* Serial: gather material indices, ensure normals & edges. */
@@ -213,6 +215,30 @@ static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_a
     offsets.normal_offset += obj.get_normal_coords().size();
   }
 
+  /* Object text buffers are written into the output file in order, as soon as all previous
+   * objects are written. This overlaps file writing with formatting of the remaining objects,
+   * and frees the buffers early instead of keeping the whole file in memory. */
+  FILE *f = obj_writer.get_outfile();
+  Array<std::atomic<bool>> buffer_done(count);
+  std::atomic<int64_t> next_to_write = 0;
+  std::mutex write_mutex;
+  auto write_finished_buffers = [&]() {
+    while (write_mutex.try_lock()) {
+      int64_t next = next_to_write.load();
+      while (next < count && buffer_done[next].load()) {
+        buffers[next].write_to_file(f);
+        next++;
+      }
+      next_to_write.store(next);
+      write_mutex.unlock();
+      /* Another thread may have finished the next buffer while the mutex was locked,
+       * in which case it relies on this thread to write it. */
+      if (next >= count || !buffer_done[next].load()) {
+        break;
+      }
+    }
+  };
+
   /* Parallel over meshes: main result writing. */
   threading::parallel_for(IndexRange(count), 1, [&](IndexRange range) {
     for (const int i : range) {
@@ -251,13 +277,15 @@ static void write_mesh_objects(const Span<std::unique_ptr<OBJMesh>> exportable_a
       /* Nothing will need this object's data after this point, release
        * various arrays here. */
       obj.clear();
+
+      buffer_done[i].store(true);
+      write_finished_buffers();
     }
   });
 
-  /* Write all the object text buffers into the output file. */
-  FILE *f = obj_writer.get_outfile();
-  for (auto &b : buffers) {
-    b.write_to_file(f);
+  /* Write any object text buffers that remain. */
+  for (const int64_t i : IndexRange::from_begin_end(next_to_write.load(), count)) {
+    buffers[i].write_to_file(f);
   }
 }
 
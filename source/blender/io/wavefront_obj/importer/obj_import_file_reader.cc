@@ -8,7 +8,9 @@
 
 #include "BKE_report.hh"
 
+#include "BLI_array.hh"
 #include "BLI_fileops.hh"
+#include "BLI_linear_allocator.hh"
 #include "BLI_map.hh"
 #include "BLI_math_color_c.hh"
 #include "BLI_math_vector_c.hh"
@@ -16,6 +18,7 @@
 #include "BLI_mmap.hh"
 #include "BLI_string.hh"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 #include "BLI_vector.hh"
 
 #include "IO_string_utils.hh"
@@ -44,6 +47,74 @@ namespace io::obj {
 
 using std::string;
 
+/** Approximate size in bytes of the parts of the file that are parsed in parallel. */
+static constexpr int64_t OBJ_CHUNK_SIZE = 256 * 1024;
+/**
+ * Number of chunks that are parsed at once before their data is added to the geometry.
+ * This bounds the amount of memory used by the intermediate chunk data.
+ */
+static constexpr int64_t OBJ_CHUNKS_PER_BATCH = 64;
+
+/** Parser state that changes while going through the file, and applies to following elements. */
+struct OBJParseState {
+  bool shaded_smooth = false;
+  string group_name;
+  int group_index = -1;
+  string material_name;
+  int material_index = -1;
+};
+
+/** A face corner as written in the file, before indices are resolved and validated. */
+struct RawFaceCorner {
+  FaceCorner corner;
+  bool got_uv = false;
+  bool got_normal = false;
+};
+
+/**
+ * Numeric data of the most common lines (vertices, normals, UVs and faces) of a line-aligned part
+ * of the file, which can be parsed independently of the rest of the file.
+ *
+ * All other lines (objects, groups, materials, curves, ...) change the parser state or are rare,
+ * so they are kept as text and handled in file order when the chunk is added, see
+ * #OBJParser::add_chunk. Face indices are only resolved at that point too, because relative
+ * indices depend on the number of elements in all previous chunks.
+ */
+struct OBJChunk {
+  enum class LineType : uint8_t { Vertex, Normal, UV, Face, Other };
+  /** Consecutive lines of the same type, to replay the lines in file order. */
+  struct LineRun {
+    LineType type;
+    int count;
+  };
+
+  Vector<LineRun> runs;
+
+  Vector<float3> vertices;
+  /** Colors and weights of `xyzrgb` vertices, with chunk-local vertex indices. */
+  Vector<std::pair<int, float3>> vertex_colors;
+  Vector<std::pair<int, float>> vertex_weights;
+  Vector<float3> vert_normals;
+  Vector<float2> uv_vertices;
+
+  Vector<RawFaceCorner> face_corners;
+  Vector<int> face_sizes;
+
+  Vector<StringRef> other_lines;
+  /** Storage for lines with line continuations, which can't reference the file directly. */
+  LinearAllocator<> allocator;
+
+  void add_line(const LineType type)
+  {
+    if (!runs.is_empty() && runs.last().type == type) {
+      runs.last().count++;
+    }
+    else {
+      runs.append({type, 1});
+    }
+  }
+};
+
 /**
  * Based on the properties of the given Geometry instance, create a new Geometry instance
  * or return the previous one.
@@ -83,12 +154,12 @@ static Geometry *create_geometry(Geometry *const prev_geometry,
   return new_geometry();
 }
 
-static void geom_add_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
+static void chunk_add_vertex(const char *p, const char *end, OBJChunk &r_chunk)
 {
-  r_global_vertices.flush_mrgb_block();
   float3 vert;
   p = parse_floats(p, end, 0.0f, vert, 3);
-  r_global_vertices.vertices.append(vert);
+  r_chunk.vertices.append(vert);
+  const int index = int(r_chunk.vertices.size() - 1);
   /* OBJ extension: `xyzrgb` vertex colors, when the vertex position
    * is followed by 3 more RGB color components. See
    * http://paulbourke.net/dataformats/obj/colour.html */
@@ -98,11 +169,11 @@ static void geom_add_vertex(const char *p, const char *end, GlobalVertices &r_gl
     if (srgb.x >= 0 && srgb.y >= 0 && srgb.z >= 0) {
       float3 linear;
       srgb_to_linearrgb_v3_v3(linear, srgb);
-      r_global_vertices.set_vertex_color(r_global_vertices.vertices.size() - 1, linear);
+      r_chunk.vertex_colors.append({index, linear});
     }
     else if (srgb.x > 0) {
       /* Treats value in srgb.x as weight. */
-      r_global_vertices.set_vertex_weight(r_global_vertices.vertices.size() - 1, srgb.x);
+      r_chunk.vertex_weights.append({index, srgb.x});
     }
   }
   UNUSED_VARS(p);
@@ -135,9 +206,7 @@ static void geom_add_mrgb_colors(const char *p, const char *end, GlobalVertices
   }
 }
 
-static void geom_add_vertex_normal(const char *p,
-                                   const char *end,
-                                   GlobalVertices &r_global_vertices)
+static void chunk_add_vertex_normal(const char *p, const char *end, OBJChunk &r_chunk)
 {
   float3 normal;
   parse_floats(p, end, 0.0f, normal, 3);
@@ -145,14 +214,58 @@ static void geom_add_vertex_normal(const char *p,
    * making them ever-so-slightly non unit length. Make sure they are
    * normalized. */
   normalize_v3(normal);
-  r_global_vertices.vert_normals.append(normal);
+  r_chunk.vert_normals.append(normal);
 }
 
-static void geom_add_uv_vertex(const char *p, const char *end, GlobalVertices &r_global_vertices)
+static void chunk_add_uv_vertex(const char *p, const char *end, OBJChunk &r_chunk)
 {
   float2 uv;
   parse_floats(p, end, 0.0f, uv, 2);
-  r_global_vertices.uv_vertices.append(uv);
+  r_chunk.uv_vertices.append(uv);
+}
+
+/**
+ * Parse the corners of a face line. Indices are kept as written in the file, they are resolved
+ * and validated in #geom_add_polygon.
+ */
+static void chunk_add_face(const char *p, const char *end, OBJChunk &r_chunk)
+{
+  int corners_num = 0;
+  p = drop_whitespace(p, end);
+  while (p < end) {
+    RawFaceCorner raw;
+    FaceCorner &corner = raw.corner;
+    /* Parse vertex index. */
+    p = parse_int(p, end, INT32_MAX, corner.vert_index, false);
+
+    /* Skip parsing when we reach start of the comment. */
+    if (p < end && *p == '#') {
+      break;
+    }
+
+    if (p < end && *p == '/') {
+      /* Parse UV index. */
+      ++p;
+      if (p < end && *p != '/') {
+        p = parse_int(p, end, INT32_MAX, corner.uv_vert_index, false);
+        raw.got_uv = corner.uv_vert_index != INT32_MAX;
+      }
+      /* Parse normal index. */
+      if (p < end && *p == '/') {
+        ++p;
+        p = parse_int(p, end, INT32_MAX, corner.vertex_normal_index, false);
+        raw.got_normal = corner.vertex_normal_index != INT32_MAX;
+      }
+    }
+    r_chunk.face_corners.append(raw);
+    corners_num++;
+
+    /* Some files contain extra stuff per face (e.g. 4 indices); skip any remainder (#103441). */
+    p = drop_non_whitespace(p, end);
+    /* Skip whitespace to get to the next face corner. */
+    p = drop_whitespace(p, end);
+  }
+  r_chunk.face_sizes.append(corners_num);
 }
 
 /**
@@ -219,8 +332,7 @@ static void geom_add_polyline(Geometry *geom,
 }
 
 static void geom_add_polygon(Geometry *geom,
-                             const char *p,
-                             const char *end,
+                             const Span<RawFaceCorner> raw_corners,
                              const GlobalVertices &global_vertices,
                              const int material_index,
                              const int group_index,
@@ -238,33 +350,15 @@ static void geom_add_polygon(Geometry *geom,
   curr_face.start_index_ = orig_corners_size;
 
   bool face_valid = true;
-  p = drop_whitespace(p, end);
-  while (p < end && face_valid) {
-    FaceCorner corner;
-    bool got_uv = false, got_normal = false;
-    /* Parse vertex index. */
-    p = parse_int(p, end, INT32_MAX, corner.vert_index, false);
-
-    /* Skip parsing when we reach start of the comment. */
-    if (*p == '#') {
+  for (const RawFaceCorner &raw : raw_corners) {
+    if (!face_valid) {
       break;
     }
+    FaceCorner corner = raw.corner;
+    const bool got_uv = raw.got_uv;
+    const bool got_normal = raw.got_normal;
 
     face_valid &= corner.vert_index != INT32_MAX;
-    if (p < end && *p == '/') {
-      /* Parse UV index. */
-      ++p;
-      if (p < end && *p != '/') {
-        p = parse_int(p, end, INT32_MAX, corner.uv_vert_index, false);
-        got_uv = corner.uv_vert_index != INT32_MAX;
-      }
-      /* Parse normal index. */
-      if (p < end && *p == '/') {
-        ++p;
-        p = parse_int(p, end, INT32_MAX, corner.vertex_normal_index, false);
-        got_normal = corner.vertex_normal_index != INT32_MAX;
-      }
-    }
     /* Always keep stored indices non-negative and zero-based. */
     corner.vert_index += corner.vert_index < 0 ? global_vertices.vertices.size() : -1;
     if (corner.vert_index < 0 || corner.vert_index >= global_vertices.vertices.size()) {
@@ -307,11 +401,6 @@ static void geom_add_polygon(Geometry *geom,
     }
     geom->face_corners_.append(corner);
     curr_face.corner_count_++;
-
-    /* Some files contain extra stuff per face (e.g. 4 indices); skip any remainder (#103441). */
-    p = drop_non_whitespace(p, end);
-    /* Skip whitespace to get to the next face corner. */
-    p = drop_whitespace(p, end);
   }
 
   if (face_valid) {
@@ -424,18 +513,16 @@ static void geom_update_smooth_group(const char *p, const char *end, bool &r_sta
 
 static void geom_new_object(const char *p,
                             const char *end,
-                            bool &r_state_shaded_smooth,
-                            string &r_state_group_name,
-                            int &r_state_material_index,
+                            OBJParseState &r_state,
                             Geometry *&r_curr_geom,
                             Vector<std::unique_ptr<Geometry>> &r_all_geometries)
 {
-  r_state_shaded_smooth = false;
-  r_state_group_name = "";
+  r_state.shaded_smooth = false;
+  r_state.group_name = "";
   /* Reset object-local material index that's used in face information.
    * NOTE: do not reset the material name; that has to carry over
    * into the next object if needed. */
-  r_state_material_index = -1;
+  r_state.material_index = -1;
   r_curr_geom = create_geometry(
       r_curr_geom, GEOM_MESH, StringRef(p, end).trim(), r_all_geometries);
 }
@@ -508,7 +595,7 @@ static void use_all_vertices_if_no_faces(Geometry *geom,
 /* OBJ file format supports "line continuations", which
  * are back-slashes, optionally followed by whitespace.
  * The line virtually extends to the next line in that case. */
-StringRef OBJParser::read_next_obj_line(StringRef &buffer)
+static StringRef read_next_obj_line(StringRef &buffer, string &line_buffer)
 {
   const char *start = buffer.begin();
   const char *end = buffer.end();
@@ -529,7 +616,7 @@ StringRef OBJParser::read_next_obj_line(StringRef &buffer)
   /* We have backslash. Copy into line buffer, replace
    * line continuation with space, return result. */
 
-  line_buffer_.assign(start, ptr);
+  line_buffer.assign(start, ptr);
 
   while (ptr < end) {
     char c = *ptr++;
@@ -541,41 +628,64 @@ StringRef OBJParser::read_next_obj_line(StringRef &buffer)
       }
       if (ahead < end && *ahead == '\n') {
         /* Line continuation: replace backslash & newline with space. */
-        line_buffer_ += ' ';
+        line_buffer += ' ';
         ptr = ahead + 1; /* Continue after the newline. */
       }
       else {
         /* Not a continuation: keep the backslash. */
-        line_buffer_ += c;
+        line_buffer += c;
       }
     }
     else if (c == '\n') {
       break;
     }
     else {
-      line_buffer_ += c;
+      line_buffer += c;
     }
   }
 
   buffer = StringRef(ptr, end);
-  return line_buffer_;
+  return line_buffer;
 }
 
-void OBJParser::parse_string_buffer(StringRef &buffer_str,
-                                    Vector<std::unique_ptr<Geometry>> &r_all_geometries,
-                                    GlobalVertices &r_global_vertices,
-                                    Geometry *&curr_geom)
+/**
+ * Split the buffer into parts of roughly `chunk_size` bytes which end at line boundaries.
+ * A newline preceded by a line continuation back-slash is not a line boundary.
+ */
+static Vector<StringRef> split_into_line_chunks(const StringRef buffer, const int64_t chunk_size)
 {
-  /* State variables: once set, they remain the same for the remaining
-   * elements in the object. */
-  bool state_shaded_smooth = false;
-  string state_group_name;
-  int state_group_index = -1;
-  string state_material_name;
-  int state_material_index = -1;
+  Vector<StringRef> chunks;
+  const char *start = buffer.begin();
+  const char *end = buffer.end();
+  while (start < end) {
+    const char *ptr = start + std::min(chunk_size, int64_t(end - start));
+    while (ptr < end) {
+      const char *newline = static_cast<const char *>(memchr(ptr, '\n', end - ptr));
+      if (newline == nullptr) {
+        ptr = end;
+        break;
+      }
+      ptr = newline + 1;
+      const char *line_end = newline;
+      while (line_end > start && line_end[-1] <= ' ' && line_end[-1] != '\n') {
+        --line_end;
+      }
+      if (line_end == start || line_end[-1] != '\\') {
+        break;
+      }
+    }
+    chunks.append(StringRef(start, ptr));
+    start = ptr;
+  }
+  return chunks;
+}
 
-  while (!buffer_str.is_empty()) {
-    StringRef line = read_next_obj_line(buffer_str);
+/** Parse the numeric data of a chunk, see #OBJChunk. Can run in parallel with other chunks. */
+static void parse_chunk(StringRef buffer, OBJChunk &r_chunk)
+{
+  string line_buffer;
+  while (!buffer.is_empty()) {
+    const StringRef line = read_next_obj_line(buffer, line_buffer);
     const char *p = line.begin(), *end = line.end();
     p = drop_whitespace(p, end);
     if (p == end) {
@@ -584,113 +694,215 @@ void OBJParser::parse_string_buffer(StringRef &buffer_str,
     /* Most common things that start with 'v': vertices, normals, UVs. */
     if (*p == 'v') {
       if (parse_keyword(p, end, "v")) {
-        geom_add_vertex(p, end, r_global_vertices);
+        chunk_add_vertex(p, end, r_chunk);
+        r_chunk.add_line(OBJChunk::LineType::Vertex);
       }
       else if (parse_keyword(p, end, "vn")) {
-        geom_add_vertex_normal(p, end, r_global_vertices);
+        chunk_add_vertex_normal(p, end, r_chunk);
+        r_chunk.add_line(OBJChunk::LineType::Normal);
       }
       else if (parse_keyword(p, end, "vt")) {
-        geom_add_uv_vertex(p, end, r_global_vertices);
+        chunk_add_uv_vertex(p, end, r_chunk);
+        r_chunk.add_line(OBJChunk::LineType::UV);
       }
     }
     /* Faces. */
     else if (parse_keyword(p, end, "f")) {
-      /* If we don't have a material index assigned yet, get one.
-       * It means "usemtl" state came from the previous object. */
-      if (state_material_index == -1 && !state_material_name.empty() &&
-          curr_geom->material_indices_.is_empty())
-      {
-        curr_geom->material_indices_.add_new(state_material_name, 0);
-        curr_geom->material_order_.append(state_material_name);
-        state_material_index = 0;
-      }
-
-      geom_add_polygon(curr_geom,
-                       p,
-                       end,
-                       r_global_vertices,
-                       state_material_index,
-                       state_group_index,
-                       state_shaded_smooth);
-    }
-    /* Faces. */
-    else if (parse_keyword(p, end, "l")) {
-      geom_add_polyline(curr_geom, p, end, r_global_vertices);
-    }
-    /* Objects. */
-    else if (parse_keyword(p, end, "o")) {
-      if (import_params_.use_split_objects) {
-        geom_new_object(p,
-                        end,
-                        state_shaded_smooth,
-                        state_group_name,
-                        state_material_index,
-                        curr_geom,
-                        r_all_geometries);
-      }
-    }
-    /* Groups. */
-    else if (parse_keyword(p, end, "g")) {
-      if (import_params_.use_split_groups) {
-        geom_new_object(p,
-                        end,
-                        state_shaded_smooth,
-                        state_group_name,
-                        state_material_index,
-                        curr_geom,
-                        r_all_geometries);
-      }
-      else {
-        geom_update_group(StringRef(p, end).trim(), state_group_name);
-        int new_index = curr_geom->group_indices_.size();
-        state_group_index = curr_geom->group_indices_.lookup_or_add(state_group_name, new_index);
-        if (new_index == state_group_index) {
-          curr_geom->group_order_.append(state_group_name);
-        }
-      }
-    }
-    /* Smoothing groups. */
-    else if (parse_keyword(p, end, "s")) {
-      geom_update_smooth_group(p, end, state_shaded_smooth);
-    }
-    /* Materials and their libraries. */
-    else if (parse_keyword(p, end, "usemtl")) {
-      state_material_name = StringRef(p, end).trim();
-      int new_mat_index = curr_geom->material_indices_.size();
-      state_material_index = curr_geom->material_indices_.lookup_or_add(state_material_name,
-                                                                        new_mat_index);
-      if (new_mat_index == state_material_index) {
-        curr_geom->material_order_.append(state_material_name);
-      }
-    }
-    else if (parse_keyword(p, end, "mtllib")) {
-      add_mtl_library(StringRef(p, end).trim());
-    }
-    else if (parse_keyword(p, end, "#MRGB")) {
-      geom_add_mrgb_colors(p, end, r_global_vertices);
+      chunk_add_face(p, end, r_chunk);
+      r_chunk.add_line(OBJChunk::LineType::Face);
     }
-    /* Comments. */
-    else if (*p == '#') {
-      /* Nothing to do. */
+    else {
+      const bool references_file = line.data() != line_buffer.data();
+      r_chunk.other_lines.append(references_file ? StringRef(p, end) :
+                                                r_chunk.allocator.copy_string(StringRef(p, end)));
+      r_chunk.add_line(OBJChunk::LineType::Other);
     }
-    /* Curve related things. */
-    else if (parse_keyword(p, end, "cstype")) {
-      curr_geom = geom_set_curve_type(curr_geom, p, end, state_group_name, r_all_geometries);
+  }
+}
+
+void OBJParser::parse_line(StringRef line,
+                           OBJParseState &state,
+                           Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                           GlobalVertices &r_global_vertices,
+                           Geometry *&curr_geom)
+{
+  const char *p = line.begin(), *end = line.end();
+  p = drop_whitespace(p, end);
+  if (p == end) {
+    return;
+  }
+  /* Polylines. */
+  if (parse_keyword(p, end, "l")) {
+    geom_add_polyline(curr_geom, p, end, r_global_vertices);
+  }
+  /* Objects. */
+  else if (parse_keyword(p, end, "o")) {
+    if (import_params_.use_split_objects) {
+      geom_new_object(p, end, state, curr_geom, r_all_geometries);
     }
-    else if (parse_keyword(p, end, "deg")) {
-      geom_set_curve_degree(curr_geom, p, end);
+  }
+  /* Groups. */
+  else if (parse_keyword(p, end, "g")) {
+    if (import_params_.use_split_groups) {
+      geom_new_object(p, end, state, curr_geom, r_all_geometries);
     }
-    else if (parse_keyword(p, end, "curv")) {
-      geom_add_curve_vertex_indices(curr_geom, p, end, r_global_vertices);
+    else {
+      geom_update_group(StringRef(p, end).trim(), state.group_name);
+      int new_index = curr_geom->group_indices_.size();
+      state.group_index = curr_geom->group_indices_.lookup_or_add(state.group_name, new_index);
+      if (new_index == state.group_index) {
+        curr_geom->group_order_.append(state.group_name);
+      }
     }
-    else if (parse_keyword(p, end, "parm")) {
-      geom_add_curve_parameters(curr_geom, p, end);
+  }
+  /* Smoothing groups. */
+  else if (parse_keyword(p, end, "s")) {
+    geom_update_smooth_group(p, end, state.shaded_smooth);
+  }
+  /* Materials and their libraries. */
+  else if (parse_keyword(p, end, "usemtl")) {
+    state.material_name = StringRef(p, end).trim();
+    int new_mat_index = curr_geom->material_indices_.size();
+    state.material_index = curr_geom->material_indices_.lookup_or_add(state.material_name,
+                                                                      new_mat_index);
+    if (new_mat_index == state.material_index) {
+      curr_geom->material_order_.append(state.material_name);
     }
-    else if (StringRef(p, end).startswith("end")) {
-      /* End of curve definition, nothing else to do. */
+  }
+  else if (parse_keyword(p, end, "mtllib")) {
+    add_mtl_library(StringRef(p, end).trim());
+  }
+  else if (parse_keyword(p, end, "#MRGB")) {
+    geom_add_mrgb_colors(p, end, r_global_vertices);
+  }
+  /* Comments. */
+  else if (*p == '#') {
+    /* Nothing to do. */
+  }
+  /* Curve related things. */
+  else if (parse_keyword(p, end, "cstype")) {
+    curr_geom = geom_set_curve_type(curr_geom, p, end, state.group_name, r_all_geometries);
+  }
+  else if (parse_keyword(p, end, "deg")) {
+    geom_set_curve_degree(curr_geom, p, end);
+  }
+  else if (parse_keyword(p, end, "curv")) {
+    geom_add_curve_vertex_indices(curr_geom, p, end, r_global_vertices);
+  }
+  else if (parse_keyword(p, end, "parm")) {
+    geom_add_curve_parameters(curr_geom, p, end);
+  }
+  else if (StringRef(p, end).startswith("end")) {
+    /* End of curve definition, nothing else to do. */
+  }
+  else {
+    CLOG_WARN(&LOG, "OBJ element not recognized: '%s'", string(p, end).c_str());
+  }
+}
+
+void OBJParser::add_chunk(const OBJChunk &chunk,
+                          OBJParseState &state,
+                          Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                          GlobalVertices &r_global_vertices,
+                          Geometry *&curr_geom)
+{
+  int64_t vertex_i = 0, normal_i = 0, uv_i = 0, face_i = 0, corner_i = 0, other_i = 0;
+  int64_t color_i = 0, weight_i = 0;
+
+  for (const OBJChunk::LineRun &run : chunk.runs) {
+    switch (run.type) {
+      case OBJChunk::LineType::Vertex: {
+        /* Only #MRGB lines add to the block, so flushing once per run is enough. */
+        r_global_vertices.flush_mrgb_block();
+        const int64_t global_offset = r_global_vertices.vertices.size() - vertex_i;
+        r_global_vertices.vertices.extend(chunk.vertices.as_span().slice(vertex_i, run.count));
+        vertex_i += run.count;
+        for (; color_i < chunk.vertex_colors.size(); color_i++) {
+          const auto &[index, color] = chunk.vertex_colors[color_i];
+          if (index >= vertex_i) {
+            break;
+          }
+          r_global_vertices.set_vertex_color(global_offset + index, color);
+        }
+        for (; weight_i < chunk.vertex_weights.size(); weight_i++) {
+          const auto &[index, weight] = chunk.vertex_weights[weight_i];
+          if (index >= vertex_i) {
+            break;
+          }
+          r_global_vertices.set_vertex_weight(global_offset + index, weight);
+        }
+        break;
+      }
+      case OBJChunk::LineType::Normal: {
+        r_global_vertices.vert_normals.extend(
+            chunk.vert_normals.as_span().slice(normal_i, run.count));
+        normal_i += run.count;
+        break;
+      }
+      case OBJChunk::LineType::UV: {
+        r_global_vertices.uv_vertices.extend(chunk.uv_vertices.as_span().slice(uv_i, run.count));
+        uv_i += run.count;
+        break;
+      }
+      case OBJChunk::LineType::Face: {
+        for ([[maybe_unused]] const int i : IndexRange(run.count)) {
+          /* If we don't have a material index assigned yet, get one.
+           * It means "usemtl" state came from the previous object. */
+          if (state.material_index == -1 && !state.material_name.empty() &&
+              curr_geom->material_indices_.is_empty())
+          {
+            curr_geom->material_indices_.add_new(state.material_name, 0);
+            curr_geom->material_order_.append(state.material_name);
+            state.material_index = 0;
+          }
+
+          const int face_size = chunk.face_sizes[face_i];
+          geom_add_polygon(curr_geom,
+                           chunk.face_corners.as_span().slice(corner_i, face_size),
+                           r_global_vertices,
+                           state.material_index,
+                           state.group_index,
+                           state.shaded_smooth);
+          face_i++;
+          corner_i += face_size;
+        }
+        break;
+      }
+      case OBJChunk::LineType::Other: {
+        for ([[maybe_unused]] const int i : IndexRange(run.count)) {
+          this->parse_line(
+              chunk.other_lines[other_i], state, r_all_geometries, r_global_vertices, curr_geom);
+          other_i++;
+        }
+        break;
+      }
     }
-    else {
-      CLOG_WARN(&LOG, "OBJ element not recognized: '%s'", string(p, end).c_str());
+  }
+}
+
+void OBJParser::parse_string_buffer(StringRef buffer_str,
+                                    Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                                    GlobalVertices &r_global_vertices,
+                                    Geometry *&curr_geom)
+{
+  /* State variables: once set, they remain the same for the remaining
+   * elements in the object. */
+  OBJParseState state;
+
+  const Vector<StringRef> chunk_buffers = split_into_line_chunks(buffer_str, OBJ_CHUNK_SIZE);
+  for (int64_t batch_start = 0; batch_start < chunk_buffers.size();
+       batch_start += OBJ_CHUNKS_PER_BATCH)
+  {
+    const Span<StringRef> batch_buffers = chunk_buffers.as_span().slice(
+        batch_start, std::min(OBJ_CHUNKS_PER_BATCH, chunk_buffers.size() - batch_start));
+    Array<OBJChunk> chunks(batch_buffers.size());
+    threading::parallel_for(chunks.index_range(), 1, [&](const IndexRange range) {
+      for (const int64_t i : range) {
+        parse_chunk(batch_buffers[i], chunks[i]);
+      }
+    });
+    for (const OBJChunk &chunk : chunks) {
+      this->add_chunk(chunk, state, r_all_geometries, r_global_vertices, curr_geom);
     }
   }
 }
@@ -712,7 +924,7 @@ void OBJParser::parse(Vector<std::unique_ptr<Geometry>> &r_all_geometries,
   const char *file_data = static_cast<const char *>(BLI_mmap_get_pointer(mmap_file_));
   size_t file_size = BLI_mmap_get_length(mmap_file_);
   StringRef buffer_str{file_data, int64_t(file_size)};
-  OBJParser::parse_string_buffer(buffer_str, r_all_geometries, r_global_vertices, curr_geom);
+  this->parse_string_buffer(buffer_str, r_all_geometries, r_global_vertices, curr_geom);
 
   r_global_vertices.flush_mrgb_block();
   use_all_vertices_if_no_faces(curr_geom, r_all_geometries, r_global_vertices);
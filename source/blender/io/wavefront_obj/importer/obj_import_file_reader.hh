@@ -22,13 +22,14 @@ struct BLI_mmap_file;
 namespace blender::io::obj {
 
 struct MTLMaterial;
+struct OBJChunk;
+struct OBJParseState;
 
 class OBJParser {
  private:
   const OBJImportParams &import_params_;
   Vector<std::string> mtl_libraries_;
   BLI_mmap_file *mmap_file_ = nullptr;
-  std::string line_buffer_;
 
  public:
   /**
@@ -51,11 +52,26 @@ class OBJParser {
  private:
   void add_mtl_library(StringRef path);
   void add_default_mtl_library();
-  StringRef read_next_obj_line(StringRef &buffer);
-  void parse_string_buffer(StringRef &buffer_str,
+  /**
+   * Split the buffer into line-aligned chunks whose vertices and faces are parsed in parallel,
+   * then add their data to the geometries in file order.
+   */
+  void parse_string_buffer(StringRef buffer_str,
                            Vector<std::unique_ptr<Geometry>> &r_all_geometries,
                            GlobalVertices &r_global_vertices,
                            Geometry *&curr_geom);
+  /** Add the data of a parsed chunk, resolving face indices relative to all previous chunks. */
+  void add_chunk(const OBJChunk &chunk,
+                 OBJParseState &state,
+                 Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                 GlobalVertices &r_global_vertices,
+                 Geometry *&curr_geom);
+  /** Parse a line that changes the parser state or is not handled by chunk parsing. */
+  void parse_line(StringRef line,
+                  OBJParseState &state,
+                  Vector<std::unique_ptr<Geometry>> &r_all_geometries,
+                  GlobalVertices &r_global_vertices,
+                  Geometry *&curr_geom);
 };
 
 class MTLParser {
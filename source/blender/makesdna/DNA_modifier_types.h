@@ -2418,6 +2418,8 @@ ENUM_OPERATORS(NodesModifierPanelFlag);
 enum NodesModifierBakeFlag : uint32_t {
   NODES_MODIFIER_BAKE_CUSTOM_SIMULATION_FRAME_RANGE = 1 << 0,
   NODES_MODIFIER_BAKE_CUSTOM_PATH = 1 << 1,
+  /** Compress the baked attribute arrays losslessly. */
+  NODES_MODIFIER_BAKE_COMPRESS = 1 << 2,
 };
 ENUM_OPERATORS(NodesModifierBakeFlag);
 
@@ -674,6 +674,7 @@ ENUM_OPERATORS(eCompositorCacheFlags);
 enum eCompositorPrecision : int {
   SCE_COMPOSITOR_PRECISION_AUTO = 0,
   SCE_COMPOSITOR_PRECISION_FULL = 1,
+  SCE_COMPOSITOR_PRECISION_HALF = 2,
 };
 
 /** #RenderData::compositor_denoise_device */
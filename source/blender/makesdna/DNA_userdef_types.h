@@ -68,6 +68,13 @@ enum eUserPref_AssetFlag : char {
 };
 ENUM_OPERATORS(eUserPref_AssetFlag)
 
+/** #UserDef.undo_flag */
+enum eUserPref_UndoFlag : char {
+  /** Compress global undo steps which are unlikely to be loaded soon. */
+  USER_UNDO_COMPRESS_MEMFILE = 1 << 0,
+};
+ENUM_OPERATORS(eUserPref_UndoFlag)
+
 /** #UserDef.extension_flag */
 enum eUserPref_ExtensionFlag : char {
   USER_EXTENSION_FLAG_ONLINE_ACCESS_HANDLED = 1 << 0,
@@ -871,7 +878,9 @@ struct UserDef_Experimental {
    * actually remove this flag is tracked in #158903. */
   char use_remote_asset_libraries = 1;
   char use_collection_importer = 0;
-  char _pad[4] = {};
+  char use_display_transform_lut = 0;
+  char use_depsgraph_priority_scheduling = 0;
+  char _pad[2] = {};
 };
 
 #define USER_EXPERIMENTAL_TEST(userdef, member) (((userdef)->experimental).member)
@@ -1090,7 +1099,7 @@ struct UserDef {
   short active_asset_library = 0;
   eUserPref_AssetFlag asset_flag = USER_ASSETS_USE_ONLINE_ESSENTIALS;
 
-  char _pad14[1] = {};
+  eUserPref_UndoFlag undo_flag = {};
 
   short undosteps = 32;
   int undomemory = 0;
@@ -1111,6 +1120,8 @@ struct UserDef {
   short vbotimeout = 120, vbocollectrate = 60;
   short textimeout = 120, texcollectrate = 60;
   int memcachelimit = 4096;
+  /** Size of the disk tier of the memory cache in megabytes, zero disables it. */
+  int memcache_disk_limit = 0;
   /**
    * Maximum evaluation depth of node trees (e.g. number of nested node groups, not how many nodes
    * are in a chain).
@@ -1136,7 +1147,6 @@ struct UserDef {
   eBezTriple_Interpolation ipo_new = BEZT_IPO_BEZ;
   /** Handle types for newly added keyframes. */
   eBezTriple_Handle keyhandles_new = HD_AUTO_ANIM;
-  char _pad11[4] = {};
   eZoomFrame_Mode view_frame_type = ZOOM_FRAME_MODE_KEEP_RANGE;
 
   /** Number of keyframes to zoom around current frame. */
@@ -279,6 +279,18 @@ static void rna_Depsgraph_debug_tag_update(Depsgraph *depsgraph)
   DEG_graph_tag_relations_update(depsgraph);
 }
 
+static bool rna_Depsgraph_debug_relations_validate(Depsgraph *depsgraph, Main *bmain)
+{
+  Depsgraph *full_depsgraph = DEG_graph_new(bmain,
+                                            DEG_get_input_scene(depsgraph),
+                                            DEG_get_input_view_layer(depsgraph),
+                                            DEG_get_mode(depsgraph));
+  DEG_graph_build_from_view_layer(full_depsgraph);
+  const bool is_equal = DEG_debug_compare(full_depsgraph, depsgraph);
+  DEG_graph_free(full_depsgraph);
+  return is_equal;
+}
+
 static void rna_Depsgraph_debug_stats(Depsgraph *depsgraph, char *result)
 {
   size_t outer, ops, rels;
@@ -733,6 +745,17 @@ static void rna_def_depsgraph(BlenderRNA *brna)
 
   func = RNA_def_function(srna, "debug_tag_update", "rna_Depsgraph_debug_tag_update");
 
+  func = RNA_def_function(
+      srna, "debug_relations_validate", "rna_Depsgraph_debug_relations_validate");
+  RNA_def_function_ui_description(
+      func,
+      "Compare the dependency graph with one built from scratch, differences are printed. "
+      "Relations are expected to be up to date, see update()");
+  RNA_def_function_flag(func, FUNC_USE_MAIN);
+  parm = RNA_def_boolean(
+      func, "result", false, "Result", "True if the dependency graphs are the same");
+  RNA_def_function_return(func, parm);
+
   func = RNA_def_function(srna, "debug_stats", "rna_Depsgraph_debug_stats");
   RNA_def_function_ui_description(func, "Report the number of elements in the Dependency Graph");
   /* weak!, no way to return dynamic string type */
@@ -1063,6 +1063,17 @@ static void rna_Userdef_memcache_update(Main * /*bmain*/, Scene * /*scene*/, Poi
   USERDEF_TAG_DIRTY;
 }
 
+static void rna_Userdef_memcache_disk_update(Main * /*bmain*/,
+                                             Scene * /*scene*/,
+                                             PointerRNA * /*ptr*/)
+{
+  char cache_dir[FILE_MAX];
+  BKE_appdir_folder_caches(cache_dir, sizeof(cache_dir));
+  BLI_path_append(cache_dir, sizeof(cache_dir), "memory_cache");
+  memory_cache::set_disk_cache(cache_dir, int64_t(U.memcache_disk_limit) * 1024 * 1024);
+  USERDEF_TAG_DIRTY;
+}
+
 static void rna_UserDef_weight_color_update(Main *bmain, Scene *scene, PointerRNA *ptr)
 {
   Object *ob;
@@ -5733,6 +5744,13 @@ static void rna_def_userdef_edit(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Undo Memory Size", "Maximum memory usage in megabytes (0 means unlimited)");
 
+  prop = RNA_def_property(srna, "use_undo_compression", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "undo_flag", USER_UNDO_COMPRESS_MEMFILE);
+  RNA_def_property_ui_text(prop,
+                           "Compress Undo Steps",
+                           "Compress global undo steps in the background once they are older "
+                           "than the previous step, to reduce memory usage");
+
   prop = RNA_def_property(srna, "use_global_undo", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "uiflag", USER_GLOBALUNDO);
   RNA_def_property_ui_text(
@@ -6212,6 +6230,16 @@ static void rna_def_userdef_system(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Memory Cache Limit", "Memory cache limit (in megabytes)");
   RNA_def_property_update(prop, 0, "rna_Userdef_memcache_update");
 
+  prop = RNA_def_property(srna, "memory_cache_disk_limit", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, nullptr, "memcache_disk_limit");
+  RNA_def_property_range(prop, 0, INT_MAX);
+  RNA_def_property_ui_text(prop,
+                           "Disk Cache Limit",
+                           "Size limit of the cache on disk that keeps data which was freed from "
+                           "the memory cache, like geometry imported by nodes, to reuse it in "
+                           "later sessions (in megabytes, zero disables the disk cache)");
+  RNA_def_property_update(prop, 0, "rna_Userdef_memcache_disk_update");
+
   /* Nodes. */
 
   prop = RNA_def_property(srna, "nodes_stack_limit", PROP_INT, PROP_NONE);
@@ -7776,6 +7804,18 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
       prop, "Collection Import", "Enables a file importer to be configured on a Collection");
   RNA_def_property_update(prop, 0, "rna_userdef_ui_update");
 
+  prop = RNA_def_property(srna, "use_display_transform_lut", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(prop,
+                           "Display Transform LUT",
+                           "Approximate display transforms of images drawn on the CPU with a "
+                           "baked 3D LUT, which is faster for large images");
+
+  prop = RNA_def_property(srna, "use_depsgraph_priority_scheduling", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_ui_text(prop,
+                           "Dependency Graph Priority Scheduling",
+                           "Evaluate the longest chains of operations of the dependency graph "
+                           "first, based on the measured evaluation time of every operation");
+
   prop = RNA_def_property(srna, "use_extensions_debug", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_ui_text(
       prop,
@@ -8,7 +8,6 @@
 
 #include <cstring>
 #include <fmt/format.h>
-#include <sstream>
 #include <string>
 #include <xxhash.h>
 
@@ -948,45 +947,6 @@ static BakeFrameIndices get_bake_frame_indices(
   return frame_indices;
 }
 
-static void ensure_bake_loaded(bake::NodeBakeCache &bake_cache, bake::FrameCache &frame_cache)
-{
-  if (!frame_cache.values.is_empty()) {
-    return;
-  }
-  if (!frame_cache.meta_data_source.has_value()) {
-    return;
-  }
-  if (bake_cache.memory_blob_reader) {
-    if (const auto *meta_buffer = std::get_if<Span<std::byte>>(&*frame_cache.meta_data_source)) {
-      const std::string meta_str{reinterpret_cast<const char *>(meta_buffer->data()),
-                                 size_t(meta_buffer->size())};
-      std::istringstream meta_stream{meta_str};
-      std::optional<bake::BakeValues> bake_state = bake::deserialize_bake(
-          meta_stream, *bake_cache.memory_blob_reader, *bake_cache.blob_sharing);
-      if (!bake_state.has_value()) {
-        return;
-      }
-      frame_cache.values = std::move(*bake_state);
-      return;
-    }
-  }
-  if (!bake_cache.blobs_dir) {
-    return;
-  }
-  const auto *meta_path = std::get_if<std::string>(&*frame_cache.meta_data_source);
-  if (!meta_path) {
-    return;
-  }
-  bake::DiskBlobReader blob_reader{*bake_cache.blobs_dir};
-  fstream meta_file{*meta_path};
-  std::optional<bake::BakeValues> bake_values = bake::deserialize_bake(
-      meta_file, blob_reader, *bake_cache.blob_sharing);
-  if (!bake_values.has_value()) {
-    return;
-  }
-  frame_cache.values = std::move(*bake_values);
-}
-
 static bool try_find_baked_data(const NodesModifierBake &bake,
                                 bake::NodeBakeCache &bake_cache,
                                 const Main &bmain,
@@ -1208,6 +1168,7 @@ class NodesModifierSimulationParams : public nodes::GeoNodesSimulationParams {
     const BakeFrameIndices frame_indices = get_bake_frame_indices(node_cache.bake.frames,
                                                                   current_frame_);
     if (node_cache.cache_status == bake::CacheStatus::Baked) {
+      node_cache.bake.prefetch(current_frame_);
       this->read_from_cache(frame_indices, node_cache, zone_behavior);
       return;
     }
@@ -1375,7 +1336,7 @@ class NodesModifierSimulationParams : public nodes::GeoNodesSimulationParams {
                    nodes::SimulationZoneBehavior &zone_behavior) const
   {
     bake::FrameCache &frame_cache = *node_cache.bake.frames[frame_index];
-    ensure_bake_loaded(node_cache.bake, frame_cache);
+    node_cache.bake.ensure_frame_loaded(frame_cache);
     auto &read_single_info = zone_behavior.output.emplace<sim_output::ReadSingle>();
     read_single_info.values = frame_cache.values;
   }
@@ -1387,8 +1348,8 @@ class NodesModifierSimulationParams : public nodes::GeoNodesSimulationParams {
   {
     bake::FrameCache &prev_frame_cache = *node_cache.bake.frames[prev_frame_index];
     bake::FrameCache &next_frame_cache = *node_cache.bake.frames[next_frame_index];
-    ensure_bake_loaded(node_cache.bake, prev_frame_cache);
-    ensure_bake_loaded(node_cache.bake, next_frame_cache);
+    node_cache.bake.ensure_frame_loaded(prev_frame_cache);
+    node_cache.bake.ensure_frame_loaded(next_frame_cache);
     auto &read_interpolated_info = zone_behavior.output.emplace<sim_output::ReadInterpolated>();
     read_interpolated_info.mix_factor = (float(current_frame_) - float(prev_frame_cache.frame)) /
                                         (float(next_frame_cache.frame) -
@@ -1492,6 +1453,7 @@ class NodesModifierBakeParams : public nodes::GeoNodesBakeParams {
       behavior.behavior.emplace<sim_output::PassThrough>();
       return;
     }
+    node_cache.bake.prefetch(current_frame_);
     const BakeFrameIndices frame_indices = get_bake_frame_indices(node_cache.bake.frames,
                                                                   current_frame_);
     if (frame_indices.current) {
@@ -1518,7 +1480,7 @@ class NodesModifierBakeParams : public nodes::GeoNodesBakeParams {
                    nodes::BakeNodeBehavior &behavior) const
   {
     bake::FrameCache &frame_cache = *node_cache.bake.frames[frame_index];
-    ensure_bake_loaded(node_cache.bake, frame_cache);
+    node_cache.bake.ensure_frame_loaded(frame_cache);
     if (this->check_read_error(frame_cache, behavior)) {
       return;
     }
@@ -1533,8 +1495,8 @@ class NodesModifierBakeParams : public nodes::GeoNodesBakeParams {
   {
     bake::FrameCache &prev_frame_cache = *node_cache.bake.frames[prev_frame_index];
     bake::FrameCache &next_frame_cache = *node_cache.bake.frames[next_frame_index];
-    ensure_bake_loaded(node_cache.bake, prev_frame_cache);
-    ensure_bake_loaded(node_cache.bake, next_frame_cache);
+    node_cache.bake.ensure_frame_loaded(prev_frame_cache);
+    node_cache.bake.ensure_frame_loaded(next_frame_cache);
     if (this->check_read_error(prev_frame_cache, behavior) ||
         this->check_read_error(next_frame_cache, behavior))
     {
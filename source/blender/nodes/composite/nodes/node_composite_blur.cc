@@ -2,9 +2,11 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_array.hh"
 #include "BLI_assert.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 
 #include "RNA_types.hh"
 
@@ -211,56 +213,72 @@ class BlurOperation : public NodeOperation {
     const Domain domain = input.domain();
     output.allocate_texture(domain);
 
-    parallel_for(domain.data_size, [&](const int2 texel) {
-      float4 accumulated_color = float4(0.0f);
-
-      /* First, compute the contribution of the center pixel. */
-      float4 center_color = float4(input.load_pixel_extended<Color>(texel));
-      accumulated_color += center_color * weights.load_pixel<float>(int2(0));
-
-      int2 weights_size = weights.domain().data_size;
-
-      /* Then, compute the contributions of the pixels along the x axis of the filter, noting that
-       * the weights texture only stores the weights for the positive half, but since the filter is
-       * symmetric, the same weight is used for the negative half and we add both of their
-       * contributions. */
-      for (int x = 1; x < weights_size.x; x++) {
-        float weight = weights.load_pixel<float>(int2(x, 0));
-        accumulated_color += float4(input.load_pixel_extended<Color>(texel + int2(x, 0))) * weight;
-        accumulated_color += float4(input.load_pixel_extended<Color>(texel + int2(-x, 0))) *
-                             weight;
+    const int2 size = domain.data_size;
+    const int2 weights_size = weights.domain().data_size;
+    parallel_for_row_segments(size, [&](const int y, const IndexRange x_range) {
+      /* Gather the rows of the weights as well as the input rows above and below the current row
+       * at each of the rows of the filter, clamping to the image bounds to extend it. */
+      Array<Span<float>, 16> weights_rows(weights_size.y);
+      Array<Span<Color>, 16> upper_rows(weights_size.y);
+      Array<Span<Color>, 16> lower_rows(weights_size.y);
+      for (const int i : IndexRange(weights_size.y)) {
+        weights_rows[i] = weights.row_segment<float>(i, IndexRange(weights_size.x));
+        upper_rows[i] = input.row_segment<Color>(math::min(y + i, size.y - 1), IndexRange(size.x));
+        lower_rows[i] = input.row_segment<Color>(math::max(y - i, 0), IndexRange(size.x));
       }
 
-      /* Then, compute the contributions of the pixels along the y axis of the filter, noting that
-       * the weights texture only stores the weights for the positive half, but since the filter is
-       * symmetric, the same weight is used for the negative half and we add both of their
-       * contributions. */
-      for (int y = 1; y < weights_size.y; y++) {
-        float weight = weights.load_pixel<float>(int2(0, y));
-        accumulated_color += float4(input.load_pixel_extended<Color>(texel + int2(0, y))) * weight;
-        accumulated_color += float4(input.load_pixel_extended<Color>(texel + int2(0, -y))) *
-                             weight;
-      }
+      /* Loads the pixel at the given x coordinate from the given row, clamping to the row bounds
+       * to extend it. */
+      const int64_t last_x = size.x - 1;
+      auto load = [&](const Span<Color> row, const int64_t x) {
+        return float4(row[math::clamp(x, int64_t(0), last_x)]);
+      };
+
+      MutableSpan<Color> output_row = output.row_segment_for_write<Color>(y, x_range);
+      for (const int64_t i : x_range.index_range()) {
+        const int64_t x = x_range[i];
+        float4 accumulated_color = float4(0.0f);
+
+        /* First, compute the contribution of the center pixel. */
+        float4 center_color = load(upper_rows[0], x);
+        accumulated_color += center_color * weights_rows[0][0];
+
+        /* Then, compute the contributions of the pixels along the x axis of the filter, noting
+         * that the weights texture only stores the weights for the positive half, but since the
+         * filter is symmetric, the same weight is used for the negative half and we add both of
+         * their contributions. */
+        for (int dx = 1; dx < weights_size.x; dx++) {
+          float weight = weights_rows[0][dx];
+          accumulated_color += load(upper_rows[0], x + dx) * weight;
+          accumulated_color += load(upper_rows[0], x - dx) * weight;
+        }
 
-      /* Finally, compute the contributions of the pixels in the four quadrants of the filter,
-       * noting that the weights texture only stores the weights for the upper right quadrant, but
-       * since the filter is symmetric, the same weight is used for the rest of the quadrants and
-       * we add all four of their contributions. */
-      for (int y = 1; y < weights_size.y; y++) {
-        for (int x = 1; x < weights_size.x; x++) {
-          float weight = weights.load_pixel<float>(int2(x, y));
-          accumulated_color += float4(input.load_pixel_extended<Color>(texel + int2(x, y))) *
-                               weight;
-          accumulated_color += float4(input.load_pixel_extended<Color>(texel + int2(-x, y))) *
-                               weight;
-          accumulated_color += float4(input.load_pixel_extended<Color>(texel + int2(x, -y))) *
-                               weight;
-          accumulated_color += float4(input.load_pixel_extended<Color>(texel + int2(-x, -y))) *
-                               weight;
+        /* Then, compute the contributions of the pixels along the y axis of the filter, noting
+         * that the weights texture only stores the weights for the positive half, but since the
+         * filter is symmetric, the same weight is used for the negative half and we add both of
+         * their contributions. */
+        for (int dy = 1; dy < weights_size.y; dy++) {
+          float weight = weights_rows[dy][0];
+          accumulated_color += load(upper_rows[dy], x) * weight;
+          accumulated_color += load(lower_rows[dy], x) * weight;
         }
-      }
 
-      output.store_pixel(texel, Color(accumulated_color));
+        /* Finally, compute the contributions of the pixels in the four quadrants of the filter,
+         * noting that the weights texture only stores the weights for the upper right quadrant,
+         * but since the filter is symmetric, the same weight is used for the rest of the
+         * quadrants and we add all four of their contributions. */
+        for (int dy = 1; dy < weights_size.y; dy++) {
+          for (int dx = 1; dx < weights_size.x; dx++) {
+            float weight = weights_rows[dy][dx];
+            accumulated_color += load(upper_rows[dy], x + dx) * weight;
+            accumulated_color += load(upper_rows[dy], x - dx) * weight;
+            accumulated_color += load(lower_rows[dy], x + dx) * weight;
+            accumulated_color += load(lower_rows[dy], x - dx) * weight;
+          }
+        }
+
+        output_row[i] = Color(accumulated_color);
+      }
     });
   }
 
@@ -57,6 +57,12 @@ class DespeckleOperation : public NodeOperation {
  public:
   using NodeOperation::NodeOperation;
 
+  /* The operation reads the 3x3 window around every pixel. */
+  std::optional<int> get_kernel_radius() override
+  {
+    return 1;
+  }
+
   void execute() override
   {
     const Result &input = this->get_input("Image");
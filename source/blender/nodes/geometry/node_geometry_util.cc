@@ -2,8 +2,13 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cstring>
 #include <optional>
+#include <ostream>
 
+#include <fmt/format.h>
+
+#include "BLI_memory_counter.hh"
 #include "BLI_string.hh"
 
 #include "node_geometry_util.hh"
@@ -12,6 +17,8 @@
 #include "DNA_space_types.h"
 #include "DNA_userdef_types.h"
 
+#include "BKE_bake_items_serialize.hh"
+#include "BKE_blender_version.h"
 #include "BKE_node.hh"
 
 #include "NOD_rna_define.hh"
@@ -25,6 +32,73 @@ namespace blender {
 
 namespace nodes {
 
+std::string import_geometry_cache_key(const StringRef importer_name, const int importer_version)
+{
+  return fmt::format("{} {} blender {}.{}.{} bake {}",
+                     importer_name,
+                     importer_version,
+                     BLENDER_VERSION,
+                     BLENDER_VERSION_PATCH,
+                     BLENDER_FILE_SUBVERSION,
+                     bke::bake::bake_file_version);
+}
+
+void ImportGeometryCache::count_memory(MemoryCounter &counter) const
+{
+  this->geometry.count_memory(counter);
+}
+
+bool ImportGeometryCache::write_to_disk(std::ostream &stream) const
+{
+  const uint64_t warnings_num = this->warnings.size();
+  stream.write(reinterpret_cast<const char *>(&warnings_num), sizeof(uint64_t));
+  for (const eval_log::NodeWarning &warning : this->warnings) {
+    const int32_t type = int32_t(warning.type);
+    const uint64_t message_size = warning.message.size();
+    stream.write(reinterpret_cast<const char *>(&type), sizeof(int32_t));
+    stream.write(reinterpret_cast<const char *>(&message_size), sizeof(uint64_t));
+    stream.write(warning.message.data(), warning.message.size());
+  }
+  return bke::bake::serialize_geometry(this->geometry, stream);
+}
+
+std::unique_ptr<ImportGeometryCache> ImportGeometryCache::read_from_disk(Span<std::byte> data)
+{
+  auto read = [&](void *r_value, const uint64_t size) {
+    if (uint64_t(data.size()) < size) {
+      return false;
+    }
+    memcpy(r_value, data.data(), size);
+    data = data.drop_front(int64_t(size));
+    return true;
+  };
+
+  auto value = std::make_unique<ImportGeometryCache>();
+  uint64_t warnings_num;
+  if (!read(&warnings_num, sizeof(uint64_t))) {
+    return nullptr;
+  }
+  for ([[maybe_unused]] const uint64_t i : IndexRange(warnings_num)) {
+    int32_t type;
+    uint64_t message_size;
+    if (!read(&type, sizeof(int32_t)) || !read(&message_size, sizeof(uint64_t)) ||
+        uint64_t(data.size()) < message_size)
+    {
+      return nullptr;
+    }
+    const StringRef message(reinterpret_cast<const char *>(data.data()), int64_t(message_size));
+    value->warnings.append({NodeWarningType(type), message});
+    data = data.drop_front(int64_t(message_size));
+  }
+
+  std::optional<GeometrySet> geometry = bke::bake::deserialize_geometry(data);
+  if (!geometry) {
+    return nullptr;
+  }
+  value->geometry = std::move(*geometry);
+  return value;
+}
+
 bool check_tool_context_and_error(GeoNodeExecParams &params)
 {
   if (!params.user_data()->call_data->operator_data) {
@@ -8,6 +8,8 @@
 
 #include "MEM_guardedalloc.h"  // IWYU pragma: export
 
+#include "BLI_memory_cache.hh"
+
 #include "BKE_node.hh"
 #include "BKE_node_legacy_types.hh"  // IWYU pragma: export
 #include "BKE_node_socket_value.hh"  // IWYU pragma: export
@@ -82,5 +84,30 @@ void node_geo_exec_with_too_old_openvdb(GeoNodeExecParams &params);
 
 void draw_data_blocks(const bContext *C, ui::Layout &layout, PointerRNA &bake_rna);
 
+/**
+ * Key of an importer for #memory_cache::get_loaded. Data in the disk tier of the cache may have
+ * been written by a different Blender version, so the persistent identifier of the key contains
+ * the Blender version, the bake format version (see #ImportGeometryCache) and the version of the
+ * importer, which has to be increased when the importer output changes.
+ */
+std::string import_geometry_cache_key(StringRef importer_name, int importer_version);
+
+/**
+ * Cached result of the nodes that import a geometry from a file. It supports the disk tier of the
+ * memory cache, so that files don't have to be imported again in later sessions.
+ */
+class ImportGeometryCache : public memory_cache::CachedValue {
+ public:
+  GeometrySet geometry;
+  Vector<eval_log::NodeWarning> warnings;
+
+  void count_memory(MemoryCounter &counter) const override;
+
+  bool write_to_disk(std::ostream &stream) const override;
+
+  /** Read the data written by #write_to_disk, returns null if it's invalid. */
+  static std::unique_ptr<ImportGeometryCache> read_from_disk(Span<std::byte> data);
+};
+
 }  // namespace nodes
 }  // namespace blender
@@ -728,6 +728,7 @@ void draw_common_bake_settings(bContext *C, BakeDrawContext &ctx, ui::Layout &la
                    ICON_NONE,
                    placeholder_path);
   }
+  settings_col.prop(&ctx.bake_rna, "use_compression", UI_ITEM_NONE, std::nullopt, ICON_NONE);
   {
     ui::Layout &col = settings_col.column(true);
     col.prop(&ctx.bake_rna,
@@ -27,17 +27,6 @@ static void node_declare(NodeDeclarationBuilder &b)
   b.add_output<decl::Geometry>("Instances"_ustr);
 }
 
-class LoadObjCache : public memory_cache::CachedValue {
- public:
-  GeometrySet geometry;
-  Vector<eval_log::NodeWarning> warnings;
-
-  void count_memory(MemoryCounter &counter) const override
-  {
-    this->geometry.count_memory(counter);
-  }
-};
-
 static void node_geo_exec(GeoNodeExecParams params)
 {
 #ifdef WITH_IO_WAVEFRONT_OBJ
@@ -48,35 +37,42 @@ static void node_geo_exec(GeoNodeExecParams params)
     return;
   }
 
-  std::shared_ptr<const LoadObjCache> cached_value = memory_cache::get_loaded<LoadObjCache>(
-      GenericStringKey{"import_obj_node"}, {StringRefNull(*path)}, [&]() {
-        OBJImportParams import_params;
-        STRNCPY(import_params.filepath, path->c_str());
-
-        ReportList reports;
-        BKE_reports_init(&reports, RPT_STORE);
-        BLI_SCOPED_DEFER([&]() { BKE_reports_free(&reports); });
-        import_params.reports = &reports;
-
-        Vector<bke::GeometrySet> geometries;
-        OBJ_import_geometries(&import_params, geometries);
-
-        auto instances = std::make_unique<bke::Instances>(geometries.size());
-        MutableSpan<int> handles = instances->reference_handles_for_write();
-        instances->transforms_for_write().fill(float4x4::identity());
-        for (const int i : geometries.index_range()) {
-          handles[i] = instances->add_reference(bke::InstanceReference{std::move(geometries[i])});
-        }
-
-        auto cached_value = std::make_unique<LoadObjCache>();
-        cached_value->geometry = GeometrySet::from_instances(std::move(instances));
-
-        for (Report &report : (import_params.reports)->list) {
-          cached_value->warnings.append_as(report);
-        }
-
-        return cached_value;
-      });
+  /* Increase the importer version when the imported geometry changes. */
+  const std::string cache_key = import_geometry_cache_key("import_obj_node", 1);
+  std::shared_ptr<const ImportGeometryCache> cached_value =
+      memory_cache::get_loaded<ImportGeometryCache>(
+          GenericStringKey{cache_key},
+          {StringRefNull(*path)},
+          [&]() {
+            OBJImportParams import_params;
+            STRNCPY(import_params.filepath, path->c_str());
+
+            ReportList reports;
+            BKE_reports_init(&reports, RPT_STORE);
+            BLI_SCOPED_DEFER([&]() { BKE_reports_free(&reports); });
+            import_params.reports = &reports;
+
+            Vector<bke::GeometrySet> geometries;
+            OBJ_import_geometries(&import_params, geometries);
+
+            auto instances = std::make_unique<bke::Instances>(geometries.size());
+            MutableSpan<int> handles = instances->reference_handles_for_write();
+            instances->transforms_for_write().fill(float4x4::identity());
+            for (const int i : geometries.index_range()) {
+              handles[i] = instances->add_reference(
+                  bke::InstanceReference{std::move(geometries[i])});
+            }
+
+            auto cached_value = std::make_unique<ImportGeometryCache>();
+            cached_value->geometry = GeometrySet::from_instances(std::move(instances));
+
+            for (Report &report : (import_params.reports)->list) {
+              cached_value->warnings.append_as(report);
+            }
+
+            return cached_value;
+          },
+          &ImportGeometryCache::read_from_disk);
 
   for (const eval_log::NodeWarning &warning : cached_value->warnings) {
     params.error_message_add(warning.type, warning.message);
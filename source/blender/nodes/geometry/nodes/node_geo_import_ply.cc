@@ -26,17 +26,6 @@ static void node_declare(NodeDeclarationBuilder &b)
   b.add_output<decl::Geometry>("Mesh"_ustr);
 }
 
-class LoadPlyCache : public memory_cache::CachedValue {
- public:
-  GeometrySet geometry;
-  Vector<eval_log::NodeWarning> warnings;
-
-  void count_memory(MemoryCounter &counter) const override
-  {
-    this->geometry.count_memory(counter);
-  }
-};
-
 static void node_geo_exec(GeoNodeExecParams params)
 {
 #ifdef WITH_IO_PLY
@@ -47,27 +36,33 @@ static void node_geo_exec(GeoNodeExecParams params)
     return;
   }
 
-  std::shared_ptr<const LoadPlyCache> cached_value = memory_cache::get_loaded<LoadPlyCache>(
-      GenericStringKey{"import_ply_node"}, {StringRefNull(*path)}, [&]() {
-        PLYImportParams import_params;
-        STRNCPY(import_params.filepath, path->c_str());
-        import_params.import_attributes = true;
-
-        ReportList reports;
-        BKE_reports_init(&reports, RPT_STORE);
-        BLI_SCOPED_DEFER([&]() { BKE_reports_free(&reports); });
-        import_params.reports = &reports;
-
-        Mesh *mesh = PLY_import_mesh(import_params);
-
-        auto cached_value = std::make_unique<LoadPlyCache>();
-        cached_value->geometry = GeometrySet::from_mesh(mesh);
-
-        for (Report &report : (import_params.reports)->list) {
-          cached_value->warnings.append_as(report);
-        }
-        return cached_value;
-      });
+  /* Increase the importer version when the imported geometry changes. */
+  const std::string cache_key = import_geometry_cache_key("import_ply_node", 1);
+  std::shared_ptr<const ImportGeometryCache> cached_value =
+      memory_cache::get_loaded<ImportGeometryCache>(
+          GenericStringKey{cache_key},
+          {StringRefNull(*path)},
+          [&]() {
+            PLYImportParams import_params;
+            STRNCPY(import_params.filepath, path->c_str());
+            import_params.import_attributes = true;
+
+            ReportList reports;
+            BKE_reports_init(&reports, RPT_STORE);
+            BLI_SCOPED_DEFER([&]() { BKE_reports_free(&reports); });
+            import_params.reports = &reports;
+
+            Mesh *mesh = PLY_import_mesh(import_params);
+
+            auto cached_value = std::make_unique<ImportGeometryCache>();
+            cached_value->geometry = GeometrySet::from_mesh(mesh);
+
+            for (Report &report : (import_params.reports)->list) {
+              cached_value->warnings.append_as(report);
+            }
+            return cached_value;
+          },
+          &ImportGeometryCache::read_from_disk);
 
   for (const eval_log::NodeWarning &warning : cached_value->warnings) {
     params.error_message_add(warning.type, warning.message);
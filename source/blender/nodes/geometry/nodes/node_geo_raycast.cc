@@ -140,54 +140,69 @@ static void raycast_to_mesh(const IndexMask &mask,
                             const MutableSpan<float3> r_bary_weights)
 {
   const bke::bvh::Tree &tree_data = mesh.bvh_tris();
-  mask.foreach_index([&](const int i) {
-    bke::bvh::Ray ray{};
-    ray.origin = ray_origins[i];
-    ray.direction = ray_directions[i];
-    ray.dist_max = ray_lengths[i];
-
-    if (const std::optional<bke::bvh::RayHit> hit = tree_data.ray_intersect(ray)) {
-      if (!r_hit.is_empty()) {
-        r_hit[i] = true;
-      }
-      if (!r_hit_indices.is_empty()) {
-        /* The caller must be able to handle invalid indices anyway, so don't clamp this value. */
-        r_hit_indices[i] = hit->index;
-      }
-      if (!r_hit_positions.is_empty()) {
-        r_hit_positions[i] = hit->position(ray);
-      }
-      if (!r_hit_normals.is_empty()) {
-        r_hit_normals[i] = math::normalize(hit->normal);
-      }
-      if (!r_hit_distances.is_empty()) {
-        r_hit_distances[i] = hit->distance;
-      }
-      if (!r_bary_weights.is_empty()) {
-        r_bary_weights[i] = hit->bary_coord;
-      }
-    }
-    else {
-      if (!r_hit.is_empty()) {
-        r_hit[i] = false;
-      }
-      if (!r_hit_indices.is_empty()) {
-        r_hit_indices[i] = -1;
-      }
-      if (!r_hit_positions.is_empty()) {
-        r_hit_positions[i] = float3(0.0f, 0.0f, 0.0f);
-      }
-      if (!r_hit_normals.is_empty()) {
-        r_hit_normals[i] = float3(0.0f, 0.0f, 0.0f);
-      }
-      if (!r_hit_distances.is_empty()) {
-        r_hit_distances[i] = ray_lengths[i];
+
+  /* Rays are intersected in chunks, so that consecutive rays can share the traversal of the
+   * tree. */
+  static constexpr int64_t chunk_size = 256;
+  Array<bke::bvh::Ray, 0> rays(std::min(mask.size(), chunk_size));
+  Array<std::optional<bke::bvh::RayHit>, 0> hits(rays.size());
+  for (int64_t chunk_start = 0; chunk_start < mask.size(); chunk_start += chunk_size) {
+    const IndexMask chunk = mask.slice(chunk_start,
+                                       std::min(chunk_size, mask.size() - chunk_start));
+    chunk.foreach_index([&](const int i, const int pos) {
+      bke::bvh::Ray &ray = rays[pos];
+      ray.origin = ray_origins[i];
+      ray.direction = ray_directions[i];
+      ray.dist_max = ray_lengths[i];
+    });
+    tree_data.ray_intersect_batch(rays.as_span().take_front(chunk.size()),
+                                  hits.as_mutable_span().take_front(chunk.size()));
+
+    chunk.foreach_index([&](const int i, const int pos) {
+      if (const std::optional<bke::bvh::RayHit> &hit = hits[pos]) {
+        if (!r_hit.is_empty()) {
+          r_hit[i] = true;
+        }
+        if (!r_hit_indices.is_empty()) {
+          /* The caller must be able to handle invalid indices anyway, so don't clamp this
+           * value. */
+          r_hit_indices[i] = hit->index;
+        }
+        if (!r_hit_positions.is_empty()) {
+          r_hit_positions[i] = hit->position(rays[pos]);
+        }
+        if (!r_hit_normals.is_empty()) {
+          r_hit_normals[i] = math::normalize(hit->normal);
+        }
+        if (!r_hit_distances.is_empty()) {
+          r_hit_distances[i] = hit->distance;
+        }
+        if (!r_bary_weights.is_empty()) {
+          r_bary_weights[i] = hit->bary_coord;
+        }
       }
-      if (!r_bary_weights.is_empty()) {
-        r_bary_weights[i] = float3(0);
+      else {
+        if (!r_hit.is_empty()) {
+          r_hit[i] = false;
+        }
+        if (!r_hit_indices.is_empty()) {
+          r_hit_indices[i] = -1;
+        }
+        if (!r_hit_positions.is_empty()) {
+          r_hit_positions[i] = float3(0.0f, 0.0f, 0.0f);
+        }
+        if (!r_hit_normals.is_empty()) {
+          r_hit_normals[i] = float3(0.0f, 0.0f, 0.0f);
+        }
+        if (!r_hit_distances.is_empty()) {
+          r_hit_distances[i] = ray_lengths[i];
+        }
+        if (!r_bary_weights.is_empty()) {
+          r_bary_weights[i] = float3(0);
+        }
       }
-    }
-  });
+    });
+  }
 }
 
 class RaycastFunction : public mf::MultiFunction {
@@ -241,7 +241,7 @@ PyDoc_STRVAR(
     "\n"
     "   :param size: New size.\n"
     "   :type size: tuple[int, int]\n"
-    "   :param method: Method of resizing ('FAST', 'BILINEAR').\n"
+    "   :param method: Method of resizing ('FAST', 'BILINEAR', 'MITCHELL', 'LANCZOS3').\n"
     "   :type method: str\n");
 static PyObject *py_imbuf_resize(Py_ImBuf *self, PyObject *args, PyObject *kw)
 {
@@ -250,10 +250,12 @@ static PyObject *py_imbuf_resize(Py_ImBuf *self, PyObject *args, PyObject *kw)
 
   int size[2];
 
-  enum { FAST, BILINEAR };
+  enum { FAST, BILINEAR, MITCHELL, LANCZOS3 };
   const PyC_StringEnumItems method_items[] = {
       {FAST, "FAST"},
       {BILINEAR, "BILINEAR"},
+      {MITCHELL, "MITCHELL"},
+      {LANCZOS3, "LANCZOS3"},
       {0, nullptr},
   };
   PyC_StringEnum method = {method_items, FAST};
@@ -287,6 +289,12 @@ static PyObject *py_imbuf_resize(Py_ImBuf *self, PyObject *args, PyObject *kw)
   else if (method.value_found == BILINEAR) {
     IMB_scale(self->ibuf, UNPACK2(size), IMBScaleFilter::Box, false);
   }
+  else if (method.value_found == MITCHELL) {
+    IMB_scale(self->ibuf, UNPACK2(size), IMBScaleFilter::Mitchell, false);
+  }
+  else if (method.value_found == LANCZOS3) {
+    IMB_scale(self->ibuf, UNPACK2(size), IMBScaleFilter::Lanczos3, false);
+  }
   else {
     BLI_assert_unreachable();
   }
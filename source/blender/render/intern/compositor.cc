@@ -34,6 +34,7 @@
 #include "DEG_depsgraph_query.hh"
 
 #include "COM_context.hh"
+#include "COM_cpu_buffer_pool.hh"
 #include "COM_conversion_operation.hh"
 #include "COM_domain.hh"
 #include "COM_node_group_operation.hh"
@@ -610,6 +611,8 @@ class Context : public compositor::Context {
         }
       case SCE_COMPOSITOR_PRECISION_FULL:
         return compositor::ResultPrecision::Full;
+      case SCE_COMPOSITOR_PRECISION_HALF:
+        return compositor::ResultPrecision::Half;
     }
 
     BLI_assert_unreachable();
@@ -626,6 +629,21 @@ class Context : public compositor::Context {
     return this->get_scene().runtime->compositor.nodes_evaluation_log.get();
   }
 
+  int get_tile_size() const override
+  {
+    if (this->use_gpu()) {
+      return 0;
+    }
+    /* Tiny tiles, such that small images are evaluated in many tiles, used to test that tiled and
+     * untiled evaluation give the same results. */
+    if (G.debug_value == 5010) {
+      return 4;
+    }
+    /* Large enough for operations to be efficiently multi-threaded in every tile, while keeping
+     * the intermediate results of frames of any size bounded. */
+    return 1024;
+  }
+
   void evaluate_operation_post() const override
   {
     /* If the compositor is executing due to a user edit the node tree, we wait until the operation
@@ -842,6 +860,8 @@ class Compositor {
       last_evaluation_precision_ = context.get_precision();
     }
 
+    compositor::CPUBufferPool::get().reset();
+
     if (context.use_gpu()) {
       gpu::TexturePool::get().reset();
 
@@ -62,6 +62,7 @@
 
 #include "NOD_composite.hh"
 
+#include "COM_cpu_buffer_pool.hh"
 #include "COM_node_group_operation.hh"
 #include "COM_render_context.hh"
 
@@ -564,6 +565,9 @@ void RE_FreeAllRender()
 
   RE_FreeInteractiveCompositorRenders();
 
+  /* Free the buffers pooled by all compositor evaluations. */
+  compositor::CPUBufferPool::get().reset(true);
+
 #ifdef WITH_FREESTYLE
   /* finalize Freestyle */
   FRS_exit();
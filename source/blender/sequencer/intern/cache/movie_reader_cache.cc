@@ -4,6 +4,7 @@
 
 #include "movie_reader_cache.hh"
 
+#include <algorithm>
 #include <atomic>
 #include <limits>
 #include <memory>
@@ -13,6 +14,7 @@
 
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
+#include "DNA_userdef_types.h"
 
 #include "BLI_mutex.hh"
 #include "BLI_path_utils.hh"
@@ -69,6 +71,9 @@ struct MovieReaderCache {
   static constexpr int64_t max_entries = 8;
   static constexpr uint64_t stale_after_timestamps = 8;
   static constexpr int backward_seek_penalty = 32;
+  /* Part of the memory cache limit of the preferences that is used by the GOP caches of all
+   * readers, see #MOV_set_gop_cache_limit. */
+  static constexpr int gop_cache_memory_divisor = 4;
 
   Mutex mutex_;
   Vector<std::unique_ptr<MovieReaderCacheEntry>> entries_;
@@ -86,8 +91,30 @@ struct MovieReaderCache {
   bool reader_ensure_initialized(MovieReaderCacheEntry &entry);
   bool remove_oldest_stale_entry();
   void remove_excess_entries();
+  size_t gop_cache_limit_get() const;
+  void gop_cache_limits_update();
 };
 
+size_t MovieReaderCache::gop_cache_limit_get() const
+{
+  /* The memory is split evenly between the readers. Assume a few readers even if there are fewer,
+   * so that a single reader does not use all of it. */
+  const size_t memory_limit = size_t(U.memcachelimit) * 1024 * 1024 / gop_cache_memory_divisor;
+  return memory_limit / size_t(std::max<int64_t>(entries_.size(), max_entries / 2));
+}
+
+void MovieReaderCache::gop_cache_limits_update()
+{
+  /* Readers in use are updated when they are released, since they are not accessed from other
+   * threads until then. */
+  const size_t limit = gop_cache_limit_get();
+  for (const std::unique_ptr<MovieReaderCacheEntry> &entry : entries_) {
+    if (!entry->is_accessed && entry->reader != nullptr) {
+      MOV_set_gop_cache_limit(entry->reader, limit);
+    }
+  }
+}
+
 bool MovieReaderCache::remove_oldest_stale_entry()
 {
   int64_t oldest_index = -1;
@@ -107,6 +134,7 @@ bool MovieReaderCache::remove_oldest_stale_entry()
     return false;
   }
   entries_.remove(oldest_index);
+  gop_cache_limits_update();
   return true;
 }
 
@@ -197,13 +225,18 @@ MovieReaderAccessor MovieReaderCache::acquire(const MovieReaderKey &key,
     entry->key = key;
     best = entry.get();
     entries_.append(std::move(entry));
+    gop_cache_limits_update();
   }
 
   best->is_accessed = true;
   best->timestamp = timestamp_counter_;
+  const size_t gop_cache_limit = gop_cache_limit_get();
   lock.unlock();
 
   reader_open(*best);
+  if (best->reader != nullptr) {
+    MOV_set_gop_cache_limit(best->reader, gop_cache_limit);
+  }
   return MovieReaderAccessor(this, best);
 }
 
@@ -236,6 +269,7 @@ MovieReaderAccessor MovieReaderCache::acquire_any(const MovieReaderKey &key)
     entry->key = key;
     best = entry.get();
     entries_.append(std::move(entry));
+    gop_cache_limits_update();
   }
 
   best->is_accessed = true;
@@ -311,6 +345,8 @@ void MovieReaderCache::release(MovieReaderCacheEntry &entry)
       }
     }
   }
+  /* Also applies a limit that changed while the reader was used. */
+  gop_cache_limits_update();
 }
 
 void MovieReaderCache::invalidate(const std::string &source_filepath)
@@ -328,6 +364,7 @@ void MovieReaderCache::invalidate(const std::string &source_filepath)
       entries_.remove(i);
     }
   }
+  gop_cache_limits_update();
 }
 
 void MovieReaderCache::clear()
@@ -342,6 +379,7 @@ void MovieReaderCache::clear()
       entries_.remove(i);
     }
   }
+  gop_cache_limits_update();
 }
 
 MovieReaderAccessor::MovieReaderAccessor(MovieReaderCache *cache, MovieReaderCacheEntry *entry)
@@ -17,6 +17,10 @@
  *   soft size limit; stale entries are removed when subsequent frames are rendered.
  * - Cache size uses #MovieReaderCache::max_entries as a soft limit. Readers above it are removed
  *   after they have not been used for #MovieReaderCache::stale_after_timestamps render timestamps.
+ * - Readers keep the decoded frames of their most recent GOP, so that reverse playback and
+ *   scrubbing back do not decode the GOP again for every frame. The memory of these frames is
+ *   bounded by a part of the memory cache limit of the preferences, which is split between all
+ *   readers again when readers are added or removed.
  */
 
 #pragma once
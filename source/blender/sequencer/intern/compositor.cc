@@ -197,6 +197,8 @@ compositor::ResultPrecision CompositorContext::get_precision() const
                                          compositor::ResultPrecision::Half;
     case SCE_COMPOSITOR_PRECISION_FULL:
       return compositor::ResultPrecision::Full;
+    case SCE_COMPOSITOR_PRECISION_HALF:
+      return compositor::ResultPrecision::Half;
   }
   BLI_assert_unreachable();
   return compositor::ResultPrecision::Half;
@@ -12,6 +12,7 @@
 #include "BKE_idprop.hh"
 #include "BKE_node_runtime.hh"
 
+#include "COM_cpu_buffer_pool.hh"
 #include "COM_domain.hh"
 #include "COM_utilities.hh"
 
@@ -189,6 +190,7 @@ static SeqResult do_compositor_effect(const RenderData *context,
         com_context.use_gpu(), com_context.get_precision(), context->gpu_context);
     com_context.evaluate();
     com_context.cache_manager().reset();
+    compositor::CPUBufferPool::get().reset();
     if (com_context.use_gpu()) {
       render_end_gpu(*context);
     }
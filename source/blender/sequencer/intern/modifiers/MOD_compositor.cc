@@ -8,6 +8,7 @@
 
 #include "BLT_translation.hh"
 
+#include "COM_cpu_buffer_pool.hh"
 #include "COM_domain.hh"
 #include "COM_result.hh"
 #include "COM_utilities.hh"
@@ -285,6 +286,7 @@ static void compositor_modifier_apply(ModifierApplyContext &context,
       com_mod_context.use_gpu(), com_mod_context.get_precision(), context.render_data.gpu_context);
   com_mod_context.evaluate();
   com_mod_context.cache_manager().reset();
+  compositor::CPUBufferPool::get().reset();
   com_mod_context.free_resources();
   if (com_mod_context.use_gpu()) {
     render_end_gpu(context.render_data);
@@ -10,6 +10,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <limits>
+#include <memory>
+#include <optional>
 
 #include "MEM_guardedalloc.h"
 
@@ -17,8 +19,11 @@
 #include "DNA_screen_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
+#include "DNA_userdef_types.h"
 
+#include "BLI_set.hh"
 #include "BLI_threads.hh"
+#include "BLI_vector.hh"
 
 #include "IMB_imbuf.hh"
 
@@ -45,6 +50,7 @@
 #include "SEQ_sequencer.hh"
 #include "SEQ_time.hh"
 
+#include "cache/final_image_cache.hh"
 #include "prefetch.hh"
 #include "render.hh"
 
@@ -59,47 +65,80 @@ namespace seq {
 /* Prefetch several frames before the playhead, so that it is fast to move it a bit backwards. */
 static constexpr int before_playhead_frames = 5;
 
+/* Maximum number of workers which render frames at the same time. */
+static constexpr int max_workers_num = 4;
+
+struct PrefetchJob;
+
+/* Worker rendering prefetched frames in its own thread. Every worker has its own evaluation
+ * context, so that the workers can render different frames at the same time. */
+struct PrefetchWorker {
+  PrefetchJob *pfjob = nullptr;
+
+  Main *bmain_eval = nullptr;
+  Scene *scene_eval = nullptr;
+  Depsgraph *depsgraph = nullptr;
+
+  /* Render context of the evaluated scene. */
+  RenderData context_cpy = {};
+
+  /* Frame which is being rendered by the worker, as an offset from #PrefetchJob::cfra, and the
+   * timeline frame it corresponds to. The offset is not set while the worker is idle. */
+  std::optional<int> frame_offset;
+  int timeline_frame = 0;
+  /* Value of #PrefetchJob::generation when the frame was claimed. */
+  int generation = 0;
+
+ public:
+  void init_depsgraph();
+  void free_depsgraph();
+
+  void init_gpu();
+  void free_gpu();
+};
+
 struct PrefetchJob {
   PrefetchJob *next = nullptr;
   PrefetchJob *prev = nullptr;
 
   Main *bmain = nullptr;
-  Main *bmain_eval = nullptr;
   Scene *scene = nullptr;
-  Scene *scene_eval = nullptr;
-  Depsgraph *depsgraph = nullptr;
 
+  /* Protects the prefetch area and the scheduling state below, and is used to suspend workers
+   * while there is nothing to prefetch. */
   ThreadMutex prefetch_suspend_mutex = {};
   ThreadCondition prefetch_suspend_cond = {};
 
   ListBaseT<ThreadSlot> threads = {};
+  Vector<std::unique_ptr<PrefetchWorker>> workers;
 
   /* context */
   RenderData context = {};
-  RenderData context_cpy = {};
 
   /* prefetch area */
   int cfra = 0;
   int timeline_start = 0;
   int timeline_end = 0;
   int timeline_length = 0;
+  /* Number of frames after #cfra which are all prefetched. */
   int num_frames_prefetched = 0;
+  /* Offsets of frames after #num_frames_prefetched which are prefetched already, because workers
+   * finish frames in any order. */
+  Set<int> prefetched_frame_offsets;
+  /* One past the largest frame offset claimed by a worker. */
+  int num_frames_claimed = 0;
+  /* Incremented when the prefetch area is reset, frames claimed before are not counted. */
+  int generation = 0;
   int cache_flags = 0; /* Only used to detect cache flag changes. */
 
   /* Control: */
   /* Set by prefetch. */
   bool running = false;
-  bool waiting = false;
+  int running_workers_num = 0;
+  int waiting_workers_num = 0;
   bool stop = false;
   /* Set from outside. */
   bool is_scrubbing = false;
-
- public:
-  void init_depsgraph();
-  void free_depsgraph();
-
-  void init_gpu();
-  void free_gpu();
 };
 
 static PrefetchJob *seq_prefetch_job_get(Scene *scene)
@@ -140,7 +179,7 @@ static bool seq_prefetch_job_is_waiting(Scene *scene)
     return false;
   }
 
-  return pfjob->waiting;
+  return pfjob->waiting_workers_num == pfjob->running_workers_num;
 }
 
 static Strip *original_strip_get(const Strip *strip, ListBaseT<Strip> *seqbase)
@@ -203,9 +242,9 @@ static bool seq_prefetch_is_cache_full(Scene *scene)
   return evict_caches_if_full(scene);
 }
 
-static int seq_prefetch_cfra(PrefetchJob *pfjob)
+static int seq_prefetch_frame_from_offset(PrefetchJob *pfjob, const int frame_offset)
 {
-  int new_frame = pfjob->cfra + pfjob->num_frames_prefetched;
+  int new_frame = pfjob->cfra + frame_offset;
   const ScenePlaybackRange playback_range = BKE_scene_get_playback_range(pfjob->scene);
   if (new_frame >= playback_range.end_frame) {
     /* Wrap around to where we will jump when we reach the end frame. */
@@ -214,11 +253,6 @@ static int seq_prefetch_cfra(PrefetchJob *pfjob)
   return new_frame;
 }
 
-static AnimationEvalContext seq_prefetch_anim_eval_context(PrefetchJob *pfjob)
-{
-  return BKE_animsys_eval_context_construct(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
-}
-
 void seq_prefetch_get_time_range(Scene *scene, int *r_start, int *r_end)
 {
   /* When there is no prefetch job, return "impossible" negative values. */
@@ -233,11 +267,14 @@ void seq_prefetch_get_time_range(Scene *scene, int *r_start, int *r_end)
     return;
   }
 
+  /* Frames which are claimed by workers are part of the range too, so that they are not evicted
+   * from the cache while they are rendered. */
   *r_start = pfjob->cfra;
-  *r_end = seq_prefetch_cfra(pfjob);
+  *r_end = seq_prefetch_frame_from_offset(
+      pfjob, std::max(pfjob->num_frames_prefetched, pfjob->num_frames_claimed - 1));
 }
 
-void PrefetchJob::free_depsgraph()
+void PrefetchWorker::free_depsgraph()
 {
   if (this->depsgraph != nullptr) {
     DEG_graph_free(this->depsgraph);
@@ -246,36 +283,39 @@ void PrefetchJob::free_depsgraph()
   this->scene_eval = nullptr;
 }
 
-static void seq_prefetch_update_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_update_depsgraph(PrefetchWorker *worker)
 {
-  DEG_evaluate_on_framechange(pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  DEG_evaluate_on_framechange(worker->depsgraph, worker->timeline_frame);
   /* Prevent depsgraph from copying scene data to evaluated scene. It would reset updated frame. */
-  DEG_ids_clear_recalc(pfjob->depsgraph, false);
+  DEG_ids_clear_recalc(worker->depsgraph, false);
 }
 
-void PrefetchJob::init_depsgraph()
+void PrefetchWorker::init_depsgraph()
 {
-  ViewLayer *view_layer = BKE_view_layer_default_render(this->scene);
+  Scene *scene = this->pfjob->scene;
+  ViewLayer *view_layer = BKE_view_layer_default_render(scene);
 
-  this->depsgraph = DEG_graph_new(this->bmain_eval, this->scene, view_layer, DAG_EVAL_RENDER);
+  this->depsgraph = DEG_graph_new(this->bmain_eval, scene, view_layer, DAG_EVAL_RENDER);
   DEG_debug_name_set(this->depsgraph, "SEQUENCER PREFETCH");
 
   /* Make sure there is a correct evaluated scene pointer. */
   DEG_graph_build_for_render_pipeline(this->depsgraph);
 
   /* Update immediately so we have proper evaluated scene. */
+  this->timeline_frame = seq_prefetch_frame_from_offset(this->pfjob,
+                                                        this->pfjob->num_frames_prefetched);
   seq_prefetch_update_depsgraph(this);
 
   this->scene_eval = DEG_get_evaluated_scene(this->depsgraph);
   this->scene_eval->ed->cache_flag = SEQ_CACHE_NONE;
 }
 
-void PrefetchJob::init_gpu()
+void PrefetchWorker::init_gpu()
 {
   this->context_cpy.gpu_context = gpu::GPU_create_secondary_context();
 }
 
-void PrefetchJob::free_gpu()
+void PrefetchWorker::free_gpu()
 {
   if (this->context_cpy.gpu_context.ghost_context != nullptr) {
     gpu::GPU_destroy_secondary_context(this->context_cpy.gpu_context);
@@ -283,23 +323,54 @@ void PrefetchJob::free_gpu()
   }
 }
 
+/* Forget about all prefetched and claimed frames. */
+static void seq_prefetch_reset_area(PrefetchJob *pfjob)
+{
+  pfjob->num_frames_prefetched = 0;
+  pfjob->num_frames_claimed = 0;
+  pfjob->prefetched_frame_offsets.clear();
+  pfjob->generation++;
+}
+
+/* Move the start of the prefetch area forward by `delta` frames. */
+static void seq_prefetch_rebase_area(PrefetchJob *pfjob, const int delta)
+{
+  pfjob->cfra += delta;
+  pfjob->num_frames_prefetched = std::max(pfjob->num_frames_prefetched - delta, 0);
+  pfjob->num_frames_claimed = std::max(pfjob->num_frames_claimed - delta, 0);
+
+  Set<int> prefetched_frame_offsets;
+  for (const int frame_offset : pfjob->prefetched_frame_offsets) {
+    if (frame_offset - delta >= pfjob->num_frames_prefetched) {
+      prefetched_frame_offsets.add(frame_offset - delta);
+    }
+  }
+  pfjob->prefetched_frame_offsets = std::move(prefetched_frame_offsets);
+  while (pfjob->prefetched_frame_offsets.remove(pfjob->num_frames_prefetched)) {
+    pfjob->num_frames_prefetched++;
+  }
+
+  /* Frames which end up before the playhead are not counted when they are finished. */
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    if (worker->frame_offset) {
+      *worker->frame_offset -= delta;
+    }
+  }
+}
+
 static void seq_prefetch_update_area(PrefetchJob *pfjob)
 {
   int cfra = math::max(pfjob->scene->r.cfra - before_playhead_frames, pfjob->timeline_start);
 
   /* rebase */
   if (cfra > pfjob->cfra) {
-    int delta = cfra - pfjob->cfra;
-    pfjob->cfra = cfra;
-    pfjob->num_frames_prefetched -= delta;
-
-    pfjob->num_frames_prefetched = std::max(pfjob->num_frames_prefetched, 0);
+    seq_prefetch_rebase_area(pfjob, cfra - pfjob->cfra);
   }
 
   /* reset */
   if (cfra < pfjob->cfra) {
     pfjob->cfra = cfra;
-    pfjob->num_frames_prefetched = 0;
+    seq_prefetch_reset_area(pfjob);
   }
 
   /* timeline span changes */
@@ -313,14 +384,14 @@ static void seq_prefetch_update_area(PrefetchJob *pfjob)
     /* Reset the number of prefetched frames as we need to re-evaluate which
      * frames to keep in the cache.
      */
-    pfjob->num_frames_prefetched = 0;
+    seq_prefetch_reset_area(pfjob);
   }
 
   /* cache flag changes */
   Scene *scene = pfjob->scene;
   if (pfjob->cache_flags != scene->ed->cache_flag) {
     pfjob->cache_flags = scene->ed->cache_flag;
-    pfjob->num_frames_prefetched = 0;
+    seq_prefetch_reset_area(pfjob);
   }
 }
 
@@ -345,7 +416,7 @@ void prefetch_stop(Scene *scene)
   pfjob->stop = true;
 
   while (pfjob->running) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
@@ -353,18 +424,20 @@ static void seq_prefetch_update_context(const RenderData *context)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
 
-  render_new_render_data(pfjob->bmain_eval,
-                         pfjob->depsgraph,
-                         pfjob->scene_eval,
-                         context->rectx,
-                         context->recty,
-                         context->preview_render_size,
-                         nullptr,
-                         &pfjob->context_cpy);
-  pfjob->context_cpy.is_prefetch_render = true;
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    render_new_render_data(worker->bmain_eval,
+                           worker->depsgraph,
+                           worker->scene_eval,
+                           context->rectx,
+                           context->recty,
+                           context->preview_render_size,
+                           nullptr,
+                           &worker->context_cpy);
+    worker->context_cpy.is_prefetch_render = true;
+  }
 
   render_new_render_data(pfjob->bmain,
-                         pfjob->depsgraph,
+                         pfjob->workers.first()->depsgraph,
                          pfjob->scene,
                          context->rectx,
                          context->recty,
@@ -383,21 +456,25 @@ static void seq_prefetch_update_scene(Scene *scene)
   }
 
   pfjob->scene = scene;
-  pfjob->free_depsgraph();
-  pfjob->init_depsgraph();
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    worker->free_depsgraph();
+    worker->init_depsgraph();
+  }
 }
 
 static void seq_prefetch_update_active_seqbase(PrefetchJob *pfjob)
 {
   MetaStack *ms_orig = meta_stack_active_get(editing_get(pfjob->scene));
-  Editing *ed_eval = editing_get(pfjob->scene_eval);
 
-  if (ms_orig != nullptr) {
-    Strip *meta_eval = original_strip_get(ms_orig->parent_strip, pfjob->scene_eval);
-    ed_eval->current_meta_strip = meta_eval;
-  }
-  else {
-    ed_eval->current_meta_strip = nullptr;
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    Editing *ed_eval = editing_get(worker->scene_eval);
+    if (ms_orig != nullptr) {
+      Strip *meta_eval = original_strip_get(ms_orig->parent_strip, worker->scene_eval);
+      ed_eval->current_meta_strip = meta_eval;
+    }
+    else {
+      ed_eval->current_meta_strip = nullptr;
+    }
   }
 }
 
@@ -405,8 +482,8 @@ static void seq_prefetch_resume(Scene *scene)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
-  if (pfjob && pfjob->waiting) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+  if (pfjob && pfjob->waiting_workers_num > 0) {
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
@@ -419,13 +496,17 @@ void seq_prefetch_free(Scene *scene)
 
   prefetch_stop(scene);
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    BLI_threadpool_remove(&pfjob->threads, worker.get());
+  }
   BLI_threadpool_end(&pfjob->threads);
   BLI_mutex_end(&pfjob->prefetch_suspend_mutex);
   BLI_condition_end(&pfjob->prefetch_suspend_cond);
-  pfjob->free_depsgraph();
-  pfjob->free_gpu();
-  BKE_main_free(pfjob->bmain_eval);
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    worker->free_depsgraph();
+    worker->free_gpu();
+    BKE_main_free(worker->bmain_eval);
+  }
   scene->ed->runtime->prefetch_job = nullptr;
   MEM_delete(pfjob);
 }
@@ -536,18 +617,17 @@ static bool strip_renders_scene_strip(const Scene *scene,
 
 /* Prefetch must avoid rendering scene strips because they are not supported yet
  * and this will lead to crashes.  */
-static bool seq_prefetch_must_skip_frame(PrefetchJob *pfjob)
+static bool seq_prefetch_must_skip_frame(PrefetchWorker *worker)
 {
-  const Scene *scene = pfjob->scene_eval;
-  const Editing *ed = editing_get(pfjob->scene_eval);
+  const Scene *scene = worker->scene_eval;
+  const Editing *ed = editing_get(worker->scene_eval);
   ListBaseT<Strip> *seqbase = active_seqbase_get(ed);
   ListBaseT<SeqTimelineChannel> *channels = channels_displayed_get(ed);
-  int timeline_frame = seq_prefetch_cfra(pfjob);
 
   /* Pass in state to check for infinite recursion of "sequencer-type" scene strips. */
   SeqRenderState state = {};
 
-  return seqbase_renders_scene_strip(scene, channels, seqbase, timeline_frame, state);
+  return seqbase_renders_scene_strip(scene, channels, seqbase, worker->timeline_frame, state);
 }
 
 static bool seq_prefetch_need_suspend(PrefetchJob *pfjob)
@@ -556,36 +636,128 @@ static bool seq_prefetch_need_suspend(PrefetchJob *pfjob)
          (pfjob->num_frames_prefetched >= pfjob->timeline_length);
 }
 
-static void seq_prefetch_do_suspend(PrefetchJob *pfjob)
+static bool seq_prefetch_need_stop(PrefetchJob *pfjob)
 {
-  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
-  while (seq_prefetch_need_suspend(pfjob) &&
-         (pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) && !pfjob->stop)
+  return !(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) ||
+         !(pfjob->scene->ed->cache_flag & SEQ_CACHE_ALL_TYPES) || pfjob->stop;
+}
+
+/* Number of frames after the prefetched ones which workers may render at the same time. Frames
+ * are only rendered as far ahead as the remaining cache capacity allows, estimated from the
+ * memory used by the cached frames, so that they are not evicted before playback reaches them.
+ * Every worker holds about a frame worth of images while rendering, which is not part of the
+ * cache yet, so that memory is reserved from the cache capacity as well. */
+static int seq_prefetch_window_size(PrefetchJob *pfjob)
+{
+  const int workers_num = int(pfjob->workers.size());
+  const size_t final_images_num = final_image_cache_get_image_count(pfjob->scene);
+  if (final_images_num == 0) {
+    return workers_num;
+  }
+
+  const size_t cache_limit = size_t(U.memcachelimit) * 1024 * 1024;
+  const size_t cache_used = source_image_cache_calc_memory_size(pfjob->scene) +
+                            final_image_cache_calc_memory_size(pfjob->scene);
+  const size_t frame_size = std::max<size_t>(cache_used / final_images_num, 1);
+  const size_t workers_used = size_t(workers_num) * frame_size;
+  const size_t frames_num = cache_used + workers_used < cache_limit ?
+                                (cache_limit - cache_used - workers_used) / frame_size :
+                                0;
+  return int(std::clamp<size_t>(frames_num, 1, workers_num));
+}
+
+/* First frame in the prefetch window which is neither prefetched nor claimed by a worker. */
+static std::optional<int> seq_prefetch_next_frame_offset(PrefetchJob *pfjob)
+{
+  const int window_end = std::min(pfjob->num_frames_prefetched + seq_prefetch_window_size(pfjob),
+                                  pfjob->timeline_length);
+  for (int frame_offset = pfjob->num_frames_prefetched; frame_offset < window_end; frame_offset++)
   {
-    pfjob->waiting = true;
-    BLI_condition_wait(&pfjob->prefetch_suspend_cond, &pfjob->prefetch_suspend_mutex);
-    seq_prefetch_update_area(pfjob);
+    if (pfjob->prefetched_frame_offsets.contains(frame_offset)) {
+      continue;
+    }
+    const bool is_claimed = std::any_of(
+        pfjob->workers.begin(),
+        pfjob->workers.end(),
+        [&](const std::unique_ptr<PrefetchWorker> &worker) {
+          return worker->frame_offset == frame_offset;
+        });
+    if (!is_claimed) {
+      return frame_offset;
+    }
   }
-  pfjob->waiting = false;
-  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+  return std::nullopt;
 }
 
-static void *seq_prefetch_frames(void *job)
+/* Claim the next frame to be rendered by the worker, suspending the worker while there is nothing
+ * to prefetch. Returns false when the worker should stop. */
+static bool seq_prefetch_claim_frame(PrefetchWorker *worker)
 {
-  PrefetchJob *pfjob = static_cast<PrefetchJob *>(job);
+  PrefetchJob *pfjob = worker->pfjob;
+  bool claimed = false;
 
-  while (true) {
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  while (!seq_prefetch_need_stop(pfjob)) {
+    seq_prefetch_update_area(pfjob);
     if (pfjob->cfra < pfjob->timeline_start || pfjob->cfra > pfjob->timeline_end) {
       /* Don't try to prefetch anything when we are outside of the timeline range. */
       break;
     }
-    pfjob->scene_eval->ed->runtime->prefetch_job = nullptr;
 
-    seq_prefetch_update_depsgraph(pfjob);
-    AnimData *adt = BKE_animdata_from_id(&pfjob->context_cpy.scene->id);
-    AnimationEvalContext anim_eval_context = seq_prefetch_anim_eval_context(pfjob);
+    if (!seq_prefetch_need_suspend(pfjob)) {
+      if (const std::optional<int> frame_offset = seq_prefetch_next_frame_offset(pfjob)) {
+        worker->frame_offset = frame_offset;
+        worker->timeline_frame = seq_prefetch_frame_from_offset(pfjob, *frame_offset);
+        worker->generation = pfjob->generation;
+        pfjob->num_frames_claimed = std::max(pfjob->num_frames_claimed, *frame_offset + 1);
+        claimed = true;
+        break;
+      }
+    }
+
+    /* Suspend thread if there is nothing to be prefetched. */
+    pfjob->waiting_workers_num++;
+    BLI_condition_wait(&pfjob->prefetch_suspend_cond, &pfjob->prefetch_suspend_mutex);
+    pfjob->waiting_workers_num--;
+  }
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+
+  return claimed;
+}
+
+static void seq_prefetch_finish_frame(PrefetchWorker *worker)
+{
+  PrefetchJob *pfjob = worker->pfjob;
+
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  const int frame_offset = *worker->frame_offset;
+  if (worker->generation == pfjob->generation && frame_offset >= pfjob->num_frames_prefetched) {
+    pfjob->prefetched_frame_offsets.add(frame_offset);
+    while (pfjob->prefetched_frame_offsets.remove(pfjob->num_frames_prefetched)) {
+      pfjob->num_frames_prefetched++;
+    }
+  }
+  worker->frame_offset.reset();
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+
+  /* Let suspended workers claim the frames which now fit in the prefetch window. */
+  BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
+}
+
+static void *seq_prefetch_frames(void *worker_v)
+{
+  PrefetchWorker *worker = static_cast<PrefetchWorker *>(worker_v);
+  PrefetchJob *pfjob = worker->pfjob;
+
+  while (seq_prefetch_claim_frame(worker)) {
+    worker->scene_eval->ed->runtime->prefetch_job = nullptr;
+
+    seq_prefetch_update_depsgraph(worker);
+    AnimData *adt = BKE_animdata_from_id(&worker->context_cpy.scene->id);
+    AnimationEvalContext anim_eval_context = BKE_animsys_eval_context_construct(
+        worker->depsgraph, worker->timeline_frame);
     BKE_animsys_evaluate_animdata(
-        &pfjob->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
+        &worker->context_cpy.scene->id, adt, &anim_eval_context, ADT_RECALC_ALL, false);
 
     /* This is quite hacky solution:
      * We need cross-reference original scene with copy for cache.
@@ -593,37 +765,28 @@ static void *seq_prefetch_frames(void *job)
      * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
      * Set to nullptr before return!
      */
-    pfjob->scene_eval->ed->runtime->prefetch_job = pfjob;
+    worker->scene_eval->ed->runtime->prefetch_job = pfjob;
 
-    if (seq_prefetch_must_skip_frame(pfjob)) {
-      pfjob->num_frames_prefetched++;
-      /* Break instead of keep looping if the job should be terminated. */
-      if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) ||
-          !(pfjob->scene->ed->cache_flag & SEQ_CACHE_ALL_TYPES) || pfjob->stop)
-      {
-        break;
-      }
-      continue;
+    if (!seq_prefetch_must_skip_frame(worker)) {
+      ImBuf *ibuf = render_give_ibuf(&worker->context_cpy, worker->timeline_frame, 0);
+      IMB_freeImBuf(ibuf);
     }
 
-    ImBuf *ibuf = render_give_ibuf(&pfjob->context_cpy, seq_prefetch_cfra(pfjob), 0);
-    pfjob->num_frames_prefetched++;
-    IMB_freeImBuf(ibuf);
-
-    /* Suspend thread if there is nothing to be prefetched. */
-    seq_prefetch_do_suspend(pfjob);
+    seq_prefetch_finish_frame(worker);
+  }
 
-    if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) ||
-        !(pfjob->scene->ed->cache_flag & SEQ_CACHE_ALL_TYPES) || pfjob->stop)
-    {
-      break;
-    }
+  worker->scene_eval->ed->runtime->prefetch_job = nullptr;
 
-    seq_prefetch_update_area(pfjob);
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  pfjob->running_workers_num--;
+  if (pfjob->running_workers_num == 0) {
+    pfjob->running = false;
   }
-
-  pfjob->running = false;
-  pfjob->scene_eval->ed->runtime->prefetch_job = nullptr;
+  else {
+    /* Other workers are stopped as well, for the same reason. */
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
+  }
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 
   return nullptr;
 }
@@ -639,14 +802,23 @@ static PrefetchJob *seq_prefetch_start_ex(const RenderData *context, float cfra)
     pfjob = MEM_new<PrefetchJob>("PrefetchJob");
     context->scene->ed->runtime->prefetch_job = pfjob;
 
-    BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, 1);
+    /* Rendering a frame is multi-threaded already and renders are exclusive, the workers mainly
+     * hide the parts which are not, like file reading, movie decoding and depsgraph evaluation. */
+    const int workers_num = std::clamp(BLI_system_thread_count() / 8, 1, max_workers_num);
+
+    BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, workers_num);
     BLI_mutex_init(&pfjob->prefetch_suspend_mutex);
     BLI_condition_init(&pfjob->prefetch_suspend_cond);
 
-    pfjob->bmain_eval = BKE_main_new();
     pfjob->scene = context->scene;
-    pfjob->init_depsgraph();
-    pfjob->init_gpu();
+    for (int i = 0; i < workers_num; i++) {
+      std::unique_ptr<PrefetchWorker> worker = std::make_unique<PrefetchWorker>();
+      worker->pfjob = pfjob;
+      worker->bmain_eval = BKE_main_new();
+      worker->init_depsgraph();
+      worker->init_gpu();
+      pfjob->workers.append(std::move(worker));
+    }
   }
   pfjob->bmain = context->bmain;
 
@@ -658,19 +830,23 @@ static PrefetchJob *seq_prefetch_start_ex(const RenderData *context, float cfra)
 
   pfjob->cfra = math::max(int(cfra - before_playhead_frames), pfjob->timeline_start);
 
-  pfjob->num_frames_prefetched = 0;
+  seq_prefetch_reset_area(pfjob);
   pfjob->cache_flags = scene->ed->cache_flag;
 
-  pfjob->waiting = false;
+  pfjob->waiting_workers_num = 0;
   pfjob->stop = false;
   pfjob->running = true;
+  pfjob->running_workers_num = int(pfjob->workers.size());
 
   seq_prefetch_update_scene(context->scene);
   seq_prefetch_update_context(context);
   seq_prefetch_update_active_seqbase(pfjob);
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
-  BLI_threadpool_insert(&pfjob->threads, pfjob);
+  for (std::unique_ptr<PrefetchWorker> &worker : pfjob->workers) {
+    worker->frame_offset.reset();
+    BLI_threadpool_remove(&pfjob->threads, worker.get());
+    BLI_threadpool_insert(&pfjob->threads, worker.get());
+  }
 
   return pfjob;
 }
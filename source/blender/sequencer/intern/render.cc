@@ -19,9 +19,11 @@
 #include "BLI_listbase.hh"
 #include "BLI_math_geom_c.hh"
 #include "BLI_math_matrix.hh"
+#include "BLI_mutex.hh"
 #include "BLI_path_utils.hh"
 #include "BLI_rect.hh"
 #include "BLI_task.hh"
+#include "BLI_utility_mixins.hh"
 
 #include "BKE_anim_data.hh"
 #include "BKE_animsys.hh"
@@ -86,6 +88,7 @@
 #include "utils.hh"
 
 #include <algorithm>
+#include <mutex>
 #include <utility>
 
 namespace blender::seq {
@@ -97,7 +100,36 @@ static SeqResult seq_render_strip_stack(const RenderData *context,
                                         float timeline_frame,
                                         int chanshown);
 
+/* Renders are exclusive, because strips and their runtime data are shared between the renders of
+ * the prefetch workers and other renders. Prefetch workers only release the lock while they read
+ * or decode media, see #PrefetchMediaReadScope. */
 static Mutex seq_render_mutex;
+/* Render lock of the current thread, when it renders a frame for prefetching. */
+static thread_local std::unique_lock<Mutex> *seq_render_prefetch_lock = nullptr;
+
+/**
+ * Let other prefetch workers render while the current one reads an image file or decodes a movie
+ * frame. Only data which is not accessed by other renders may be used in this scope: file paths,
+ * the evaluated strip copy of the worker and movie readers acquired from #MovieReaderCache.
+ */
+class PrefetchMediaReadScope : NonCopyable, NonMovable {
+  std::unique_lock<Mutex> *lock_;
+
+ public:
+  PrefetchMediaReadScope() : lock_(seq_render_prefetch_lock)
+  {
+    if (lock_ != nullptr) {
+      lock_->unlock();
+    }
+  }
+
+  ~PrefetchMediaReadScope()
+  {
+    if (lock_ != nullptr) {
+      lock_->lock();
+    }
+  }
+};
 DrawViewFn view3d_fn = nullptr; /* nullptr in background mode */
 
 /* -------------------------------------------------------------------- */
@@ -889,6 +921,7 @@ static ImBuf *seq_render_image_strip_view(
   }
 
   if (prefix[0] == '\0') {
+    PrefetchMediaReadScope media_read_scope;
     ibuf = IMB_load_image_from_filepath(filepath, flag, strip->data->colorspace_settings.name);
   }
   else {
@@ -898,6 +931,7 @@ static ImBuf *seq_render_image_strip_view(
     {
       return nullptr;
     }
+    PrefetchMediaReadScope media_read_scope;
     ibuf = IMB_load_image_from_filepath(
         filepath_view, flag, strip->data->colorspace_settings.name);
   }
@@ -1076,6 +1110,7 @@ static ImBuf *seq_render_movie_strip_view(const RenderData *context,
       ibuf = seq_render_movie_strip_custom_file_proxy(context, strip, timeline_frame);
     }
     else {
+      PrefetchMediaReadScope media_read_scope;
       ibuf = reader.decode_frame(frame_index + strip->anim_startofs, psize);
     }
 
@@ -1086,6 +1121,7 @@ static ImBuf *seq_render_movie_strip_view(const RenderData *context,
 
   /* Fetching for requested proxy size failed, try fetching the original instead. */
   if (ibuf == nullptr) {
+    PrefetchMediaReadScope media_read_scope;
     ibuf = reader.decode_frame(frame_index + strip->anim_startofs, IMB_PROXY_NONE);
   }
   if (ibuf == nullptr) {
@@ -2143,7 +2179,10 @@ ImBuf *render_give_ibuf(const RenderData *context, float timeline_frame, int cha
   SeqRenderState state;
 
   if (!strips.is_empty() && !out) {
-    std::scoped_lock lock(seq_render_mutex);
+    std::unique_lock lock(seq_render_mutex);
+    if (context->is_prefetch_render) {
+      seq_render_prefetch_lock = &lock;
+    }
     movie_reader_cache_timestamp_bump();
     /* Try to make space before we add any new frames to the cache if it is full.
      * If we do this after we have added the new cache, we risk removing what we just added. */
@@ -2161,6 +2200,7 @@ ImBuf *render_give_ibuf(const RenderData *context, float timeline_frame, int cha
                             context->render != nullptr,
                             out);
     }
+    seq_render_prefetch_lock = nullptr;
   }
 
   seq_prefetch_start(context, timeline_frame);
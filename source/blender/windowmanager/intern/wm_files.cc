@@ -544,6 +544,11 @@ static void wm_init_userdef(Main *bmain)
   MEM_CacheLimiter_set_maximum(cache_limit);
   memory_cache::set_approximate_size_limit(cache_limit);
 
+  char memory_cache_dir[FILE_MAX];
+  BKE_appdir_folder_caches(memory_cache_dir, sizeof(memory_cache_dir));
+  BLI_path_append(memory_cache_dir, sizeof(memory_cache_dir), "memory_cache");
+  memory_cache::set_disk_cache(memory_cache_dir, int64_t(U.memcache_disk_limit) * 1024 * 1024);
+
   BKE_sound_init(bmain);
 
   /* Update the temporary directory from the preferences or fall back to the system default. */
@@ -2341,6 +2346,7 @@ bool WM_autosave_write(wmWindowManager *wm, Main *bmain, ReportList *reports)
 
   /* Error reporting into console. */
   BlendFileWriteParams params{};
+  params.use_adaptive_compression = true;
   const bool success = BLO_write_file(bmain, filepath, fileflags, &params, reports);
 
   /* Restart auto-save timer. */
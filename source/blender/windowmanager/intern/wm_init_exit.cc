@@ -600,8 +600,10 @@ void WM_exit_ex(bContext *C, const bool do_python_exit, const bool do_user_exit_
 
   BKE_mball_cubeTable_free();
 
-  /* Clear the cache which may (indirectly) contain e.g. GPU resources which need to be freed
-   * before the GPU backend is destroyed. */
+  /* Keep the cached values that support it for the next session, then clear the cache which may
+   * (indirectly) contain e.g. GPU resources which need to be freed before the GPU backend is
+   * destroyed. */
+  memory_cache::flush_to_disk();
   memory_cache::clear();
 
   /* Render code might still access databases. */
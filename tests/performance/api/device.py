@@ -135,7 +135,8 @@ class TestMachine:
 
         device_cpu = get_cpu_name()
         self.devices = [TestDevice('CPU', 'CPU', device_cpu, device_cpu, operating_system),
-                        TestDevice('CPU-OSL', 'CPU-OSL', device_cpu, device_cpu, operating_system)]
+                        TestDevice('CPU-OSL', 'CPU-OSL', device_cpu, device_cpu, operating_system),
+                        TestDevice('CPU-WAVEFRONT', 'CPU-WAVEFRONT', device_cpu, device_cpu, operating_system)]
         self.has_gpus = need_gpus
 
         if need_gpus and env.blender_executable:
@@ -29,6 +29,81 @@ def _run(args):
     return result
 
 
+def _run_rig_chain(args):
+    import bpy
+    import time
+
+    # Build a scene where one long chain of operations (armature, deformation, subdivision)
+    # competes with many small independent animated objects, similar to a character rig in a set.
+    bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+    bpy.context.preferences.experimental.use_depsgraph_priority_scheduling = args['priority_scheduling']
+    scene = bpy.context.scene
+    scene.frame_start = 1
+    scene.frame_end = 100
+
+    armature_data = bpy.data.armatures.new("Rig")
+    armature = bpy.data.objects.new("Rig", armature_data)
+    scene.collection.objects.link(armature)
+    bpy.context.view_layer.objects.active = armature
+    bpy.ops.object.mode_set(mode='EDIT')
+    parent = None
+    for i in range(args['bones']):
+        bone = armature_data.edit_bones.new(f"Bone{i}")
+        bone.head = (0.0, 0.0, i * 0.1)
+        bone.tail = (0.0, 0.0, (i + 1) * 0.1)
+        bone.parent = parent
+        bone.use_connect = parent is not None
+        parent = bone
+    bpy.ops.object.mode_set(mode='OBJECT')
+    for i, pose_bone in enumerate(armature.pose.bones):
+        pose_bone.rotation_mode = 'XYZ'
+        pose_bone.rotation_euler = (0.0, 0.0, 0.0)
+        pose_bone.keyframe_insert("rotation_euler", frame=scene.frame_start)
+        pose_bone.rotation_euler = (0.05 * (i % 3), 0.0, 0.05)
+        pose_bone.keyframe_insert("rotation_euler", frame=scene.frame_end)
+
+    bpy.ops.mesh.primitive_cylinder_add(vertices=64, depth=args['bones'] * 0.1)
+    body = bpy.context.active_object
+    body.location.z = args['bones'] * 0.05
+    bpy.ops.object.transform_apply(location=True)
+    body.parent = armature
+    armature_modifier = body.modifiers.new("Armature", 'ARMATURE')
+    armature_modifier.object = armature
+    # Envelopes avoid having to set up vertex groups for the deformation.
+    armature_modifier.use_vertex_groups = False
+    armature_modifier.use_bone_envelopes = True
+    subdivision = body.modifiers.new("Subdivision", 'SUBSURF')
+    subdivision.levels = args['subdivision_levels']
+    body.modifiers.new("Smooth", 'SMOOTH')
+
+    for i in range(args['props']):
+        bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=2, location=(i % 20, i // 20, 0.0))
+        prop = bpy.context.active_object
+        prop.keyframe_insert("location", frame=scene.frame_start)
+        prop.location.z = 1.0
+        prop.keyframe_insert("location", frame=scene.frame_end)
+        prop.modifiers.new("Subdivision", 'SUBSURF').levels = 1
+
+    scene.frame_set(scene.frame_start)
+
+    start_time = time.time()
+    elapsed_time = 0.0
+    num_frames = 0
+
+    while elapsed_time < 10.0:
+        f = scene.frame_current + 1
+        if f >= scene.frame_end:
+            f = scene.frame_start
+        scene.frame_set(f)
+        num_frames += 1
+        elapsed_time = time.time() - start_time
+
+    time_per_frame = elapsed_time / num_frames
+
+    result = {'time': time_per_frame}
+    return result
+
+
 class AnimationTest(api.Test):
     def __init__(self, filepath):
         self.filepath = filepath
@@ -45,6 +120,32 @@ class AnimationTest(api.Test):
         return result
 
 
+class AnimationRigChainTest(api.Test):
+    def __init__(self, priority_scheduling):
+        # Compare with and without prioritizing the longest chains of depsgraph operations.
+        self.priority_scheduling = priority_scheduling
+
+    def name(self):
+        if self.priority_scheduling:
+            return "rig_chain_playback_priority_scheduling"
+        return "rig_chain_playback"
+
+    def category(self):
+        return "animation"
+
+    def run(self, env, device_id, gpu_backend):
+        args = {
+            'bones': 32,
+            'subdivision_levels': 3,
+            'props': 200,
+            'priority_scheduling': self.priority_scheduling,
+        }
+        result, _ = env.run_in_blender(_run_rig_chain, args, ["--factory-startup"])
+        return result
+
+
 def generate(env):
     filepaths = env.find_blend_files('animation/*')
-    return [AnimationTest(filepath) for filepath in filepaths]
+    return [AnimationTest(filepath) for filepath in filepaths] + [
+        AnimationRigChainTest(priority_scheduling) for priority_scheduling in (False, True)
+    ]
@@ -22,6 +22,32 @@ def _run(filepath):
     return result
 
 
+def _run_compressed(filepath):
+    import bpy
+    import os
+    import tempfile
+    import time
+
+    bpy.ops.wm.open_mainfile(filepath=filepath)
+
+    # Save a compressed copy, so that loading exercises the (multi-threaded) zstd reader.
+    with tempfile.TemporaryDirectory() as tmpdir:
+        compressed_filepath = os.path.join(tmpdir, os.path.basename(filepath))
+        bpy.ops.wm.save_as_mainfile(filepath=compressed_filepath, compress=True, copy=True)
+        bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+
+        # Load once to ensure it's cached by OS
+        bpy.ops.wm.open_mainfile(filepath=compressed_filepath)
+        bpy.ops.wm.read_homefile(use_empty=True, use_factory_startup=True)
+
+        start_time = time.time()
+        bpy.ops.wm.open_mainfile(filepath=compressed_filepath)
+        elapsed_time = time.time() - start_time
+
+    result = {'time': elapsed_time}
+    return result
+
+
 class BlendLoadTest(api.Test):
     def __init__(self, filepath):
         self.filepath = filepath
@@ -37,6 +63,27 @@ class BlendLoadTest(api.Test):
         return result
 
 
+class BlendLoadCompressedTest(api.Test):
+    def __init__(self, filepath, threads):
+        self.filepath = filepath
+        # Zero means using all available threads.
+        self.threads = threads
+
+    def name(self):
+        threads_str = str(self.threads) if self.threads else "all"
+        return f"{self.filepath.stem}_compressed_threads_{threads_str}"
+
+    def category(self):
+        return "blend_load"
+
+    def run(self, env, device_id, gpu_backend):
+        blender_args = ['--threads', str(self.threads)]
+        result, _ = env.run_in_blender(_run_compressed, str(self.filepath), blender_args)
+        return result
+
+
 def generate(env):
     filepaths = env.find_blend_files('*/*')
-    return [BlendLoadTest(filepath) for filepath in filepaths]
+    tests = [BlendLoadTest(filepath) for filepath in filepaths]
+    tests += [BlendLoadCompressedTest(filepath, threads) for filepath in filepaths for threads in (1, 0)]
+    return tests
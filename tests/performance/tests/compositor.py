@@ -12,6 +12,7 @@ def _run(args):
     device_type, _ = (args['device_type'].split("-") + [""])[:2]
     scene = bpy.context.scene
     scene.render.compositor_device = ('CPU' if device_type == 'CPU' else 'GPU')
+    scene.render.compositor_precision = args['precision']
 
     test_time_start = time.time()
     measured_times = []
@@ -37,11 +38,14 @@ def _run(args):
 
 
 class CompositorTest(api.Test):
-    def __init__(self, filepath):
+    def __init__(self, filepath, precision):
         self.filepath = filepath
+        # Overrides the precision of the file, to compare full and half precision. Final renders use
+        # full precision by default, so there is no separate test for the precision of the file.
+        self.precision = precision
 
     def name(self):
-        return self.filepath.stem
+        return f"{self.filepath.stem}_{self.precision.lower()}_precision"
 
     def category(self):
         return "compositor"
@@ -52,7 +56,7 @@ class CompositorTest(api.Test):
     def run(self, env, device_id, gpu_backend):
         tokens = device_id.split('_')
         device_type = tokens[0]
-        args = {'device_type': device_type}
+        args = {'device_type': device_type, 'precision': self.precision}
 
         result, _ = env.run_in_blender(_run, args, [self.filepath])
         return result
@@ -60,4 +64,4 @@ class CompositorTest(api.Test):
 
 def generate(env):
     filepaths = env.find_blend_files('compositor/*')
-    return [CompositorTest(filepath) for filepath in filepaths]
+    return [CompositorTest(filepath, precision) for filepath in filepaths for precision in ('FULL', 'HALF')]
@@ -14,9 +14,10 @@ def _run(args):
     device_suffixes = device_info[1:]
     use_hwrt = "RT" in device_suffixes
     use_osl = "OSL" in device_suffixes
+    use_wavefront = "WAVEFRONT" in device_suffixes
 
     for suffix in device_suffixes:
-        if suffix not in {"RT", "OSL"}:
+        if suffix not in {"RT", "OSL", "WAVEFRONT"}:
             raise SystemExit(f"Unknown device type suffix {suffix}")
 
     device_index = args['device_index']
@@ -41,6 +42,11 @@ def _run(args):
     if use_osl:
         scene.cycles.shading_system = True
 
+    if use_wavefront:
+        if device_type != 'CPU':
+            raise SystemExit("The wavefront integrator is only available on the CPU")
+        scene.cycles.debug_use_cpu_wavefront = True
+
     if scene.cycles.device == 'GPU':
         # Enable specified GPU in preferences.
         prefs = bpy.context.preferences
@@ -84,7 +90,8 @@ class CyclesTest(api.Test):
 
     def supported_device_types(self):
         return [
-            "CPU", "CPU-OSL", "CUDA", "OPTIX", "OPTIX-OSL", "ONEAPI", "ONEAPI-RT", "HIP", "HIP-RT", "METAL", "METAL-RT"
+            "CPU", "CPU-OSL", "CPU-WAVEFRONT", "CUDA", "OPTIX", "OPTIX-OSL", "ONEAPI", "ONEAPI-RT", "HIP", "HIP-RT",
+            "METAL", "METAL-RT"
         ]
 
     def run(self, env, device_id, gpu_backend):
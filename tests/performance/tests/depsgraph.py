@@ -0,0 +1,78 @@
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run_relations_update(args):
+    import bpy
+    import time
+
+    objects_num = args["objects_num"]
+    iterations = args["iterations"]
+    full_rebuild = args["full_rebuild"]
+
+    bpy.ops.wm.read_homefile(use_factory_startup=True)
+    scene = bpy.context.scene
+    mesh = bpy.data.meshes.new("Mesh")
+    mesh.from_pydata([(0, 0, 0), (1, 0, 0), (0, 1, 0)], [], [(0, 1, 2)])
+    for i in range(objects_num):
+        ob = bpy.data.objects.new(f"Object{i}", mesh)
+        ob.location = (i % 100, i // 100, 0)
+        ob.modifiers.new("Displace", 'DISPLACE')
+        scene.collection.objects.link(ob)
+
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+    depsgraph.update()
+    ob = scene.collection.objects[0]
+
+    start_time = time.time()
+
+    for i in range(iterations):
+        modifier = ob.modifiers.new("Subdivision", 'SUBSURF')
+        if full_rebuild:
+            depsgraph.debug_tag_update()
+        depsgraph.update()
+        ob.modifiers.remove(modifier)
+        if full_rebuild:
+            depsgraph.debug_tag_update()
+        depsgraph.update()
+
+    elapsed_time = time.time() - start_time
+
+    result = {'time': elapsed_time}
+    return result
+
+
+class DepsgraphRelationsUpdateTest(api.Test):
+    def __init__(self, objects_num, iterations, full_rebuild):
+        self.objects_num = objects_num
+        self.iterations = iterations
+        self.full_rebuild = full_rebuild
+
+    def name(self):
+        update_type = "Full" if self.full_rebuild else "Incremental"
+        return f"{update_type} Relations Update ({self.objects_num} objects)"
+
+    def category(self):
+        return "depsgraph"
+
+    def run(self, env, device_id, gpu_backend):
+        args = {
+            "objects_num": self.objects_num,
+            "iterations": self.iterations,
+            "full_rebuild": self.full_rebuild,
+        }
+        result, _ = env.run_in_blender(_run_relations_update, args, ["--factory-startup"])
+        return result
+
+
+def generate(env):
+    # Adding and removing a modifier only tags relations of the object, which are updated in place
+    # unless a full rebuild is forced, evaluation is the same in both cases.
+    return [
+        DepsgraphRelationsUpdateTest(objects_num, 50, full_rebuild)
+        for objects_num in (100, 10000)
+        for full_rebuild in (False, True)
+    ]
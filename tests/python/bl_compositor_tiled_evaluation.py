@@ -0,0 +1,94 @@
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# ./blender.bin --background --factory-startup --python tests/python/bl_compositor_tiled_evaluation.py -- --verbose
+import bpy
+import os
+import tempfile
+import unittest
+
+# Makes the CPU compositor use tiny tiles, such that the small images of these tests are evaluated
+# in many tiles, see `get_tile_size` in `render/intern/compositor.cc`.
+DEBUG_VALUE_TINY_TILES = 5010
+
+
+class TestCompositorTiledEvaluation(unittest.TestCase):
+    """
+    Filter nodes are evaluated in tiles along with the pixel nodes before them. The results have to
+    match an evaluation of the whole image at once.
+    """
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        self.temp_dir = tempfile.TemporaryDirectory()
+
+        scene = bpy.context.scene
+        scene.render.resolution_x = 256
+        scene.render.resolution_y = 128
+        scene.render.resolution_percentage = 100
+        scene.render.compositor_device = 'CPU'
+        scene.render.image_settings.file_format = 'OPEN_EXR'
+        scene.render.image_settings.color_depth = '32'
+
+        self.image = bpy.data.images.new("Grid", 256, 128, float_buffer=True)
+        self.image.generated_type = 'COLOR_GRID'
+
+    def tearDown(self):
+        bpy.app.debug_value = 0
+        self.temp_dir.cleanup()
+
+    def create_node_group(self, filter_node_type):
+        """
+        Create an image node followed by an invert node, which is a pixel node, and a filter node.
+        """
+        tree = bpy.data.node_groups.new("Compositor", 'CompositorNodeTree')
+        tree.interface.new_socket("Image", in_out='OUTPUT', socket_type='NodeSocketColor')
+
+        image_node = tree.nodes.new('CompositorNodeImage')
+        image_node.image = self.image
+        invert_node = tree.nodes.new('CompositorNodeInvert')
+        filter_node = tree.nodes.new(filter_node_type)
+        output_node = tree.nodes.new('NodeGroupOutput')
+
+        tree.links.new(image_node.outputs["Image"], invert_node.inputs["Color"])
+        tree.links.new(invert_node.outputs["Color"], filter_node.inputs["Image"])
+        tree.links.new(filter_node.outputs["Image"], output_node.inputs[0])
+
+        bpy.context.scene.compositing_node_group = tree
+        return filter_node
+
+    def render_pixels(self, debug_value):
+        bpy.app.debug_value = debug_value
+        bpy.ops.render.render()
+
+        filepath = os.path.join(self.temp_dir.name, "render_{:d}.exr".format(debug_value))
+        bpy.data.images["Render Result"].save_render(filepath)
+        image = bpy.data.images.load(filepath)
+        pixels = image.pixels[:]
+        bpy.data.images.remove(image)
+        return pixels
+
+    def assert_tiled_matches_untiled(self):
+        untiled_pixels = self.render_pixels(0)
+        tiled_pixels = self.render_pixels(DEBUG_VALUE_TINY_TILES)
+        self.assertEqual(len(tiled_pixels), len(untiled_pixels))
+        mismatches = sum(1 for a, b in zip(tiled_pixels, untiled_pixels) if a != b)
+        self.assertEqual(mismatches, 0)
+
+    def test_filter(self):
+        for filter_type in ('SOFTEN', 'SHARPEN', 'LAPLACE', 'KIRSCH'):
+            with self.subTest(filter_type=filter_type):
+                filter_node = self.create_node_group('CompositorNodeFilter')
+                filter_node.inputs["Type"].default_value = filter_type
+                self.assert_tiled_matches_untiled()
+
+    def test_despeckle(self):
+        self.create_node_group('CompositorNodeDespeckle')
+        self.assert_tiled_matches_untiled()
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
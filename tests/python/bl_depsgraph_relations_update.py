@@ -0,0 +1,91 @@
+# SPDX-FileCopyrightText: 2026 Blender Authors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+# ./blender.bin --background --factory-startup --python tests/python/bl_depsgraph_relations_update.py -- --verbose
+import bpy
+import unittest
+
+
+class TestRelationsUpdate(unittest.TestCase):
+    """
+    Adding and removing modifiers only tags relations of the object for update, which updates the
+    dependency graph in place. The result has to match a dependency graph built from scratch.
+    """
+
+    def setUp(self):
+        bpy.ops.wm.read_homefile(use_factory_startup=True)
+        self.scene = bpy.context.scene
+        self.depsgraph = bpy.context.evaluated_depsgraph_get()
+
+    def add_mesh_object(self, name):
+        mesh = bpy.data.meshes.new(name)
+        mesh.from_pydata([(0, 0, 0), (1, 0, 0), (0, 1, 0)], [], [(0, 1, 2)])
+        ob = bpy.data.objects.new(name, mesh)
+        self.scene.collection.objects.link(ob)
+        return ob
+
+    def update_and_validate(self):
+        self.depsgraph.update()
+        self.assertTrue(self.depsgraph.debug_relations_validate())
+
+    def test_modifier_add_remove(self):
+        ob = self.add_mesh_object("Object")
+        self.update_and_validate()
+
+        modifier = ob.modifiers.new("Subdivision", 'SUBSURF')
+        self.update_and_validate()
+        ob.modifiers.new("Displace", 'DISPLACE')
+        self.update_and_validate()
+        ob.modifiers.remove(modifier)
+        self.update_and_validate()
+        ob.modifiers.clear()
+        self.update_and_validate()
+
+    def test_modifier_remove_last_user(self):
+        # The node group is only used by the removed modifier, so it is not a part of the graph
+        # anymore afterwards.
+        ob = self.add_mesh_object("Object")
+        modifier = ob.modifiers.new("Nodes", 'NODES')
+        modifier.node_group = bpy.data.node_groups.new("Nodes", 'GeometryNodeTree')
+        self.update_and_validate()
+
+        ob.modifiers.remove(modifier)
+        self.update_and_validate()
+
+    def test_modifier_remove_shared(self):
+        ob = self.add_mesh_object("Object")
+        ob_other = self.add_mesh_object("Other")
+        node_group = bpy.data.node_groups.new("Nodes", 'GeometryNodeTree')
+        modifier = ob.modifiers.new("Nodes", 'NODES')
+        modifier.node_group = node_group
+        ob_other.modifiers.new("Nodes", 'NODES').node_group = node_group
+        self.update_and_validate()
+
+        ob.modifiers.remove(modifier)
+        self.update_and_validate()
+        ob.modifiers.new("Subdivision", 'SUBSURF')
+        self.update_and_validate()
+
+    def test_modifier_remove_custom_data_request(self):
+        # The data transfer modifier requests custom data layers of the source object.
+        ob = self.add_mesh_object("Object")
+        ob_source = self.add_mesh_object("Source")
+        modifier = ob.modifiers.new("DataTransfer", 'DATA_TRANSFER')
+        modifier.object = ob_source
+        modifier.use_loop_data = True
+        modifier.data_types_loops = {'CUSTOM_NORMAL'}
+        modifier.use_vert_data = True
+        modifier.data_types_verts = {'VGROUP_WEIGHTS'}
+        self.update_and_validate()
+
+        ob.modifiers.new("Subdivision", 'SUBSURF')
+        self.update_and_validate()
+        ob.modifiers.remove(modifier)
+        self.update_and_validate()
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
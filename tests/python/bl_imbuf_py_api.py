@@ -181,6 +181,16 @@ class TestImBufResize(unittest.TestCase):
         self.assertEqual(ibuf.size, DEFAULT_SIZE)
         ibuf.free()
 
+    def test_resize_method_filters(self):
+        for method in ('MITCHELL', 'LANCZOS3'):
+            with self.subTest(method=method):
+                ibuf = imbuf.new((64, 64))
+                ibuf.resize(DEFAULT_SIZE, method=method)
+                self.assertEqual(ibuf.size, DEFAULT_SIZE)
+                ibuf.resize((48, 80), method=method)
+                self.assertEqual(ibuf.size, (48, 80))
+                ibuf.free()
+
     def test_resize_invalid(self):
         ibuf = imbuf.new(DEFAULT_SIZE)
         with self.assertRaises(ValueError):
@@ -156,7 +156,8 @@ class CyclesReport(render_report.Report):
             oiiotool,
             device=None,
             blocklist=[],
-            osl=False):
+            osl=False,
+            wavefront=False):
         # Split device name in format "<device_type>[-<RT>]" into individual
         # tokens, setting the RT suffix to an empty string if its not specified.
         self.device, suffix = (device.split("-") + [""])[:2]
@@ -169,12 +170,17 @@ class CyclesReport(render_report.Report):
             variation += ' ' + suffix
         if self.osl:
             variation += ' OSL'
+        if wavefront:
+            variation += ' Wavefront'
 
         super().__init__(title, output_dir, oiiotool, variation, blocklist)
 
         self.set_pixelated(True)
         self.set_reference_dir("cycles_renders")
-        if device == 'CPU':
+        if wavefront:
+            # The wavefront integrator must match the megakernel output.
+            self.set_compare_engine('cycles', 'CPU')
+        elif device == 'CPU':
             self.set_compare_engine('eevee')
         else:
             self.set_compare_engine('cycles', 'CPU')
@@ -262,6 +268,8 @@ def create_argparse():
     parser.add_argument("--device", required=True)
     parser.add_argument("--osl", default='none', type=str, choices=["none", "limited", "all"])
     parser.add_argument('--batch', default=False, action='store_true')
+    parser.add_argument('--wavefront', default=False, action='store_true',
+                        help="Render with the CPU wavefront integrator instead of the megakernel")
     return parser
 
 
@@ -296,6 +304,13 @@ def main():
 
     device = args.device
 
+    if args.wavefront:
+        if device != 'CPU':
+            print("The wavefront integrator is only available on the CPU")
+            sys.exit(1)
+        # Inherited by the Blender processes that render the tests.
+        os.environ['CYCLES_CPU_WAVEFRONT'] = '1'
+
     blocklist = BLOCKLIST_ALL
 
     if args.osl == 'none':
@@ -327,7 +342,10 @@ def main():
         blocklist += BLOCKLIST_HIPRT
 
     test_dir_name = Path(args.testdir).name
-    report = CyclesReport('Cycles', test_dir_name, args.outdir, args.oiiotool, device, blocklist, args.osl == 'all')
+    report = CyclesReport('Cycles', test_dir_name, args.outdir, args.oiiotool,
+                          device, blocklist, args.osl == 'all', args.wavefront)
+    if args.wavefront:
+        report.set_test_name_suffix("_wavefront")
 
     # Increase threshold for motion blur, see #78777.
     #
@@ -6,6 +6,7 @@
 import argparse
 import pathlib
 import sys
+import textwrap
 import unittest
 
 from modules.test_utils import AbstractBlenderRunnerTest
@@ -90,6 +91,61 @@ class FPSDetectionTest(AbstractFFmpegSequencerTest):
             361)
 
 
+class ReverseDecodingTest(AbstractFFmpegSequencerTest):
+    """
+    Frames decoded in reverse order are partly taken from the decoded frames of the current GOP
+    (group of pictures) instead of being decoded again. They have to match the frames that are
+    decoded in forward order.
+    """
+
+    def get_frame_hashes(self, filename: pathlib.Path, frames: list[int]) -> list[tuple[int, str]]:
+        movie = self.testdir / filename
+        script = textwrap.dedent("""\
+            import bpy
+            import hashlib
+            import os
+            import tempfile
+            scene = bpy.context.scene
+            scene.render.resolution_x = 160
+            scene.render.resolution_y = 90
+            scene.render.resolution_percentage = 100
+            scene.render.image_settings.file_format = 'PNG'
+            ed = scene.sequence_editor_create()
+            ed.use_cache_raw = False
+            ed.use_cache_final = False
+            ed.strips.new_movie('test_movie', {movie!r}, channel=1, frame_start=1)
+            with tempfile.TemporaryDirectory() as temp_dir:
+                filepath = os.path.join(temp_dir, 'frame.png')
+                for frame in {frames!r}:
+                    scene.frame_set(frame)
+                    bpy.ops.render.render()
+                    bpy.data.images['Render Result'].save_render(filepath)
+                    image = bpy.data.images.load(filepath)
+                    digest = hashlib.md5(bytes(round(v * 255) for v in image.pixels)).hexdigest()
+                    bpy.data.images.remove(image)
+                    print(f'hash:{{frame}}:{{digest}}')
+            """).format(movie=movie.as_posix(), frames=frames)
+        output = self.run_blender('', script)
+        hashes = []
+        for line in output.splitlines():
+            if line.startswith("hash:"):
+                _, frame, digest = line.split(':')
+                hashes.append((int(frame), digest))
+        return hashes
+
+    def test_reverse_equals_forward(self):
+        frames = list(range(1, 31))
+        # Decode forward first, so that the reader is at the end of the range and the frames
+        # before it are taken from the GOP cache when decoding in reverse.
+        hashes = self.get_frame_hashes('T126866.mp4', frames + frames[::-1])
+        self.assertEqual(len(hashes), 2 * len(frames))
+        forward = dict(hashes[:len(frames)])
+        backward = dict(hashes[len(frames):])
+        self.assertEqual(forward, backward)
+        # The frames are not all the same, otherwise the test would not detect wrong frames.
+        self.assertGreater(len(set(forward.values())), 1)
+
+
 if __name__ == '__main__':
     parser = argparse.ArgumentParser()
     parser.add_argument('--blender', required=True)
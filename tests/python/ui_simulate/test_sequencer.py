@@ -58,3 +58,66 @@ def compositor_modifier_mask_with_single_input():
 
     t.assertEqual(modifier.input_mask_type, 'ID')
     t.assertIs(modifier.input_mask_id, mask)
+
+
+def prefetch_playback():
+    """
+    Prefetch frames with several workers in the background, while the preview is redrawn and the
+    current frame changes.
+    """
+    import bpy
+
+    _, t, window = ui.test_window()
+
+    scene = window.scene
+    window.workspace.sequencer_scene = scene
+    sequence_editor = scene.sequence_editor_create()
+    movie_path = os.path.normpath(
+        os.path.join(os.path.dirname(__file__), "..", "..", "files", "compositor", "motion.mp4")
+    )
+    strip = sequence_editor.strips.new_movie(
+        name="Movie",
+        filepath=movie_path,
+        channel=1,
+        frame_start=1,
+    )
+    color_strip = sequence_editor.strips.new_effect(
+        name="Color",
+        type='COLOR',
+        channel=2,
+        frame_start=1,
+        length=strip.frame_final_duration,
+    )
+    color_strip.blend_type = 'MULTIPLY'
+    scene.render.resolution_x = 1920
+    scene.render.resolution_y = 1080
+    scene.render.resolution_percentage = 100
+    scene.frame_start = 1
+    scene.frame_end = strip.frame_final_end - 1
+    scene.frame_set(1)
+
+    area = ui.largest_area(window.screen)
+    area.type = 'SEQUENCE_EDITOR'
+    area.spaces.active.view_type = 'PREVIEW'
+    sequence_editor.use_cache_final = True
+    sequence_editor.use_prefetch = True
+    yield
+
+    # The preview only renders the current frame, other frames are cached by prefetching.
+    frame_size_mb = scene.render.resolution_x * scene.render.resolution_y * 4 / (1024 * 1024)
+    expected_size_mb = int(min(3, scene.frame_end) * frame_size_mb)
+
+    def is_prefetched():
+        return sequence_editor.cache_final_size >= expected_size_mb
+
+    yield from ui.idle_until(is_prefetched, timeout=10.0)
+    t.assertGreaterEqual(sequence_editor.cache_final_size, expected_size_mb)
+
+    # Changing the current frame restarts prefetching while workers may still be rendering.
+    for frame in (scene.frame_end, 2, 1):
+        scene.frame_set(frame)
+        area.tag_redraw()
+        yield
+    # Let the restarted workers render for a while.
+    yield from ui.idle_until(lambda: False, timeout=0.5)
+    t.assertGreaterEqual(sequence_editor.cache_final_size, expected_size_mb)